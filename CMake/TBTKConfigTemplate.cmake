@@ -34,6 +34,7 @@ FIND_PACKAGE(Eigen3 QUIET)
 FIND_PACKAGE(FFTW3 QUIET)
 FIND_PACKAGE(GMP QUIET)
 FIND_PACKAGE(Gnuplot QUIET)
+FIND_PACKAGE(MPI QUIET)
 FIND_PACKAGE(OpenCV QUIET)
 IF(NOT TBTK_NO_OPEN_BLAS)
 	FIND_PACKAGE(OpenBLAS QUIET)
@@ -131,6 +132,15 @@ IF(TBTK_ENABLE_ALL_OPTIONS)
 	ENDIF(LIBINT2_FOUND)
 ENDIF(TBTK_ENABLE_ALL_OPTIONS)
 
+IF(MPI_CXX_FOUND)
+	TBTK_MESSAGE("[X] MPI")
+	INCLUDE_DIRECTORIES(${MPI_CXX_INCLUDE_PATH})
+	LIST(APPEND TBTK_LIBRARIES ${MPI_CXX_LIBRARIES})
+	ADD_DEFINITIONS(-DTBTK_USE_MPI)
+ELSE(MPI_CXX_FOUND)
+	TBTK_MESSAGE("[ ] MPI")
+ENDIF(MPI_CXX_FOUND)
+
 IF(OpenCV_FOUND)
 	TBTK_MESSAGE("[X] OpenCV")
 #	SET(TBTK_LIBRARIES "${TBTK_LIBRARIES} ${OpenCV_LIBRARIES}")
@@ -0,0 +1,242 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file BasisIndexCache.h
+ *  @brief Flat lookup table between physical indices and basis indices.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_BASIS_INDEX_CACHE
+#define COM_DAFER45_TBTK_BASIS_INDEX_CACHE
+
+#include "TBTK/Index.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Flat lookup table between physical indices and basis indices.
+ *
+ *  The BasisIndexCache stores the physical @link Index Indices @endlink of a
+ *  Hilbert space basis in flat arrays and provides constant time lookup in
+ *  both directions. It is used by the HoppingAmplitudeSet to avoid walking
+ *  the HoppingAmplitudeTree once per subindex in
+ *  HoppingAmplitudeSet::getBasisIndex() and
+ *  HoppingAmplitudeSet::getPhysicalIndex().
+ *
+ *  The @link Index Indices@endlink are added in the order of their basis
+ *  indices, after which BasisIndexCache::generate() is called. If all
+ *  @link Index Indices@endlink have the same number of subindices and fill
+ *  a sufficiently large fraction of the rectangular range that they span,
+ *  the lookup is done through a dense table with one entry per point in the
+ *  range. Otherwise an open addressing hash table is used.
+ *
+ *  BasisIndexCache::getBasisIndex() returns -1 for @link Index
+ *  Indices@endlink that are not in the cache. The cache can therefore be
+ *  queried first, with the full tree lookup used as a fallback that also
+ *  takes care of error reporting. */
+class BasisIndexCache{
+public:
+	/** Enum class for specifying how the basis indices are looked up. */
+	enum class StorageFormat{None, Dense, Hash};
+
+	/** Constructor. */
+	BasisIndexCache();
+
+	/** Add the physical Index for the next basis index.
+	 *
+	 *  @param index The physical Index. */
+	void add(const Index &index);
+
+	/** Generate the lookup table. No more @link Index Indices@endlink
+	 *  should be added after this call. */
+	void generate();
+
+	/** Remove all @link Index Indices@endlink and release the memory. */
+	void clear();
+
+	/** Check whether the lookup table has been generated.
+	 *
+	 *  @return True if BasisIndexCache::generate() has been called since
+	 *  the last call to BasisIndexCache::clear(). */
+	bool getIsGenerated() const;
+
+	/** Get the storage format.
+	 *
+	 *  @return The StorageFormat used for the lookup. StorageFormat::None
+	 *  if the lookup table has not been generated. */
+	StorageFormat getStorageFormat() const;
+
+	/** Get the number of basis indices.
+	 *
+	 *  @return The number of @link Index Indices@endlink that have been
+	 *  added. */
+	unsigned int getSize() const;
+
+	/** Get the basis index for a physical Index.
+	 *
+	 *  @param index The physical Index.
+	 *
+	 *  @return The basis index of the physical Index, or -1 if the Index
+	 *  is not in the cache or the lookup table has not been generated. */
+	int getBasisIndex(const Index &index) const;
+
+	/** Get the physical Index for a basis index.
+	 *
+	 *  @param basisIndex The basis index. Must be in the range
+	 *  [0, getSize()).
+	 *
+	 *  @return The physical Index of the basis index. */
+	Index getPhysicalIndex(int basisIndex) const;
+
+	/** Get size in bytes.
+	 *
+	 *  @return Memory size required to store the BasisIndexCache. */
+	unsigned int getSizeInBytes() const;
+private:
+	/** The storage format that is used for the lookup. */
+	StorageFormat storageFormat;
+
+	/** The subindices of all added @link Index Indices@endlink, stored
+	 *  one after the other. */
+	std::vector<int> subindices;
+
+	/** Offsets into subindices for each basis index. Contains one more
+	 *  element than the number of basis indices. */
+	std::vector<unsigned int> offsets;
+
+	/** Number of values that each subindex can take in the dense storage
+	 *  format. */
+	std::vector<unsigned int> ranges;
+
+	/** Strides used to compute the position in the dense table. */
+	std::vector<unsigned int> strides;
+
+	/** Lookup table. For the dense storage format, this contains the
+	 *  basis index for each point in the rectangular range spanned by the
+	 *  @link Index Indices@endlink. For the hash storage format, it
+	 *  contains the basis indices in the buckets given by the hash of the
+	 *  corresponding @link Index Indices@endlink. Empty entries are -1. */
+	std::vector<int> table;
+
+	/** Mask used to map a hash to a bucket. */
+	std::uint64_t hashMask;
+
+	/** Generate the dense lookup table.
+	 *
+	 *  @return False if the @link Index Indices@endlink are too sparse for
+	 *  the dense storage format. */
+	bool generateDense();
+
+	/** Generate the hash table. */
+	void generateHash();
+
+	/** Check whether an Index is equal to the physical Index of a given
+	 *  basis index. */
+	bool equals(int basisIndex, const Index &index) const;
+};
+
+inline bool BasisIndexCache::getIsGenerated() const{
+	return storageFormat != StorageFormat::None;
+}
+
+inline BasisIndexCache::StorageFormat BasisIndexCache::getStorageFormat(
+) const{
+	return storageFormat;
+}
+
+inline unsigned int BasisIndexCache::getSize() const{
+	return offsets.size() - 1;
+}
+
+inline int BasisIndexCache::getBasisIndex(const Index &index) const{
+	switch(storageFormat){
+	case StorageFormat::Dense:
+	{
+		if(index.getSize() != ranges.size())
+			return -1;
+
+		unsigned int position = 0;
+		for(unsigned int n = 0; n < ranges.size(); n++){
+			unsigned int subindex = (int)index[n];
+			if(subindex >= ranges[n])
+				return -1;
+
+			position += subindex*strides[n];
+		}
+
+		return table[position];
+	}
+	case StorageFormat::Hash:
+	{
+		std::uint64_t bucket = Index::hashSubindices(
+			index,
+			0,
+			index.getSize()
+		)&hashMask;
+		while(true){
+			int basisIndex = table[bucket];
+			if(basisIndex == -1 || equals(basisIndex, index))
+				return basisIndex;
+
+			bucket = (bucket + 1)&hashMask;
+		}
+	}
+	default:
+		return -1;
+	}
+}
+
+inline Index BasisIndexCache::getPhysicalIndex(int basisIndex) const{
+	TBTKAssert(
+		basisIndex >= 0 && (unsigned int)basisIndex < getSize(),
+		"BasisIndexCache::getPhysicalIndex()",
+		"Basis index '" << basisIndex << "' out of bound.",
+		"The basis index must be in the range [0, " << getSize()
+		<< ")."
+	);
+
+	Index index;
+	for(
+		unsigned int n = offsets[basisIndex];
+		n < offsets[basisIndex+1];
+		n++
+	){
+		index.pushBack(subindices[n]);
+	}
+
+	return index;
+}
+
+inline bool BasisIndexCache::equals(int basisIndex, const Index &index) const{
+	unsigned int offset = offsets[basisIndex];
+	unsigned int size = offsets[basisIndex+1] - offset;
+	if(size != index.getSize())
+		return false;
+
+	for(unsigned int n = 0; n < size; n++)
+		if(subindices[offset + n] != (int)index[n])
+			return false;
+
+	return true;
+}
+
+};	//End of namespace TBTK
+
+#endif
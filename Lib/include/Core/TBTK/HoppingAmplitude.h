@@ -29,6 +29,7 @@
 #include <complex>
 #include <initializer_list>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace TBTK{
@@ -119,6 +120,25 @@ public:
 	 *  @param ha HoppingAmplitude to copy. */
 	HoppingAmplitude(const HoppingAmplitude &ha);
 
+	/** Move constructor.
+	 *
+	 *  @param ha HoppingAmplitude to move. */
+	HoppingAmplitude(HoppingAmplitude &&ha) noexcept;
+
+	/** Assignment operator.
+	 *
+	 *  @param rhs HoppingAmplitude to assign to the left hand side.
+	 *
+	 *  @return Reference to the assigned HoppingAmplitude. */
+	HoppingAmplitude& operator=(const HoppingAmplitude &rhs);
+
+	/** Move assignment operator.
+	 *
+	 *  @param rhs HoppingAmplitude to assign to the left hand side.
+	 *
+	 *  @return Reference to the assigned HoppingAmplitude. */
+	HoppingAmplitude& operator=(HoppingAmplitude &&rhs) noexcept;
+
 	//TBTKFeature Core.HoppingAmplitude.Serialization.1 2019-09-23
 	/** Constructor. Constructs the HoppingAmplitude from a serialization
 	 *  string.
@@ -240,6 +260,38 @@ private:
 
 };
 
+inline HoppingAmplitude::HoppingAmplitude(
+	HoppingAmplitude &&ha
+) noexcept :
+	amplitude(ha.amplitude),
+	amplitudeCallback(ha.amplitudeCallback),
+	fromIndex(std::move(ha.fromIndex)),
+	toIndex(std::move(ha.toIndex))
+{
+}
+
+inline HoppingAmplitude& HoppingAmplitude::operator=(
+	const HoppingAmplitude &rhs
+){
+	amplitude = rhs.amplitude;
+	amplitudeCallback = rhs.amplitudeCallback;
+	fromIndex = rhs.fromIndex;
+	toIndex = rhs.toIndex;
+
+	return *this;
+}
+
+inline HoppingAmplitude& HoppingAmplitude::operator=(
+	HoppingAmplitude &&rhs
+) noexcept{
+	amplitude = rhs.amplitude;
+	amplitudeCallback = rhs.amplitudeCallback;
+	fromIndex = std::move(rhs.fromIndex);
+	toIndex = std::move(rhs.toIndex);
+
+	return *this;
+}
+
 inline std::complex<double> HoppingAmplitude::getAmplitude() const{
 	if(amplitudeCallback){
 		return amplitudeCallback->getHoppingAmplitude(
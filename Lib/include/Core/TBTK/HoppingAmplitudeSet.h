@@ -23,6 +23,7 @@
 #ifndef COM_DAFER45_TBTK_HOPPING_AMPLITUDE_SET
 #define COM_DAFER45_TBTK_HOPPING_AMPLITUDE_SET
 
+#include "TBTK/BasisIndexCache.h"
 #include "TBTK/HoppingAmplitude.h"
 #include "TBTK/HoppingAmplitudeTree.h"
 #include "TBTK/IndexTree.h"
@@ -31,7 +32,9 @@
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
 #include <complex>
+#include <mutex>
 #include <vector>
 
 namespace TBTK{
@@ -46,21 +49,38 @@ namespace TBTK{
  *  @endlink have been added to the HoppingAmplitudeSet, the construct method
  *  has to be called in order to construct an appropriate Hilbert space. The
  *  HoppingAmplitudeSet is most importantly used by the Model to store the
- *  Hamiltonian. */
+ *  Hamiltonian.
+ *
+ *  When the HoppingAmplitudeSet is constructed, a BasisIndexCache is also
+ *  generated. This makes getBasisIndex() and getPhysicalIndex() constant
+ *  time operations, independent of the number of subindices. The cache can
+ *  be turned off using setUseBasisIndexCache() to save memory.
+ *
+ *  For very large models, compact storage can be turned on using
+ *  setUseCompactStorage(). Once constructed, the HoppingAmplitudeSet then
+ *  only stores the basis indices of the to- and from-Indices together with
+ *  the amplitude of each HoppingAmplitude in contiguous arrays. The physical
+ *  @link Index Indices@endlink are shared through the tree structure, and
+ *  callback dependent @link HoppingAmplitude HoppingAmplitudes@endlink are
+ *  kept in a separate table. The iterators reconstruct the @link
+ *  HoppingAmplitude HoppingAmplitudes@endlink on the fly and therefore
+ *  cannot be modified. Only ConstIterators are available in this mode.
+ *
+ *  @link HoppingAmplitude HoppingAmplitudes@endlink can be added from
+ *  several OpenMP threads at the same time using addConcurrently(). Each
+ *  thread then stages its @link HoppingAmplitude HoppingAmplitudes@endlink
+ *  in a separate buffer, and the buffers are sorted, merged, and inserted
+ *  into the tree structure when construct() is called. Only a single level
+ *  of OpenMP parallelism is supported. */
 class HoppingAmplitudeSet :
 	virtual public Serializable,
 	private HoppingAmplitudeTree
 {
 public:
-	using HoppingAmplitudeTree::add;
-	using HoppingAmplitudeTree::getHoppingAmplitudes;
-	using HoppingAmplitudeTree::getBasisIndex;
-	using HoppingAmplitudeTree::getPhysicalIndex;
 	using HoppingAmplitudeTree::getBasisSize;
 	using HoppingAmplitudeTree::isProperSubspace;
 	using HoppingAmplitudeTree::getSubspaceIndices;
 	using HoppingAmplitudeTree::getSubspaceIndex;
-	using HoppingAmplitudeTree::getIndexList;
 
 	/** Constructs a HoppingAmplitudeSet. */
 	HoppingAmplitudeSet();
@@ -87,6 +107,44 @@ public:
 	/** Destructor. */
 	virtual ~HoppingAmplitudeSet();
 
+	/** Add a HoppingAmplitude. Invalidates the BasisIndexCache.
+	 *
+	 *  @param ha HoppingAmplitude to add. */
+	void add(HoppingAmplitude ha);
+
+	/** Add a HoppingAmplitude from within an OpenMP parallel region. The
+	 *  HoppingAmplitude is staged in a buffer that belongs to the calling
+	 *  thread and is added to the HoppingAmplitudeSet when
+	 *  HoppingAmplitudeSet::construct() is called. No locking is required,
+	 *  but HoppingAmplitudeSet::add() must not be called at the same time.
+	 *  The HoppingAmplitudeSet must have been created after the number of
+	 *  OpenMP threads has been set. The buffer is selected using the
+	 *  OpenMP thread number. Calls from nested parallel regions are
+	 *  therefore rejected, and the function must not be called from
+	 *  threads that are not created by OpenMP, such as std::thread.
+	 *
+	 *  @param hoppingAmplitude HoppingAmplitude to add. */
+	void addConcurrently(const HoppingAmplitude &hoppingAmplitude);
+
+	/** Get Hilbert space basis index for given physical index.
+	 *
+	 *  @param index Physical Index for which to obtain the Hilbert space
+	 *  index.
+	 *
+	 *  @return The Hilbert space index corresponding to the given Physical
+	 *  Index. Returns -1 if HoppingAmplitudeSet::construct() has not been
+	 *  called. */
+	int getBasisIndex(const Index &index) const;
+
+	/** Get physical Index for given Hilbert space basis index.
+	 *
+	 *  @param basisIndex Hilbert space index for which to obtain the
+	 *  physical Index.
+	 *
+	 *  @return The physical Index corresponding to the given Hilbert space
+	 *  index. */
+	Index getPhysicalIndex(int basisIndex) const;
+
 	/** Construct Hilbert space. No more @link HoppingAmplitude
 	 *  HoppingAmplitudes @endlink should be added after this call. */
 	void construct();
@@ -96,6 +154,65 @@ public:
 	 *  @return True if the Hilbert space basis has been constructed. */
 	bool getIsConstructed() const;
 
+	/** Set whether a BasisIndexCache should be used to speed up
+	 *  getBasisIndex() and getPhysicalIndex(). The cache is used by
+	 *  default. If the HoppingAmplitudeSet already is constructed, the
+	 *  cache is generated or released immediately.
+	 *
+	 *  @param useBasisIndexCache Flag indicating whether to use the
+	 *  BasisIndexCache. */
+	void setUseBasisIndexCache(bool useBasisIndexCache);
+
+	/** Get whether a BasisIndexCache is used.
+	 *
+	 *  @return True if a BasisIndexCache is used. */
+	bool getUseBasisIndexCache() const;
+
+	/** Get the BasisIndexCache. Can for example be used to check its
+	 *  memory footprint.
+	 *
+	 *  @return The BasisIndexCache. */
+	const BasisIndexCache& getBasisIndexCache() const;
+
+	/** Set whether to use compact storage. Compact storage is off by
+	 *  default. If the HoppingAmplitudeSet already is constructed, the
+	 *  @link HoppingAmplitude HoppingAmplitudes @endlink are moved to or
+	 *  from the compact storage immediately. Otherwise this happens when
+	 *  HoppingAmplitudeSet::construct() is called. The to-Index of every
+	 *  HoppingAmplitude must be part of the basis for the compact storage
+	 *  to be used.
+	 *
+	 *  @param useCompactStorage Flag indicating whether to use compact
+	 *  storage. */
+	void setUseCompactStorage(bool useCompactStorage);
+
+	/** Get whether compact storage is used.
+	 *
+	 *  @return True if compact storage is used. */
+	bool getUseCompactStorage() const;
+
+	/** Get all @link HoppingAmplitude HoppingAmplitudes @endlink with
+	 *  given 'from'-index. Not available when compact storage is used.
+	 *
+	 *  @param index From-Index.
+	 *
+	 *  @return All @link HoppingAmplitude HoppingAmplitudes @endlink with
+	 *  the given from-Index. */
+	const std::vector<HoppingAmplitude>& getHoppingAmplitudes(
+		Index index
+	) const;
+
+	/** Generate a list containing the indices in the HoppingAmplitudeSet
+	 *  that satisfies the specified patterns. The indices are ordered in
+	 *  terms of rising Hilbert space indices.
+	 *
+	 *  @param patterns Patterns to match against. IDX_ALL can be used as a
+	 *  wildcard.
+	 *
+	 *  @return A list of physical indices that match the specified
+	 *  patterns. */
+	std::vector<Index> getIndexList(const std::vector<Index> &patterns) const;
+
 	/** Get first index in block.
 	 *
 	 *  @param subspaceIndex The physical Index of the subspace.
@@ -131,12 +248,52 @@ public:
 	IndexTree getIndexTree(const Index &subspace) const;
 
 	/** Get a sprase matrix corresponding to the HoppingAMplitudeSet. The
-	 *  basis of the matrix is the Hilbert space basis.
+	 *  basis of the matrix is the Hilbert space basis. The matrix is on
+	 *  the CSC format and is built on every call without being cached,
+	 *  which avoids keeping a second copy of the Hamiltonian in the
+	 *  HoppingAmplitudeSet for callers that only need the matrix once.
 	 *
 	 *  @return A sparse matrix representation of the HoppingAmplitudeSet.
 	 */
 	SparseMatrix<std::complex<double>> getSparseMatrix() const;
 
+	/** Get a sparse matrix corresponding to the HoppingAmplitudeSet on a
+	 *  given storage format. The matrix is built directly from the basis
+	 *  indices the first time that it is requested and is then cached
+	 *  until @link HoppingAmplitude HoppingAmplitudes@endlink are added
+	 *  or the storage mode is changed. Creating a non-const Iterator only
+	 *  causes the matrix elements to be reevaluated on the next call,
+	 *  while the sparsity pattern is kept. Callback dependent matrix
+	 *  elements are reevaluated on every call, but the matrix is only
+	 *  written to if one of the callbacks returns a new value. The
+	 *  function can therefore be called from several threads at the same
+	 *  time as long as the callback values do not change while the
+	 *  returned matrix is in use. The returned reference is only valid
+	 *  until the HoppingAmplitudeSet is modified.
+	 *
+	 *  @param storageFormat The storage format of the matrix.
+	 *
+	 *  @return A sparse matrix representation of the HoppingAmplitudeSet.
+	 */
+	const SparseMatrix<std::complex<double>>& getSparseMatrix(
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+	) const;
+
+	/** Get the revision of the sparse matrix that is returned by
+	 *  getSparseMatrix(SparseMatrix<std::complex<double>>::StorageFormat).
+	 *  The revision changes every time that the matrix is regenerated or
+	 *  any of its matrix elements are updated, and can be used to detect
+	 *  changes to the Hamiltonian without inspecting the matrix. Only
+	 *  calls to getSparseMatrix() update the matrix, so this function
+	 *  should be called after getSparseMatrix().
+	 *
+	 *  @param storageFormat The storage format of the matrix.
+	 *
+	 *  @return The revision of the sparse matrix. */
+	unsigned long long getSparseMatrixRevision(
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+	) const;
+
 	class Iterator;
 	class ConstIterator;
 private:
@@ -191,9 +348,28 @@ private:
 		>::type HoppingAmplitudeTreePointerType;
 
 		/** HoppingAmplitudeTree iterator. Implements the actual
-		 *  iteration. */
+		 *  iteration when compact storage is not used. Points to the
+		 *  end of the tree when compact storage is used. */
 		HoppingAmplitudeTreeIteratorType iterator;
 
+		/** The HoppingAmplitudeSet that is iterated over. */
+		const HoppingAmplitudeSet *hoppingAmplitudeSet;
+
+		/** Current position in the compact storage. */
+		unsigned int position;
+
+		/** Position in the callback table of the first callback
+		 *  dependent HoppingAmplitude at or after the current
+		 *  position. */
+		unsigned int callbackPosition;
+
+		/** The position for which hoppingAmplitude has been
+		 *  reconstructed. -1 if none. */
+		int reconstructedPosition;
+
+		/** HoppingAmplitude reconstructed from the compact storage. */
+		HoppingAmplitude hoppingAmplitude;
+
 		/** Give access to the constructor to Iterator and
 		 *  ConstIterator. */
 		friend class Iterator;
@@ -202,6 +378,7 @@ private:
 		/** Private constructor. Limits the ability to construct the
 		 *  iterator to the HoppingAmplitudeSet. */
 		_Iterator(
+			const HoppingAmplitudeSet *hoppingAmplitudeSet,
 			HoppingAmplitudeTreePointerType hoppingAmplitudeTree,
 			bool end = false
 		);
@@ -212,9 +389,14 @@ public:
 	class Iterator : public _Iterator<false>{
 	private:
 		Iterator(
+			const HoppingAmplitudeSet *hoppingAmplitudeSet,
 			HoppingAmplitudeTree *hoppingAmplitudeTree,
 			bool end = false
-		) : _Iterator<false>(hoppingAmplitudeTree, end){};
+		) : _Iterator<false>(
+			hoppingAmplitudeSet,
+			hoppingAmplitudeTree,
+			end
+		){};
 
 		/** Make the HoppingAmplitudeSet able to construct an Iterator.
 		*/
@@ -226,16 +408,21 @@ public:
 	class ConstIterator : public _Iterator<true>{
 	private:
 		ConstIterator(
+			const HoppingAmplitudeSet *hoppingAmplitudeSet,
 			const HoppingAmplitudeTree *hoppingAmplitudeTree,
 			bool end = false
-		) : _Iterator<true>(hoppingAmplitudeTree, end){};
+		) : _Iterator<true>(
+			hoppingAmplitudeSet,
+			hoppingAmplitudeTree,
+			end
+		){};
 
 		/** Make the HoppingAmplitudeSet able to construct an Iterator.
 		*/
 		friend class HoppingAmplitudeSet;
 	};
 
-	/** Create Iterator.
+	/** Create Iterator. Not available when compact storage is used.
 	 *
 	 *  @return Iterator pointing to the first element in the
 	 *  HoppingAmplitudeSet. */
@@ -253,7 +440,8 @@ public:
 	 *  HoppingAmplitudeSet. */
 	ConstIterator cbegin() const;
 
-	/** Create Iterator for a particular subspace.
+	/** Create Iterator for a particular subspace. Not available when
+	 *  compact storage is used.
 	 *
 	 *  @param Index for the subspace the Iterator is to be iterating over.
 	 *
@@ -364,6 +552,165 @@ private:
 	/** Flag indicating whether the HoppingAmplitudeSet have been
 	 *  constructed. */
 	bool isConstructed;
+
+	/** Flag indicating whether to use the BasisIndexCache. */
+	bool useBasisIndexCache;
+
+	/** Cache for fast lookup of basis indices and physical indices. */
+	BasisIndexCache basisIndexCache;
+
+	/** Flag indicating whether to use compact storage. */
+	bool useCompactStorage;
+
+	/** Flag indicating whether the HoppingAmplitudes currently are stored
+	 *  in the compact storage. */
+	bool isCompact;
+
+	/** Basis indices of the to-Indices in the compact storage. The
+	 *  HoppingAmplitudes are stored in the order of the basis indices of
+	 *  their from-Indices. */
+	std::vector<int> compactToIndices;
+
+	/** Basis indices of the from-Indices in the compact storage. */
+	std::vector<int> compactFromIndices;
+
+	/** Amplitudes in the compact storage. Not used for callback dependent
+	 *  HoppingAmplitudes. */
+	std::vector<std::complex<double>> compactAmplitudes;
+
+	/** Positions in the compact storage of the callback dependent
+	 *  HoppingAmplitudes. */
+	std::vector<unsigned int> callbackPositions;
+
+	/** Callback dependent HoppingAmplitudes. Element n is stored at
+	 *  position callbackPositions[n] in the compact storage. */
+	std::vector<HoppingAmplitude> callbackHoppingAmplitudes;
+
+	/** Generate the BasisIndexCache. */
+	void generateBasisIndexCache();
+
+	/** Move the HoppingAmplitudes from the tree to the compact storage. */
+	void generateCompactStorage();
+
+	/** Move the HoppingAmplitudes from the compact storage back to the
+	 *  tree. */
+	void releaseCompactStorage();
+
+	/** Reconstruct a HoppingAmplitude from the compact storage.
+	 *
+	 *  @param position The position in the compact storage.
+	 *  @param callbackPosition The position in the callback table of the
+	 *  first callback dependent HoppingAmplitude at or after position.
+	 *
+	 *  @return The HoppingAmplitude. */
+	HoppingAmplitude getCompactHoppingAmplitude(
+		unsigned int position,
+		unsigned int callbackPosition
+	) const;
+
+	/** Buffer for the HoppingAmplitudes that are added concurrently by a
+	 *  single thread. Padded to avoid that the buffers of different
+	 *  threads share cache lines. */
+	class StagingBuffer{
+	public:
+		/** The staged HoppingAmplitudes. */
+		std::vector<HoppingAmplitude> hoppingAmplitudes;
+
+		/** Padding. */
+		char padding[64];
+	};
+
+	/** Cached sparse matrix on one of the storage formats. Copying a
+	 *  SparseMatrixCache results in an empty cache since the cache points
+	 *  to the callback dependent HoppingAmplitudes of the
+	 *  HoppingAmplitudeSet that generated it. */
+	class SparseMatrixCache{
+	public:
+		/** Constructor. */
+		SparseMatrixCache();
+
+		/** Copy constructor. Creates an empty cache. */
+		SparseMatrixCache(const SparseMatrixCache &);
+
+		/** Assignment operator. Clears the cache. */
+		SparseMatrixCache& operator=(const SparseMatrixCache &rhs);
+
+		/** Clear the cache. */
+		void clear();
+
+		/** Flag indicating whether the cache has been generated. */
+		bool isGenerated;
+
+		/** Flag indicating that the HoppingAmplitudes may have been
+		 *  modified through a non-const Iterator since the matrix
+		 *  elements were calculated. */
+		bool hasStaleValues;
+
+		/** Lock that serializes generation and updates of the cache.
+		 */
+		std::mutex mutex;
+
+		/** Incremented every time the sparse matrix changes. Not reset
+		 *  when the cache is cleared. */
+		unsigned long long revision;
+
+		/** The cached sparse matrix. */
+		SparseMatrix<std::complex<double>> sparseMatrix;
+
+		/** The callback dependent HoppingAmplitudes. */
+		std::vector<const HoppingAmplitude*> callbackHoppingAmplitudes;
+
+		/** Positions in the value array of the sparse matrix that the
+		 *  callback dependent HoppingAmplitudes contribute to. */
+		std::vector<unsigned int> callbackValuePositions;
+
+		/** The value at each of the callback value positions when the
+		 *  callback dependent HoppingAmplitudes are excluded. */
+		std::vector<std::complex<double>> staticValues;
+
+		/** The amplitudes of the callback dependent HoppingAmplitudes
+		 *  that the matrix elements were last evaluated with. Empty if
+		 *  the callback dependent matrix elements have to be written.
+		 */
+		std::vector<std::complex<double>> callbackAmplitudes;
+
+		/** Positions in the value array of the sparse matrix that each
+		 *  HoppingAmplitude contributes to, in iteration order. Only
+		 *  used when compact storage is not used. */
+		std::vector<unsigned int> valuePositions;
+	};
+
+	/** Sparse matrix caches for the CSR and CSC formats. */
+	mutable SparseMatrixCache sparseMatrixCaches[2];
+
+	/** Generate the sparse matrix cache for the given storage format. */
+	void generateSparseMatrixCache(
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+	) const;
+
+	/** Reevaluate all matrix elements of the sparse matrix cache for the
+	 *  given storage format, keeping the sparsity pattern. Regenerates the
+	 *  cache if the callback dependence of the HoppingAmplitudes has
+	 *  changed. */
+	void updateSparseMatrixCacheValues(
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+	) const;
+
+	/** Clear the sparse matrix caches. */
+	void clearSparseMatrixCaches();
+
+	/** Mark the matrix elements of the sparse matrix caches as stale. */
+	void invalidateSparseMatrixCacheValues();
+
+	/** One StagingBuffer per thread. */
+	std::vector<StagingBuffer> stagingBuffers;
+
+	/** Create one StagingBuffer per thread. */
+	void createStagingBuffers();
+
+	/** Sort and merge the staged HoppingAmplitudes and add them to the
+	 *  tree structure. */
+	void mergeStagedHoppingAmplitudes();
 };
 
 inline void HoppingAmplitudeSet::construct(){
@@ -374,14 +721,113 @@ inline void HoppingAmplitudeSet::construct(){
 		""
 	);
 
+	mergeStagedHoppingAmplitudes();
+	clearSparseMatrixCaches();
 	HoppingAmplitudeTree::generateBasisIndices();
 	isConstructed = true;
+
+	if(useBasisIndexCache)
+		generateBasisIndexCache();
+	if(useCompactStorage)
+		generateCompactStorage();
+}
+
+inline void HoppingAmplitudeSet::clearSparseMatrixCaches(){
+	sparseMatrixCaches[0].clear();
+	sparseMatrixCaches[1].clear();
+}
+
+inline void HoppingAmplitudeSet::invalidateSparseMatrixCacheValues(){
+	for(unsigned int n = 0; n < 2; n++)
+		if(sparseMatrixCaches[n].isGenerated)
+			sparseMatrixCaches[n].hasStaleValues = true;
 }
 
 inline bool HoppingAmplitudeSet::getIsConstructed() const{
 	return isConstructed;
 }
 
+inline void HoppingAmplitudeSet::add(HoppingAmplitude ha){
+	basisIndexCache.clear();
+	clearSparseMatrixCaches();
+	HoppingAmplitudeTree::add(ha);
+}
+
+inline int HoppingAmplitudeSet::getBasisIndex(const Index &index) const{
+	int basisIndex = basisIndexCache.getBasisIndex(index);
+	if(basisIndex != -1)
+		return basisIndex;
+
+	//Fall back on the tree for Indices that are not in the cache. This
+	//also takes care of the error reporting for invalid Indices.
+	return HoppingAmplitudeTree::getBasisIndex(index);
+}
+
+inline Index HoppingAmplitudeSet::getPhysicalIndex(int basisIndex) const{
+	if(
+		basisIndexCache.getIsGenerated()
+		&& basisIndex >= 0
+		&& (unsigned int)basisIndex < basisIndexCache.getSize()
+	){
+		return basisIndexCache.getPhysicalIndex(basisIndex);
+	}
+
+	return HoppingAmplitudeTree::getPhysicalIndex(basisIndex);
+}
+
+inline void HoppingAmplitudeSet::setUseBasisIndexCache(
+	bool useBasisIndexCache
+){
+	this->useBasisIndexCache = useBasisIndexCache;
+	if(!useBasisIndexCache)
+		basisIndexCache.clear();
+	else if(isConstructed && !basisIndexCache.getIsGenerated())
+		generateBasisIndexCache();
+}
+
+inline bool HoppingAmplitudeSet::getUseBasisIndexCache() const{
+	return useBasisIndexCache;
+}
+
+inline const BasisIndexCache& HoppingAmplitudeSet::getBasisIndexCache(
+) const{
+	return basisIndexCache;
+}
+
+inline void HoppingAmplitudeSet::setUseCompactStorage(
+	bool useCompactStorage
+){
+	this->useCompactStorage = useCompactStorage;
+	if(isConstructed){
+		if(useCompactStorage && !isCompact){
+			clearSparseMatrixCaches();
+			generateCompactStorage();
+		}
+		else if(!useCompactStorage && isCompact){
+			clearSparseMatrixCaches();
+			releaseCompactStorage();
+		}
+	}
+}
+
+inline bool HoppingAmplitudeSet::getUseCompactStorage() const{
+	return useCompactStorage;
+}
+
+inline const std::vector<HoppingAmplitude>&
+HoppingAmplitudeSet::getHoppingAmplitudes(Index index) const{
+	TBTKAssert(
+		!isCompact,
+		"HoppingAmplitudeSet::getHoppingAmplitudes()",
+		"The HoppingAmplitudes are not available as a vector when"
+		<< " compact storage is used.",
+		"Iterate over the HoppingAmplitudes using begin() and end(),"
+		<< " or call setUseCompactStorage(false) first."
+	);
+
+	return HoppingAmplitudeTree::getHoppingAmplitudes(index);
+}
+
 inline int HoppingAmplitudeSet::getFirstIndexInBlock(
 	const Index &blockIndex
 ) const{
@@ -394,119 +840,177 @@ inline int HoppingAmplitudeSet::getLastIndexInBlock(
 	return HoppingAmplitudeTree::getLastIndexInSubspace(blockIndex);
 }
 
-inline SparseMatrix<std::complex<double>> HoppingAmplitudeSet::getSparseMatrix(
-) const{
+inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::begin(){
 	TBTKAssert(
-		isConstructed,
-		"HoppingAmplitudeSet::getSparseMatrix()",
-		"HoppingAmplitudeSet has to be constructed first.",
-		""
+		!isCompact,
+		"HoppingAmplitudeSet::begin()",
+		"Unable to create a non-const Iterator when compact storage is"
+		<< " used.",
+		"The HoppingAmplitudes are reconstructed on the fly and cannot"
+		<< " be modified. Use cbegin() to iterate over them."
 	);
 
-	SparseMatrix<std::complex<double>> sparseMatrix(
-		SparseMatrix<std::complex<double>>::StorageFormat::CSC
-	);
-
-	for(
-		ConstIterator iterator = begin();
-		iterator != end();
-		++iterator
-	){
-		sparseMatrix.add(
-			getBasisIndex((*iterator).getToIndex()),
-			getBasisIndex((*iterator).getFromIndex()),
-			(*iterator).getAmplitude()
-		);
-	}
-	sparseMatrix.construct();
-
-	return sparseMatrix;
-}
+	//The amplitudes may be modified through the Iterator.
+	invalidateSparseMatrixCacheValues();
 
-inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::begin(){
-	return Iterator(this);
+	return Iterator(this, this);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::begin() const{
-	return ConstIterator(this);
+	return ConstIterator(this, this);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::cbegin() const{
-	return ConstIterator(this);
+	return ConstIterator(this, this);
 }
 
 inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::begin(
 	const Index &subspace
 ){
-	return Iterator(getSubTree(subspace));
+	TBTKAssert(
+		!isCompact,
+		"HoppingAmplitudeSet::begin()",
+		"Unable to create a non-const Iterator when compact storage is"
+		<< " used.",
+		"The HoppingAmplitudes are reconstructed on the fly and cannot"
+		<< " be modified. Use cbegin() to iterate over them."
+	);
+
+	//The amplitudes may be modified through the Iterator.
+	invalidateSparseMatrixCacheValues();
+
+	return Iterator(this, getSubTree(subspace));
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::begin(
 	const Index &subspace
 ) const{
-	return ConstIterator(getSubTree(subspace));
+	return ConstIterator(this, getSubTree(subspace));
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::cbegin(
 	const Index &subspace
 ) const{
-	return ConstIterator(getSubTree(subspace));
+	return ConstIterator(this, getSubTree(subspace));
 }
 
 inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::end(){
-	return Iterator(this, true);
+	return Iterator(this, this, true);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::end() const{
-	return ConstIterator(this, true);
+	return ConstIterator(this, this, true);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::cend() const{
-	return ConstIterator(this, true);
+	return ConstIterator(this, this, true);
 }
 
 inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::end(
 	const Index &subspace
 ){
-	return Iterator(getSubTree(subspace), true);
+	return Iterator(this, getSubTree(subspace), true);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::end(
 	const Index &subspace
 ) const{
-	return ConstIterator(getSubTree(subspace), true);
+	return ConstIterator(this, getSubTree(subspace), true);
 }
 
 inline HoppingAmplitudeSet::ConstIterator HoppingAmplitudeSet::cend(
 	const Index &subspace
 ) const{
-	return ConstIterator(getSubTree(subspace), true);
+	return ConstIterator(this, getSubTree(subspace), true);
 }
 
 template<bool isConstIterator>
 inline bool HoppingAmplitudeSet::_Iterator<isConstIterator>::operator==(
 	const _Iterator &rhs
 ) const{
-	return iterator == rhs.iterator;
+	return iterator == rhs.iterator && position == rhs.position;
 }
 
 template<bool isConstIterator>
 inline bool HoppingAmplitudeSet::_Iterator<isConstIterator>::operator!=(
 	const _Iterator &rhs
 ) const{
-	return iterator != rhs.iterator;
+	return !operator==(rhs);
 }
 
 inline unsigned int HoppingAmplitudeSet::getSizeInBytes() const{
-	unsigned int size = sizeof(*this) - sizeof(HoppingAmplitudeTree);
+	unsigned int size = sizeof(*this) - sizeof(HoppingAmplitudeTree)
+		- sizeof(BasisIndexCache);
 	size += HoppingAmplitudeTree::getSizeInBytes();
+	size += basisIndexCache.getSizeInBytes();
+	size += compactToIndices.capacity()*sizeof(int);
+	size += compactFromIndices.capacity()*sizeof(int);
+	size += compactAmplitudes.capacity()*sizeof(std::complex<double>);
+	size += callbackPositions.capacity()*sizeof(unsigned int);
+	for(unsigned int n = 0; n < callbackHoppingAmplitudes.size(); n++)
+		size += callbackHoppingAmplitudes[n].getSizeInBytes();
+	size += (
+		callbackHoppingAmplitudes.capacity()
+		- callbackHoppingAmplitudes.size()
+	)*sizeof(HoppingAmplitude);
+	for(unsigned int n = 0; n < stagingBuffers.size(); n++){
+		const std::vector<HoppingAmplitude> &hoppingAmplitudes
+			= stagingBuffers[n].hoppingAmplitudes;
+		for(unsigned int c = 0; c < hoppingAmplitudes.size(); c++)
+			size += hoppingAmplitudes[c].getSizeInBytes();
+		size += (
+			hoppingAmplitudes.capacity() - hoppingAmplitudes.size()
+		)*sizeof(HoppingAmplitude);
+	}
+	size += stagingBuffers.capacity()*sizeof(StagingBuffer);
+	for(unsigned int n = 0; n < 2; n++){
+		const SparseMatrixCache &cache = sparseMatrixCaches[n];
+		if(!cache.isGenerated)
+			continue;
+
+		unsigned int numMatrixElements;
+		if(n == 0)
+			numMatrixElements = cache.sparseMatrix.getCSRNumMatrixElements();
+		else
+			numMatrixElements = cache.sparseMatrix.getCSCNumMatrixElements();
+		size += numMatrixElements*(
+			sizeof(unsigned int) + sizeof(std::complex<double>)
+		);
+		size += (getBasisSize() + 1)*sizeof(unsigned int);
+		size += cache.callbackHoppingAmplitudes.capacity()*sizeof(
+			const HoppingAmplitude*
+		);
+		size += cache.callbackValuePositions.capacity()*sizeof(
+			unsigned int
+		);
+		size += cache.staticValues.capacity()*sizeof(
+			std::complex<double>
+		);
+		size += cache.callbackAmplitudes.capacity()*sizeof(
+			std::complex<double>
+		);
+		size += cache.valuePositions.capacity()*sizeof(unsigned int);
+	}
 
 	return size;
 }
 
 template<bool isConstIterator>
 inline void HoppingAmplitudeSet::_Iterator<isConstIterator>::operator++(){
-	++iterator;
+	if(hoppingAmplitudeSet->isCompact){
+		position++;
+		const std::vector<unsigned int> &callbackPositions
+			= hoppingAmplitudeSet->callbackPositions;
+		while(
+			callbackPosition < callbackPositions.size()
+			&& callbackPositions[callbackPosition] < position
+		){
+			callbackPosition++;
+		}
+	}
+	else{
+		++iterator;
+	}
 }
 
 template<bool isConstIterator>
@@ -515,7 +1019,19 @@ inline typename HoppingAmplitudeSet::_Iterator<
 >::HoppingAmplitudeReferenceType HoppingAmplitudeSet::_Iterator<
 	isConstIterator
 >::operator*(){
-	return *iterator;
+	if(!hoppingAmplitudeSet->isCompact)
+		return *iterator;
+
+	if(reconstructedPosition != (int)position){
+		hoppingAmplitude
+			= hoppingAmplitudeSet->getCompactHoppingAmplitude(
+				position,
+				callbackPosition
+			);
+		reconstructedPosition = position;
+	}
+
+	return hoppingAmplitude;
 }
 
 template<bool isConstIterator>
@@ -535,17 +1051,57 @@ inline int HoppingAmplitudeSet::_Iterator<isConstIterator>::getNumBasisIndices()
 
 template<bool isConstIterator>
 inline HoppingAmplitudeSet::_Iterator<isConstIterator>::_Iterator(
+	const HoppingAmplitudeSet *hoppingAmplitudeSet,
 	HoppingAmplitudeTreePointerType hoppingAmplitudeTree,
 	bool end
 ) :
 	iterator(
 		(
-			end ?
+			end || hoppingAmplitudeSet->isCompact ?
 			hoppingAmplitudeTree->end()
 			: hoppingAmplitudeTree->begin()
 		)
-	)
+	),
+	hoppingAmplitudeSet(hoppingAmplitudeSet),
+	position(0),
+	callbackPosition(0),
+	reconstructedPosition(-1)
 {
+	if(!hoppingAmplitudeSet->isCompact)
+		return;
+
+	//The compact storage is ordered by the basis indices of the
+	//from-Indices. The HoppingAmplitudes of the tree therefore occupy the
+	//contiguous range of positions with from-Indices in the basis index
+	//range of the tree.
+	int minBasisIndex = hoppingAmplitudeTree->getMinIndex();
+	if(minBasisIndex == -1)
+		return;
+
+	const std::vector<int> &fromIndices
+		= hoppingAmplitudeSet->compactFromIndices;
+	if(end){
+		position = std::upper_bound(
+			fromIndices.begin(),
+			fromIndices.end(),
+			hoppingAmplitudeTree->getMaxIndex()
+		) - fromIndices.begin();
+	}
+	else{
+		position = std::lower_bound(
+			fromIndices.begin(),
+			fromIndices.end(),
+			minBasisIndex
+		) - fromIndices.begin();
+	}
+
+	const std::vector<unsigned int> &callbackPositions
+		= hoppingAmplitudeSet->callbackPositions;
+	callbackPosition = std::lower_bound(
+		callbackPositions.begin(),
+		callbackPositions.end(),
+		position
+	) - callbackPositions.begin();
 }
 
 };	//End of namespace TBTK
@@ -71,6 +71,16 @@ public:
 	 *  @param ha HoppingAmplitude to add. */
 	void add(HoppingAmplitude ha);
 
+	/** Add @link HoppingAmplitude HoppingAmplitudes @endlink that are
+	 *  sorted lexicographically with respect to their from-Indices, with
+	 *  an Index sorted before any longer Index that it is a prefix of.
+	 *  Independent subtrees are filled in parallel.
+	 *
+	 *  @param sortedHoppingAmplitudes The HoppingAmplitudes to add. */
+	void addSorted(
+		const std::vector<HoppingAmplitude> &sortedHoppingAmplitudes
+	);
+
 	/** Get basis size.
 	 *
 	 *  @return The basis size if the basis has been generated using the
@@ -412,6 +422,17 @@ private:
 	 *  HoppingAmplitudeTree::add and is called recursively. */
 	void _add(HoppingAmplitude &ha, unsigned int subindex);
 
+	/** Add the sorted HoppingAmplitudes in the range [first, last). All
+	 *  HoppingAmplitudes in the range have from-Indices that agree on the
+	 *  subindices before position 'subindex'. Is called by the public
+	 *  HoppingAmplitudeTree::addSorted and is called recursively. */
+	void _addSorted(
+		const std::vector<HoppingAmplitude> &sortedHoppingAmplitudes,
+		unsigned int first,
+		unsigned int last,
+		unsigned int subindex
+	);
+
 	/** Get sub tree. Is called by HoppingAmplitudeTree::getSubTree and is
 	 *  called recursively. */
 	const HoppingAmplitudeTree* getSubTree(
@@ -483,6 +504,16 @@ private:
 	/** Returns (depth) first HoppingAmplitude as an example, in case of
 	 *  error while adding HoppingAmplitudes to the tree. */
 	HoppingAmplitude getFirstHA() const;
+
+	/** Remove all @link HoppingAmplitude HoppingAmplitudes @endlink and
+	 *  release their memory, while keeping the tree structure and the
+	 *  basis indices. Is called recursively. */
+	void clearHoppingAmplitudes();
+
+	/** Give the HoppingAmplitudeSet access to the basis index range of
+	 *  subtrees and to HoppingAmplitudeTree::clearHoppingAmplitudes() when
+	 *  it switches to compact storage. */
+	friend class HoppingAmplitudeSet;
 };
 
 inline int HoppingAmplitudeTree::getBasisSize() const{
@@ -731,7 +762,7 @@ typename HoppingAmplitudeTree::_Iterator<
 			""
 		);
 	}
-	const HoppingAmplitudeTree *tn = this->tree;
+	HoppingAmplitudeTreePointerType tn = this->tree;
 	for(unsigned int n = 0; n < currentIndex.size()-1; n++){
 		tn = &tn->children.at(currentIndex.at(n));
 	}
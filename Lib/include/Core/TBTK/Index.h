@@ -27,6 +27,9 @@
 #include "TBTK/Serializable.h"
 #include "TBTK/Streams.h"
 
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
 #include <vector>
 
 namespace TBTK{
@@ -37,6 +40,11 @@ namespace TBTK{
  *  {x, y, spin}, {x, y, z, orbital, spin}, and
  *  {subsystem, x, y, z, orbital, spin}.
  *
+ *  Indices with up to eight @link Subindex Subindices@endlink are stored
+ *  inside the Index itself, so that creating, copying, and concatenating
+ *  such indices does not allocate memory on the heap. Larger indices fall
+ *  back on heap storage.
+ *
  *  # Example
  *  \snippet Core/Index.cpp Index
  *  ## Output
@@ -78,6 +86,25 @@ public:
 	 *  @param index Index to copy. */
 	Index(const Index &index) : indices(index.indices){};
 
+	/** Move constructor.
+	 *
+	 *  @param index Index to move. */
+	Index(Index &&index) noexcept : indices(std::move(index.indices)){};
+
+	/** Assignment operator.
+	 *
+	 *  @param rhs Index to assign to the left hand side.
+	 *
+	 *  @return Reference to the assigned Index. */
+	Index& operator=(const Index &rhs);
+
+	/** Move assignment operator.
+	 *
+	 *  @param rhs Index to assign to the left hand side.
+	 *
+	 *  @return Reference to the assigned Index. */
+	Index& operator=(Index &&rhs) noexcept;
+
 	//TBTKFeature Core.Index.Construction.4 2019-09-19
 	//TBTKFeature Core.Index.Construction.5.C++ 2019-09-19
 	/** Constructs a new Index by concatenating two indices into one total
@@ -241,6 +268,22 @@ public:
 	 *  Indices @endlink.*/
 	std::vector<Index> split() const;
 
+	/** Get the number of components of a compound Index. Does not
+	 *  allocate any memory.
+	 *
+	 *  @return The number of component Indices separated by
+	 *  IDX_SEPARATOR. An Index without separators has one component. */
+	unsigned int getNumComponents() const;
+
+	/** Get a single component of a compound Index. Avoids the
+	 *  std::vector<Index> created by split() and does not allocate memory
+	 *  on the heap for components with up to eight subindices.
+	 *
+	 *  @param n The component to get.
+	 *
+	 *  @return The nth component Index. */
+	Index getComponent(unsigned int n) const;
+
 	//TBTKFeature Core.Index.isPatternIndex.1 2019-09-19
 	//TBTKFeature Core.Index.isPatternIndex.2 2019-09-19
 	//TBTKFeature Core.Index.isPatternIndex.3 2019-09-19
@@ -297,6 +340,16 @@ public:
 	 *  i2. */
 	friend bool operator>(const Index &i1, const Index &i2);
 
+	/** Comparison operator. Equivalent to i1.equals(i2).
+	 *
+	 *  @return True if i1 and i2 have the same subindices. */
+	friend bool operator==(const Index &i1, const Index &i2);
+
+	/** Comparison operator. Equivalent to !i1.equals(i2).
+	 *
+	 *  @return True if i1 and i2 have different subindices. */
+	friend bool operator!=(const Index &i1, const Index &i2);
+
 	//TBTKFeature Core.Index.operator[].1.C++ 2019-09-19
 	//TBTKFeature Core.Index.operator[].2.C++ 2019-09-19
 	/** Subscript operator.
@@ -324,13 +377,144 @@ public:
 	 *  @return Serialized string represenation of the Index. */
 	std::string serialize(Serializable::Mode mode) const;
 
+	/** Get a hash of the Index. The hash is computed from the subindices
+	 *  on each call, which only involves the inline storage for indices
+	 *  with up to eight subindices. Equal indices have equal hashes.
+	 *
+	 *  @return A hash of the Index. */
+	std::size_t getHash() const;
+
+	/** Calculate the hash of the subindices in the range
+	 *  [offset, offset + numSubindices) of a container. FNV-1a is used
+	 *  over the subindices, followed by a final avalanche step that
+	 *  spreads the entropy to the low bits. This is the hash returned by
+	 *  getHash() and can be used to hash subindices that are not stored
+	 *  in an Index.
+	 *
+	 *  @param subindices Container with the subindices.
+	 *  @param offset The position of the first subindex.
+	 *  @param numSubindices The number of subindices.
+	 *
+	 *  @return A hash of the subindices. */
+	template<typename Container>
+	static std::uint64_t hashSubindices(
+		const Container &subindices,
+		unsigned int offset,
+		unsigned int numSubindices
+	);
+
 	/** Get size in bytes.
 	 *
 	 *  @return Memory size required to store the Index. */
 	unsigned int getSizeInBytes() const;
 private:
+	/** Container for the subindices with a vector like interface. Stores
+	 *  up to INLINE_CAPACITY subindices inside the container itself and
+	 *  only allocates memory on the heap for larger indices. */
+	class SubindexContainer{
+	public:
+		/** Constructor. */
+		SubindexContainer();
+
+		/** Constructor. */
+		SubindexContainer(std::initializer_list<Subindex> subindices);
+
+		/** Constructor. */
+		SubindexContainer(const std::vector<Subindex> &subindices);
+
+		/** Copy constructor. */
+		SubindexContainer(const SubindexContainer &subindexContainer);
+
+		/** Move constructor. */
+		SubindexContainer(
+			SubindexContainer &&subindexContainer
+		) noexcept;
+
+		/** Destructor. */
+		~SubindexContainer();
+
+		/** Assignment operator. */
+		SubindexContainer& operator=(const SubindexContainer &rhs);
+
+		/** Move assignment operator. */
+		SubindexContainer& operator=(SubindexContainer &&rhs) noexcept;
+
+		/** Subscript operator. */
+		Subindex& operator[](unsigned int n);
+
+		/** Subscript operator. */
+		const Subindex& operator[](unsigned int n) const;
+
+		/** Get subindex n. Throws std::out_of_range if n is out of
+		 *  range. */
+		Subindex& at(unsigned int n);
+
+		/** Get subindex n. Throws std::out_of_range if n is out of
+		 *  range. */
+		const Subindex& at(unsigned int n) const;
+
+		/** Get the number of subindices. */
+		unsigned int size() const;
+
+		/** Get the number of subindices that can be stored without
+		 *  reallocation. */
+		unsigned int capacity() const;
+
+		/** Check whether the subindices are stored inline. */
+		bool isInline() const;
+
+		/** Reserve space for a given number of subindices. */
+		void reserve(unsigned int capacity);
+
+		/** Append a subindex. */
+		void push_back(Subindex subindex);
+
+		/** Remove the last subindex. */
+		void pop_back();
+
+		/** Get the last subindex. */
+		Subindex& back();
+
+		/** Insert a subindex at position n. */
+		void insert(unsigned int n, Subindex subindex);
+
+		/** Remove the subindex at position n. */
+		void erase(unsigned int n);
+
+		/** Get pointer to the first subindex. */
+		const Subindex* begin() const;
+
+		/** Get pointer to one past the last subindex. */
+		const Subindex* end() const;
+	private:
+		/** Number of subindices that are stored inline. */
+		static constexpr unsigned int INLINE_CAPACITY = 8;
+
+		/** Pointer to the storage that is in use. Points to
+		 *  inlineStorage or to memory on the heap. */
+		Subindex *data;
+
+		/** Number of subindices. */
+		unsigned int numSubindices;
+
+		/** Number of subindices that fit in the storage in use. */
+		unsigned int storageCapacity;
+
+		/** Inline storage. */
+		Subindex inlineStorage[INLINE_CAPACITY];
+
+		/** Copy subindices into empty storage with enough capacity. */
+		void copy(const SubindexContainer &subindexContainer);
+
+		/** Take over the storage of another container. */
+		void move(SubindexContainer &subindexContainer);
+
+		/** Release heap storage and reset to empty inline storage. */
+		void release();
+	};
+
 	/** Subindex container. */
-	std::vector<Subindex> indices;
+	SubindexContainer indices;
 };
 
 inline std::string Index::toString() const{
@@ -458,6 +642,18 @@ inline bool Index::equals(const Index &index, bool allowWildcard) const{
 	return true;
 }
 
+inline Index& Index::operator=(const Index &rhs){
+	indices = rhs.indices;
+
+	return *this;
+}
+
+inline Index& Index::operator=(Index &&rhs) noexcept{
+	indices = std::move(rhs.indices);
+
+	return *this;
+}
+
 inline Subindex& Index::at(unsigned int n){
 	return indices.at(n);
 }
@@ -480,7 +676,7 @@ inline void Index::pushBack(Subindex subindex){
 
 inline Subindex Index::popFront(){
 	Subindex first = indices.at(0);
-	indices.erase(indices.begin());
+	indices.erase(0);
 
 	return first;
 }
@@ -493,12 +689,12 @@ inline Subindex Index::popBack(){
 }
 
 inline void Index::insert(unsigned int n, Subindex subindex){
-	indices.insert(indices.begin() + n, subindex);
+	indices.insert(n, subindex);
 }
 
 inline Subindex Index::erase(unsigned int n){
 	Subindex subindex = indices[n];
-	indices.erase(indices.begin() + n);
+	indices.erase(n);
 
 	return subindex;
 }
@@ -516,6 +712,39 @@ inline std::vector<Index> Index::split() const{
 	return components;
 }
 
+inline unsigned int Index::getNumComponents() const{
+	unsigned int numComponents = 1;
+	for(unsigned int n = 0; n < indices.size(); n++)
+		if(indices[n].isIndexSeparator())
+			numComponents++;
+
+	return numComponents;
+}
+
+inline Index Index::getComponent(unsigned int n) const{
+	Index component;
+	unsigned int currentComponent = 0;
+	for(unsigned int c = 0; c < indices.size(); c++){
+		if(indices[c].isIndexSeparator()){
+			currentComponent++;
+			if(currentComponent > n)
+				break;
+		}
+		else if(currentComponent == n){
+			component.pushBack(indices[c]);
+		}
+	}
+	TBTKAssert(
+		currentComponent >= n,
+		"Index::getComponent()",
+		"Component '" << n << "' is out of range for the Index "
+		<< toString() << ".",
+		""
+	);
+
+	return component;
+}
+
 inline bool Index::isPatternIndex() const{
 	for(unsigned int n = 0; n < indices.size(); n++)
 		if(indices.at(n) < 0)
@@ -532,10 +761,251 @@ inline const Subindex& Index::operator[](unsigned int subindex) const{
 	return indices[subindex];
 }
 
+inline bool operator==(const Index &i1, const Index &i2){
+	return i1.equals(i2);
+}
+
+inline bool operator!=(const Index &i1, const Index &i2){
+	return !i1.equals(i2);
+}
+
+inline std::size_t Index::getHash() const{
+	return hashSubindices(indices, 0, indices.size());
+}
+
+template<typename Container>
+inline std::uint64_t Index::hashSubindices(
+	const Container &subindices,
+	unsigned int offset,
+	unsigned int numSubindices
+){
+	//FNV-1a over the subindices followed by a final avalanche step to
+	//spread the entropy to the low bits that are used as bucket index.
+	std::uint64_t hash = 14695981039346656037ULL;
+	for(unsigned int n = 0; n < numSubindices; n++){
+		hash ^= (std::uint32_t)(int)subindices[offset + n];
+		hash *= 1099511628211ULL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
 inline unsigned int Index::getSizeInBytes() const{
-	return sizeof(*this) + sizeof(int)*indices.capacity();
+	if(indices.isInline())
+		return sizeof(*this);
+	else
+		return sizeof(*this) + sizeof(Subindex)*indices.capacity();
+}
+
+inline Index::SubindexContainer::SubindexContainer(){
+	data = inlineStorage;
+	numSubindices = 0;
+	storageCapacity = INLINE_CAPACITY;
+}
+
+inline Index::SubindexContainer::SubindexContainer(
+	std::initializer_list<Subindex> subindices
+) :
+	SubindexContainer()
+{
+	reserve(subindices.size());
+	for(const Subindex &subindex : subindices)
+		data[numSubindices++] = subindex;
+}
+
+inline Index::SubindexContainer::SubindexContainer(
+	const std::vector<Subindex> &subindices
+) :
+	SubindexContainer()
+{
+	reserve(subindices.size());
+	for(unsigned int n = 0; n < subindices.size(); n++)
+		data[numSubindices++] = subindices[n];
+}
+
+inline Index::SubindexContainer::SubindexContainer(
+	const SubindexContainer &subindexContainer
+) :
+	SubindexContainer()
+{
+	copy(subindexContainer);
+}
+
+inline Index::SubindexContainer::SubindexContainer(
+	SubindexContainer &&subindexContainer
+) noexcept :
+	SubindexContainer()
+{
+	move(subindexContainer);
+}
+
+inline Index::SubindexContainer::~SubindexContainer(){
+	if(data != inlineStorage)
+		delete [] data;
+}
+
+inline Index::SubindexContainer& Index::SubindexContainer::operator=(
+	const SubindexContainer &rhs
+){
+	if(this != &rhs){
+		numSubindices = 0;
+		copy(rhs);
+	}
+
+	return *this;
+}
+
+inline Index::SubindexContainer& Index::SubindexContainer::operator=(
+	SubindexContainer &&rhs
+) noexcept{
+	if(this != &rhs){
+		release();
+		move(rhs);
+	}
+
+	return *this;
+}
+
+inline Subindex& Index::SubindexContainer::operator[](unsigned int n){
+	return data[n];
+}
+
+inline const Subindex& Index::SubindexContainer::operator[](
+	unsigned int n
+) const{
+	return data[n];
+}
+
+inline Subindex& Index::SubindexContainer::at(unsigned int n){
+	if(n >= numSubindices)
+		throw std::out_of_range("Index::SubindexContainer::at()");
+
+	return data[n];
+}
+
+inline const Subindex& Index::SubindexContainer::at(unsigned int n) const{
+	if(n >= numSubindices)
+		throw std::out_of_range("Index::SubindexContainer::at()");
+
+	return data[n];
+}
+
+inline unsigned int Index::SubindexContainer::size() const{
+	return numSubindices;
+}
+
+inline unsigned int Index::SubindexContainer::capacity() const{
+	return storageCapacity;
+}
+
+inline bool Index::SubindexContainer::isInline() const{
+	return data == inlineStorage;
+}
+
+inline void Index::SubindexContainer::reserve(unsigned int capacity){
+	if(capacity <= storageCapacity)
+		return;
+
+	Subindex *newData = new Subindex[capacity];
+	for(unsigned int n = 0; n < numSubindices; n++)
+		newData[n] = data[n];
+	if(data != inlineStorage)
+		delete [] data;
+	data = newData;
+	storageCapacity = capacity;
+}
+
+inline void Index::SubindexContainer::push_back(Subindex subindex){
+	if(numSubindices == storageCapacity)
+		reserve(2*storageCapacity);
+	data[numSubindices++] = subindex;
+}
+
+inline void Index::SubindexContainer::pop_back(){
+	numSubindices--;
+}
+
+inline Subindex& Index::SubindexContainer::back(){
+	return data[numSubindices-1];
+}
+
+inline void Index::SubindexContainer::insert(
+	unsigned int n,
+	Subindex subindex
+){
+	if(numSubindices == storageCapacity)
+		reserve(2*storageCapacity);
+	for(unsigned int c = numSubindices; c > n; c--)
+		data[c] = data[c-1];
+	data[n] = subindex;
+	numSubindices++;
+}
+
+inline void Index::SubindexContainer::erase(unsigned int n){
+	for(unsigned int c = n; c+1 < numSubindices; c++)
+		data[c] = data[c+1];
+	numSubindices--;
+}
+
+inline const Subindex* Index::SubindexContainer::begin() const{
+	return data;
+}
+
+inline const Subindex* Index::SubindexContainer::end() const{
+	return data + numSubindices;
+}
+
+inline void Index::SubindexContainer::copy(
+	const SubindexContainer &subindexContainer
+){
+	reserve(subindexContainer.numSubindices);
+	for(unsigned int n = 0; n < subindexContainer.numSubindices; n++)
+		data[n] = subindexContainer.data[n];
+	numSubindices = subindexContainer.numSubindices;
+}
+
+inline void Index::SubindexContainer::move(
+	SubindexContainer &subindexContainer
+){
+	if(subindexContainer.data == subindexContainer.inlineStorage){
+		for(unsigned int n = 0; n < subindexContainer.numSubindices; n++)
+			data[n] = subindexContainer.data[n];
+		numSubindices = subindexContainer.numSubindices;
+	}
+	else{
+		data = subindexContainer.data;
+		numSubindices = subindexContainer.numSubindices;
+		storageCapacity = subindexContainer.storageCapacity;
+		subindexContainer.data = subindexContainer.inlineStorage;
+		subindexContainer.storageCapacity = INLINE_CAPACITY;
+	}
+	subindexContainer.numSubindices = 0;
+}
+
+inline void Index::SubindexContainer::release(){
+	if(data != inlineStorage)
+		delete [] data;
+	data = inlineStorage;
+	numSubindices = 0;
+	storageCapacity = INLINE_CAPACITY;
 }
 
 };	//End of namespace TBTK
 
+namespace std{
+
+/** Hash function that allows Index to be used as key in unordered
+ *  containers. */
+template<>
+struct hash<TBTK::Index>{
+	std::size_t operator()(const TBTK::Index &index) const{
+		return index.getHash();
+	}
+};
+
+};	//End of namespace std
+
 #endif
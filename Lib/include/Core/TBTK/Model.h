@@ -114,6 +114,25 @@ public:
 	 @param ha HoppingAmplitude to add. */
 	void add(HoppingAmplitude ha);
 
+	/** Add a HoppingAmplitude from within an OpenMP parallel region. The
+	 *  HoppingAmplitude is passed through the HoppingAmplitudeFilter, if
+	 *  one is set, which therefore has to be thread safe. See
+	 *  HoppingAmplitudeSet::addConcurrently().
+	 *
+	 *  @param hoppingAmplitude HoppingAmplitude to add. */
+	void addConcurrently(const HoppingAmplitude &hoppingAmplitude);
+
+	/** Add a HoppingAmplitude and its Hermitian conjugate from within an
+	 *  OpenMP parallel region. Corresponds to
+	 *  Model::operator<<(const std::tuple<HoppingAmplitude, HoppingAmplitude>&)
+	 *  and is typically called as addConcurrently(HoppingAmplitude(...) + HC).
+	 *
+	 *  @param hoppingAmplitudes The HoppingAmplitudes to add. */
+	void addConcurrently(
+		const std::tuple<HoppingAmplitude, HoppingAmplitude>
+			&hoppingAmplitudes
+	);
+
 	/** Add a Model as a subsystem.
 	 *
 	 *  @param model Model to include as subsystem.
@@ -163,6 +182,13 @@ public:
 	 *  @return True if the Hilbert space basis has been constructed. */
 	bool getIsConstructed();
 
+	/** Set whether the HoppingAmplitudeSet should use compact storage.
+	 *  See HoppingAmplitudeSet::setUseCompactStorage().
+	 *
+	 *  @param useCompactStorage Flag indicating whether to use compact
+	 *  storage. */
+	void setUseCompactStorage(bool useCompactStorage);
+
 	/** Set temperature.
 	 *
 	 *  @param temperature The temperature. */
@@ -313,6 +339,24 @@ inline void Model::add(HoppingAmplitude ha){
 	singleParticleContext.getHoppingAmplitudeSet().add(ha);
 }
 
+inline void Model::addConcurrently(const HoppingAmplitude &hoppingAmplitude){
+	if(
+		hoppingAmplitudeFilter == nullptr
+		|| hoppingAmplitudeFilter->isIncluded(hoppingAmplitude)
+	){
+		singleParticleContext.getHoppingAmplitudeSet().addConcurrently(
+			hoppingAmplitude
+		);
+	}
+}
+
+inline void Model::addConcurrently(
+	const std::tuple<HoppingAmplitude, HoppingAmplitude> &hoppingAmplitudes
+){
+	addConcurrently(std::get<0>(hoppingAmplitudes));
+	addConcurrently(std::get<1>(hoppingAmplitudes));
+}
+
 inline int Model::getBasisSize() const{
 	return singleParticleContext.getHoppingAmplitudeSet().getBasisSize();
 }
@@ -341,6 +385,12 @@ inline bool Model::getIsConstructed(){
 	return singleParticleContext.getHoppingAmplitudeSet().getIsConstructed();
 }
 
+inline void Model::setUseCompactStorage(bool useCompactStorage){
+	singleParticleContext.getHoppingAmplitudeSet().setUseCompactStorage(
+		useCompactStorage
+	);
+}
+
 inline void Model::setTemperature(double temperature){
 	this->temperature = temperature;
 }
@@ -25,6 +25,7 @@
 #define COM_DAFER45_TBTK_RPA_MOMENTUM_SPACE_CONTEXT
 
 #include "TBTK/BrillouinZone.h"
+#include "TBTK/IrreducibleBrillouinZone.h"
 #include "TBTK/Solver/BlockDiagonalizer.h"
 #include "TBTK/PropertyExtractor/BlockDiagonalizer.h"
 
@@ -66,6 +67,13 @@ public:
 	/** Get number of orbitals. */
 	unsigned int getNumOrbitals() const;
 
+	/** Set symmetry operations. If set, only the irreducible part of the
+	 *  Brillouin zone is diagonalized and the remaining mesh points are
+	 *  reconstructed using the symmetry operations. */
+	void setSymmetryOperations(
+		const std::vector<SymmetryOperation> &symmetryOperations
+	);
+
 	/** Initialize the SusceptibilityCalculator. */
 	void init();
 
@@ -103,6 +111,12 @@ private:
 	/** Number of orbitals. */
 	unsigned int numOrbitals;
 
+	/** Symmetry operations. */
+	std::vector<SymmetryOperation> symmetryOperations;
+
+	/** Irreducible Brillouin zone. */
+	IrreducibleBrillouinZone *irreducibleBrillouinZone;
+
 	/** Solver. */
 	Solver::BlockDiagonalizer solver;
 
@@ -179,6 +193,14 @@ inline unsigned int MomentumSpaceContext::getNumOrbitals() const{
 	return numOrbitals;
 }
 
+inline void MomentumSpaceContext::setSymmetryOperations(
+	const std::vector<SymmetryOperation> &symmetryOperations
+){
+	this->symmetryOperations = symmetryOperations;
+
+	isInitialized = false;
+}
+
 inline double MomentumSpaceContext::getEnergy(unsigned int state) const{
 	return energies[state];
 }
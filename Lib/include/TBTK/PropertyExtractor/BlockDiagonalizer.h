@@ -35,6 +35,8 @@
 #include "TBTK/PropertyExtractor/PropertyExtractor.h"
 
 #include <complex>
+#include <limits>
+#include <string>
 //#include <initializer_list>
 
 namespace TBTK{
@@ -45,6 +47,14 @@ namespace PropertyExtractor{
  *  The PropertyExtractor::Diagonalizer extracts @link
  *  Property::AbstractProperty@endlink from the Solver::BlockDiagonalizer.
  *
+ *  # Distributed execution
+ *  If the Solver::BlockDiagonalizer distributes the blocks over several MPI
+ *  processes, each process calculates the contribution from its own blocks.
+ *  The contributions are then summed using collective MPI operations. Every
+ *  process therefore has to make the same calls to the PropertyExtractor.
+ *  Use setDistributedReduction() to choose which processes that receive the
+ *  full Property.
+ *
  *  # Example
  *  \snippet PropertyExtractor/BlockDiagonalizer.cpp BlockDiagonalizer
  *  ## Output
@@ -58,6 +68,38 @@ public:
 	 *  @param solver The Solver to use. */
 	BlockDiagonalizer();
 
+	/** Enum class for specifying which processes that receive the full
+	 *  Property when the Solver::BlockDiagonalizer uses distributed
+	 *  execution.
+	 *
+	 *  All:
+	 *      Every process receives the full Property.
+	 *
+	 *  Root:
+	 *      Only the process with rank zero receives the full Property.
+	 *      The other processes keep the contribution from their own
+	 *      blocks.
+	 *
+	 *  None:
+	 *      Every process keeps the contribution from its own blocks. No
+	 *      communication takes place. */
+	enum class DistributedReduction{All, Root, None};
+
+	/** Set which processes that receive the full Property when the
+	 *  Solver::BlockDiagonalizer uses distributed execution. The default
+	 *  is DistributedReduction::All.
+	 *
+	 *  @param distributedReduction The DistributedReduction. */
+	void setDistributedReduction(
+		DistributedReduction distributedReduction
+	);
+
+	/** Get which processes that receive the full Property when the
+	 *  Solver::BlockDiagonalizer uses distributed execution.
+	 *
+	 *  @return The DistributedReduction. */
+	DistributedReduction getDistributedReduction() const;
+
 	/** Get eigenvalues. The eigenvalues are ordered first by block, and
 	 *  then in accending order. This means that eigenvalues for blocks
 	 *  with smaller @link Index Indices @endlink comes before eigenvalues
@@ -174,6 +216,36 @@ public:
 	/** Overrider PropertyExtractor::calculateEntropy(). */
 	virtual double calculateEntropy();
 private:
+	/** Which processes that receive the full Property. */
+	DistributedReduction distributedReduction;
+
+	/** Sums the given data over the processes according to the
+	 *  DistributedReduction. Does nothing if the Solver does not use
+	 *  distributed execution.
+	 *
+	 *  @param data The data to sum. Replaced by the sum on the processes
+	 *  that receive the full result.
+	 *  @param size The number of elements in the data. */
+	void reduce(double *data, size_t size) const;
+
+	/** Sums the given data over the processes according to the
+	 *  DistributedReduction.
+	 *
+	 *  @param data The data to sum. */
+	void reduce(std::vector<double> &data) const;
+
+	/** Sums the given data over the processes according to the
+	 *  DistributedReduction.
+	 *
+	 *  @param data The data to sum. */
+	void reduce(std::vector<std::complex<double>> &data) const;
+
+	/** Sums the given data over the processes according to the
+	 *  DistributedReduction.
+	 *
+	 *  @param data The data to sum. */
+	void reduce(std::vector<SpinMatrix> &data) const;
+
 	/** Callback for calculating the wave function. Used by
 	 *  calculateWaveFunctions. */
 	static void calculateWaveFunctionsCallback(
@@ -237,8 +309,41 @@ private:
 
 	/** Get the Solver. */
 	const Solver::BlockDiagonalizer& getSolver() const;
+	/** Ensures that the eigenvectors are available for all states with
+	 *  eigenvalues in the interval (lowerBound, upperBound). Exits with an
+	 *  error message otherwise.
+	 *
+	 *  @param function The name of the calling function.
+	 *  @param lowerBound The lower bound of the interval.
+	 *  @param upperBound The upper bound of the interval. */
+	void assertEigenVectorsAvailable(
+		const std::string &function,
+		double lowerBound = -std::numeric_limits<double>::infinity(),
+		double upperBound = std::numeric_limits<double>::infinity()
+	);
 };
 
+inline void BlockDiagonalizer::setDistributedReduction(
+	DistributedReduction distributedReduction
+){
+	this->distributedReduction = distributedReduction;
+}
+
+inline BlockDiagonalizer::DistributedReduction
+BlockDiagonalizer::getDistributedReduction() const{
+	return distributedReduction;
+}
+
+inline void BlockDiagonalizer::reduce(std::vector<double> &data) const{
+	reduce(data.data(), data.size());
+}
+
+inline void BlockDiagonalizer::reduce(
+	std::vector<std::complex<double>> &data
+) const{
+	reduce(reinterpret_cast<double*>(data.data()), 2*data.size());
+}
+
 inline double BlockDiagonalizer::getEigenValue(int state) const{
 	return getSolver().getEigenValue(state);
 }
@@ -25,6 +25,7 @@
 
 #include "TBTK/Solver/ChebyshevExpander.h"
 #include "TBTK/Property/Density.h"
+#include "TBTK/Property/DOS.h"
 #include "TBTK/Property/GreensFunction.h"
 #include "TBTK/Property/LDOS.h"
 #include "TBTK/Property/Magnetization.h"
@@ -111,6 +112,15 @@ public:
 		std::vector<Index> patterns
 	);
 
+	/** Overrides PropertyExtractor::calculateDOS(). The DOS is calculated
+	 *  using the stochastic trace estimator
+	 *  Solver::ChebyshevExpander::calculateTraceCoefficients(), which
+	 *  means that it is exact only in the limit of infinitely many random
+	 *  vectors.
+	 *
+	 *  @return A Property::DOS containing the density of states. */
+	virtual Property::DOS calculateDOS();
+
 	/** Overrides PropertyExtractor::calculateLDOS(). */
 	virtual Property::LDOS calculateLDOS(Index pattern, Index ranges);
 
@@ -130,9 +140,18 @@ public:
 		std::vector<Index> patterns
 	);
 private:
-	/** !!!Not tested!!! Callback for calculating density.
-	 *  Used by calculateDensity. */
-	static void calculateDensityCallback(
+	/** Indices collected by collectIndexCallback() for batched
+	 *  calculation. */
+	std::vector<Index> batchIndices;
+
+	/** Memory offsets for the indices in batchIndices. */
+	std::vector<int> batchOffsets;
+
+	/** Callback that collects the indices and offsets passed to it in
+	 *  batchIndices and batchOffsets. Used together with
+	 *  calculateBatched() to calculate properties for multiple indices
+	 *  simultaneously. */
+	static void collectIndexCallback(
 		PropertyExtractor *cb_this,
 		Property::Property &property,
 		const Index &index,
@@ -140,6 +159,36 @@ private:
 		Information &information
 	);
 
+	/** Calculate the Green's functions \f$G_{ii}(E)\f$ for the indices
+	 *  collected by collectIndexCallback(), using blocks of
+	 *  Solver::ChebyshevExpander::getBlockSize() indices at a time, and
+	 *  pass them to the accumulate function together with the
+	 *  corresponding offset. The collected indices are cleared when
+	 *  finished.
+	 *
+	 *  @param accumulate Function that adds the contribution from a
+	 *  Green's function to the Property.
+	 *
+	 *  @param property The Property to calculate. */
+	void calculateBatched(
+		void (*accumulate)(
+			ChebyshevExpander *propertyExtractor,
+			Property::Property &property,
+			const std::vector<std::complex<double>> &greensFunctionData,
+			int offset
+		),
+		Property::Property &property
+	);
+
+	/** Adds the contribution to the density from a Green's function.
+	 *  Used by calculateDensity. */
+	static void accumulateDensity(
+		ChebyshevExpander *propertyExtractor,
+		Property::Property &property,
+		const std::vector<std::complex<double>> &greensFunctionData,
+		int offset
+	);
+
 	/** !!!Not tested!!! Callback for calculating magnetization.
 	 *  Used by calculateMAG. */
 	static void calculateMAGCallback(
@@ -150,14 +199,13 @@ private:
 		Information &information
 	);
 
-	/** !!!Not tested!!! Callback for calculating local density of states.
-	 *  Used by calculateLDOS. */
-	static void calculateLDOSCallback(
-		PropertyExtractor *cb_this,
+	/** Adds the contribution to the local density of states from a
+	 *  Green's function. Used by calculateLDOS. */
+	static void accumulateLDOS(
+		ChebyshevExpander *propertyExtractor,
 		Property::Property &property,
-		const Index &index,
-		int offset,
-		Information &information
+		const std::vector<std::complex<double>> &greensFunctionData,
+		int offset
 	);
 
 	/** !!!Not tested!!! Callback for calculating spin-polarized local
@@ -170,6 +218,12 @@ private:
 		Information &information
 	);
 
+	/** Convert a Property::GreensFunction::Type to the corresponding
+	 *  Solver::ChebyshevExpander::Type. */
+	static Solver::ChebyshevExpander::Type getChebyshevType(
+		Property::GreensFunction::Type type
+	);
+
 	/** Get the Solver. */
 	Solver::ChebyshevExpander& getSolver();
 
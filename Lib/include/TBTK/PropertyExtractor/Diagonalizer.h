@@ -35,6 +35,8 @@
 #include "TBTK/PropertyExtractor/PropertyExtractor.h"
 
 #include <complex>
+#include <limits>
+#include <string>
 
 namespace TBTK{
 namespace PropertyExtractor{
@@ -225,6 +227,27 @@ private:
 
 	/** Get the Solver. */
 	Solver::Diagonalizer& getSolver();
+
+	/** Ensures that the eigenvectors are available for all states with
+	 *  eigenvalues in the interval (lowerBound, upperBound). Exits with an
+	 *  error message otherwise.
+	 *
+	 *  @param function The name of the calling function.
+	 *  @param lowerBound The lower bound of the interval.
+	 *  @param upperBound The upper bound of the interval. */
+	void assertEigenVectorsAvailable(
+		const std::string &function,
+		double lowerBound = -std::numeric_limits<double>::infinity(),
+		double upperBound = std::numeric_limits<double>::infinity()
+	);
+
+	/** Ensures that the full spectrum has been calculated. Properties
+	 *  that sum over the occupation of every state are otherwise missing
+	 *  the states outside of the eigenvalue window or eigenstate index
+	 *  range of the Solver. Exits with an error message otherwise.
+	 *
+	 *  @param function The name of the calling function. */
+	void assertFullSpectrum(const std::string &function);
 };
 
 inline double Diagonalizer::getEigenValue(int state){
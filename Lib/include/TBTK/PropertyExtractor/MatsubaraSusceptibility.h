@@ -57,6 +57,9 @@ private:
 		 */
 		SusceptibilityBlockInformation();
 
+		/** Overrides Information::clone(). */
+		virtual SusceptibilityBlockInformation* clone() const;
+
 		/** Set whether the susceptibility should be calculated for all
 		 *  block indices. */
 		void setCalculateSusceptibilityForAllBlocks(
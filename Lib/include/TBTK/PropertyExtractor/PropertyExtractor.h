@@ -433,6 +433,19 @@ protected:
 		 *  PropertyExtractor::PropertyExtractor::Information. */
 		Information();
 
+		/** Destructor. */
+		virtual ~Information();
+
+		/** Create a copy of the Information. Used to give each thread
+		 *  its own Information when a thread-safe callback is called
+		 *  in parallel. Classes that extend the Information must
+		 *  override this function, which is checked before the
+		 *  callback is called in parallel.
+		 *
+		 *  @return Pointer to a newly allocated copy of the
+		 *  Information. The caller is responsible for deleting it. */
+		virtual Information* clone() const;
+
 		/** Set the subindex for the spin index.
 		 *
 		 *  @param spinIndex The subindex that is the spin index. */
@@ -495,7 +508,16 @@ protected:
 	 *  function.
 	 *
 	 *  @param information Allows for custom information to be passed
-	 *  between the calculate-functions and the correpsonding callbacks. */
+	 *  between the calculate-functions and the correpsonding callbacks.
+	 *
+	 *  @param callbackIsThreadSafe Flag indicating that the callback can
+	 *  be called simultaneously from several threads as long as the
+	 *  memory offsets differ. If true, the Indices are distributed over
+	 *  OpenMP threads that each get their own copy of the Information.
+	 *  Indices that share the same memory offset, such as those generated
+	 *  by IDX_SUM_ALL, are handled by a single thread in the same order as
+	 *  in a serial calculation. The summation order, and therefore the
+	 *  result, is therefore independent of the number of threads. */
 	template<typename DataType>
 	void calculate(
 		void (*callback)(
@@ -510,7 +532,8 @@ protected:
 		const Index &ranges,
 		int currentOffset,
 		int offsetMultiplier,
-		Information &information
+		Information &information,
+		bool callbackIsThreadSafe = false
 	);
 
 	/** Loops over the indices satisfying the specified patterns and calls
@@ -526,7 +549,12 @@ protected:
 	 *  @param memoryLayout The memory layout used for the Property.
 	 *  @param abstractProperty The Property that is being calculated.
 	 *  @param information Allows for custom information to be passed
-	 *  between the calculate-functions and the correpsonding callbacks. */
+	 *  between the calculate-functions and the correpsonding callbacks.
+	 *
+	 *  @param callbackIsThreadSafe Flag indicating that the callback can
+	 *  be called simultaneously from several threads as long as the
+	 *  memory offsets differ. See the other calculate() function for
+	 *  details. */
 	template<typename DataType>
 	void calculate(
 		void (*callback)(
@@ -539,7 +567,8 @@ protected:
 		const IndexTree &allIndices,
 		const IndexTree &memoryLayout,
 		Property::AbstractProperty<DataType> &abstractProperty,
-		Information &information
+		Information &information,
+		bool callbackIsThreadSafe = false
 	);
 
 	/** Ensure that range indices are on compliant format. I.e., sets the
@@ -692,6 +721,56 @@ private:
 
 	/** Reference to solver. */
 	PersistentObjectReference<Solver::Solver> solver;
+
+	/** Information used to collect the Indices and memory offsets that
+	 *  a callback is to be called for, before they are distributed over
+	 *  threads. */
+	class IndexCollectionInformation : public Information{
+	public:
+		/** The collected Indices. */
+		std::vector<Index> indices;
+
+		/** The memory offsets for the collected Indices. */
+		std::vector<int> offsets;
+	};
+
+	/** Callback that stores the Index and memory offset in an
+	 *  IndexCollectionInformation. */
+	static void collectIndicesCallback(
+		PropertyExtractor *cb_this,
+		Property::Property &property,
+		const Index &index,
+		int offset,
+		Information &information
+	);
+
+	/** Calls a thread-safe callback in parallel for the given Indices.
+	 *  Indices with the same memory offset are handled by the same thread
+	 *  in the order that they appear in.
+	 *
+	 *  @param callback The callback.
+	 *  @param property The Property that is being calculated.
+	 *  @param indices The Indices to call the callback for.
+	 *  @param offsets The memory offsets for the Indices.
+	 *  @param spinIndices The spin subindex to set in the Information
+	 *  before the callback is called for the corresponding Index. Ignored
+	 *  if empty or if the value is -1.
+	 *  @param information The Information that each thread gets a copy
+	 *  of. */
+	void calculateInParallel(
+		void (*callback)(
+			PropertyExtractor *cb_this,
+			Property::Property &property,
+			const Index &index,
+			int offset,
+			Information &information
+		),
+		Property::Property &property,
+		const std::vector<Index> &indices,
+		const std::vector<int> &offsets,
+		const std::vector<int> &spinIndices,
+		Information &information
+	);
 };
 
 inline void PropertyExtractor::setEnergyWindow(const Range &energyWindow){
@@ -791,8 +870,32 @@ void PropertyExtractor::calculate(
 	const Index &ranges,
 	int currentOffset,
 	int offsetMultiplier,
-	Information &information
+	Information &information,
+	bool callbackIsThreadSafe
 ){
+	if(callbackIsThreadSafe){
+		IndexCollectionInformation indexCollectionInformation;
+		calculate(
+			collectIndicesCallback,
+			property,
+			pattern,
+			ranges,
+			currentOffset,
+			offsetMultiplier,
+			indexCollectionInformation
+		);
+		calculateInParallel(
+			callback,
+			property,
+			indexCollectionInformation.indices,
+			indexCollectionInformation.offsets,
+			{},
+			information
+		);
+
+		return;
+	}
+
 	//Find the next specifier index.
 	int currentSubindex = pattern.getSize()-1;
 	for(; currentSubindex >= 0; currentSubindex--){
@@ -858,8 +961,12 @@ void PropertyExtractor::calculate(
 	const IndexTree &allIndices,
 	const IndexTree &memoryLayout,
 	Property::AbstractProperty<DataType> &abstractProperty,
-	Information &information
+	Information &information,
+	bool callbackIsThreadSafe
 ){
+	std::vector<Index> indices;
+	std::vector<int> offsets;
+	std::vector<int> spinSubindices;
 	for(
 		IndexTree::ConstIterator iterator = allIndices.cbegin();
 		iterator != allIndices.end();
@@ -872,6 +979,7 @@ void PropertyExtractor::calculate(
 				index,
 				IndexTree::SearchMode::MatchWildcards
 			);
+		int spinIndex = -1;
 		if(spinIndices.size() != 0){
 			TBTKAssert(
 				spinIndices.size() == 1,
@@ -880,14 +988,35 @@ void PropertyExtractor::calculate(
 				"Use IDX_SPIN at most once per pattern to"
 				<< " indicate spin index."
 			);
-			information.setSpinIndex(spinIndices[0]);
+			spinIndex = spinIndices[0];
+		}
+
+		if(callbackIsThreadSafe){
+			indices.push_back(index);
+			offsets.push_back(abstractProperty.getOffset(index));
+			spinSubindices.push_back(spinIndex);
+		}
+		else{
+			if(spinIndex != -1)
+				information.setSpinIndex(spinIndex);
+
+			callback(
+				this,
+				abstractProperty,
+				index,
+				abstractProperty.getOffset(index),
+				information
+			);
 		}
+	}
 
-		callback(
-			this,
+	if(callbackIsThreadSafe){
+		calculateInParallel(
+			callback,
 			abstractProperty,
-			index,
-			abstractProperty.getOffset(index),
+			indices,
+			offsets,
+			spinSubindices,
 			information
 		);
 	}
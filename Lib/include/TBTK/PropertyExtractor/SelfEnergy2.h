@@ -56,6 +56,9 @@ private:
 		 */
 		SelfEnergyBlockInformation();
 
+		/** Overrides Information::clone(). */
+		virtual SelfEnergyBlockInformation* clone() const;
+
 		/** Set whether the self-energy should be calculated for all
 		 *  block indices. */
 		void setCalculateSelfEnergyForAllBlocks(
@@ -26,11 +26,16 @@
 #include "TBTK/BlockStructureDescriptor.h"
 #include "TBTK/CArray.h"
 #include "TBTK/Communicator.h"
+#include "TBTK/IrreducibleBrillouinZone.h"
+#include "TBTK/MemoryMappedFile.h"
 #include "TBTK/Model.h"
 #include "TBTK/Solver/Solver.h"
 #include "TBTK/Timer.h"
 
 #include <complex>
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace TBTK{
 namespace Solver{
@@ -61,6 +66,58 @@ namespace Solver{
  *  behavior instead becomes an upper bound, with \f$h\f$ the maximum block
  *  dimension.
  *
+ *  <b>Parallel execution:</b><br />
+ *  When parallel execution is enabled, the blocks are diagonalized in order of
+ *  decreasing cost \f$h^3\f$ and are dynamically dispatched to the threads.
+ *  Blocks that cost more than the average workload per thread cannot be
+ *  balanced against the other blocks. Such blocks are instead diagonalized
+ *  one at a time outside of the parallel region, which leaves all threads to
+ *  a threaded BLAS/LAPACK library. When all eigenvectors or only the
+ *  eigenvalues are calculated, these blocks are diagonalized in full storage
+ *  using a divide and conquer algorithm that benefits from the threads. With
+ *  an eigenvector window, they are still diagonalized in packed storage,
+ *  which only gains little from the extra threads. The remaining blocks are
+ *  diagonalized one per thread. The time it took to diagonalize each block
+ *  is available through getBlockTimings().
+ *
+ *  <b>Distributed execution:</b><br />
+ *  If TBTK is compiled with MPI, setDistributedExecution() can be used to
+ *  distribute the blocks over the processes in MPI_COMM_WORLD. The blocks
+ *  are assigned to the processes such that the total cost \f$h^3\f$ per
+ *  process is balanced, and each process only stores the Hamiltonian,
+ *  eigenvalues, and eigenvectors for its own blocks. Use isLocalState() to
+ *  check whether a state belongs to the current process. The eigenvalues and
+ *  amplitudes can only be accessed for local states. Since the accessors are
+ *  called in tight loops, this is not checked by getEigenValue() and
+ *  getAmplitude(), and the caller is responsible for only requesting local
+ *  states.
+ *  PropertyExtractor::BlockDiagonalizer combines the contributions from the
+ *  different processes using collective operations. All processes must
+ *  therefore run the BlockDiagonalizer and extract the same Properties.
+ *  MPI_Init() has to be called before the BlockDiagonalizer is run.
+ *
+ *  <b>Symmetry reduction:</b><br />
+ *  If the blocks are labeled by the mesh points of a BrillouinZone, use
+ *  setIrreducibleBrillouinZone() to only diagonalize the blocks at the
+ *  irreducible mesh points. The eigenvalues of the remaining blocks are
+ *  copied from the irreducible block in the same star, and the eigenvectors
+ *  are obtained by applying the orbital representation of the corresponding
+ *  SymmetryOperation. The Hamiltonian is only set up for the irreducible
+ *  blocks. All eigenvalues and eigenvectors are therefore available as usual,
+ *  and PropertyExtractor::BlockDiagonalizer works on the full Brillouin zone.
+ *  The first subindices of each block Index must be the mesh point, e.g.
+ *  {kx, ky, spin} for a two-dimensional mesh, and the Hamiltonian must be
+ *  symmetric under every SymmetryOperation.
+ *
+ *  <b>Out-of-core eigenvectors:</b><br />
+ *  The eigenvectors require \f$O(nh^2)\f$ memory, which can exceed the
+ *  available RAM for large Models. Use setEigenVectorScratchFile() to store
+ *  the eigenvectors in a memory-mapped scratch file instead. The operating
+ *  system then pages the eigenvectors of a block in and out of memory on
+ *  demand. Each block is only accessed when it is diagonalized and when
+ *  @link Property::AbstractProperty Properties@endlink are extracted for it,
+ *  so only a few blocks need to be kept in memory at a time.
+ *
  *  # Example
  *  \snippet Solver/BlockDiagonalizer.cpp BlockDiagonalizer
  *  ## Output
@@ -80,9 +137,45 @@ public:
 		) = 0;
 	};
 
+	/** Enum class for specifying which eigenvectors to calculate.
+	 *
+	 *  None:
+	 *      Only calculate eigenvalues. No memory is allocated for the
+	 *      eigenvectors.
+	 *
+	 *  All:
+	 *      Calculate all eigenvectors.
+	 *
+	 *  Window:
+	 *      Calculate all eigenvalues, but only the eigenvectors for
+	 *      eigenvalues in the interval set by setEigenVectorWindow(). Each
+	 *      block is reduced to tridiagonal form once, and only the
+	 *      eigenvectors inside the window are transformed back. */
+	enum class EigenVectorMode{None, All, Window};
+
 	/** Constructs a Solver::Diagonalizer. */
 	BlockDiagonalizer();
 
+	/** Copy constructor. Deleted since the eigenvectors can be stored in
+	 *  a scratch file that is owned by the BlockDiagonalizer. */
+	BlockDiagonalizer(const BlockDiagonalizer &blockDiagonalizer) = delete;
+
+	/** Move constructor.
+	 *
+	 *  @param blockDiagonalizer BlockDiagonalizer to move. */
+	BlockDiagonalizer(BlockDiagonalizer &&blockDiagonalizer) = default;
+
+	/** Assignment operator. Deleted since the eigenvectors can be stored
+	 *  in a scratch file that is owned by the BlockDiagonalizer. */
+	BlockDiagonalizer& operator=(const BlockDiagonalizer &rhs) = delete;
+
+	/** Move assignment operator.
+	 *
+	 *  @param rhs BlockDiagonalizer to assign to the left hand side.
+	 *
+	 *  @return Reference to the assigned BlockDiagonalizer. */
+	BlockDiagonalizer& operator=(BlockDiagonalizer &&rhs) = default;
+
 	/** Set SelfCOnsistencyCallback. If never called, the self-consistency
 	 *  loop will not be run.
 	 *
@@ -106,6 +199,50 @@ public:
 	 *  self-consistent calculation. */
 	void setMaxIterations(int maxIterations);
 
+	/** Set which eigenvectors to calculate. Use setEigenVectorWindow() to
+	 *  only calculate the eigenvectors in an energy window.
+	 *
+	 *  @param eigenVectorMode EigenVectorMode::None or
+	 *  EigenVectorMode::All. */
+	void setEigenVectorMode(EigenVectorMode eigenVectorMode);
+
+	/** Get which eigenvectors that are calculated.
+	 *
+	 *  @return The EigenVectorMode. */
+	EigenVectorMode getEigenVectorMode() const;
+
+	/** Calculate all eigenvalues, but only the eigenvectors for
+	 *  eigenvalues in the interval (lowerBound, upperBound]. Sets the
+	 *  EigenVectorMode to EigenVectorMode::Window.
+	 *
+	 *  @param lowerBound The lower bound of the energy window.
+	 *  @param upperBound The upper bound of the energy window. */
+	void setEigenVectorWindow(double lowerBound, double upperBound);
+
+	/** Store the eigenvectors in a memory-mapped scratch file instead of
+	 *  in RAM. The file is created when the BlockDiagonalizer is run,
+	 *  overwriting any existing file with the same name, and is removed
+	 *  when the BlockDiagonalizer is destroyed or run again. Pass an empty
+	 *  string to store the eigenvectors in RAM, which is the default.
+	 *
+	 *  @param filename The name of the scratch file. */
+	void setEigenVectorScratchFile(const std::string &filename);
+
+	/** Get the name of the scratch file that the eigenvectors are stored
+	 *  in.
+	 *
+	 *  @return The name of the scratch file. An empty string if the
+	 *  eigenvectors are stored in RAM. */
+	const std::string& getEigenVectorScratchFile() const;
+
+	/** Check whether the eigenvector for a given state has been
+	 *  calculated.
+	 *
+	 *  @param state The state number.
+	 *
+	 *  @return True if the eigenvector has been calculated. */
+	bool hasEigenVector(int state) const;
+
 	/** Run calculations. Diagonalizes ones if no self-consistency callback
 	 *  have been set, or otherwise multiple times until slef-consistencey
 	 *  or maximum number of iterations has been reached. */
@@ -115,7 +252,8 @@ public:
 	 *  then in accending order. This means that eigenvalues for blocks
 	 *  with smaller @link Index Indices @endlink comes before eigenvalues
 	 *  for blocks with larger @link Index Indices @endlink, while inside
-	 *  each block the eigenvalues are in accending order.
+	 *  each block the eigenvalues are in accending order. The state must
+	 *  be local to the current process (see isLocalState()).
 	 *
 	 *  @param state The state number.
 	 *
@@ -124,7 +262,8 @@ public:
 
 	/** Get eigenvalue for specific block. Note that in contrast to
 	 *  getEigenValue(int state), 'state' here is relative to the first
-	 *  state of the block.
+	 *  state of the block. The state must be local to the current process
+	 *  (see isLocalState()).
 	 *
 	 *  @param blockIndex Block index to get the eigenvalue for.
 	 *  @param state State index relative to the block in accending order.
@@ -133,7 +272,9 @@ public:
 	const double getEigenValue(const Index &blockIndex, int state) const;
 
 	/** Get amplitude for given eigenvector \f$n\f$ and physical index
-	 * \f$x\f$: \f$\Psi_{n}(x)\f$.
+	 * \f$x\f$: \f$\Psi_{n}(x)\f$. The eigenvector must have been
+	 * calculated (see hasEigenVector()). The state must be local to the
+	 * current process (see isLocalState()).
 	 *
 	 *  @param state Eigenstate number \f$n\f$.
 	 *  @param index Physical index \f$x\f$.
@@ -142,7 +283,8 @@ public:
 	const std::complex<double> getAmplitude(int state, const Index &index) const;
 
 	/** Get amplitude for given eigenvector \f$n\f$, block index \f$b\f$,
-	 *  and physical index \f$x\f$: \f$\Psi_{nb}(x)\f$.
+	 *  and physical index \f$x\f$: \f$\Psi_{nb}(x)\f$. The state must be
+	 *  local to the current process (see isLocalState()).
 	 *
 	 *  @param blockIndex Block index \f$b\f$
 	 *  @param state Eigenstate number \f$n\f$ relative to the given block.
@@ -176,6 +318,46 @@ public:
 	 *
 	 *  @pragma parallelExecution True to enable parallel execution. */
 	void setParallelExecution(bool parallelExecution);
+
+	/** Set whether to distribute the blocks over the processes in
+	 *  MPI_COMM_WORLD. Distributed execution is only possible if TBTK is
+	 *  compiled with MPI.
+	 *
+	 *  @param distributedExecution True to enable distributed execution.
+	 */
+	void setDistributedExecution(bool distributedExecution);
+
+	/** Get whether the blocks are distributed over the processes in
+	 *  MPI_COMM_WORLD.
+	 *
+	 *  @return True if distributed execution is enabled. */
+	bool getDistributedExecution() const;
+
+	/** Check whether a state belongs to a block that is solved by the
+	 *  current process. Eigenvalues and eigenvectors are only available
+	 *  for such states. Always true if distributed execution is disabled.
+	 *
+	 *  @param state The state number.
+	 *
+	 *  @return True if the state is solved by the current process. */
+	bool isLocalState(int state) const;
+
+	/** Get the time it took to diagonalize each block in the last
+	 *  diagonalization.
+	 *
+	 *  @return The time in seconds it took to diagonalize each block. */
+	const std::vector<double>& getBlockTimings() const;
+
+	/** Only diagonalize the blocks at the irreducible mesh points of an
+	 *  IrreducibleBrillouinZone. The eigenvalues and eigenvectors of the
+	 *  remaining blocks are reconstructed using the SymmetryOperations.
+	 *  The IrreducibleBrillouinZone must remain alive for as long as the
+	 *  BlockDiagonalizer is run.
+	 *
+	 *  @param irreducibleBrillouinZone The IrreducibleBrillouinZone. */
+	void setIrreducibleBrillouinZone(
+		const IrreducibleBrillouinZone &irreducibleBrillouinZone
+	);
 private:
 	/** pointer to array containing Hamiltonian. */
 	CArray<std::complex<double>> hamiltonian;
@@ -183,8 +365,16 @@ private:
 	/** Pointer to array containing eigenvalues.*/
 	CArray<double> eigenValues;
 
-	/** Pointer to array containing eigenvectors. */
-	CArray<std::complex<double>> eigenVectors;
+	/** Storage for the eigenvectors when they are stored in RAM. */
+	CArray<std::complex<double>> eigenVectorStorage;
+
+	/** Storage for the eigenvectors when they are stored in a scratch
+	 *  file. */
+	MemoryMappedFile eigenVectorScratchStorage;
+
+	/** The name of the scratch file to store the eigenvectors in. Empty
+	 *  if the eigenvectors are stored in RAM. */
+	std::string eigenVectorScratchFile;
 
 	/** BlockStructureDescriptor. */
 	BlockStructureDescriptor blockStructureDescriptor;
@@ -196,10 +386,26 @@ private:
 	std::vector<unsigned int> blockOffsets;
 
 	/** Eigen vector sizes. */
-	std::vector<unsigned int> eigenVectorSizes;
+	std::vector<size_t> eigenVectorSizes;
 
 	/** Eigen vector offsets. */
-	std::vector<unsigned int> eigenVectorOffsets;
+	std::vector<size_t> eigenVectorOffsets;
+
+	/** Which eigenvectors to calculate. */
+	EigenVectorMode eigenVectorMode;
+
+	/** Lower bound of the eigenvector window. */
+	double eigenVectorWindowLowerBound;
+
+	/** Upper bound of the eigenvector window. */
+	double eigenVectorWindowUpperBound;
+
+	/** The first state with a calculated eigenvector in each block,
+	 *  relative to the first state in the block. */
+	std::vector<unsigned int> firstEigenVectorInBlock;
+
+	/** The number of calculated eigenvectors in each block. */
+	std::vector<unsigned int> numEigenVectorsInBlock;
 
 	/** Maximum number of iterations in the self-consistency loop. */
 	int maxIterations;
@@ -207,6 +413,30 @@ private:
 	/** Flag indicating wether to enable parallel execution. */
 	bool parallelExecution;
 
+	/** The time in seconds it took to diagonalize each block in the last
+	 *  diagonalization. */
+	std::vector<double> blockTimings;
+
+	/** Flag indicating whether to distribute the blocks over the
+	 *  processes in MPI_COMM_WORLD. */
+	bool distributedExecution;
+
+	/** Flags indicating which blocks that are solved by the current
+	 *  process. */
+	std::vector<bool> localBlocks;
+
+	/** IrreducibleBrillouinZone used to reduce the number of blocks that
+	 *  are diagonalized. */
+	const IrreducibleBrillouinZone *irreducibleBrillouinZone;
+
+	/** The irreducible block that each block is reconstructed from. Equal
+	 *  to the block itself for irreducible blocks. */
+	std::vector<unsigned int> irreducibleBlocks;
+
+	/** The SymmetryOperation that maps the irreducible block to each
+	 *  block. */
+	std::vector<const SymmetryOperation*> blockSymmetryOperations;
+
 	/** Callback function to call each time a diagonalization has been
 	 *  completed. */
 	SelfConsistencyCallback *selfConsistencyCallback;
@@ -217,10 +447,201 @@ private:
 	/** Updates Hamiltonian. */
 	void update();
 
+	/** Determines which blocks that are solved by the current process.
+	 *  The blocks are assigned in order of decreasing cost to the process
+	 *  with the smallest total cost. */
+	void distributeBlocks();
+
+	/** Determines the irreducible block and SymmetryOperation for each
+	 *  block. */
+	void reduceBlocks();
+
+	/** Check whether a block is irreducible.
+	 *
+	 *  @param block The block.
+	 *
+	 *  @return True if the block is diagonalized rather than
+	 *  reconstructed. */
+	bool isIrreducibleBlock(unsigned int block) const;
+
+	/** Get the blocks in order of decreasing cost.
+	 *
+	 *  @return The block numbers in order of decreasing cost. */
+	std::vector<unsigned int> getBlocksByDecreasingCost() const;
+
+	/** Get the cost of diagonalizing a block.
+	 *
+	 *  @param block The block.
+	 *
+	 *  @return The cost of diagonalizing the block. */
+	double getBlockCost(unsigned int block) const;
+
+	/** Allocates memory for the eigenvectors, either in RAM or in the
+	 *  scratch file.
+	 *
+	 *  @param size The number of eigenvector elements. */
+	void allocateEigenVectors(size_t size);
+
 	/** Diagonalizes the Hamiltonian. */
 	void solve();
+
+	/** Diagonalizes the Hamiltonian when the EigenVectorMode is
+	 *  EigenVectorMode::Window. The Hamiltonian is destroyed on exit. */
+	void solveEigenVectorWindow();
+
+	/** Diagonalizes a single block in full storage using the divide and
+	 *  conquer routine zheevd, which makes better use of a threaded
+	 *  BLAS/LAPACK library than the packed routines. Used for blocks that
+	 *  are solved with all threads given to BLAS/LAPACK.
+	 *
+	 *  @param block The block to diagonalize.
+	 *  @param calculateEigenVectors Whether to calculate the
+	 *  eigenvectors in addition to the eigenvalues. */
+	void solveLargeBlock(unsigned int block, bool calculateEigenVectors);
+
+	/** Calls solveBlock for every block. When parallel execution is
+	 *  enabled, the blocks are scheduled in order of decreasing cost. A
+	 *  block that costs more than the remaining workload per thread is
+	 *  solved alone with all threads given to BLAS/LAPACK, as long as at
+	 *  least as many blocks as threads remain. The remaining blocks are
+	 *  dynamically dispatched one per thread with single threaded
+	 *  BLAS/LAPACK. The number of BLAS/LAPACK threads is controlled for
+	 *  OpenBLAS and MKL. The time spent in each block is added to
+	 *  blockTimings.
+	 *
+	 *  @param solveBlock Function that solves a single block. The second
+	 *  argument is true if the block is solved alone with all threads
+	 *  given to BLAS/LAPACK. */
+	void solveBlocks(
+		const std::function<void(unsigned int, bool)> &solveBlock
+	);
+
+	/** Copies the eigenvalues of the irreducible blocks to the remaining
+	 *  local blocks. */
+	void reconstructEigenValues();
+
+	/** Calculates the eigenvectors of the local blocks that are not
+	 *  irreducible by applying the orbital representation of the
+	 *  corresponding SymmetryOperation to the eigenvectors of the
+	 *  irreducible block. */
+	void reconstructEigenVectors();
+
+	/** Print a summary of the block timings. */
+	void printBlockTimings() const;
+
+	/** Get the offset in the eigenvector array for the eigenvector of a
+	 *  given state.
+	 *
+	 *  @param block The block that the state belongs to.
+	 *  @param state The state number relative to the first state in the
+	 *  block.
+	 *
+	 *  @return The offset of the eigenvector. */
+	size_t getEigenVectorOffset(
+		unsigned int block,
+		unsigned int state
+	) const;
+
+	/** Get the eigenvectors, which are stored in either
+	 *  eigenVectorStorage or eigenVectorScratchStorage. Resolved on every
+	 *  call rather than stored as a pointer, such that the
+	 *  BlockDiagonalizer remains valid when it is moved.
+	 *
+	 *  @return Pointer to the eigenvectors. */
+	std::complex<double>* getEigenVectors();
+
+	/** Get the eigenvectors.
+	 *
+	 *  @return Pointer to the eigenvectors. */
+	const std::complex<double>* getEigenVectors() const;
 };
 
+inline void BlockDiagonalizer::setEigenVectorMode(
+	EigenVectorMode eigenVectorMode
+){
+	TBTKAssert(
+		eigenVectorMode != EigenVectorMode::Window,
+		"Solver::BlockDiagonalizer::setEigenVectorMode()",
+		"EigenVectorMode::Window cannot be set using this function.",
+		"Use BlockDiagonalizer::setEigenVectorWindow() instead."
+	);
+	this->eigenVectorMode = eigenVectorMode;
+}
+
+inline BlockDiagonalizer::EigenVectorMode
+BlockDiagonalizer::getEigenVectorMode() const{
+	return eigenVectorMode;
+}
+
+inline void BlockDiagonalizer::setEigenVectorWindow(
+	double lowerBound,
+	double upperBound
+){
+	TBTKAssert(
+		lowerBound < upperBound,
+		"Solver::BlockDiagonalizer::setEigenVectorWindow()",
+		"The lower bound '" << lowerBound << "' must be smaller than"
+		<< " the upper bound '" << upperBound << "'.",
+		""
+	);
+	eigenVectorMode = EigenVectorMode::Window;
+	eigenVectorWindowLowerBound = lowerBound;
+	eigenVectorWindowUpperBound = upperBound;
+}
+
+inline void BlockDiagonalizer::setEigenVectorScratchFile(
+	const std::string &filename
+){
+	eigenVectorScratchFile = filename;
+}
+
+inline const std::string&
+BlockDiagonalizer::getEigenVectorScratchFile() const{
+	return eigenVectorScratchFile;
+}
+
+inline bool BlockDiagonalizer::hasEigenVector(int state) const{
+	unsigned int block = blockStructureDescriptor.getBlockIndex(state);
+	unsigned int intraBlockState = state
+		- blockStructureDescriptor.getFirstStateInBlock(block);
+
+	return intraBlockState >= firstEigenVectorInBlock[block]
+		&& intraBlockState < firstEigenVectorInBlock[block]
+			+ numEigenVectorsInBlock[block];
+}
+
+inline size_t BlockDiagonalizer::getEigenVectorOffset(
+	unsigned int block,
+	unsigned int state
+) const{
+	return eigenVectorOffsets[block] + (
+		state - firstEigenVectorInBlock[block]
+	)*blockStructureDescriptor.getNumStatesInBlock(block);
+}
+
+inline std::complex<double>* BlockDiagonalizer::getEigenVectors(){
+	if(eigenVectorScratchStorage.getData() != nullptr){
+		return static_cast<std::complex<double>*>(
+			eigenVectorScratchStorage.getData()
+		);
+	}
+	else{
+		return eigenVectorStorage.getData();
+	}
+}
+
+inline const std::complex<double>* BlockDiagonalizer::getEigenVectors(
+) const{
+	if(eigenVectorScratchStorage.getData() != nullptr){
+		return static_cast<const std::complex<double>*>(
+			eigenVectorScratchStorage.getData()
+		);
+	}
+	else{
+		return eigenVectorStorage.getData();
+	}
+}
+
 inline void BlockDiagonalizer::setSelfConsistencyCallback(
 	SelfConsistencyCallback &selfConsistencyCallback
 ){
@@ -237,20 +658,20 @@ inline const std::complex<double> BlockDiagonalizer::getAmplitude(
 ) const{
 	const Model &model = getModel();
 	unsigned int block = blockStructureDescriptor.getBlockIndex(state);
-	unsigned int offset = eigenVectorOffsets.at(block);
 	unsigned int linearIndex = model.getBasisIndex(index);
 	unsigned int firstStateInBlock
 		= blockStructureDescriptor.getFirstStateInBlock(block);
 	unsigned int lastStateInBlock = firstStateInBlock
 		+ blockStructureDescriptor.getNumStatesInBlock(block)-1;
-	offset += (
+	size_t offset = getEigenVectorOffset(
+		block,
 		state - firstStateInBlock
-	)*blockStructureDescriptor.getNumStatesInBlock(block);
+	);
 	if(
 		linearIndex >= firstStateInBlock
 		&& linearIndex <= lastStateInBlock
 	){
-		return eigenVectors[
+		return getEigenVectors()[
 			offset + (linearIndex - firstStateInBlock)
 		];
 	}
@@ -281,13 +702,12 @@ inline const std::complex<double> BlockDiagonalizer::getAmplitude(
 		<< " states, but state " << state << " was requested.",
 		""
 	);
-	unsigned int offset = eigenVectorOffsets.at(block)
-		+ state*blockStructureDescriptor.getNumStatesInBlock(block);
+	size_t offset = getEigenVectorOffset(block, state);
 	unsigned int linearIndex = getModel().getBasisIndex(
 		Index(blockIndex, intraBlockIndex)
 	);
 
-	return eigenVectors[offset + (linearIndex - firstStateInBlock)];
+	return getEigenVectors()[offset + (linearIndex - firstStateInBlock)];
 }
 
 inline const double BlockDiagonalizer::getEigenValue(int state) const{
@@ -332,6 +752,40 @@ inline void BlockDiagonalizer::setParallelExecution(
 	this->parallelExecution = parallelExecution;
 }
 
+inline void BlockDiagonalizer::setDistributedExecution(
+	bool distributedExecution
+){
+	this->distributedExecution = distributedExecution;
+}
+
+inline bool BlockDiagonalizer::getDistributedExecution() const{
+	return distributedExecution;
+}
+
+inline bool BlockDiagonalizer::isLocalState(int state) const{
+	return localBlocks[blockStructureDescriptor.getBlockIndex(state)];
+}
+
+inline bool BlockDiagonalizer::isIrreducibleBlock(unsigned int block) const{
+	return irreducibleBlocks[block] == block;
+}
+
+inline double BlockDiagonalizer::getBlockCost(unsigned int block) const{
+	double numStates = blockStructureDescriptor.getNumStatesInBlock(block);
+
+	return numStates*numStates*numStates;
+}
+
+inline const std::vector<double>& BlockDiagonalizer::getBlockTimings() const{
+	return blockTimings;
+}
+
+inline void BlockDiagonalizer::setIrreducibleBrillouinZone(
+	const IrreducibleBrillouinZone &irreducibleBrillouinZone
+){
+	this->irreducibleBrillouinZone = &irreducibleBrillouinZone;
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
 
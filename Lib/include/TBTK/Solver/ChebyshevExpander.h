@@ -31,7 +31,9 @@
 #include "TBTK/Model.h"
 #include "TBTK/Range.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/SparseMatrix.h"
 
+#include <cmath>
 #include <complex>
 #ifndef __APPLE__
 #	include <omp.h>
@@ -78,18 +80,90 @@ public:
 	/** Destructor. */
 	virtual ~ChebyshevExpander();
 
+	/** Enum class for specifying how the spectral bounds are estimated
+	 *  when the scale factor is determined automatically. Gershgorin uses
+	 *  the Gershgorin circle theorem, which gives a strict but often loose
+	 *  bound. Lanczos uses a few Lanczos iterations, which gives a tight
+	 *  estimate of the extremal eigenvalues. The Lanczos estimate is not a
+	 *  strict bound, since the iteration can miss eigenvalues that have a
+	 *  small overlap with the starting vector, and a larger safety margin
+	 *  should therefore be used with it. The Lanczos estimate is never
+	 *  allowed to be larger than the Gershgorin bound, and the Gershgorin
+	 *  bound is used if the extremal Ritz values have not converged. */
+	enum class SpectralBoundsMethod{
+		Gershgorin,
+		Lanczos
+	};
+
+	/** Overrides Solver::setModel(). */
+	virtual void setModel(Model &model);
+
 	/** Sets the scale factor that rescales the Hamiltonian to ensure that
 	 *  the energy spectrum of the Hamiltonian is bounded on the interval
-	 *  (-1, 1).
+	 *  (-1, 1). Disables the automatic scale factor.
 	 *
 	 *  @param scaleFactor The scale factor. */
 	void setScaleFactor(double scaleFactor);
 
-	/** Get scale factor.
+	/** Get scale factor. If the automatic scale factor is enabled and the
+	 *  scale factor has not yet been estimated for the current Model, it
+	 *  is estimated by this call, which requires that the Model has been
+	 *  set.
 	 *
 	 *  @return The scale factor that is used to rescale the Hamiltonian. */
 	double getScaleFactor();
 
+	/** Set whether the scale factor should be determined automatically
+	 *  from an estimate of the spectral bounds of the Hamiltonian. The
+	 *  estimate is performed when an expansion is calculated, and is
+	 *  repeated if the Model or the matrix elements of the Hamiltonian
+	 *  have changed since the previous estimate. The scale factor is set
+	 *  to the largest absolute value of the estimated spectral bounds
+	 *  multiplied by one plus the safety margin. The default value is
+	 *  false.
+	 *
+	 *  Note that the energy window has to be contained in the interval
+	 *  (-scaleFactor, scaleFactor) also when the scale factor is
+	 *  determined automatically. This is checked when the scale factor is
+	 *  estimated.
+	 *
+	 *  @param automaticScaleFactor True to determine the scale factor
+	 *  automatically. */
+	void setAutomaticScaleFactor(bool automaticScaleFactor);
+
+	/** Get whether the scale factor is determined automatically.
+	 *
+	 *  @return True if the scale factor is determined automatically. */
+	bool getAutomaticScaleFactor() const;
+
+	/** Set the method used to estimate the spectral bounds when the scale
+	 *  factor is determined automatically. The default value is
+	 *  SpectralBoundsMethod::Gershgorin.
+	 *
+	 *  @param spectralBoundsMethod The method to use. */
+	void setSpectralBoundsMethod(SpectralBoundsMethod spectralBoundsMethod);
+
+	/** Get the method used to estimate the spectral bounds when the scale
+	 *  factor is determined automatically.
+	 *
+	 *  @return The method used to estimate the spectral bounds. */
+	SpectralBoundsMethod getSpectralBoundsMethod() const;
+
+	/** Set the relative safety margin to add to the estimated spectral
+	 *  bounds when the scale factor is determined automatically. The
+	 *  default value is 0.01, which is appropriate for
+	 *  SpectralBoundsMethod::Gershgorin. A margin of at least 0.05 is
+	 *  recommended for SpectralBoundsMethod::Lanczos.
+	 *
+	 *  @param scaleFactorSafetyMargin The safety margin. */
+	void setScaleFactorSafetyMargin(double scaleFactorSafetyMargin);
+
+	/** Get the relative safety margin to add to the estimated spectral
+	 *  bounds when the scale factor is determined automatically.
+	 *
+	 *  @return The safety margin. */
+	double getScaleFactorSafetyMargin() const;
+
 	/** Set the number of Chebyshev coefficients to use during
 	 *  calculations. The default value is 1000.
 	 *
@@ -115,7 +189,9 @@ public:
 	double getBroadening() const;
 
 	/** Set the energy window. The energy window must be contained in the
-	 *  window (-SCALE_FACTOR, SCALE_FACTOR).
+	 *  window (-SCALE_FACTOR, SCALE_FACTOR). If the scale factor is
+	 *  determined automatically, this is checked when the scale factor is
+	 *  estimated.
 	 *
 	 *  @param energyWindow The energy window to use when calculating the
 	 *  Green's function. */
@@ -164,6 +240,182 @@ public:
 	 *  @return True if a lookup table is used. */
 	bool getUseLookupTable() const ;
 
+	/** Set whether Green's functions should be generated using a fast
+	 *  discrete cosine transform on the CPU. The sum over the Chebyshev
+	 *  coefficients is then evaluated on a grid of Chebyshev nodes using
+	 *  a fast Fourier transform, which requires
+	 *  \f$O(N\log N)\f$ operations, where N is proportional to the number
+	 *  of coefficients. The result is interpolated to the energy window
+	 *  using cubic interpolation. No lookup table is needed and the
+	 *  setting takes precedence over setUseLookupTable() when the Green's
+	 *  functions are generated on CPU. The default value is false.
+	 *
+	 *  @param useFastTransform True to use the fast transform. */
+	void setUseFastTransform(bool useFastTransform);
+
+	/** Get whether Green's functions are generated using a fast discrete
+	 *  cosine transform.
+	 *
+	 *  @return True if the fast transform is used. */
+	bool getUseFastTransform() const;
+
+	/** Set the tolerance used to adaptively truncate the Chebyshev
+	 *  expansion. When the tolerance is larger than zero, the expansion
+	 *  for a given 'from'-index is terminated once the magnitude of all
+	 *  of its broadened coefficients has stayed below the tolerance for a
+	 *  number of consecutive moments. The returned coefficient vectors
+	 *  then contain fewer than numCoefficients elements. Since the
+	 *  coefficients are moments of normalized states, the tolerance is
+	 *  an absolute error in the coefficients. Only applies to
+	 *  coefficients calculated on CPU. The default value is 0, which
+	 *  disables the truncation.
+	 *
+	 *  @param adaptiveTruncationTolerance The truncation tolerance. */
+	void setAdaptiveTruncationTolerance(double adaptiveTruncationTolerance);
+
+	/** Get the tolerance used to adaptively truncate the Chebyshev
+	 *  expansion.
+	 *
+	 *  @return The adaptive truncation tolerance. */
+	double getAdaptiveTruncationTolerance() const;
+
+	/** Set whether the Chebyshev coefficients should be calculated using
+	 *  only the local environment of each 'from'-index. The recursion is
+	 *  then performed on the part of the Hamiltonian that acts on the
+	 *  states within \f$(N - 1 + d)/2\f$ hops of the 'from'-index,
+	 *  where \f$N\f$ is the number of coefficients and \f$d\f$ is the
+	 *  largest distance to a 'to'-index. This gives the same coefficients
+	 *  as a calculation on the full Hamiltonian, at a cost per
+	 *  'from'-index that is independent of the system size. Different
+	 *  'from'-indices are processed in parallel. Only applies to
+	 *  coefficients calculated on CPU. The default value is false.
+	 *
+	 *  @param useLocalEnvironment True to use the local environment. */
+	void setUseLocalEnvironment(bool useLocalEnvironment);
+
+	/** Get whether the Chebyshev coefficients are calculated using only
+	 *  the local environment of each 'from'-index.
+	 *
+	 *  @return True if the local environment is used. */
+	bool getUseLocalEnvironment() const;
+
+	/** Set the truncation radius used by calculateDensityMatrix(). If
+	 *  the radius is non-negative, the expansion for each 'from'-index is
+	 *  calculated using only the part of the Hamiltonian that acts on
+	 *  the states that can be reached from the 'from'-index in at most
+	 *  'radius' hops. Density matrix elements between states that are
+	 *  further apart than the radius are then zero. This makes the cost
+	 *  per 'from'-index independent of the system size. The expansion is
+	 *  exact if the radius is at least numCoefficients - 1. The default
+	 *  value is -1, which disables the truncation.
+	 *
+	 *  @param densityMatrixTruncationRadius The truncation radius. */
+	void setDensityMatrixTruncationRadius(
+		int densityMatrixTruncationRadius
+	);
+
+	/** Get the truncation radius used by calculateDensityMatrix().
+	 *
+	 *  @return The truncation radius. */
+	int getDensityMatrixTruncationRadius() const;
+
+	/** Set the number of 'from'-indices for which the Chebyshev
+	 *  coefficients are calculated simultaneously when
+	 *  calculateBlockCoefficients() is called.
+	 *  The recursions for the different 'from'-indices are advanced
+	 *  together, which means that the Hamiltonian only has to be read
+	 *  from memory once per blockSize 'from'-indices. The memory
+	 *  required for the recursion grows linearly with the block size. The
+	 *  default value is 8.
+	 *
+	 *  @param blockSize The number of 'from'-indices to process
+	 *  simultaneously. */
+	void setBlockSize(unsigned int blockSize);
+
+	/** Get the number of 'from'-indices for which the Chebyshev
+	 *  coefficients are calculated simultaneously.
+	 *
+	 *  @return The block size. */
+	unsigned int getBlockSize() const;
+
+	/** Enum class for specifying the type of random vectors used by
+	 *  calculateTraceCoefficients(). RandomPhase vectors have elements
+	 *  \f$e^{i\phi}\f$ with \f$\phi\f$ uniformly distributed on
+	 *  \f$[0, 2\pi)\f$, while Rademacher vectors have elements that are
+	 *  \f$\pm 1\f$ with equal probability. */
+	enum class RandomVectorType{
+		RandomPhase,
+		Rademacher
+	};
+
+	/** Set the number of random vectors to average over in
+	 *  calculateTraceCoefficients(). The default value is 10.
+	 *
+	 *  @param numRandomVectors The number of random vectors. */
+	void setNumRandomVectors(unsigned int numRandomVectors);
+
+	/** Get the number of random vectors to average over in
+	 *  calculateTraceCoefficients().
+	 *
+	 *  @return The number of random vectors. */
+	unsigned int getNumRandomVectors() const;
+
+	/** Set the type of random vectors to use in
+	 *  calculateTraceCoefficients(). The default value is
+	 *  RandomVectorType::RandomPhase.
+	 *
+	 *  @param randomVectorType The type of random vectors. */
+	void setRandomVectorType(RandomVectorType randomVectorType);
+
+	/** Get the type of random vectors to use in
+	 *  calculateTraceCoefficients().
+	 *
+	 *  @return The type of random vectors. */
+	RandomVectorType getRandomVectorType() const;
+
+	/** Set the seed used to generate random vectors in
+	 *  calculateTraceCoefficients(). The default value is 0.
+	 *
+	 *  @param randomSeed The seed. */
+	void setRandomSeed(unsigned int randomSeed);
+
+	/** Get the seed used to generate random vectors in
+	 *  calculateTraceCoefficients().
+	 *
+	 *  @return The seed. */
+	unsigned int getRandomSeed() const;
+
+	/** Calculates the Chebyshev coefficients for the trace
+	 *  \f$\sum_{i}G_{ii}(E)\f$ using a stochastic trace estimator. The
+	 *  coefficients are averaged over getNumRandomVectors() random vectors
+	 *  \f$|r\rangle\f$ as \f$\langle r|T_n(H)|r\rangle\f$, which
+	 *  requires \f$O(N)\f$ work per coefficient and random vector,
+	 *  where N is the basis size. The random vectors are processed in
+	 *  blocks of getBlockSize() vectors and each random vector is
+	 *  generated from its own random number stream. The result is
+	 *  therefore reproducible for a given seed, independently of the
+	 *  number of threads and the block size.
+	 *
+	 *  The density of states is obtained by passing the coefficients to
+	 *  generateGreensFunction() and taking \f$-1/\pi\f$ times the
+	 *  imaginary part of the retarded Green's function.
+	 *
+	 *  @return The Chebyshev coefficients for the trace. */
+	std::vector<std::complex<double>> calculateTraceCoefficients();
+
+	/** Same as calculateTraceCoefficients(), but also estimates the
+	 *  statistical error of each coefficient.
+	 *
+	 *  @param standardErrors Vector that on return contains the standard
+	 *  error of the mean for each coefficient, estimated from the spread
+	 *  between the random vectors. The errors are infinite if only one
+	 *  random vector is used.
+	 *
+	 *  @return The Chebyshev coefficients for the trace. */
+	std::vector<std::complex<double>> calculateTraceCoefficients(
+		std::vector<double> &standardErrors
+	);
+
 	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$, where
 	 *  \f$i = \textrm{to}\f$ is a set of indices and \f$j =
 	 *  \textrm{from}\f$.
@@ -199,6 +451,46 @@ public:
 		Index from
 	);
 
+	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$ for
+	 *  several 'from'-indices \f$j\f$, each with its own set of
+	 *  'to'-indices \f$i\f$. On the CPU, the recursions for up to
+	 *  getBlockSize() 'from'-indices are performed simultaneously.
+	 *
+	 *  @param to One vector of 'to'-indices for each 'from'-index.
+	 *  @param from The 'from'-indices.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[from][to][coefficient], where 'from' and 'to' are the
+	 *  positions of the indices in the corresponding vectors. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateBlockCoefficients(
+		const std::vector<std::vector<Index>> &to,
+		const std::vector<Index> &from
+	);
+
+	/** Calculates density matrix elements
+	 *  \f$\rho_{ij} = \langle c_{j}^{\dagger}c_{i}\rangle
+	 *  = \langle i|f(H)|j\rangle\f$ by expanding the Fermi function
+	 *  \f$f(H)\f$ in Chebyshev polynomials. The temperature and chemical
+	 *  potential are taken from the Model, which must have Fermi-Dirac
+	 *  statistics. Only sparse matrix-vector products are required,
+	 *  which together with setDensityMatrixTruncationRadius() allows for
+	 *  linear scaling in the number of 'from'-indices. The density
+	 *  \f$\langle c_{i}^{\dagger}c_{i}\rangle\f$ is obtained by
+	 *  letting 'to' and 'from' be equal.
+	 *
+	 *  @param to One vector of 'to'-indices \f$i\f$ for each
+	 *  'from'-index.
+	 *  @param from The 'from'-indices \f$j\f$.
+	 *
+	 *  @return The density matrix elements on the format
+	 *  densityMatrix[from][to]. */
+	std::vector<std::vector<std::complex<double>>> calculateDensityMatrix(
+		const std::vector<std::vector<Index>> &to,
+		const std::vector<Index> &from
+	);
+
 	/** Enum class describing the type of Green's function to calculate. */
 	enum class Type{
 		Advanced,
@@ -221,10 +513,63 @@ public:
 		const std::vector<std::complex<double>> &coefficients,
 		Type type = Type::Retarded
 	);
+
+	/** Prepare the scale factor and lookup tables that are lazily set up
+	 *  by generateGreensFunction(). Must be called before
+	 *  generateGreensFunction() is called concurrently from several
+	 *  threads. */
+	void prepareGreensFunctionGeneration();
+
+	/** Get the energies of the Chebyshev nodes
+	 *  \f$E_k = s\cos(\pi(k + 1/2)/K)\f$, where s is the scale factor and
+	 *  K is the number of nodes. The energies are in descending order.
+	 *
+	 *  @param numNodes The number of nodes K.
+	 *
+	 *  @return The energies of the Chebyshev nodes. */
+	std::vector<double> getChebyshevNodes(unsigned int numNodes);
+
+	/** Generate Green's function on the Chebyshev nodes returned by
+	 *  getChebyshevNodes(). The sum over the coefficients is evaluated
+	 *  for all nodes simultaneously using a fast discrete cosine
+	 *  transform, which requires \f$O(K\log K)\f$ operations.
+	 *
+	 *  @param coefficients Chebyshev coefficients calculated by
+	 *  ChebyshevExpander::calculateCoefficients.
+	 *
+	 *  @param numNodes The number of nodes K. Must be a power of two that
+	 *  is at least as large as the number of coefficients.
+	 *
+	 *  @param type The type of Green's function to generate.
+	 *
+	 *  @return The Green's function evaluated at the Chebyshev nodes. */
+	std::vector<std::complex<double>> generateGreensFunctionOnChebyshevNodes(
+		const std::vector<std::complex<double>> &coefficients,
+		unsigned int numNodes,
+		Type type = Type::Retarded
+	);
 private:
 	/** Scale factor. */
 	double scaleFactor;
 
+	/** Flag indicating whether the scale factor is determined
+	 *  automatically. */
+	bool automaticScaleFactor;
+
+	/** Flag indicating whether the automatic scale factor has been
+	 *  estimated for the current Model. */
+	bool scaleFactorIsEstimated;
+
+	/** Revision of the sparse matrix of the Hamiltonian for which the
+	 *  automatic scale factor was estimated. */
+	unsigned long long estimatedHamiltonianRevision;
+
+	/** The method used to estimate the spectral bounds. */
+	SpectralBoundsMethod spectralBoundsMethod;
+
+	/** Relative safety margin for the automatic scale factor. */
+	double scaleFactorSafetyMargin;
+
 	/** The number of Chebyshev coefficients to calculate and use. */
 	int numCoefficients;
 
@@ -234,6 +579,20 @@ private:
 	/** The energy window to calculate the Green's function over. */
 	Range energyWindow;
 
+	/** The number of 'from'-indices to calculate coefficients for
+	 *  simultaneously. */
+	unsigned int blockSize;
+
+	/** The number of random vectors used by
+	 *  calculateTraceCoefficients(). */
+	unsigned int numRandomVectors;
+
+	/** The type of random vectors used by calculateTraceCoefficients(). */
+	RandomVectorType randomVectorType;
+
+	/** The seed used by calculateTraceCoefficients(). */
+	unsigned int randomSeed;
+
 	/** Flag indicating whether to use GPU to calculate Chebyshev
 	 *  coefficients. */
 	bool calculateCoefficientsOnGPU;
@@ -246,6 +605,22 @@ private:
 	 *  Green's functions. */
 	bool useLookupTable;
 
+	/** Flag indicating whether to use a fast discrete cosine transform
+	 *  when generating Green's functions. */
+	bool useFastTransform;
+
+	/** Tolerance below which the Chebyshev expansion is truncated. Zero
+	 *  disables the adaptive truncation. */
+	double adaptiveTruncationTolerance;
+
+	/** Truncation radius used by calculateDensityMatrix(). Negative
+	 *  values disable the truncation. */
+	int densityMatrixTruncationRadius;
+
+	/** Flag indicating whether to calculate the coefficients using only
+	 *  the local environment of each 'from'-index. */
+	bool useLocalEnvironment;
+
 	/** Pointer to lookup table used to speed up evaluation of multiple
 	 *  Green's functions. */
 	Invalidatable<
@@ -272,6 +647,28 @@ private:
 	/** Ensure that the lookup table is in a ready state. */
 	void ensureLookupTableIsReady();
 
+	/** Ensure that the scale factor has been estimated if the automatic
+	 *  scale factor is enabled. An existing estimate is kept even if the
+	 *  Hamiltonian has changed, such that Green's functions are generated
+	 *  with the same scale factor as the coefficients. */
+	void ensureScaleFactorIsReady();
+
+	/** Estimate the scale factor if the automatic scale factor is enabled
+	 *  and the Hamiltonian has changed since the previous estimate. Called
+	 *  before every expansion. */
+	void updateScaleFactor();
+
+	/** Assert that the energy window is contained in the interval
+	 *  (-scaleFactor, scaleFactor). */
+	void assertEnergyWindowIsValid() const;
+
+	/** Estimate the spectral bounds of the Hamiltonian using the method
+	 *  specified by spectralBoundsMethod.
+	 *
+	 *  @return The largest absolute value of the estimated lower and
+	 *  upper spectral bounds. */
+	double estimateSpectralRadius() const;
+
 	/** Generate lokup table for quicker generation of multiple Green's
 	 *  functions. Required if evaluation is to be performed on GPU.
 	 *  @param numCoefficeints Number of coefficients used in Chebyshev
@@ -329,6 +726,114 @@ private:
 		Index from
 	);
 
+	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$ for
+	 *  several 'from'-indices \f$j\f$, each with its own set of
+	 *  'to'-indices \f$i\f$. The 'from'-indices are divided into blocks
+	 *  of size blockSize and the recursions for all 'from'-indices in a
+	 *  block are performed simultaneously using sparse matrix times dense
+	 *  block multiplications. Runs on CPU.
+	 *
+	 *  @param to One vector of 'to'-indices for each 'from'-index.
+	 *  @param from The 'from'-indices.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[from][to][coefficient]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateBlockCoefficientsCPU(
+		const std::vector<std::vector<Index>> &to,
+		const std::vector<Index> &from
+	);
+
+	/** Runs the Chebyshev recursion for a block of 'from'-indices using
+	 *  the given Hamiltonian, which is assumed to be on CSR format. The
+	 *  Hamiltonian is divided by the scale factor in the matrix-vector
+	 *  multiplications. Takes adaptive truncation and broadening into
+	 *  account.
+	 *
+	 *  @param sparseMatrix The unscaled Hamiltonian.
+	 *  @param basisSize The size of the basis the Hamiltonian acts on.
+	 *  @param fromBasisIndices The basis indices of the 'from'-indices.
+	 *  @param toBasisIndices The basis indices of the 'to'-indices for
+	 *  each 'from'-index.
+	 *  @param showProgress Whether to print progress when verbose.
+	 *
+	 *  @return The Chebyshev coefficients on the format
+	 *  coefficients[from][to][n]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateBlockCoefficientsCPU(
+		const SparseMatrix<std::complex<double>> &sparseMatrix,
+		unsigned int basisSize,
+		const std::vector<unsigned int> &fromBasisIndices,
+		const std::vector<std::vector<unsigned int>> &toBasisIndices,
+		bool showProgress
+	) const;
+
+	/** Calculates the Chebyshev coefficients for each 'from'-index using
+	 *  the part of the Hamiltonian that acts on the states that are
+	 *  within a given number of hops from the 'from'-index. Coefficients
+	 *  for 'to'-indices outside of this local environment are zero. The
+	 *  'from'-indices are processed in parallel.
+	 *
+	 *  @param to The 'to'-indices for each 'from'-index.
+	 *  @param from The 'from'-indices.
+	 *  @param radius The number of hops that defines the local
+	 *  environment. If negative, the smallest radius for which the
+	 *  coefficients are exact is used.
+	 *
+	 *  @return The Chebyshev coefficients on the format
+	 *  coefficients[from][to][n]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateLocalCoefficientsCPU(
+		const std::vector<std::vector<Index>> &to,
+		const std::vector<Index> &from,
+		int radius
+	);
+
+	/** Calculates the Chebyshev coefficients of the Fermi function
+	 *  \f$f(s x)\f$, where \f$s\f$ is the scale factor, using the
+	 *  temperature and chemical potential of the Model.
+	 *
+	 *  @return The first numCoefficients Chebyshev coefficients of the
+	 *  Fermi function. */
+	std::vector<double> calculateFermiFunctionCoefficients() const;
+
+	/** Calculate the scalar products \f$\langle l_b|r_b\rangle\f$ between
+	 *  the vectors in two blocks of vectors. Element b of row n is
+	 *  assumed to be stored at position numVectors*n + b.
+	 *
+	 *  @param lhs The block of vectors \f$|l_b\rangle\f$.
+	 *  @param rhs The block of vectors \f$|r_b\rangle\f$.
+	 *  @param basisSize The number of rows in each block.
+	 *  @param numVectors The number of vectors in each block.
+	 *  @param result Vector with at least numVectors elements to write
+	 *  the scalar products to. */
+	void calculateScalarProducts(
+		const CArray<std::complex<double>> &lhs,
+		const CArray<std::complex<double>> &rhs,
+		unsigned int basisSize,
+		unsigned int numVectors,
+		std::vector<std::complex<double>> &result
+	) const;
+
+	/** Multiply the coefficients by a Lorentzian kernel to remedy Gibb's
+	 *  oscillations. Does nothing if the broadening is zero.
+	 *
+	 *  @param coefficients The coefficients to convolve. */
+	void applyBroadening(
+		std::vector<std::vector<std::complex<double>>> &coefficients
+	) const;
+
+	/** Get the factor by which the Lorentzian convolution multiplies the
+	 *  nth coefficient.
+	 *
+	 *  @param n The coefficient number.
+	 *
+	 *  @return The broadening factor for the nth coefficient. */
+	double getBroadeningFactor(unsigned int n) const;
+
 	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$, where
 	 *  \f$i = \textrm{to}\f$ is a set of indices and \f$j =
 	 *  \textrm{from}\f$. Runs on GPU.
@@ -375,6 +880,53 @@ private:
 		Type type = Type::Retarded
 	);
 
+	/** Calculate the sums
+	 *  \f$\sum_{n}\frac{b^{(m)}}{1 + \delta_{0m}}F(m\theta_k)\f$, where
+	 *  \f$\theta_k = \pi(k + 1/2)/K\f$ and F is the function
+	 *  corresponding to the Green's function type, using a fast Fourier
+	 *  transform.
+	 *
+	 *  @param coefficients The Chebyshev coefficients.
+	 *  @param numNodes The number of nodes K. Must be a power of two
+	 *  that is at least as large as the number of coefficients.
+	 *
+	 *  @param type The type of Green's function.
+	 *
+	 *  @return The sums for each node. */
+	std::vector<std::complex<double>> calculateFastTransformSums(
+		const std::vector<std::complex<double>> &coefficients,
+		unsigned int numNodes,
+		Type type
+	) const;
+
+	/** Generate Green's function on the energy window by interpolating
+	 *  the result of a fast discrete cosine transform. Runs on CPU.
+	 *
+	 *  @param coefficients Chebyshev coefficients calculated by
+	 *  ChebyshevExpander::calculateCoefficients.
+	 *
+	 *  @param type The type of Green's function to generate.
+	 *
+	 *  @return The Green's function. */
+	std::vector<std::complex<double>> generateGreensFunctionFastTransform(
+		const std::vector<std::complex<double>> &coefficients,
+		Type type
+	) const;
+
+	/** Multiply the sums calculated by calculateFastTransformSums() or
+	 *  the corresponding direct sums by the type dependent prefactor.
+	 *
+	 *  @param sum The sum.
+	 *  @param E The energy in units of the scale factor.
+	 *  @param type The type of Green's function.
+	 *
+	 *  @return The Green's function. */
+	std::complex<double> applyGreensFunctionPrefactor(
+		std::complex<double> sum,
+		double E,
+		Type type
+	) const;
+
 	/** Genererate Green's function. Uses lookup table generated by
 	 *  ChebyshevExpander::generateLookupTable. Runs on GPU.
 	 *  @param greensFunction Pointer to array able to hold Green's
@@ -405,12 +957,57 @@ inline void ChebyshevExpander::setScaleFactor(double scaleFactor){
 		destroyLookupTableGPU();
 
 	this->scaleFactor = scaleFactor;
+	automaticScaleFactor = false;
 }
 
 inline double ChebyshevExpander::getScaleFactor(){
+	ensureScaleFactorIsReady();
+
 	return scaleFactor;
 }
 
+inline void ChebyshevExpander::setAutomaticScaleFactor(
+	bool automaticScaleFactor
+){
+	this->automaticScaleFactor = automaticScaleFactor;
+	scaleFactorIsEstimated = false;
+}
+
+inline bool ChebyshevExpander::getAutomaticScaleFactor() const{
+	return automaticScaleFactor;
+}
+
+inline void ChebyshevExpander::setSpectralBoundsMethod(
+	SpectralBoundsMethod spectralBoundsMethod
+){
+	this->spectralBoundsMethod = spectralBoundsMethod;
+	scaleFactorIsEstimated = false;
+}
+
+inline ChebyshevExpander::SpectralBoundsMethod
+ChebyshevExpander::getSpectralBoundsMethod() const{
+	return spectralBoundsMethod;
+}
+
+inline void ChebyshevExpander::setScaleFactorSafetyMargin(
+	double scaleFactorSafetyMargin
+){
+	TBTKAssert(
+		scaleFactorSafetyMargin >= 0,
+		"Solver::ChebyshevExpander::setScaleFactorSafetyMargin()",
+		"The 'scaleFactorSafetyMargin=" << scaleFactorSafetyMargin
+		<< "' cannot be negative.",
+		""
+	);
+
+	this->scaleFactorSafetyMargin = scaleFactorSafetyMargin;
+	scaleFactorIsEstimated = false;
+}
+
+inline double ChebyshevExpander::getScaleFactorSafetyMargin() const{
+	return scaleFactorSafetyMargin;
+}
+
 inline void ChebyshevExpander::setNumCoefficients(int numCoefficients){
 	destroyLookupTable();
 	if(generatingFunctionLookupTable_device != nullptr)
@@ -432,28 +1029,125 @@ inline double ChebyshevExpander::getBroadening() const{
 }
 
 inline void ChebyshevExpander::setEnergyWindow(const Range &energyWindow){
-	const double epsilon = std::numeric_limits<double>::epsilon();
-	TBTKAssert(
-		energyWindow[0] > -scaleFactor*(1 - 16*epsilon)
-		&& energyWindow.getLast() < scaleFactor*(1 - 16*epsilon),
-		"Solver::ChebyshevExpander::setEnergyWindow()",
-		"Invalid energy window. The 'energyWindow=["
-		<< energyWindow[0] << ", " << energyWindow.getLast() << "]' is"
-		<< " not contained in the interval (-scaleFactor, scaleFactor)"
-		<< "=(" << -scaleFactor << ", " << scaleFactor << ").",
-		""
-	);
 	destroyLookupTable();
 	if(generatingFunctionLookupTable_device != nullptr)
 		destroyLookupTableGPU();
 
 	this->energyWindow = energyWindow;
+
+	//The automatic scale factor is only known once the Model has been set
+	//and is checked against the energy window when it is estimated.
+	if(!automaticScaleFactor)
+		assertEnergyWindowIsValid();
 }
 
 inline const Range& ChebyshevExpander::getEnergyWindow() const{
 	return energyWindow;
 }
 
+inline void ChebyshevExpander::setUseFastTransform(bool useFastTransform){
+	this->useFastTransform = useFastTransform;
+}
+
+inline bool ChebyshevExpander::getUseFastTransform() const{
+	return useFastTransform;
+}
+
+inline void ChebyshevExpander::setAdaptiveTruncationTolerance(
+	double adaptiveTruncationTolerance
+){
+	TBTKAssert(
+		adaptiveTruncationTolerance >= 0,
+		"Solver::ChebyshevExpander::setAdaptiveTruncationTolerance()",
+		"The adaptive truncation tolerance must be non-negative.",
+		""
+	);
+	this->adaptiveTruncationTolerance = adaptiveTruncationTolerance;
+}
+
+inline double ChebyshevExpander::getAdaptiveTruncationTolerance() const{
+	return adaptiveTruncationTolerance;
+}
+
+inline void ChebyshevExpander::setUseLocalEnvironment(
+	bool useLocalEnvironment
+){
+	this->useLocalEnvironment = useLocalEnvironment;
+}
+
+inline bool ChebyshevExpander::getUseLocalEnvironment() const{
+	return useLocalEnvironment;
+}
+
+inline void ChebyshevExpander::setDensityMatrixTruncationRadius(
+	int densityMatrixTruncationRadius
+){
+	this->densityMatrixTruncationRadius = densityMatrixTruncationRadius;
+}
+
+inline int ChebyshevExpander::getDensityMatrixTruncationRadius() const{
+	return densityMatrixTruncationRadius;
+}
+
+inline void ChebyshevExpander::setBlockSize(unsigned int blockSize){
+	TBTKAssert(
+		blockSize > 0,
+		"Solver::ChebyshevExpander::setBlockSize()",
+		"The 'blockSize' must be larger than zero.",
+		""
+	);
+
+	this->blockSize = blockSize;
+}
+
+inline unsigned int ChebyshevExpander::getBlockSize() const{
+	return blockSize;
+}
+
+inline void ChebyshevExpander::setNumRandomVectors(
+	unsigned int numRandomVectors
+){
+	TBTKAssert(
+		numRandomVectors > 0,
+		"Solver::ChebyshevExpander::setNumRandomVectors()",
+		"The 'numRandomVectors' must be larger than zero.",
+		""
+	);
+
+	this->numRandomVectors = numRandomVectors;
+}
+
+inline unsigned int ChebyshevExpander::getNumRandomVectors() const{
+	return numRandomVectors;
+}
+
+inline void ChebyshevExpander::setRandomVectorType(
+	RandomVectorType randomVectorType
+){
+	this->randomVectorType = randomVectorType;
+}
+
+inline ChebyshevExpander::RandomVectorType
+ChebyshevExpander::getRandomVectorType() const{
+	return randomVectorType;
+}
+
+inline void ChebyshevExpander::setRandomSeed(unsigned int randomSeed){
+	this->randomSeed = randomSeed;
+}
+
+inline unsigned int ChebyshevExpander::getRandomSeed() const{
+	return randomSeed;
+}
+
+inline std::vector<
+	std::complex<double>
+> ChebyshevExpander::calculateTraceCoefficients(){
+	std::vector<double> standardErrors;
+
+	return calculateTraceCoefficients(standardErrors);
+}
+
 inline void ChebyshevExpander::setCalculateCoefficientsOnGPU(
 	bool calculateCoefficientsOnGPU
 ){
@@ -494,6 +1188,8 @@ inline std::vector<
 	std::vector<Index> &to,
 	Index from
 ){
+	updateScaleFactor();
+
 	if(calculateCoefficientsOnGPU){
 		return calculateCoefficientsGPU(
 			to,
@@ -512,6 +1208,8 @@ inline std::vector<std::complex<double>> ChebyshevExpander::calculateCoefficient
 	Index to,
 	Index from
 ){
+	updateScaleFactor();
+
 	if(calculateCoefficientsOnGPU){
 		return calculateCoefficientsGPU(
 			to,
@@ -526,6 +1224,43 @@ inline std::vector<std::complex<double>> ChebyshevExpander::calculateCoefficient
 	}
 }
 
+inline std::vector<
+	std::vector<std::vector<std::complex<double>>>
+> ChebyshevExpander::calculateBlockCoefficients(
+	const std::vector<std::vector<Index>> &to,
+	const std::vector<Index> &from
+){
+	TBTKAssert(
+		to.size() == from.size(),
+		"Solver::ChebyshevExpander::calculateBlockCoefficients()",
+		"Incompatible sizes. The number of 'to'-index vectors ("
+		<< to.size() << ") must be equal to the number of"
+		<< " 'from'-indices (" << from.size() << ").",
+		""
+	);
+	updateScaleFactor();
+
+	if(calculateCoefficientsOnGPU){
+		std::vector<
+			std::vector<std::vector<std::complex<double>>>
+		> coefficients;
+		for(unsigned int n = 0; n < from.size(); n++){
+			std::vector<Index> toIndices = to[n];
+			coefficients.push_back(
+				calculateCoefficientsGPU(toIndices, from[n])
+			);
+		}
+
+		return coefficients;
+	}
+	else{
+		return calculateBlockCoefficientsCPU(
+			to,
+			from
+		);
+	}
+}
+
 inline bool ChebyshevExpander::getLookupTableIsLoadedGPU(){
 	if(generatingFunctionLookupTable_device != NULL)
 		return true;
@@ -537,7 +1272,22 @@ inline std::vector<std::complex<double>> ChebyshevExpander::generateGreensFuncti
 	const std::vector<std::complex<double>> &coefficients,
 	Type type
 ){
+	ensureScaleFactorIsReady();
+
 	if(generateGreensFunctionsOnGPU){
+		//The GPU kernel expects numCoefficients coefficients, while
+		//adaptively truncated expansions can be shorter.
+		if(coefficients.size() < (unsigned int)numCoefficients){
+			std::vector<std::complex<double>> paddedCoefficients
+				= coefficients;
+			paddedCoefficients.resize(numCoefficients, 0);
+
+			return generateGreensFunctionGPU(
+				paddedCoefficients,
+				type
+			);
+		}
+
 		return generateGreensFunctionGPU(coefficients, type);
 	}
 	else{
@@ -545,6 +1295,43 @@ inline std::vector<std::complex<double>> ChebyshevExpander::generateGreensFuncti
 	}
 }
 
+inline void ChebyshevExpander::prepareGreensFunctionGeneration(){
+	ensureScaleFactorIsReady();
+	if(generateGreensFunctionsOnGPU || !useFastTransform)
+		ensureLookupTableIsReady();
+}
+
+inline double ChebyshevExpander::getBroadeningFactor(unsigned int n) const{
+	if(broadening == 0)
+		return 1;
+
+	double lambda = broadening*numCoefficients;
+	return std::sinh(
+		lambda*(1 - n/(double)numCoefficients)
+	)/std::sinh(lambda);
+}
+
+inline void ChebyshevExpander::ensureScaleFactorIsReady(){
+	if(!automaticScaleFactor || scaleFactorIsEstimated)
+		return;
+
+	updateScaleFactor();
+}
+
+inline void ChebyshevExpander::assertEnergyWindowIsValid() const{
+	const double epsilon = std::numeric_limits<double>::epsilon();
+	TBTKAssert(
+		energyWindow[0] > -scaleFactor*(1 - 16*epsilon)
+		&& energyWindow.getLast() < scaleFactor*(1 - 16*epsilon),
+		"Solver::ChebyshevExpander::setEnergyWindow()",
+		"Invalid energy window. The 'energyWindow=["
+		<< energyWindow[0] << ", " << energyWindow.getLast() << "]' is"
+		<< " not contained in the interval (-scaleFactor, scaleFactor)"
+		<< "=(" << -scaleFactor << ", " << scaleFactor << ").",
+		""
+	);
+}
+
 inline void ChebyshevExpander::ensureLookupTableIsReady(){
 	if(useLookupTable){
 		if(!generatingFunctionLookupTable.getIsValid())
@@ -25,8 +25,10 @@
 
 #include "TBTK/CArray.h"
 #include "TBTK/Communicator.h"
+#include "TBTK/Matrix.h"
 #include "TBTK/Model.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/TBTKMacros.h"
 
 #include <complex>
 
@@ -67,9 +69,185 @@ public:
 		virtual bool selfConsistencyCallback(Diagonalizer &diagonalizer) = 0;
 	};
 
+	/** Enum class for specifying the LAPACK routine used to diagonalize
+	 *  the Hamiltonian.
+	 *
+	 *  Packed:
+	 *      Uses zhpev on a packed upper triangular matrix. Slowest, but
+	 *      requires the least amount of memory.
+	 *
+	 *  DivideAndConquer:
+	 *      Uses zheevd on a full matrix. Significantly faster than Packed
+	 *      for large matrices, but requires additional workspace.
+	 *
+	 *  MRRR:
+	 *      Uses zheevr on a full matrix (multiple relatively robust
+	 *      representations). Allows for only the eigenvalues and
+	 *      eigenvectors in a given energy window or index range to be
+	 *      calculated.
+	 *
+	 *  LOBPCG:
+	 *      Iterative solver (locally optimal block preconditioned
+	 *      conjugate gradient) that works on the sparse Hamiltonian.
+	 *      Requires an eigenstate index range or an energy window to be
+	 *      set and only works for orthonormal bases. For an index range,
+	 *      the lowest states up to the last index are iterated. For an
+	 *      energy window, the states closest to the center of the window
+	 *      are iterated (folded spectrum), and the number of iterated
+	 *      states is increased until the window is covered. In a
+	 *      self-consistent calculation, each iteration starts from the
+	 *      eigenvectors of the previous step, which typically makes the
+	 *      iteration converge in a few steps. */
+	enum class Algorithm{Packed, DivideAndConquer, MRRR, LOBPCG};
+
+	/** Enum class for specifying which eigenvectors to calculate.
+	 *
+	 *  None:
+	 *      Only calculate eigenvalues. No memory is allocated for the
+	 *      eigenvectors.
+	 *
+	 *  All:
+	 *      Calculate the eigenvectors for all calculated eigenvalues.
+	 *
+	 *  Window:
+	 *      Calculate all eigenvalues, but only the eigenvectors for
+	 *      eigenvalues in the interval set by setEigenVectorWindow(). The
+	 *      packed Hamiltonian is reduced to tridiagonal form with zhptrd
+	 *      and only the eigenvectors inside the window are calculated and
+	 *      transformed back, independently of the Algorithm. */
+	enum class EigenVectorMode{None, All, Window};
+
+	/** Enum class for specifying how a non-orthonormal basis is handled.
+	 *
+	 *  Cholesky:
+	 *      Solves the generalized eigenvalue problem \f$HC = SCE\f$ by
+	 *      Cholesky factorizing the overlap matrix \f$S = U^{\dagger}U\f$
+	 *      and reducing the problem to standard form. The factorization
+	 *      is calculated once per call to run() and reused in every
+	 *      self-consistency step. Requires \f$S\f$ to be positive
+	 *      definite.
+	 *
+	 *  CanonicalOrthogonalization:
+	 *      Transforms to an orthonormal basis by diagonalizing the
+	 *      overlap matrix. Slower, but more robust for nearly linearly
+	 *      dependent bases. */
+	enum class NonOrthonormalBasisMethod{
+		Cholesky,
+		CanonicalOrthogonalization
+	};
+
 	/** Constructs a Solver::Diagonalizer. */
 	Diagonalizer();
 
+	/** Set the algorithm used to diagonalize the Hamiltonian.
+	 *
+	 *  @param algorithm The algorithm to use. */
+	void setAlgorithm(Algorithm algorithm);
+
+	/** Get the algorithm used to diagonalize the Hamiltonian.
+	 *
+	 *  @return The algorithm that is used. */
+	Algorithm getAlgorithm() const;
+
+	/** Only calculate the eigenvalues and eigenvectors for eigenvalues in
+	 *  the interval (lowerBound, upperBound]. Requires the algorithm to
+	 *  be Algorithm::MRRR or Algorithm::LOBPCG. The bounds are typically
+	 *  set to the energy window of the PropertyExtractor. The eigenvalues
+	 *  and eigenvectors that are returned by the Diagonalizer are then
+	 *  only those inside the window.
+	 *
+	 *  @param lowerBound The lower bound of the energy window.
+	 *  @param upperBound The upper bound of the energy window. */
+	void setEigenValueWindow(double lowerBound, double upperBound);
+
+	/** Only calculate the eigenvalues and eigenvectors with index
+	 *  first <= n <= last, where the states are ordered in accending
+	 *  order. Requires the algorithm to be Algorithm::MRRR or
+	 *  Algorithm::LOBPCG.
+	 *
+	 *  @param first The index of the first state to calculate.
+	 *  @param last The index of the last state to calculate. */
+	void setEigenStateIndexRange(int first, int last);
+
+	/** Calculate all eigenvalues and eigenvectors. Undoes the effect of
+	 *  setEigenValueWindow() and setEigenStateIndexRange(). */
+	void setFullSpectrum();
+
+	/** Check whether all eigenvalues are calculated, or only those set by
+	 *  setEigenValueWindow() or setEigenStateIndexRange().
+	 *
+	 *  @return True if all eigenvalues are calculated. */
+	bool hasFullSpectrum() const;
+
+	/** Set the tolerance for Algorithm::LOBPCG. The iteration stops when
+	 *  the norm of the residual \f$H\Psi_n - E_n\Psi_n\f$ is smaller
+	 *  than the tolerance for every iterated state. For an energy window,
+	 *  the residual is that of the folded operator \f$(H - E_c)^2\f$,
+	 *  where \f$E_c\f$ is the center of the window.
+	 *
+	 *  @param lobpcgTolerance The tolerance. */
+	void setLOBPCGTolerance(double lobpcgTolerance);
+
+	/** Get the tolerance for Algorithm::LOBPCG.
+	 *
+	 *  @return The tolerance. */
+	double getLOBPCGTolerance() const;
+
+	/** Set the maximum number of iterations that Algorithm::LOBPCG
+	 *  performs in each call to solve.
+	 *
+	 *  @param lobpcgMaxIterations The maximum number of iterations. */
+	void setLOBPCGMaxIterations(int lobpcgMaxIterations);
+
+	/** Get the maximum number of iterations that Algorithm::LOBPCG
+	 *  performs in each call to solve.
+	 *
+	 *  @return The maximum number of iterations. */
+	int getLOBPCGMaxIterations() const;
+
+	/** Set the method used to handle non-orthonormal bases. Only used if
+	 *  the Model has an OverlapAmplitudeSet that does not assume an
+	 *  orthonormal basis.
+	 *
+	 *  @param nonOrthonormalBasisMethod The method to use. */
+	void setNonOrthonormalBasisMethod(
+		NonOrthonormalBasisMethod nonOrthonormalBasisMethod
+	);
+
+	/** Get the method used to handle non-orthonormal bases.
+	 *
+	 *  @return The method that is used. */
+	NonOrthonormalBasisMethod getNonOrthonormalBasisMethod() const;
+
+	/** Set which eigenvectors to calculate. Use setEigenVectorWindow() to
+	 *  only calculate the eigenvectors in an energy window.
+	 *
+	 *  @param eigenVectorMode EigenVectorMode::None or
+	 *  EigenVectorMode::All. */
+	void setEigenVectorMode(EigenVectorMode eigenVectorMode);
+
+	/** Get which eigenvectors that are calculated.
+	 *
+	 *  @return The EigenVectorMode. */
+	EigenVectorMode getEigenVectorMode() const;
+
+	/** Calculate all eigenvalues, but only the eigenvectors for
+	 *  eigenvalues in the interval (lowerBound, upperBound]. Sets the
+	 *  EigenVectorMode to EigenVectorMode::Window. Cannot be combined with
+	 *  setEigenValueWindow() or setEigenStateIndexRange().
+	 *
+	 *  @param lowerBound The lower bound of the energy window.
+	 *  @param upperBound The upper bound of the energy window. */
+	void setEigenVectorWindow(double lowerBound, double upperBound);
+
+	/** Check whether the eigenvector for a given state has been
+	 *  calculated.
+	 *
+	 *  @param state The state number.
+	 *
+	 *  @return True if the eigenvector has been calculated. */
+	bool hasEigenVector(int state) const;
+
 	/** Set SelfConsistencyCallback. If never called, the self-consistency
 	 *  loop will not be run.
 	 *
@@ -98,7 +276,9 @@ public:
 	 *  or maximum number of iterations has been reached. */
 	void run();
 
-	/** Get eigenvalues. Eigenvalues are ordered in accending order.
+	/** Get eigenvalues. Eigenvalues are ordered in accending order. If
+	 *  only part of the spectrum has been calculated, the size of the
+	 *  array is equal to the number of calculated eigenvalues.
 	 *
 	 *  @return A pointer to the internal storage for the eigenvalues. */
 	const CArray<double>& getEigenValues() const;
@@ -113,7 +293,9 @@ public:
 	 *  memory, with the eigenvector corresponding to the smallest
 	 *  eigenvalue occupying the 'basisSize' first positions, the second
 	 *  occupying the next 'basisSize' elements, and so forth, where
-	 *  'basisSize' is the basis size of the Model.
+	 *  'basisSize' is the basis size of the Model. If the EigenVectorMode
+	 *  is EigenVectorMode::Window, the first eigenvector is that of the
+	 *  first state inside the window.
 	 *
 	 *  @return A pointer to the internal storage for the eigenvectors. **/
 	const CArray<std::complex<double>>& getEigenVectors() const;
@@ -136,7 +318,9 @@ public:
 	const double getEigenValue(int state) const;
 
 	/** Get amplitude for given eigenvector \f$n\f$ and physical index
-	 * \f$x\f$: \f$\Psi_{n}(x)\f$.
+	 * \f$x\f$: \f$\Psi_{n}(x)\f$. The eigenvector must have been
+	 * calculated. This is not checked since the function is called in
+	 * tight loops. Use hasEigenVector() to check beforehand.
 	 *
 	 *  @param state Eigenstate number \f$n\f$.
 	 *  @param index Physical index \f$x\f$.
@@ -147,6 +331,43 @@ public:
 		const Index &index
 	) const;
 private:
+	/** Enum class for specifying which part of the spectrum to
+	 *  calculate. */
+	enum class SpectrumRange{All, EigenValueWindow, EigenStateIndexRange};
+
+	/** The algorithm used to diagonalize the Hamiltonian. */
+	Algorithm algorithm;
+
+	/** The part of the spectrum to calculate. */
+	SpectrumRange spectrumRange;
+
+	/** Lower bound of the eigenvalue window. */
+	double eigenValueWindowLowerBound;
+
+	/** Upper bound of the eigenvalue window. */
+	double eigenValueWindowUpperBound;
+
+	/** First state in the eigenstate index range. */
+	int firstEigenStateIndex;
+
+	/** Last state in the eigenstate index range. */
+	int lastEigenStateIndex;
+
+	/** Which eigenvectors to calculate. */
+	EigenVectorMode eigenVectorMode;
+
+	/** Lower bound of the eigenvector window. */
+	double eigenVectorWindowLowerBound;
+
+	/** Upper bound of the eigenvector window. */
+	double eigenVectorWindowUpperBound;
+
+	/** The state of the first calculated eigenvector. */
+	int firstEigenVectorState;
+
+	/** The number of calculated eigenvectors. */
+	int numEigenVectors;
+
 	/** pointer to array containing Hamiltonian. */
 	CArray<std::complex<double>> hamiltonian;
 
@@ -156,10 +377,29 @@ private:
 	/** Pointer to array containing eigenvectors. */
 	CArray<std::complex<double>> eigenVectors;
 
+	/** The method used to handle non-orthonormal bases. */
+	NonOrthonormalBasisMethod nonOrthonormalBasisMethod;
+
 	/** Pointer to array containing the basis transformation. Only used for
-	 *  non-orthonormal bases.*/
+	 *  non-orthonormal bases with
+	 *  NonOrthonormalBasisMethod::CanonicalOrthogonalization.*/
 	CArray<std::complex<double>> basisTransformation;
 
+	/** The states iterated by Algorithm::LOBPCG in the previous call to
+	 *  solve(). Used as starting point in the next call. */
+	Matrix<std::complex<double>> lobpcgSubspace;
+
+	/** Tolerance for Algorithm::LOBPCG. */
+	double lobpcgTolerance;
+
+	/** Maximum number of iterations for Algorithm::LOBPCG. */
+	int lobpcgMaxIterations;
+
+	/** Packed upper triangular Cholesky factor \f$U\f$ of the overlap
+	 *  matrix \f$S = U^{\dagger}U\f$. Only used for non-orthonormal bases
+	 *  with NonOrthonormalBasisMethod::Cholesky. */
+	CArray<std::complex<double>> overlapFactorization;
+
 	/** Maximum number of iterations in the self-consistency loop. */
 	int maxIterations;
 
@@ -176,6 +416,40 @@ private:
 	/** Diagonalizes the Hamiltonian. */
 	void solve();
 
+	/** Diagonalizes the Hamiltonian using zhpev.
+	 *
+	 *  @param calculateEigenVectors Whether to calculate eigenvectors. */
+	void solvePacked(bool calculateEigenVectors);
+
+	/** Diagonalizes the Hamiltonian using zheevd.
+	 *
+	 *  @param calculateEigenVectors Whether to calculate eigenvectors. */
+	void solveDivideAndConquer(bool calculateEigenVectors);
+
+	/** Diagonalizes the Hamiltonian using zheevr.
+	 *
+	 *  @param calculateEigenVectors Whether to calculate eigenvectors. */
+	void solveMRRR(bool calculateEigenVectors);
+
+	/** Calculates part of the spectrum using LOBPCG.
+	 *
+	 *  @param calculateEigenVectors Whether to store the eigenvectors. */
+	void solveLOBPCG(bool calculateEigenVectors);
+
+	/** Calculates all eigenvalues and the eigenvectors for the
+	 *  eigenvalues inside the eigenvector window. The packed Hamiltonian
+	 *  is reduced to tridiagonal form once, and only the eigenvectors
+	 *  inside the window are transformed back to the original basis. The
+	 *  Hamiltonian is destroyed on exit. */
+	void solveEigenVectorWindow();
+
+	/** Expands the packed upper triangular Hamiltonian to a full column
+	 *  major matrix with the upper triangle filled in.
+	 *
+	 *  @param matrix Array with space for basisSize*basisSize elements to
+	 *  write the result to. */
+	void expandHamiltonian(std::complex<double> *matrix) const;
+
 	/** Setup the basis transformation. */
 	void setupBasisTransformation();
 
@@ -186,6 +460,129 @@ private:
 	void transformToOriginalBasis();
 };
 
+inline void Diagonalizer::setAlgorithm(Algorithm algorithm){
+	this->algorithm = algorithm;
+}
+
+inline Diagonalizer::Algorithm Diagonalizer::getAlgorithm() const{
+	return algorithm;
+}
+
+inline void Diagonalizer::setEigenValueWindow(
+	double lowerBound,
+	double upperBound
+){
+	TBTKAssert(
+		lowerBound < upperBound,
+		"Solver::Diagonalizer::setEigenValueWindow()",
+		"The lower bound '" << lowerBound << "' must be smaller than"
+		<< " the upper bound '" << upperBound << "'.",
+		""
+	);
+	spectrumRange = SpectrumRange::EigenValueWindow;
+	eigenValueWindowLowerBound = lowerBound;
+	eigenValueWindowUpperBound = upperBound;
+}
+
+inline void Diagonalizer::setEigenStateIndexRange(int first, int last){
+	TBTKAssert(
+		first >= 0 && first <= last,
+		"Solver::Diagonalizer::setEigenStateIndexRange()",
+		"Invalid range [" << first << ", " << last << "].",
+		"The range must satisfy 0 <= first <= last."
+	);
+	spectrumRange = SpectrumRange::EigenStateIndexRange;
+	firstEigenStateIndex = first;
+	lastEigenStateIndex = last;
+}
+
+inline void Diagonalizer::setFullSpectrum(){
+	spectrumRange = SpectrumRange::All;
+}
+
+inline bool Diagonalizer::hasFullSpectrum() const{
+	return spectrumRange == SpectrumRange::All;
+}
+
+inline void Diagonalizer::setLOBPCGTolerance(double lobpcgTolerance){
+	TBTKAssert(
+		lobpcgTolerance > 0,
+		"Solver::Diagonalizer::setLOBPCGTolerance()",
+		"The tolerance must be positive, but '" << lobpcgTolerance
+		<< "' was given.",
+		""
+	);
+	this->lobpcgTolerance = lobpcgTolerance;
+}
+
+inline double Diagonalizer::getLOBPCGTolerance() const{
+	return lobpcgTolerance;
+}
+
+inline void Diagonalizer::setLOBPCGMaxIterations(int lobpcgMaxIterations){
+	TBTKAssert(
+		lobpcgMaxIterations > 0,
+		"Solver::Diagonalizer::setLOBPCGMaxIterations()",
+		"The maximum number of iterations must be positive, but '"
+		<< lobpcgMaxIterations << "' was given.",
+		""
+	);
+	this->lobpcgMaxIterations = lobpcgMaxIterations;
+}
+
+inline int Diagonalizer::getLOBPCGMaxIterations() const{
+	return lobpcgMaxIterations;
+}
+
+inline void Diagonalizer::setNonOrthonormalBasisMethod(
+	NonOrthonormalBasisMethod nonOrthonormalBasisMethod
+){
+	this->nonOrthonormalBasisMethod = nonOrthonormalBasisMethod;
+}
+
+inline Diagonalizer::NonOrthonormalBasisMethod
+Diagonalizer::getNonOrthonormalBasisMethod() const{
+	return nonOrthonormalBasisMethod;
+}
+
+inline void Diagonalizer::setEigenVectorMode(
+	EigenVectorMode eigenVectorMode
+){
+	TBTKAssert(
+		eigenVectorMode != EigenVectorMode::Window,
+		"Solver::Diagonalizer::setEigenVectorMode()",
+		"EigenVectorMode::Window cannot be set using this function.",
+		"Use Diagonalizer::setEigenVectorWindow() instead."
+	);
+	this->eigenVectorMode = eigenVectorMode;
+}
+
+inline Diagonalizer::EigenVectorMode Diagonalizer::getEigenVectorMode(
+) const{
+	return eigenVectorMode;
+}
+
+inline void Diagonalizer::setEigenVectorWindow(
+	double lowerBound,
+	double upperBound
+){
+	TBTKAssert(
+		lowerBound < upperBound,
+		"Solver::Diagonalizer::setEigenVectorWindow()",
+		"The lower bound '" << lowerBound << "' must be smaller than"
+		<< " the upper bound '" << upperBound << "'.",
+		""
+	);
+	eigenVectorMode = EigenVectorMode::Window;
+	eigenVectorWindowLowerBound = lowerBound;
+	eigenVectorWindowUpperBound = upperBound;
+}
+
+inline bool Diagonalizer::hasEigenVector(int state) const{
+	return state >= firstEigenVectorState
+		&& state < firstEigenVectorState + numEigenVectors;
+}
+
 inline void Diagonalizer::setSelfConsistencyCallback(
 	SelfConsistencyCallback &selfConsistencyCallback
 ){
@@ -217,7 +614,10 @@ inline const std::complex<double> Diagonalizer::getAmplitude(
 	const Index &index
 ) const{
 	const Model &model = getModel();
-	return eigenVectors[model.getBasisSize()*state + model.getBasisIndex(index)];
+	return eigenVectors[
+		model.getBasisSize()*(state - firstEigenVectorState)
+		+ model.getBasisIndex(index)
+	];
 }
 
 inline const double Diagonalizer::getEigenValue(int state) const{
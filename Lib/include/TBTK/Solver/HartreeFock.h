@@ -25,6 +25,7 @@
 #define COM_DAFER45_TBTK_HARTREE_FOCK_DIAGONALIZATION
 
 #include "TBTK/Atom.h"
+#include "TBTK/Mixer.h"
 #include "TBTK/Solver/Diagonalizer.h"
 
 namespace TBTK{
@@ -98,6 +99,21 @@ public:
 	 *  @param position The nucleus position. */
 	void addNuclearCenter(const Atom &atom, const Vector3d &position);
 
+	/** Set the Mixer that is used to mix the density matrix between
+	 *  iterations. The default Mixer uses linear mixing with mixing
+	 *  parameter one, which means that the density matrix calculated in
+	 *  one iteration is used as is in the next.
+	 *
+	 *  @param mixer The Mixer to use. */
+	void setMixer(const Mixer &mixer);
+
+	/** Get the Mixer that is used to mix the density matrix between
+	 *  iterations. Can be used to get a convergence report after the
+	 *  calculation has finished.
+	 *
+	 *  @return The Mixer. */
+	const Mixer& getMixer() const;
+
 	/** Run the calculation. */
 	void run();
 private:
@@ -125,6 +141,9 @@ private:
 	/** The density matrix. */
 	Matrix<std::complex<double>> densityMatrix;
 
+	/** Mixer used to mix the density matrix between iterations. */
+	Mixer mixer;
+
 	/** The nuclear centers. */
 	std::vector<PositionedAtom> nuclearCenters;
 
@@ -179,6 +198,14 @@ HartreeFock::getDensityMatrix() const{
 	return densityMatrix;
 }
 
+inline void HartreeFock::setMixer(const Mixer &mixer){
+	this->mixer = mixer;
+}
+
+inline const Mixer& HartreeFock::getMixer() const{
+	return mixer;
+}
+
 inline void HartreeFock::addNuclearCenter(
 	const Atom &atom,
 	const Vector3d &position
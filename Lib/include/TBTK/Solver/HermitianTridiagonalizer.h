@@ -0,0 +1,122 @@
+/* Copyright 2016 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file HermitianTridiagonalizer.h
+ *  @brief Calculates eigenvalues and selected eigenvectors of a packed
+ *  Hermitian matrix through reduction to tridiagonal form.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_SOLVER_HERMITIAN_TRIDIAGONALIZER
+#define COM_DAFER45_TBTK_SOLVER_HERMITIAN_TRIDIAGONALIZER
+
+#include <complex>
+
+namespace TBTK{
+namespace Solver{
+
+/** @brief Calculates eigenvalues and selected eigenvectors of a packed
+ *  Hermitian matrix through reduction to tridiagonal form.
+ *
+ *  Used internally by Diagonalizer and BlockDiagonalizer to calculate all
+ *  eigenvalues but only the eigenvectors in a window. The Hermitian matrix
+ *  H is stored as a packed upper triangular matrix and is first reduced to
+ *  the real symmetric tridiagonal matrix \f$T = Q^{\dagger}HQ\f$. The
+ *  eigenvalues and the selected eigenvectors of T are then calculated, and
+ *  the eigenvectors are transformed back to the original basis. */
+class HermitianTridiagonalizer{
+public:
+	/** Reduce a packed upper triangular Hermitian matrix to real
+	 *  symmetric tridiagonal form \f$T = Q^{\dagger}HQ\f$.
+	 *
+	 *  @param n The dimension of the matrix.
+	 *  @param matrix The packed matrix. Overwritten by the Householder
+	 *  reflectors that define Q.
+	 *  @param diagonal Output array of size n for the diagonal of T.
+	 *  @param offDiagonal Output array of size n for the off-diagonal of
+	 *  T.
+	 *  @param tau Output array of size max(1, n-1) for the scalar factors
+	 *  of the Householder reflectors. */
+	static void tridiagonalize(
+		int n,
+		std::complex<double> *matrix,
+		double *diagonal,
+		double *offDiagonal,
+		std::complex<double> *tau
+	);
+
+	/** Calculate all eigenvalues of a real symmetric tridiagonal matrix.
+	 *
+	 *  @param n The dimension of the matrix.
+	 *  @param diagonal The diagonal of the matrix.
+	 *  @param offDiagonal The off-diagonal of the matrix.
+	 *  @param eigenValues Output array of size n for the eigenvalues in
+	 *  ascending order. */
+	static void calculateEigenValues(
+		int n,
+		const double *diagonal,
+		const double *offDiagonal,
+		double *eigenValues
+	);
+
+	/** Calculate the eigenvectors of a real symmetric tridiagonal matrix
+	 *  for the eigenvalues with index first <= n <= last using bisection
+	 *  and inverse iteration. The eigenvectors are calculated by index
+	 *  rather than by value to ensure that they match the eigenvalues
+	 *  calculated by calculateEigenValues().
+	 *
+	 *  @param n The dimension of the matrix.
+	 *  @param diagonal The diagonal of the matrix.
+	 *  @param offDiagonal The off-diagonal of the matrix.
+	 *  @param first The index of the first eigenvector (zero-based).
+	 *  @param last The index of the last eigenvector (zero-based).
+	 *  @param eigenVectors Output array for the n x (last - first + 1)
+	 *  column major matrix that contains the eigenvectors in ascending
+	 *  order of their eigenvalues. */
+	static void calculateEigenVectors(
+		int n,
+		double *diagonal,
+		double *offDiagonal,
+		int first,
+		int last,
+		std::complex<double> *eigenVectors
+	);
+
+	/** Transform eigenvectors of T back to the basis of the original
+	 *  matrix by multiplying them by Q.
+	 *
+	 *  @param n The dimension of the matrix.
+	 *  @param numEigenVectors The number of eigenvectors.
+	 *  @param matrix The Householder reflectors returned by
+	 *  tridiagonalize().
+	 *  @param tau The scalar factors returned by tridiagonalize().
+	 *  @param eigenVectors The n x numEigenVectors column major matrix
+	 *  containing the eigenvectors. Overwritten by the transformed
+	 *  eigenvectors. */
+	static void transformEigenVectors(
+		int n,
+		int numEigenVectors,
+		std::complex<double> *matrix,
+		std::complex<double> *tau,
+		std::complex<double> *eigenVectors
+	);
+};
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
+
+#endif
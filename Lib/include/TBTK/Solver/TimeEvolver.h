@@ -26,6 +26,7 @@
 
 #include "TBTK/Solver/Diagonalizer.h"
 #include "TBTK/Model.h"
+#include "TBTK/SparseMatrix.h"
 #include "TBTK/UnitHandler.h"
 
 #include <complex>
@@ -137,6 +138,34 @@ public:
 
 	/** Get orthogonalityError. */
 	double getOrthogonalityError();
+
+	/** Propagation methods:
+	 *	Euler - First order explicit Euler step
+	 *		\f$|\Psi\rangle \rightarrow (1 - iH\Delta t/\hbar)|\Psi\rangle\f$
+	 *		followed by normalization. Requires a small time step
+	 *		to remain accurate.<br/>
+	 *	Chebyshev - Applies \f$e^{-iH\Delta t/\hbar}\f$ using a
+	 *		Chebyshev expansion with Bessel function
+	 *		coefficients. The number of terms is chosen such that
+	 *		the propagator is unitary to machine precision, which
+	 *		allows for time steps that are orders of magnitude
+	 *		larger than for the Euler method. When the decay mode is
+	 *		DecayMode::None, only the occupied states are
+	 *		propagated. The energies of the unoccupied states are
+	 *		the expectation values of the current Hamiltonian.
+	 */
+	enum class PropagationMethod{Euler, Chebyshev};
+
+	/** Set the propagation method. The default value is
+	 *  PropagationMethod::Euler.
+	 *
+	 *  @param propagationMethod The propagation method. */
+	void setPropagationMethod(PropagationMethod propagationMethod);
+
+	/** Get the propagation method.
+	 *
+	 *  @return The propagation method. */
+	PropagationMethod getPropagationMethod() const;
 private:
 	/** Diagonalizer which is used to find the ground state, and which also
 	 *  acts as a container for the eigenvectors and energies during the
@@ -235,6 +264,28 @@ private:
 
 	/** Calculate orthogonality error. */
 	void calculateOrthogonalityError();
+
+	/** Propagation method. */
+	PropagationMethod propagationMethod;
+
+	/** Take a time step using the Euler method.
+	 *
+	 *  @param hamiltonian The Hamiltonian on CSR format.
+	 *  @param timeStep The time step multiplied by 1/hbar. */
+	void stepEuler(
+		const SparseMatrix<std::complex<double>> &hamiltonian,
+		double timeStep
+	);
+
+	/** Take a time step using the Chebyshev propagator. Also updates the
+	 *  energies of the propagated states.
+	 *
+	 *  @param hamiltonian The Hamiltonian on CSR format.
+	 *  @param timeStep The time step multiplied by 1/hbar. */
+	void stepChebyshev(
+		const SparseMatrix<std::complex<double>> &hamiltonian,
+		double timeStep
+	);
 };
 
 inline void TimeEvolver::setCallback(
@@ -308,6 +359,17 @@ inline double TimeEvolver::getOrthogonalityError(){
 	return orthogonalityError;
 }
 
+inline void TimeEvolver::setPropagationMethod(
+	PropagationMethod propagationMethod
+){
+	this->propagationMethod = propagationMethod;
+}
+
+inline TimeEvolver::PropagationMethod TimeEvolver::getPropagationMethod(
+) const{
+	return propagationMethod;
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
 
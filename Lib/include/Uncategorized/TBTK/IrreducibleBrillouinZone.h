@@ -0,0 +1,226 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file IrreducibleBrillouinZone.h
+ *  @brief Reduction of a k-mesh to the irreducible Brillouin zone.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_IRREDUCIBLE_BRILLOUIN_ZONE
+#define COM_DAFER45_TBTK_IRREDUCIBLE_BRILLOUIN_ZONE
+
+#include "TBTK/BrillouinZone.h"
+#include "TBTK/Index.h"
+#include "TBTK/SymmetryOperation.h"
+
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Reduction of a k-mesh to the irreducible Brillouin zone.
+ *
+ *  The IrreducibleBrillouinZone divides the mesh points of a BrillouinZone
+ *  into stars of points that are related by symmetry. One point in each star
+ *  is chosen as the irreducible mesh point, and the remaining points are
+ *  obtained from it by one of the @link SymmetryOperation
+ *  SymmetryOperations@endlink. Only the irreducible mesh points need to be
+ *  solved, which for the full point group of a square or hexagonal lattice
+ *  reduces the work by a factor close to eight or twelve.
+ *
+ *  The SymmetryOperations do not need to form a group. The group that they
+ *  generate is constructed automatically, and the identity is always
+ *  included. Every operation in the group must map the mesh onto itself.
+ *
+ *  Mesh points are identified by the Index \f$\{m_0, m_1, ...\}\f$, with
+ *  \f$0 \leq m_i < N_i\f$. For a SpacePartition::MeshType::Nodal mesh,
+ *  this corresponds to the k-vector \f$\sum_i m_i\mathbf{b}_i/N_i\f$,
+ *  while for a SpacePartition::MeshType::Interior mesh it corresponds to
+ *  the k-vector \f$\sum_i (m_i + 1/2)\mathbf{b}_i/N_i\f$ at the center of
+ *  the mesh cell. In both cases, this is the Index returned by
+ *  BrillouinZone::getMinorCellIndex() for the k-vector.
+ *
+ *  Sums over the full mesh can be calculated as sums over the irreducible
+ *  mesh points, with each term multiplied by the weight of the point. Use
+ *  Solver::BlockDiagonalizer::setIrreducibleBrillouinZone() to only
+ *  diagonalize the blocks at the irreducible mesh points.
+ *
+ *  # Example
+ *  ```cpp
+ *    IrreducibleBrillouinZone irreducibleBrillouinZone(
+ *      brillouinZone,
+ *      {SIZE_K, SIZE_K},
+ *      {c4, mirror}
+ *    );
+ *    solver.setIrreducibleBrillouinZone(irreducibleBrillouinZone);
+ *  ``` */
+class IrreducibleBrillouinZone{
+public:
+	/** Constructor.
+	 *
+	 *  @param brillouinZone The BrillouinZone.
+	 *  @param numMeshPoints The number of mesh points along each of the
+	 *  reciprocal basis vectors.
+	 *  @param symmetryOperations SymmetryOperations that generate the
+	 *  symmetry group. */
+	IrreducibleBrillouinZone(
+		const BrillouinZone &brillouinZone,
+		const std::vector<unsigned int> &numMeshPoints,
+		const std::vector<SymmetryOperation> &symmetryOperations
+	);
+
+	/** Get the number of dimensions.
+	 *
+	 *  @return The number of dimensions of the BrillouinZone. */
+	unsigned int getNumDimensions() const;
+
+	/** Get the number of mesh points.
+	 *
+	 *  @return The number of mesh points along each of the reciprocal
+	 *  basis vectors. */
+	const std::vector<unsigned int>& getNumMeshPoints() const;
+
+	/** Get the symmetry group generated by the SymmetryOperations. The
+	 *  first element is the identity.
+	 *
+	 *  @return The SymmetryOperations in the symmetry group. */
+	const std::vector<SymmetryOperation>& getSymmetryGroup() const;
+
+	/** Get the irreducible mesh points.
+	 *
+	 *  @return The @link Index Indices@endlink of the irreducible mesh
+	 *  points. */
+	const std::vector<Index>& getIrreducibleMeshPoints() const;
+
+	/** Get the irreducible mesh point that a given mesh point is
+	 *  equivalent to.
+	 *
+	 *  @param meshPoint The Index of a mesh point.
+	 *
+	 *  @return The Index of the irreducible mesh point in the same star.
+	 */
+	const Index& getIrreducibleMeshPoint(const Index &meshPoint) const;
+
+	/** Check whether a mesh point is irreducible.
+	 *
+	 *  @param meshPoint The Index of a mesh point.
+	 *
+	 *  @return True if the mesh point is irreducible. */
+	bool isIrreducible(const Index &meshPoint) const;
+
+	/** Get the SymmetryOperation that maps the irreducible mesh point in
+	 *  the same star to the given mesh point.
+	 *
+	 *  @param meshPoint The Index of a mesh point.
+	 *
+	 *  @return The SymmetryOperation that maps the irreducible mesh point
+	 *  to the given mesh point. */
+	const SymmetryOperation& getSymmetryOperation(
+		const Index &meshPoint
+	) const;
+
+	/** Get the weight of a mesh point.
+	 *
+	 *  @param meshPoint The Index of a mesh point.
+	 *
+	 *  @return The number of mesh points in the star of the given mesh
+	 *  point divided by the total number of mesh points. The weights of
+	 *  the irreducible mesh points sum up to one. */
+	double getWeight(const Index &meshPoint) const;
+private:
+	/** The number of mesh points along each reciprocal basis vector. */
+	std::vector<unsigned int> numMeshPoints;
+
+	/** The symmetry group. */
+	std::vector<SymmetryOperation> symmetryGroup;
+
+	/** The irreducible mesh points. */
+	std::vector<Index> irreducibleMeshPoints;
+
+	/** The irreducible mesh point that each mesh point is equivalent to,
+	 *  stored as an index into irreducibleMeshPoints. */
+	std::vector<unsigned int> stars;
+
+	/** The SymmetryOperation that maps the irreducible mesh point to
+	 *  each mesh point, stored as an index into symmetryGroup. */
+	std::vector<unsigned int> symmetryOperations;
+
+	/** The number of mesh points in each star. */
+	std::vector<unsigned int> starSizes;
+
+	/** Generate the symmetry group.
+	 *
+	 *  @param generators The SymmetryOperations that generate the group.
+	 */
+	void generateSymmetryGroup(
+		const std::vector<SymmetryOperation> &generators
+	);
+
+	/** Get the linear index of a mesh point.
+	 *
+	 *  @param meshPoint The Index of a mesh point.
+	 *
+	 *  @return The linear index of the mesh point. */
+	unsigned int getLinearIndex(const Index &meshPoint) const;
+};
+
+inline unsigned int IrreducibleBrillouinZone::getNumDimensions() const{
+	return numMeshPoints.size();
+}
+
+inline const std::vector<unsigned int>&
+IrreducibleBrillouinZone::getNumMeshPoints() const{
+	return numMeshPoints;
+}
+
+inline const std::vector<SymmetryOperation>&
+IrreducibleBrillouinZone::getSymmetryGroup() const{
+	return symmetryGroup;
+}
+
+inline const std::vector<Index>&
+IrreducibleBrillouinZone::getIrreducibleMeshPoints() const{
+	return irreducibleMeshPoints;
+}
+
+inline const Index& IrreducibleBrillouinZone::getIrreducibleMeshPoint(
+	const Index &meshPoint
+) const{
+	return irreducibleMeshPoints[stars[getLinearIndex(meshPoint)]];
+}
+
+inline bool IrreducibleBrillouinZone::isIrreducible(
+	const Index &meshPoint
+) const{
+	return symmetryOperations[getLinearIndex(meshPoint)] == 0;
+}
+
+inline const SymmetryOperation& IrreducibleBrillouinZone::getSymmetryOperation(
+	const Index &meshPoint
+) const{
+	return symmetryGroup[symmetryOperations[getLinearIndex(meshPoint)]];
+}
+
+inline double IrreducibleBrillouinZone::getWeight(
+	const Index &meshPoint
+) const{
+	return starSizes[stars[getLinearIndex(meshPoint)]]
+		/(double)stars.size();
+}
+
+};	//End of namespace TBTK
+
+#endif
@@ -96,8 +96,10 @@ public:
 		const std::vector<unsigned int> &meshPoint,
 		const std::vector<unsigned int> &numMeshPoints
 	) const = 0;
-protected:
-	/** Get basis vectors. */
+
+	/** Get basis vectors. For lower dimensions than three, the basis
+	 *  vectors are padded with zeros and completed with unit vectors
+	 *  along the remaining directions. */
 	const std::vector<Vector3d>& getBasisVectors() const;
 
 	/** Get mesh type. */
@@ -0,0 +1,176 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file SymmetryOperation.h
+ *  @brief Symmetry operation acting on momentum space.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_SYMMETRY_OPERATION
+#define COM_DAFER45_TBTK_SYMMETRY_OPERATION
+
+#include "TBTK/Matrix.h"
+
+#include <complex>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Symmetry operation acting on momentum space.
+ *
+ *  A SymmetryOperation consists of a matrix \f$R\f$ that maps a k-vector
+ *  \f$\mathbf{k}\f$ to \f$R\mathbf{k}\f$, and a unitary matrix \f$U\f$ that
+ *  describes how the operation acts on the orbitals at each k-point. The
+ *  Hamiltonian is symmetric under the operation if
+ *  \f[
+ *    H(R\mathbf{k}) = UH(\mathbf{k})U^{\dagger}.
+ *  \f]
+ *  An eigenvector \f$\psi\f$ of \f$H(\mathbf{k})\f$ is then mapped to the
+ *  eigenvector \f$U\psi\f$ of \f$H(R\mathbf{k})\f$ with the same eigenvalue.
+ *
+ *  Anti-unitary operations, such as time reversal, instead satisfy
+ *  \f[
+ *    H(R\mathbf{k}) = UH(\mathbf{k})^{*}U^{\dagger}
+ *  \f]
+ *  and map \f$\psi\f$ to \f$U\psi^{*}\f$. For spinless time reversal, \f$R\f$
+ *  is minus the identity and \f$U\f$ is the identity.
+ *
+ *  The matrix \f$R\f$ is given in Cartesian coordinates and acts on the
+ *  k-vectors returned by BrillouinZone::getMinorMeshPoint(). The matrix
+ *  \f$U\f$ acts on the states of a block in the order of their intra-block
+ *  @link Index Indices@endlink.
+ *
+ *  # Example
+ *  ```cpp
+ *    //Four-fold rotation of a square lattice with a single orbital.
+ *    Matrix<std::complex<double>> U(1, 1);
+ *    U.at(0, 0) = 1;
+ *    SymmetryOperation c4({{0, -1}, {1, 0}}, U);
+ *  ``` */
+class SymmetryOperation{
+public:
+	/** Constructor.
+	 *
+	 *  @param rotation The matrix \f$R\f$ that acts on the k-vectors.
+	 *  Given as a list of rows.
+	 *  @param orbitalRepresentation The unitary matrix \f$U\f$ that acts
+	 *  on the states at each k-point.
+	 *  @param isAntiUnitary True if the operation is anti-unitary. */
+	SymmetryOperation(
+		const std::vector<std::vector<double>> &rotation,
+		const Matrix<std::complex<double>> &orbitalRepresentation,
+		bool isAntiUnitary = false
+	);
+
+	/** Create the identity operation.
+	 *
+	 *  @param numDimensions The dimension of the k-space.
+	 *  @param numOrbitals The number of states at each k-point.
+	 *
+	 *  @return The identity operation. */
+	static SymmetryOperation createIdentity(
+		unsigned int numDimensions,
+		unsigned int numOrbitals
+	);
+
+	/** Get the number of dimensions of the k-space.
+	 *
+	 *  @return The number of rows in \f$R\f$. */
+	unsigned int getNumDimensions() const;
+
+	/** Get the number of states at each k-point.
+	 *
+	 *  @return The number of rows in \f$U\f$. */
+	unsigned int getNumOrbitals() const;
+
+	/** Get the matrix \f$R\f$ that acts on the k-vectors.
+	 *
+	 *  @return The matrix \f$R\f$ as a list of rows. */
+	const std::vector<std::vector<double>>& getRotation() const;
+
+	/** Get the matrix \f$U\f$ that acts on the states at each k-point.
+	 *
+	 *  @return The matrix \f$U\f$. */
+	const Matrix<std::complex<double>>& getOrbitalRepresentation() const;
+
+	/** Check whether the operation is anti-unitary.
+	 *
+	 *  @return True if the operation is anti-unitary. */
+	bool isAntiUnitary() const;
+
+	/** Apply the operation to a k-vector.
+	 *
+	 *  @param k The k-vector \f$\mathbf{k}\f$.
+	 *
+	 *  @return The k-vector \f$R\mathbf{k}\f$. */
+	std::vector<double> apply(const std::vector<double> &k) const;
+
+	/** Compose two operations. The right hand side is applied first.
+	 *
+	 *  @param rhs The operation to apply first.
+	 *
+	 *  @return The composed operation. */
+	SymmetryOperation operator*(const SymmetryOperation &rhs) const;
+
+	/** Check whether two operations act in the same way on the k-vectors.
+	 *  The orbital representations are not compared.
+	 *
+	 *  @param symmetryOperation The operation to compare with.
+	 *  @param tolerance The largest allowed difference between two
+	 *  elements of \f$R\f$.
+	 *
+	 *  @return True if \f$R\f$ and the anti-unitarity agree. */
+	bool hasSameAction(
+		const SymmetryOperation &symmetryOperation,
+		double tolerance = 1e-10
+	) const;
+private:
+	/** The matrix that acts on the k-vectors. */
+	std::vector<std::vector<double>> rotation;
+
+	/** The matrix that acts on the states at each k-point. */
+	Matrix<std::complex<double>> orbitalRepresentation;
+
+	/** Flag indicating whether the operation is anti-unitary. */
+	bool antiUnitary;
+};
+
+inline unsigned int SymmetryOperation::getNumDimensions() const{
+	return rotation.size();
+}
+
+inline unsigned int SymmetryOperation::getNumOrbitals() const{
+	return orbitalRepresentation.getNumRows();
+}
+
+inline const std::vector<std::vector<double>>&
+SymmetryOperation::getRotation() const{
+	return rotation;
+}
+
+inline const Matrix<std::complex<double>>&
+SymmetryOperation::getOrbitalRepresentation() const{
+	return orbitalRepresentation;
+}
+
+inline bool SymmetryOperation::isAntiUnitary() const{
+	return antiUnitary;
+}
+
+};	//End of namespace TBTK
+
+#endif
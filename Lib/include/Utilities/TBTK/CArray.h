@@ -159,6 +159,7 @@ private:
 
 template<typename DataType>
 CArray<DataType>::CArray(){
+	size = 0;
 	data = nullptr;
 }
 
@@ -25,7 +25,9 @@
 
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
 #include <complex>
+#include <vector>
 
 namespace TBTK{
 
@@ -110,6 +112,40 @@ public:
 	const Matrix<DataType, 0, 0> operator*(
 		const Matrix<DataType, 0, 0> &rhs
 	) const;
+
+	/** Calculates alpha*lhs*rhs + beta*this and stores the result in
+	 *  the matrix. If beta is zero, the matrix is resized to fit the
+	 *  result and its previous content is ignored. Otherwise the matrix
+	 *  must already have the dimensions of the product. The matrix cannot
+	 *  be one of the factors. For double precision matrices the product
+	 *  is calculated using BLAS.
+	 *
+	 *  @param lhs The left hand side factor.
+	 *  @param rhs The right hand side factor.
+	 *  @param alpha Factor multiplying the product.
+	 *  @param beta Factor multiplying the current content. */
+	void multiply(
+		const Matrix<DataType, 0, 0> &lhs,
+		const Matrix<DataType, 0, 0> &rhs,
+		DataType alpha = 1,
+		DataType beta = 0
+	);
+
+	/** Same as multiply(), but calculates
+	 *  alpha*lhs^{\dagger}*rhs + beta*this without forming the adjoint of
+	 *  lhs. For real data types, the adjoint is the transpose.
+	 *
+	 *  @param lhs The left hand side factor, which is conjugate
+	 *  transposed.
+	 *  @param rhs The right hand side factor.
+	 *  @param alpha Factor multiplying the product.
+	 *  @param beta Factor multiplying the current content. */
+	void adjointMultiply(
+		const Matrix<DataType, 0, 0> &lhs,
+		const Matrix<DataType, 0, 0> &rhs,
+		DataType alpha = 1,
+		DataType beta = 0
+	);
 private:
 	/** Data. */
 	DataType *data;
@@ -119,6 +155,17 @@ private:
 
 	/** Number of columns. */
 	unsigned int cols;
+
+	/** Resize the matrix if it does not have the given dimensions. */
+	void resize(unsigned int rows, unsigned int cols);
+
+	/** Complex conjugate for real data types. */
+	template<typename Type>
+	static Type conjugate(const Type &value);
+
+	/** Complex conjugate for complex data types. */
+	template<typename Type>
+	static std::complex<Type> conjugate(const std::complex<Type> &value);
 };
 
 template<>
@@ -169,11 +216,57 @@ public:
 		const Matrix<std::complex<double>, 0, 0> &rhs
 	) const;
 
+	/** Calculates alpha*lhs*rhs + beta*this using BLAS and stores the
+	 *  result in the matrix. If beta is zero, the matrix is resized to fit
+	 *  the result and its previous content is ignored. Otherwise the
+	 *  matrix must already have the dimensions of the product. The matrix
+	 *  cannot be one of the factors.
+	 *
+	 *  @param lhs The left hand side factor.
+	 *  @param rhs The right hand side factor.
+	 *  @param alpha Factor multiplying the product.
+	 *  @param beta Factor multiplying the current content. */
+	void multiply(
+		const Matrix<std::complex<double>, 0, 0> &lhs,
+		const Matrix<std::complex<double>, 0, 0> &rhs,
+		std::complex<double> alpha = 1,
+		std::complex<double> beta = 0
+	);
+
+	/** Same as multiply(), but calculates
+	 *  alpha*lhs^{\dagger}*rhs + beta*this without forming the adjoint of
+	 *  lhs.
+	 *
+	 *  @param lhs The left hand side factor, which is conjugate
+	 *  transposed.
+	 *  @param rhs The right hand side factor.
+	 *  @param alpha Factor multiplying the product.
+	 *  @param beta Factor multiplying the current content. */
+	void adjointMultiply(
+		const Matrix<std::complex<double>, 0, 0> &lhs,
+		const Matrix<std::complex<double>, 0, 0> &rhs,
+		std::complex<double> alpha = 1,
+		std::complex<double> beta = 0
+	);
+
 	/** Invert. */
 	void invert();
 
 	/** Determinant. */
 	std::complex<double> determinant();
+
+	/** Diagonalize the matrix, which is assumed to be Hermitian. Only the
+	 *  upper triangular part of the matrix is accessed.
+	 *
+	 *  @param eigenValues Vector that the eigenvalues are written to in
+	 *  ascending order.
+	 *  @param eigenVectors Matrix that the eigenvectors are written to,
+	 *  with the nth column being the eigenvector corresponding to the nth
+	 *  eigenvalue. */
+	void diagonalizeHermitian(
+		std::vector<double> &eigenValues,
+		Matrix<std::complex<double>, 0, 0> &eigenVectors
+	) const;
 private:
 	/** Data. */
 	std::complex<double> *data;
@@ -183,6 +276,9 @@ private:
 
 	/** Number of columns. */
 	unsigned int cols;
+
+	/** Resize the matrix if it does not have the given dimensions. */
+	void resize(unsigned int rows, unsigned int cols);
 };
 
 template<typename DataType, unsigned int ROWS, unsigned int COLS>
@@ -204,6 +300,8 @@ Matrix<DataType, ROWS, COLS>::Matrix(Matrix<DataType, ROWS, COLS> &&matrix){
 template<typename DataType>
 Matrix<DataType, 0, 0>::Matrix(){
 	data = nullptr;
+	rows = 0;
+	cols = 0;
 }
 
 template<typename DataType>
@@ -232,6 +330,8 @@ Matrix<DataType, 0, 0>::Matrix(Matrix<DataType, 0, 0> &&matrix){
 
 inline Matrix<std::complex<double>, 0, 0>::Matrix(){
 	data = nullptr;
+	rows = 0;
+	cols = 0;
 }
 
 inline Matrix<std::complex<double>, 0, 0>::Matrix(unsigned int rows, unsigned int cols){
@@ -444,6 +544,165 @@ inline unsigned int Matrix<std::complex<double>, 0, 0>::getNumCols() const{
 	return cols;
 }
 
+template<typename DataType>
+inline void Matrix<DataType, 0, 0>::resize(
+	unsigned int rows,
+	unsigned int cols
+){
+	if(data != nullptr && this->rows == rows && this->cols == cols)
+		return;
+
+	if(data != nullptr)
+		delete [] data;
+
+	this->rows = rows;
+	this->cols = cols;
+	data = new DataType[rows*cols];
+}
+
+inline void Matrix<std::complex<double>, 0, 0>::resize(
+	unsigned int rows,
+	unsigned int cols
+){
+	if(data != nullptr && this->rows == rows && this->cols == cols)
+		return;
+
+	if(data != nullptr)
+		delete [] data;
+
+	this->rows = rows;
+	this->cols = cols;
+	data = new std::complex<double>[rows*cols];
+}
+
+template<typename DataType>
+inline void Matrix<DataType, 0, 0>::multiply(
+	const Matrix<DataType, 0, 0> &lhs,
+	const Matrix<DataType, 0, 0> &rhs,
+	DataType alpha,
+	DataType beta
+){
+	TBTKAssert(
+		lhs.cols == rhs.rows,
+		"Matrix::multiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.rows << "x" << lhs.cols
+		<< " and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::multiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == DataType(0)){
+		resize(lhs.rows, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.rows && cols == rhs.cols,
+			"Matrix::multiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.rows << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+
+	for(unsigned int row = 0; row < rows; row++){
+		for(unsigned int col = 0; col < cols; col++){
+			DataType product = 0;
+			for(unsigned int n = 0; n < lhs.cols; n++)
+				product += lhs.at(row, n)*rhs.at(n, col);
+
+			if(beta == DataType(0))
+				at(row, col) = alpha*product;
+			else
+				at(row, col) = alpha*product + beta*at(row, col);
+		}
+	}
+}
+
+template<typename DataType>
+inline void Matrix<DataType, 0, 0>::adjointMultiply(
+	const Matrix<DataType, 0, 0> &lhs,
+	const Matrix<DataType, 0, 0> &rhs,
+	DataType alpha,
+	DataType beta
+){
+	TBTKAssert(
+		lhs.rows == rhs.rows,
+		"Matrix::adjointMultiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.cols << "x" << lhs.rows
+		<< " (adjoint) and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::adjointMultiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == DataType(0)){
+		resize(lhs.cols, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.cols && cols == rhs.cols,
+			"Matrix::adjointMultiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.cols << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+
+	for(unsigned int row = 0; row < rows; row++){
+		for(unsigned int col = 0; col < cols; col++){
+			DataType product = 0;
+			for(unsigned int n = 0; n < lhs.rows; n++)
+				product += conjugate(lhs.at(n, row))*rhs.at(n, col);
+
+			if(beta == DataType(0))
+				at(row, col) = alpha*product;
+			else
+				at(row, col) = alpha*product + beta*at(row, col);
+		}
+	}
+}
+
+template<typename DataType>
+template<typename Type>
+inline Type Matrix<DataType, 0, 0>::conjugate(const Type &value){
+	return value;
+}
+
+template<typename DataType>
+template<typename Type>
+inline std::complex<Type> Matrix<DataType, 0, 0>::conjugate(
+	const std::complex<Type> &value
+){
+	return std::conj(value);
+}
+
+template<>
+void Matrix<double, 0, 0>::multiply(
+	const Matrix<double, 0, 0> &lhs,
+	const Matrix<double, 0, 0> &rhs,
+	double alpha,
+	double beta
+);
+
+template<>
+void Matrix<double, 0, 0>::adjointMultiply(
+	const Matrix<double, 0, 0> &lhs,
+	const Matrix<double, 0, 0> &rhs,
+	double alpha,
+	double beta
+);
+
 template<typename DataType>
 inline const Matrix<DataType, 0, 0> Matrix<DataType, 0, 0>::operator*(
 	const Matrix<DataType, 0, 0> &rhs
@@ -456,17 +715,8 @@ inline const Matrix<DataType, 0, 0> Matrix<DataType, 0, 0>::operator*(
 		<< rhs.rows << "x" << rhs.cols << "\n"
 	);
 
-	Matrix<DataType> result(rows, rhs.cols);
-	for(unsigned int row = 0; row < rows; row++){
-		for(unsigned int col = 0; col < rhs.cols; col++){
-			result.at(row, col) = 0.;
-
-			for(unsigned int n = 0; n < cols; n++){
-				result.at(row, col)
-					+= at(row, n)*rhs.at(n, col);
-			}
-		}
-	}
+	Matrix<DataType> result;
+	result.multiply(*this, rhs);
 
 	return result;
 }
@@ -482,17 +732,8 @@ inline const Matrix<std::complex<double>, 0, 0> Matrix<std::complex<double>, 0,
 		<< rhs.rows << "x" << rhs.cols << "\n"
 	);
 
-	Matrix<std::complex<double>> result(rows, rhs.cols);
-	for(unsigned int row = 0; row < rows; row++){
-		for(unsigned int col = 0; col < rhs.cols; col++){
-			result.at(row, col) = 0.;
-
-			for(unsigned int n = 0; n < cols; n++){
-				result.at(row, col)
-					+= at(row, n)*rhs.at(n, col);
-			}
-		}
-	}
+	Matrix<std::complex<double>> result;
+	result.multiply(*this, rhs);
 
 	return result;
 }
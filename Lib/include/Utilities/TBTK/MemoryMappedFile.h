@@ -0,0 +1,134 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file MemoryMappedFile.h
+ *  @brief Scratch file that is mapped into memory.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_MEMORY_MAPPED_FILE
+#define COM_DAFER45_TBTK_MEMORY_MAPPED_FILE
+
+#include <cstddef>
+#include <string>
+
+namespace TBTK{
+
+/** @brief Scratch file that is mapped into memory.
+ *
+ *  The MemoryMappedFile creates a file of a given size and maps it into
+ *  memory. The memory can be used as an ordinary array, but is backed by
+ *  the file rather than by RAM. The operating system pages the parts of the
+ *  file that are accessed in and out of memory on demand, which makes it
+ *  possible to work with arrays that are larger than the available RAM as
+ *  long as only a small part of the array is used at a time.
+ *
+ *  The file is a scratch file. Any existing file with the same name is
+ *  overwritten and the file is removed when the MemoryMappedFile is
+ *  destroyed.
+ *
+ *  # Example
+ *  ```cpp
+ *    MemoryMappedFile file("Scratch.bin", size*sizeof(double));
+ *    double *data = static_cast<double*>(file.getData());
+ *  ``` */
+class MemoryMappedFile{
+public:
+	/** Constructs an empty MemoryMappedFile. */
+	MemoryMappedFile();
+
+	/** Constructor. Creates the file and maps it into memory.
+	 *
+	 *  @param filename The name of the file.
+	 *  @param size The size of the file in bytes. */
+	MemoryMappedFile(const std::string &filename, size_t size);
+
+	/** Copy constructor. Deleted since the file cannot be shared. */
+	MemoryMappedFile(const MemoryMappedFile &memoryMappedFile) = delete;
+
+	/** Move constructor.
+	 *
+	 *  @param memoryMappedFile MemoryMappedFile to move from. */
+	MemoryMappedFile(MemoryMappedFile &&memoryMappedFile);
+
+	/** Destructor. Unmaps and removes the file. */
+	~MemoryMappedFile();
+
+	/** Assignment operator. Deleted since the file cannot be shared. */
+	MemoryMappedFile& operator=(
+		const MemoryMappedFile &memoryMappedFile
+	) = delete;
+
+	/** Move assignment operator.
+	 *
+	 *  @param memoryMappedFile MemoryMappedFile to move from.
+	 *
+	 *  @return The left hand side after assignment. */
+	MemoryMappedFile& operator=(MemoryMappedFile &&memoryMappedFile);
+
+	/** Get the mapped memory.
+	 *
+	 *  @return Pointer to the mapped memory. */
+	void* getData();
+
+	/** Get the mapped memory.
+	 *
+	 *  @return Pointer to the mapped memory. */
+	const void* getData() const;
+
+	/** Get the size of the file.
+	 *
+	 *  @return The size of the file in bytes. */
+	size_t getSize() const;
+
+	/** Get the name of the file.
+	 *
+	 *  @return The name of the file. */
+	const std::string& getFilename() const;
+private:
+	/** The name of the file. */
+	std::string filename;
+
+	/** The size of the file in bytes. */
+	size_t size;
+
+	/** The mapped memory. */
+	void *data;
+
+	/** Unmaps and removes the file. */
+	void release();
+};
+
+inline void* MemoryMappedFile::getData(){
+	return data;
+}
+
+inline const void* MemoryMappedFile::getData() const{
+	return data;
+}
+
+inline size_t MemoryMappedFile::getSize() const{
+	return size;
+}
+
+inline const std::string& MemoryMappedFile::getFilename() const{
+	return filename;
+}
+
+};	//End of namespace TBTK
+
+#endif
@@ -0,0 +1,328 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file Mixer.h
+ *  @brief Mixes order parameters in self-consistent calculations.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_MIXER
+#define COM_DAFER45_TBTK_MIXER
+
+#include "TBTK/Streamable.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <complex>
+#include <string>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Mixes order parameters in self-consistent calculations.
+ *
+ *  A self-consistent calculation produces an output order parameter from
+ *  an input order parameter. The Mixer uses the current and previous
+ *  input/output pairs to decide which order parameter to use as input in
+ *  the next iteration. It works on an order parameter of any size that the
+ *  user stores in a std::vector<std::complex<double>>. The Mixer does not
+ *  depend on which solver is used and can be called from the
+ *  self-consistency callback of for example Solver::Diagonalizer,
+ *  Solver::BlockDiagonalizer, or a loop around Solver::ChebyshevExpander.
+ *
+ *  # Methods
+ *  With residual F = output - input and mixing parameter alpha, the
+ *  following methods are available.
+ *  - Linear: input + alpha*F.
+ *  - Anderson: Removes the part of F that previous residual differences
+ *  can predict, in the least square sense.
+ *  - Pulay: Direct inversion in the iterative subspace (DIIS). Takes the
+ *  linear combination of previous iterations whose residual has the
+ *  smallest norm.
+ *  - Broyden: Johnson's modified Broyden method. This is Anderson mixing
+ *  with a small regularization of the inverse Jacobian update.
+ *
+ *  The number of previous iterations that Anderson, Pulay, and Broyden
+ *  mixing use is set with setHistorySize().
+ *
+ *  # Convergence
+ *  Each call to mix() or update() stores the norm of the residual. The
+ *  calculation is considered converged when this norm is smaller than the
+ *  tolerance. The residual history is available through
+ *  getResidualHistory(), and the Mixer can be written to a stream to print a
+ *  convergence report.
+ *
+ *  # Example
+ *  ```cpp
+ *    Mixer mixer(Mixer::Method::Pulay, 0.3);
+ *    mixer.setTolerance(1e-8);
+ *
+ *    //In the self-consistency callback.
+ *    std::vector<std::complex<double>> output = calculateOrderParameter();
+ *    return mixer.update(orderParameter, output);
+ *  ``` */
+class Mixer : public Streamable{
+public:
+	/** Enum class for specifying the mixing method. */
+	enum class Method{Linear, Anderson, Pulay, Broyden};
+
+	/** Constructor.
+	 *
+	 *  @param method The mixing method.
+	 *  @param mixingParameter The fraction of the residual that is added
+	 *  to the input.
+	 *  @param historySize The maximum number of iterations that are
+	 *  used by the Anderson, Pulay, and Broyden methods. */
+	Mixer(
+		Method method = Method::Pulay,
+		double mixingParameter = 0.5,
+		unsigned int historySize = 8
+	);
+
+	/** Set the mixing method. Clears the history.
+	 *
+	 *  @param method The mixing method. */
+	void setMethod(Method method);
+
+	/** Get the mixing method.
+	 *
+	 *  @return The mixing method. */
+	Method getMethod() const;
+
+	/** Set the mixing parameter.
+	 *
+	 *  @param mixingParameter The fraction of the residual that is added
+	 *  to the input. */
+	void setMixingParameter(double mixingParameter);
+
+	/** Get the mixing parameter.
+	 *
+	 *  @return The mixing parameter. */
+	double getMixingParameter() const;
+
+	/** Set the maximum number of iterations that are used by the
+	 *  Anderson, Pulay, and Broyden methods.
+	 *
+	 *  @param historySize The maximum number of iterations to use. */
+	void setHistorySize(unsigned int historySize);
+
+	/** Get the maximum number of iterations that are used by the
+	 *  Anderson, Pulay, and Broyden methods.
+	 *
+	 *  @return The maximum number of iterations to use. */
+	unsigned int getHistorySize() const;
+
+	/** Set the tolerance. The calculation is considered converged when
+	 *  the norm of the residual is smaller than the tolerance.
+	 *
+	 *  @param tolerance The tolerance. */
+	void setTolerance(double tolerance);
+
+	/** Get the tolerance.
+	 *
+	 *  @return The tolerance. */
+	double getTolerance() const;
+
+	/** Calculate the order parameter to use as input in the next
+	 *  iteration.
+	 *
+	 *  @param input The order parameter that was used as input in the
+	 *  current iteration.
+	 *  @param output The order parameter that was calculated in the
+	 *  current iteration.
+	 *
+	 *  @return The order parameter to use as input in the next iteration.
+	 */
+	std::vector<std::complex<double>> mix(
+		const std::vector<std::complex<double>> &input,
+		const std::vector<std::complex<double>> &output
+	);
+
+	/** Replace the order parameter by the order parameter to use as input
+	 *  in the next iteration. Same as mix(), but convenient to call from a
+	 *  self-consistency callback.
+	 *
+	 *  @param orderParameter The order parameter that was used as input
+	 *  in the current iteration. Replaced by the order parameter to use
+	 *  as input in the next iteration.
+	 *  @param output The order parameter that was calculated in the
+	 *  current iteration.
+	 *
+	 *  @return True if the calculation has converged. */
+	bool update(
+		std::vector<std::complex<double>> &orderParameter,
+		const std::vector<std::complex<double>> &output
+	);
+
+	/** Check whether the calculation has converged.
+	 *
+	 *  @return True if the norm of the last residual is smaller than the
+	 *  tolerance. */
+	bool isConverged() const;
+
+	/** Get the number of iterations.
+	 *
+	 *  @return The number of times mix() or update() has been called
+	 *  since construction or the last call to reset(). */
+	unsigned int getNumIterations() const;
+
+	/** Get the norm of the last residual.
+	 *
+	 *  @return The norm of the last residual. */
+	double getResidual() const;
+
+	/** Get the residual norms of all iterations.
+	 *
+	 *  @return The residual norms of all iterations. */
+	const std::vector<double>& getResidualHistory() const;
+
+	/** Clear the history and the residual history. */
+	void reset();
+
+	/** Implements Streamable::toString(). */
+	virtual std::string toString() const;
+private:
+	/** The mixing method. */
+	Method method;
+
+	/** The mixing parameter. */
+	double mixingParameter;
+
+	/** The maximum number of iterations used in the mixing. */
+	unsigned int historySize;
+
+	/** The tolerance. */
+	double tolerance;
+
+	/** Previous inputs. */
+	std::vector<std::vector<std::complex<double>>> inputs;
+
+	/** Previous residuals. */
+	std::vector<std::vector<std::complex<double>>> residuals;
+
+	/** Norm of the residual in each iteration. */
+	std::vector<double> residualHistory;
+
+	/** Linear mixing of the last iteration. */
+	std::vector<std::complex<double>> mixLinear() const;
+
+	/** Anderson and Broyden mixing. The Broyden method uses the weight
+	 *  w0 to regularize the update, while w0 = 0 gives Anderson mixing.
+	 *
+	 *  @param w0 The weight used to regularize the update. */
+	std::vector<std::complex<double>> mixAndersonBroyden(double w0) const;
+
+	/** Pulay mixing. */
+	std::vector<std::complex<double>> mixPulay() const;
+
+	/** Solves the linear system Ax = b. The solution is returned in b.
+	 *
+	 *  @param A Column major square matrix. Overwritten by its LU
+	 *  factorization.
+	 *  @param b The right hand side.
+	 *
+	 *  @return False if the matrix is singular. */
+	static bool solveLinearSystem(
+		std::vector<std::complex<double>> &A,
+		std::vector<std::complex<double>> &b
+	);
+};
+
+inline void Mixer::setMethod(Method method){
+	this->method = method;
+	inputs.clear();
+	residuals.clear();
+}
+
+inline Mixer::Method Mixer::getMethod() const{
+	return method;
+}
+
+inline void Mixer::setMixingParameter(double mixingParameter){
+	TBTKAssert(
+		mixingParameter > 0,
+		"Mixer::setMixingParameter()",
+		"Invalid mixing parameter '" << mixingParameter << "'.",
+		"The mixing parameter must be positive."
+	);
+	this->mixingParameter = mixingParameter;
+}
+
+inline double Mixer::getMixingParameter() const{
+	return mixingParameter;
+}
+
+inline void Mixer::setHistorySize(unsigned int historySize){
+	TBTKAssert(
+		historySize > 0,
+		"Mixer::setHistorySize()",
+		"Invalid history size '" << historySize << "'.",
+		"The history size must be at least 1."
+	);
+	this->historySize = historySize;
+	while(inputs.size() > historySize){
+		inputs.erase(inputs.begin());
+		residuals.erase(residuals.begin());
+	}
+}
+
+inline unsigned int Mixer::getHistorySize() const{
+	return historySize;
+}
+
+inline void Mixer::setTolerance(double tolerance){
+	this->tolerance = tolerance;
+}
+
+inline double Mixer::getTolerance() const{
+	return tolerance;
+}
+
+inline bool Mixer::isConverged() const{
+	if(residualHistory.size() == 0)
+		return false;
+
+	return residualHistory.back() < tolerance;
+}
+
+inline unsigned int Mixer::getNumIterations() const{
+	return residualHistory.size();
+}
+
+inline double Mixer::getResidual() const{
+	TBTKAssert(
+		residualHistory.size() != 0,
+		"Mixer::getResidual()",
+		"No residual has been calculated yet.",
+		"Call Mixer::mix() first."
+	);
+
+	return residualHistory.back();
+}
+
+inline const std::vector<double>& Mixer::getResidualHistory() const{
+	return residualHistory;
+}
+
+inline void Mixer::reset(){
+	inputs.clear();
+	residuals.clear();
+	residualHistory.clear();
+}
+
+};	//End of namespace TBTK
+
+#endif
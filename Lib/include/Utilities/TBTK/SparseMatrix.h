@@ -26,9 +26,18 @@
 #include "TBTK/TBTKMacros.h"
 
 #include <algorithm>
+#include <complex>
 #include <tuple>
 #include <vector>
 
+#ifdef TBTK_USE_OPEN_MP
+#	include <omp.h>
+#endif
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#	include <immintrin.h>
+#endif
+
 namespace TBTK{
 
 template<typename DataType>
@@ -56,6 +65,28 @@ public:
 		unsigned int numCols
 	);
 
+	/** Constructs a SparseMatrix directly on the CSR/CSC format from
+	 *  matrix elements on the coordinate (COO) format. The matrix elements
+	 *  are distributed to the rows/columns in a single counting sort
+	 *  pass, which avoids the list of lists that is built by
+	 *  SparseMatrix::construct(). Matrix elements with the same row and
+	 *  column are added together.
+	 *
+	 *  @param storageFormat The storage format.
+	 *  @param numRows The number of rows.
+	 *  @param numCols The number of columns.
+	 *  @param rows The rows of the matrix elements.
+	 *  @param columns The columns of the matrix elements.
+	 *  @param values The values of the matrix elements. */
+	SparseMatrix(
+		StorageFormat storageFormat,
+		unsigned int numRows,
+		unsigned int numCols,
+		const std::vector<unsigned int> &rows,
+		const std::vector<unsigned int> &columns,
+		const std::vector<DataType> &values
+	);
+
 	/** Assignment operator. */
 	SparseMatrix& operator=(const SparseMatrix &sparseMatrix);
 
@@ -101,9 +132,71 @@ public:
 	/** Get CSC values. */
 	const DataType* getCSCValues() const;
 
+	/** Get CSR values. The values can be modified in place, but the
+	 *  sparsity pattern remains fixed. */
+	DataType* getCSRValues();
+
+	/** Get CSC values. The values can be modified in place, but the
+	 *  sparsity pattern remains fixed. */
+	DataType* getCSCValues();
+
 	/** Construct the sparse matrix. */
 	void construct();
 
+	/** Multiply the matrix with a dense vector, \f$y = Ax\f$. The matrix
+	 *  has to be on the CSR format. The rows are partitioned between
+	 *  threads such that each thread processes approximately the same
+	 *  number of matrix elements.
+	 *
+	 *  If numVectors is larger than one, the matrix is multiplied with a
+	 *  dense block of numVectors vectors at once, which means that the
+	 *  matrix only is read once for all of the vectors. The block is
+	 *  stored row by row, with element v of row r stored at
+	 *  vector[numVectors*r + v], and the result is stored in the same
+	 *  way.
+	 *
+	 *  @param vector The vector \f$x\f$. Must contain
+	 *  numVectors*getNumColumns() elements.
+	 *
+	 *  @param result Array to write the result \f$y\f$ to. Must contain
+	 *  numVectors*getNumRows() elements and must not overlap with vector.
+	 *
+	 *  @param numVectors The number of vectors in the block. */
+	void multiply(
+		const DataType *vector,
+		DataType *result,
+		unsigned int numVectors = 1
+	) const;
+
+	/** Calculate \f$r = \alpha Ax + \beta y\f$ in a single pass over the
+	 *  matrix. For example, the Chebyshev recursion
+	 *  \f$|j_{n+1}\rangle = 2H|j_n\rangle - |j_{n-1}\rangle\f$ is
+	 *  performed by calling axpby(2, jn, -1, jnm1, jnp1). The matrix has to
+	 *  be on the CSR format.
+	 *
+	 *  @param alpha The factor \f$\alpha\f$.
+	 *  @param x The vector \f$x\f$. Must contain getNumColumns() elements.
+	 *  @param beta The factor \f$\beta\f$. If beta is zero, y is not
+	 *  accessed.
+	 *
+	 *  @param y The vector \f$y\f$. Must contain getNumRows() elements.
+	 *  May be the same array as result.
+	 *
+	 *  @param result Array to write the result \f$r\f$ to. Must contain
+	 *  getNumRows() elements and must not overlap with x.
+	 *
+	 *  @param numVectors The number of vectors in x, y, and result. See
+	 *  multiply() for the memory layout used when numVectors is larger
+	 *  than one. */
+	void axpby(
+		const DataType &alpha,
+		const DataType *x,
+		const DataType &beta,
+		const DataType *y,
+		DataType *result,
+		unsigned int numVectors = 1
+	) const;
+
 	/** Addition assignment operator.
 	 *
 	 *  @param rhs The right hand side of the expression.
@@ -258,6 +351,47 @@ public:
 		const SparseMatrix &rhs,
 		SparseMatrix &result
 	);
+
+	/** Get the range of rows to be processed by one out of several
+	 *  parts of a parallel calculation. The rows are divided such that
+	 *  each part contains approximately the same number of matrix
+	 *  elements. Requires the CSR format.
+	 *
+	 *  @param part The part to get the rows for.
+	 *  @param numParts The total number of parts.
+	 *  @param firstRow Set to the first row in the part.
+	 *  @param endRow Set to one plus the last row in the part. */
+	void getRowPartition(
+		unsigned int part,
+		unsigned int numParts,
+		unsigned int &firstRow,
+		unsigned int &endRow
+	) const;
+
+	/** Calculate the scalar product between a CSR row and a dense vector.
+	 *
+	 *  @param row The row.
+	 *  @param vector The dense vector.
+	 *
+	 *  @return The scalar product. */
+	DataType multiplyRow(unsigned int row, const DataType *vector) const;
+
+	/** Multiply a CSR row with a dense block of vectors and add the
+	 *  result to a row of the result block,
+	 *  \f$r_v \mathrel{+}= \alpha\sum_{c}A_{rc}x_{cv}\f$.
+	 *
+	 *  @param row The row.
+	 *  @param alpha The factor \f$\alpha\f$.
+	 *  @param block The dense block of vectors.
+	 *  @param numVectors The number of vectors in the block.
+	 *  @param result The row of the result block to add the result to. */
+	void multiplyRowBlock(
+		unsigned int row,
+		const DataType &alpha,
+		const DataType *block,
+		unsigned int numVectors,
+		DataType *result
+	) const;
 };
 
 template<typename DataType>
@@ -299,6 +433,149 @@ inline SparseMatrix<DataType>::SparseMatrix(
 	csxNumMatrixElements = -1;
 }
 
+template<typename DataType>
+inline SparseMatrix<DataType>::SparseMatrix(
+	StorageFormat storageFormat,
+	unsigned int numRows,
+	unsigned int numCols,
+	const std::vector<unsigned int> &rows,
+	const std::vector<unsigned int> &columns,
+	const std::vector<DataType> &values
+){
+	TBTKAssert(
+		rows.size() == columns.size() && rows.size() == values.size(),
+		"SparseMatrix::SparseMatrix()",
+		"Incompatible sizes. 'rows', 'columns', and 'values' have"
+		<< " sizes '" << rows.size() << "', '" << columns.size()
+		<< "', and '" << values.size() << "', respectively.",
+		""
+	);
+
+	this->storageFormat = storageFormat;
+
+	this->numRows = numRows;
+	this->numCols = numCols;
+	allowDynamicDimensions = false;
+
+	//The matrix elements are distributed over x and sorted with respect
+	//to y, where x and y are the rows and columns for the CSR format and
+	//the columns and rows for the CSC format.
+	const std::vector<unsigned int> *x;
+	const std::vector<unsigned int> *y;
+	unsigned int numX;
+	switch(storageFormat){
+	case StorageFormat::CSR:
+		x = &rows;
+		y = &columns;
+		numX = numRows;
+		break;
+	case StorageFormat::CSC:
+		x = &columns;
+		y = &rows;
+		numX = numCols;
+		break;
+	default:
+		TBTKExit(
+			"SparseMatrix::SparseMatrix()",
+			"Unknow StorageFormat.",
+			"This should never happen, contact the developer."
+		);
+	}
+
+	//Count the number of matrix elements for each x.
+	std::vector<unsigned int> xPointers(numX+1, 0);
+	for(unsigned int n = 0; n < values.size(); n++){
+		TBTKAssert(
+			rows[n] < numRows && columns[n] < numCols,
+			"SparseMatrix::SparseMatrix()",
+			"Invalid matrix entry. The matrix dimension is '"
+			<< numRows << "x" << numCols << "', but the matrix"
+			<< " element '" << n << "' has index '(" << rows[n]
+			<< ", " << columns[n] << ")'.",
+			""
+		);
+		xPointers[(*x)[n]+1]++;
+	}
+	for(unsigned int n = 0; n < numX; n++)
+		xPointers[n+1] += xPointers[n];
+
+	//Distribute the matrix elements. The distribution is stable, which
+	//means that matrix elements that are added in order of increasing y
+	//already are sorted.
+	std::vector<unsigned int> sortedY(values.size());
+	std::vector<DataType> sortedValues(values.size());
+	std::vector<unsigned int> positions(xPointers.begin(), xPointers.end()-1);
+	for(unsigned int n = 0; n < values.size(); n++){
+		unsigned int position = positions[(*x)[n]]++;
+		sortedY[position] = (*y)[n];
+		sortedValues[position] = values[n];
+	}
+
+	//Sort the matrix elements with respect to y where necessary and merge
+	//matrix elements with the same x and y. The merged matrix elements
+	//are compacted in place.
+	csxXPointers = new unsigned int[numX+1];
+	csxXPointers[0] = 0;
+	unsigned int numMatrixElements = 0;
+	std::vector<std::tuple<unsigned int, DataType>> workspace;
+	for(unsigned int n = 0; n < numX; n++){
+		unsigned int first = xPointers[n];
+		unsigned int last = xPointers[n+1];
+		if(
+			!std::is_sorted(
+				sortedY.begin() + first,
+				sortedY.begin() + last
+			)
+		){
+			workspace.clear();
+			for(unsigned int c = first; c < last; c++){
+				workspace.push_back(
+					std::make_tuple(sortedY[c], sortedValues[c])
+				);
+			}
+			std::stable_sort(
+				workspace.begin(),
+				workspace.end(),
+				[](
+					const std::tuple<unsigned int, DataType> &t1,
+					const std::tuple<unsigned int, DataType> &t2
+				){
+					return std::get<0>(t1) < std::get<0>(t2);
+				}
+			);
+			for(unsigned int c = first; c < last; c++){
+				sortedY[c] = std::get<0>(workspace[c - first]);
+				sortedValues[c] = std::get<1>(workspace[c - first]);
+			}
+		}
+
+		for(unsigned int c = first; c < last; c++){
+			if(
+				numMatrixElements > csxXPointers[n]
+				&& sortedY[numMatrixElements-1] == sortedY[c]
+			){
+				sortedValues[numMatrixElements-1]
+					+= sortedValues[c];
+			}
+			else{
+				sortedY[numMatrixElements] = sortedY[c];
+				sortedValues[numMatrixElements]
+					= sortedValues[c];
+				numMatrixElements++;
+			}
+		}
+		csxXPointers[n+1] = numMatrixElements;
+	}
+
+	csxNumMatrixElements = numMatrixElements;
+	csxY = new unsigned int[numMatrixElements];
+	csxValues = new DataType[numMatrixElements];
+	for(unsigned int n = 0; n < numMatrixElements; n++){
+		csxY[n] = sortedY[n];
+		csxValues[n] = sortedValues[n];
+	}
+}
+
 template<typename DataType>
 inline SparseMatrix<DataType>::SparseMatrix(
 	const SparseMatrix &sparseMatrix
@@ -776,11 +1053,132 @@ inline const DataType* SparseMatrix<DataType>::getCSCValues() const{
 	return csxValues;
 }
 
+template<typename DataType>
+inline DataType* SparseMatrix<DataType>::getCSRValues(){
+	return const_cast<DataType*>(
+		static_cast<const SparseMatrix&>(*this).getCSRValues()
+	);
+}
+
+template<typename DataType>
+inline DataType* SparseMatrix<DataType>::getCSCValues(){
+	return const_cast<DataType*>(
+		static_cast<const SparseMatrix&>(*this).getCSCValues()
+	);
+}
+
 template<typename DataType>
 inline void SparseMatrix<DataType>::construct(){
 	constructCSX();
 }
 
+template<typename DataType>
+inline void SparseMatrix<DataType>::multiply(
+	const DataType *vector,
+	DataType *result,
+	unsigned int numVectors
+) const{
+	axpby(1, vector, 0, nullptr, result, numVectors);
+}
+
+template<typename DataType>
+inline void SparseMatrix<DataType>::axpby(
+	const DataType &alpha,
+	const DataType *x,
+	const DataType &beta,
+	const DataType *y,
+	DataType *result,
+	unsigned int numVectors
+) const{
+	TBTKAssert(
+		storageFormat == StorageFormat::CSR,
+		"SparseMatrix::axpby()",
+		"Matrix-vector multiplication is only supported for matrices"
+		<< " on the CSR storage format.",
+		"Use SparseMatrix::setStorageFormat() to change the storage"
+		<< " format."
+	);
+	TBTKAssert(
+		csxNumMatrixElements != -1,
+		"SparseMatrix::axpby()",
+		"Matrix not yet constructed.",
+		"First call SparseMatrix::construct()."
+	);
+
+	bool addY = (beta != DataType(0));
+	TBTKAssert(
+		!addY || y != nullptr,
+		"SparseMatrix::axpby()",
+		"'y' is a nullptr, but 'beta' is not zero.",
+		""
+	);
+	TBTKAssert(
+		numVectors > 0,
+		"SparseMatrix::axpby()",
+		"'numVectors' must be larger than zero.",
+		""
+	);
+
+#ifdef TBTK_USE_OPEN_MP
+	#pragma omp parallel
+#endif
+	{
+#ifdef TBTK_USE_OPEN_MP
+		unsigned int part = omp_get_thread_num();
+		unsigned int numParts = omp_get_num_threads();
+#else
+		unsigned int part = 0;
+		unsigned int numParts = 1;
+#endif
+		unsigned int firstRow;
+		unsigned int endRow;
+		getRowPartition(part, numParts, firstRow, endRow);
+
+		if(numVectors == 1){
+			if(addY){
+				for(
+					unsigned int row = firstRow;
+					row < endRow;
+					row++
+				){
+					result[row] = alpha*multiplyRow(row, x)
+						+ beta*y[row];
+				}
+			}
+			else{
+				for(
+					unsigned int row = firstRow;
+					row < endRow;
+					row++
+				){
+					result[row] = alpha*multiplyRow(row, x);
+				}
+			}
+		}
+		else{
+			for(unsigned int row = firstRow; row < endRow; row++){
+				DataType *resultRow = result + numVectors*row;
+				if(addY){
+					const DataType *yRow = y + numVectors*row;
+					for(unsigned int v = 0; v < numVectors; v++)
+						resultRow[v] = beta*yRow[v];
+				}
+				else{
+					for(unsigned int v = 0; v < numVectors; v++)
+						resultRow[v] = 0;
+				}
+				multiplyRowBlock(
+					row,
+					alpha,
+					x,
+					numVectors,
+					resultRow
+				);
+			}
+		}
+	}
+}
+
 template<typename DataType>
 inline SparseMatrix<DataType>& SparseMatrix<DataType>::operator+=(
 	const SparseMatrix &rhs
@@ -1686,6 +2084,199 @@ inline void SparseMatrix<DataType>::multiply(
 	}
 }
 
+template<typename DataType>
+inline void SparseMatrix<DataType>::getRowPartition(
+	unsigned int part,
+	unsigned int numParts,
+	unsigned int &firstRow,
+	unsigned int &endRow
+) const{
+	//Rows are assigned to the parts by finding the first row that starts
+	//after the given fraction of the matrix elements. Since the
+	//boundaries are calculated the same way for every part, the end row
+	//of one part is always the first row of the next.
+	const unsigned int *rowPointers = csxXPointers;
+	const unsigned int *rowPointersEnd = rowPointers + numRows + 1;
+	unsigned long long numMatrixElements = csxNumMatrixElements;
+
+	firstRow = std::lower_bound(
+		rowPointers,
+		rowPointersEnd,
+		(unsigned int)((numMatrixElements*part)/numParts)
+	) - rowPointers;
+	if(firstRow > (unsigned int)numRows)
+		firstRow = numRows;
+
+	if(part + 1 == numParts){
+		endRow = numRows;
+	}
+	else{
+		endRow = std::lower_bound(
+			rowPointers,
+			rowPointersEnd,
+			(unsigned int)((numMatrixElements*(part+1))/numParts)
+		) - rowPointers;
+		if(endRow > (unsigned int)numRows)
+			endRow = numRows;
+	}
+}
+
+template<typename DataType>
+inline DataType SparseMatrix<DataType>::multiplyRow(
+	unsigned int row,
+	const DataType *vector
+) const{
+	DataType result = 0;
+	for(unsigned int n = csxXPointers[row]; n < csxXPointers[row+1]; n++)
+		result += csxValues[n]*vector[csxY[n]];
+
+	return result;
+}
+
+//The complex multiplication is written out explicitly since the
+//std::complex<double> operator*() has to guard against NaN and infinities,
+//which prevents the compiler from vectorizing the loop. When the library is
+//compiled with AVX2 or AVX-512 enabled (for example using -march=native),
+//two or four matrix elements are processed per instruction using fused
+//multiply-add. The real and imaginary parts of the vector elements are
+//multiplied by the matrix elements in two separate accumulators that are
+//combined at the end as
+//(a_r*x_r - a_i*x_i, a_i*x_r + a_r*x_i).
+template<>
+inline std::complex<double> SparseMatrix<std::complex<double>>::multiplyRow(
+	unsigned int row,
+	const std::complex<double> *vector
+) const{
+	const double *values = reinterpret_cast<const double*>(csxValues);
+	const double *x = reinterpret_cast<const double*>(vector);
+	unsigned int n = csxXPointers[row];
+	unsigned int end = csxXPointers[row+1];
+
+	double real = 0;
+	double imag = 0;
+#if defined(__AVX512F__)
+	__m512d sumXReal = _mm512_setzero_pd();
+	__m512d sumXImag = _mm512_setzero_pd();
+	for(; n + 4 <= end; n += 4){
+		__m512d a = _mm512_loadu_pd(values + 2*n);
+		__m256d v01 = _mm256_insertf128_pd(
+			_mm256_castpd128_pd256(_mm_loadu_pd(x + 2*csxY[n])),
+			_mm_loadu_pd(x + 2*csxY[n+1]),
+			1
+		);
+		__m256d v23 = _mm256_insertf128_pd(
+			_mm256_castpd128_pd256(_mm_loadu_pd(x + 2*csxY[n+2])),
+			_mm_loadu_pd(x + 2*csxY[n+3]),
+			1
+		);
+		__m512d v = _mm512_insertf64x4(
+			_mm512_castpd256_pd512(v01),
+			v23,
+			1
+		);
+		sumXReal = _mm512_fmadd_pd(a, _mm512_movedup_pd(v), sumXReal);
+		sumXImag = _mm512_fmadd_pd(
+			a,
+			_mm512_permute_pd(v, 0xFF),
+			sumXImag
+		);
+	}
+	__m512d sum = _mm512_fmaddsub_pd(
+		_mm512_set1_pd(1.),
+		sumXReal,
+		_mm512_permute_pd(sumXImag, 0x55)
+	);
+	__m256d sum256 = _mm256_add_pd(
+		_mm512_castpd512_pd256(sum),
+		_mm512_extractf64x4_pd(sum, 1)
+	);
+	__m128d sum128 = _mm_add_pd(
+		_mm256_castpd256_pd128(sum256),
+		_mm256_extractf128_pd(sum256, 1)
+	);
+	real = _mm_cvtsd_f64(sum128);
+	imag = _mm_cvtsd_f64(_mm_unpackhi_pd(sum128, sum128));
+#elif defined(__AVX2__) && defined(__FMA__)
+	__m256d sumXReal = _mm256_setzero_pd();
+	__m256d sumXImag = _mm256_setzero_pd();
+	for(; n + 2 <= end; n += 2){
+		__m256d a = _mm256_loadu_pd(values + 2*n);
+		__m256d v = _mm256_insertf128_pd(
+			_mm256_castpd128_pd256(_mm_loadu_pd(x + 2*csxY[n])),
+			_mm_loadu_pd(x + 2*csxY[n+1]),
+			1
+		);
+		sumXReal = _mm256_fmadd_pd(a, _mm256_movedup_pd(v), sumXReal);
+		sumXImag = _mm256_fmadd_pd(
+			a,
+			_mm256_permute_pd(v, 0xF),
+			sumXImag
+		);
+	}
+	__m256d sum = _mm256_addsub_pd(
+		sumXReal,
+		_mm256_permute_pd(sumXImag, 0x5)
+	);
+	__m128d sum128 = _mm_add_pd(
+		_mm256_castpd256_pd128(sum),
+		_mm256_extractf128_pd(sum, 1)
+	);
+	real = _mm_cvtsd_f64(sum128);
+	imag = _mm_cvtsd_f64(_mm_unpackhi_pd(sum128, sum128));
+#endif
+	for(; n < end; n++){
+		double aReal = values[2*n];
+		double aImag = values[2*n+1];
+		double xReal = x[2*csxY[n]];
+		double xImag = x[2*csxY[n]+1];
+		real += aReal*xReal - aImag*xImag;
+		imag += aImag*xReal + aReal*xImag;
+	}
+
+	return std::complex<double>(real, imag);
+}
+
+template<typename DataType>
+inline void SparseMatrix<DataType>::multiplyRowBlock(
+	unsigned int row,
+	const DataType &alpha,
+	const DataType *block,
+	unsigned int numVectors,
+	DataType *result
+) const{
+	for(unsigned int n = csxXPointers[row]; n < csxXPointers[row+1]; n++){
+		DataType value = alpha*csxValues[n];
+		const DataType *blockRow = block + numVectors*csxY[n];
+		for(unsigned int v = 0; v < numVectors; v++)
+			result[v] += value*blockRow[v];
+	}
+}
+
+//As for multiplyRow(), the complex multiplication is written out explicitly
+//to allow the compiler to vectorize the loop over the vectors in the block.
+template<>
+inline void SparseMatrix<std::complex<double>>::multiplyRowBlock(
+	unsigned int row,
+	const std::complex<double> &alpha,
+	const std::complex<double> *block,
+	unsigned int numVectors,
+	std::complex<double> *result
+) const{
+	double *r = reinterpret_cast<double*>(result);
+	for(unsigned int n = csxXPointers[row]; n < csxXPointers[row+1]; n++){
+		std::complex<double> value = alpha*csxValues[n];
+		const double aReal = value.real();
+		const double aImag = value.imag();
+		const double *x = reinterpret_cast<const double*>(
+			block + numVectors*csxY[n]
+		);
+		for(unsigned int v = 0; v < 2*numVectors; v += 2){
+			r[v] += aReal*x[v] - aImag*x[v+1];
+			r[v+1] += aImag*x[v] + aReal*x[v+1];
+		}
+	}
+}
+
 }; //End of namesapce TBTK
 
 #endif
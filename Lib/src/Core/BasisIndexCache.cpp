@@ -0,0 +1,155 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file BasisIndexCache.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/BasisIndexCache.h"
+
+using namespace std;
+
+namespace TBTK{
+
+//The dense storage format is used as long as the rectangular range spanned
+//by the Indices contains at most this many points per basis index.
+static const unsigned int MAX_DENSE_POINTS_PER_BASIS_INDEX = 4;
+
+BasisIndexCache::BasisIndexCache(){
+	storageFormat = StorageFormat::None;
+	offsets.push_back(0);
+	hashMask = 0;
+}
+
+void BasisIndexCache::add(const Index &index){
+	TBTKAssert(
+		storageFormat == StorageFormat::None,
+		"BasisIndexCache::add()",
+		"Unable to add Index to a generated BasisIndexCache.",
+		"Call BasisIndexCache::clear() first."
+	);
+
+	for(unsigned int n = 0; n < index.getSize(); n++)
+		subindices.push_back(index[n]);
+	offsets.push_back(subindices.size());
+}
+
+void BasisIndexCache::generate(){
+	TBTKAssert(
+		storageFormat == StorageFormat::None,
+		"BasisIndexCache::generate()",
+		"The BasisIndexCache is already generated.",
+		""
+	);
+
+	subindices.shrink_to_fit();
+	offsets.shrink_to_fit();
+	if(generateDense()){
+		storageFormat = StorageFormat::Dense;
+	}
+	else{
+		generateHash();
+		storageFormat = StorageFormat::Hash;
+	}
+}
+
+void BasisIndexCache::clear(){
+	storageFormat = StorageFormat::None;
+	vector<int>().swap(subindices);
+	vector<unsigned int>({0}).swap(offsets);
+	vector<unsigned int>().swap(ranges);
+	vector<unsigned int>().swap(strides);
+	vector<int>().swap(table);
+	hashMask = 0;
+}
+
+unsigned int BasisIndexCache::getSizeInBytes() const{
+	return sizeof(*this)
+		+ subindices.capacity()*sizeof(int)
+		+ offsets.capacity()*sizeof(unsigned int)
+		+ ranges.capacity()*sizeof(unsigned int)
+		+ strides.capacity()*sizeof(unsigned int)
+		+ table.capacity()*sizeof(int);
+}
+
+bool BasisIndexCache::generateDense(){
+	unsigned int size = getSize();
+	if(size == 0)
+		return false;
+
+	//All Indices need to have the same number of non-negative subindices.
+	unsigned int numSubindices = offsets[1];
+	vector<unsigned int> denseRanges(numSubindices, 0);
+	for(unsigned int b = 0; b < size; b++){
+		if(offsets[b+1] - offsets[b] != numSubindices)
+			return false;
+
+		for(unsigned int n = 0; n < numSubindices; n++){
+			int subindex = subindices[offsets[b] + n];
+			if(subindex < 0)
+				return false;
+			if((unsigned int)subindex >= denseRanges[n])
+				denseRanges[n] = subindex + 1;
+		}
+	}
+
+	//The range has to be small enough for the memory overhead to be
+	//bounded.
+	double numPoints = 1;
+	for(unsigned int n = 0; n < numSubindices; n++)
+		numPoints *= denseRanges[n];
+	if(numPoints > MAX_DENSE_POINTS_PER_BASIS_INDEX*(double)size)
+		return false;
+
+	ranges = denseRanges;
+	strides.assign(numSubindices, 1);
+	for(int n = numSubindices - 2; n >= 0; n--)
+		strides[n] = strides[n+1]*ranges[n+1];
+
+	table.assign((unsigned int)numPoints, -1);
+	for(unsigned int b = 0; b < size; b++){
+		unsigned int position = 0;
+		for(unsigned int n = 0; n < numSubindices; n++)
+			position += subindices[offsets[b] + n]*strides[n];
+		table[position] = b;
+	}
+
+	return true;
+}
+
+void BasisIndexCache::generateHash(){
+	//Use a power of two number of buckets that keeps the load factor at or
+	//below one half.
+	unsigned int size = getSize();
+	uint64_t numBuckets = 2;
+	while(numBuckets < 2*(uint64_t)size)
+		numBuckets *= 2;
+	hashMask = numBuckets - 1;
+
+	table.assign(numBuckets, -1);
+	for(unsigned int b = 0; b < size; b++){
+		uint64_t bucket = Index::hashSubindices(
+			subindices,
+			offsets[b],
+			offsets[b+1] - offsets[b]
+		)&hashMask;
+		while(table[bucket] != -1)
+			bucket = (bucket + 1)&hashMask;
+		table[bucket] = b;
+	}
+}
+
+};	//End of namespace TBTK
@@ -24,12 +24,25 @@
 
 #include "TBTK/json.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <set>
+
+#ifdef TBTK_USE_OPEN_MP
+#	include <omp.h>
+#endif
+
 using namespace std;
 
 namespace TBTK{
 
 HoppingAmplitudeSet::HoppingAmplitudeSet(){
 	isConstructed = false;
+	useBasisIndexCache = true;
+	useCompactStorage = false;
+	isCompact = false;
+	createStagingBuffers();
 }
 
 HoppingAmplitudeSet::HoppingAmplitudeSet(
@@ -38,6 +51,10 @@ HoppingAmplitudeSet::HoppingAmplitudeSet(
 	HoppingAmplitudeTree(capacity)
 {
 	isConstructed = false;
+	useBasisIndexCache = true;
+	useCompactStorage = false;
+	isCompact = false;
+	createStagingBuffers();
 }
 
 HoppingAmplitudeSet::HoppingAmplitudeSet(
@@ -100,11 +117,56 @@ HoppingAmplitudeSet::HoppingAmplitudeSet(
 			""
 		);
 	}
+
+	//The BasisIndexCache is not serialized and is regenerated instead.
+	useBasisIndexCache = true;
+	if(isConstructed)
+		generateBasisIndexCache();
+
+	useCompactStorage = false;
+	isCompact = false;
+	createStagingBuffers();
 }
 
 HoppingAmplitudeSet::~HoppingAmplitudeSet(){
 }
 
+void HoppingAmplitudeSet::addConcurrently(
+	const HoppingAmplitude &hoppingAmplitude
+){
+	unsigned int thread = 0;
+#ifdef TBTK_USE_OPEN_MP
+	//Thread numbers are only unique within the innermost team, so
+	//nested parallel regions would share staging buffers.
+	TBTKAssert(
+		omp_get_level() <= 1,
+		"HoppingAmplitudeSet::addConcurrently()",
+		"Called from a nested OpenMP parallel region.",
+		"Only call addConcurrently() from the outermost parallel"
+		<< " region."
+	);
+	thread = omp_get_thread_num();
+#endif
+	TBTKAssert(
+		thread < stagingBuffers.size(),
+		"HoppingAmplitudeSet::addConcurrently()",
+		"Called from thread '" << thread << "', but the"
+		<< " HoppingAmplitudeSet only has '" << stagingBuffers.size()
+		<< "' staging buffers.",
+		"Create the HoppingAmplitudeSet after the number of OpenMP"
+		<< " threads has been set."
+	);
+	TBTKAssert(
+		!isConstructed,
+		"HoppingAmplitudeSet::addConcurrently()",
+		"Unable to add HoppingAmplitudes to a constructed"
+		<< " HoppingAmplitudeSet.",
+		""
+	);
+
+	stagingBuffers[thread].hoppingAmplitudes.push_back(hoppingAmplitude);
+}
+
 IndexTree HoppingAmplitudeSet::getIndexTree() const{
 	IndexTree indexTree;
 	for(
@@ -133,7 +195,175 @@ IndexTree HoppingAmplitudeSet::getIndexTree(const Index &subspace) const{
 	return indexTree;
 }
 
+vector<Index> HoppingAmplitudeSet::getIndexList(
+	const vector<Index> &patterns
+) const{
+	if(!isCompact)
+		return HoppingAmplitudeTree::getIndexList(patterns);
+
+	//Every basis index in the range of a subtree corresponds to a
+	//from-Index in the subtree.
+	set<Index> indexSet;
+	for(unsigned int n = 0; n < patterns.size(); n++){
+		const Index &pattern = patterns[n];
+		Index subTreeIndex;
+		for(unsigned int c = 0; c < pattern.getSize(); c++){
+			if(pattern[c] < 0)
+				break;
+
+			subTreeIndex.pushBack(pattern[c]);
+		}
+
+		const HoppingAmplitudeTree *subTree = getSubTree(subTreeIndex);
+		int minBasisIndex = subTree->getMinIndex();
+		if(minBasisIndex == -1)
+			continue;
+
+		int maxBasisIndex = subTree->getMaxIndex();
+		for(int b = minBasisIndex; b <= maxBasisIndex; b++){
+			Index index = getPhysicalIndex(b);
+			if(index.equals(pattern, true))
+				indexSet.insert(index);
+		}
+	}
+
+	return vector<Index>(indexSet.begin(), indexSet.end());
+}
+
+void HoppingAmplitudeSet::generateBasisIndexCache(){
+	basisIndexCache.clear();
+
+	if(isCompact){
+		for(int n = 0; n < getBasisSize(); n++){
+			basisIndexCache.add(
+				HoppingAmplitudeTree::getPhysicalIndex(n)
+			);
+		}
+		basisIndexCache.generate();
+
+		return;
+	}
+
+	//The Iterator visits the HoppingAmplitudes in the order of the basis
+	//indices of their from-Indices.
+	for(
+		ConstIterator iterator = cbegin();
+		iterator != cend();
+		++iterator
+	){
+		const Index &fromIndex = (*iterator).getFromIndex();
+		int basisIndex = HoppingAmplitudeTree::getBasisIndex(fromIndex);
+		if(basisIndex == (int)basisIndexCache.getSize())
+			basisIndexCache.add(fromIndex);
+	}
+	TBTKAssert(
+		(int)basisIndexCache.getSize() == getBasisSize(),
+		"HoppingAmplitudeSet::generateBasisIndexCache()",
+		"Unable to generate BasisIndexCache.",
+		"This should never happen, contact the developer."
+	);
+	basisIndexCache.generate();
+}
+
+void HoppingAmplitudeSet::generateCompactStorage(){
+	//The Iterator visits the HoppingAmplitudes in the order of the basis
+	//indices of their from-Indices.
+	for(
+		ConstIterator iterator = cbegin();
+		iterator != cend();
+		++iterator
+	){
+		const HoppingAmplitude &hoppingAmplitude = *iterator;
+		int toBasisIndex = getBasisIndex(hoppingAmplitude.getToIndex());
+		TBTKAssert(
+			toBasisIndex != -1,
+			"HoppingAmplitudeSet::generateCompactStorage()",
+			"Unable to use compact storage. The to-Index "
+			<< hoppingAmplitude.getToIndex().toString() << " is not"
+			<< " part of the basis.",
+			"Make sure that every to-Index also appears as"
+			<< " from-Index in some HoppingAmplitude."
+		);
+		if(hoppingAmplitude.getIsCallbackDependent()){
+			callbackPositions.push_back(compactAmplitudes.size());
+			callbackHoppingAmplitudes.push_back(hoppingAmplitude);
+			compactAmplitudes.push_back(0);
+		}
+		else{
+			compactAmplitudes.push_back(
+				hoppingAmplitude.getAmplitude()
+			);
+		}
+		compactToIndices.push_back(toBasisIndex);
+		compactFromIndices.push_back(
+			getBasisIndex(hoppingAmplitude.getFromIndex())
+		);
+	}
+	compactToIndices.shrink_to_fit();
+	compactFromIndices.shrink_to_fit();
+	compactAmplitudes.shrink_to_fit();
+	callbackPositions.shrink_to_fit();
+	callbackHoppingAmplitudes.shrink_to_fit();
+
+	HoppingAmplitudeTree::clearHoppingAmplitudes();
+	isCompact = true;
+}
+
+void HoppingAmplitudeSet::releaseCompactStorage(){
+	unsigned int callbackPosition = 0;
+	for(
+		unsigned int position = 0;
+		position < compactAmplitudes.size();
+		position++
+	){
+		if(
+			callbackPosition < callbackPositions.size()
+			&& callbackPositions[callbackPosition] < position
+		){
+			callbackPosition++;
+		}
+		HoppingAmplitudeTree::add(
+			getCompactHoppingAmplitude(position, callbackPosition)
+		);
+	}
+
+	vector<int>().swap(compactToIndices);
+	vector<int>().swap(compactFromIndices);
+	vector<complex<double>>().swap(compactAmplitudes);
+	vector<unsigned int>().swap(callbackPositions);
+	vector<HoppingAmplitude>().swap(callbackHoppingAmplitudes);
+	isCompact = false;
+}
+
+HoppingAmplitude HoppingAmplitudeSet::getCompactHoppingAmplitude(
+	unsigned int position,
+	unsigned int callbackPosition
+) const{
+	if(
+		callbackPosition < callbackPositions.size()
+		&& callbackPositions[callbackPosition] == position
+	){
+		return callbackHoppingAmplitudes[callbackPosition];
+	}
+
+	return HoppingAmplitude(
+		compactAmplitudes[position],
+		getPhysicalIndex(compactToIndices[position]),
+		getPhysicalIndex(compactFromIndices[position])
+	);
+}
+
 string HoppingAmplitudeSet::serialize(Mode mode) const{
+	if(isCompact){
+		//The tree does not contain the HoppingAmplitudes when compact
+		//storage is used. Serialize a copy that stores them in the
+		//tree instead.
+		HoppingAmplitudeSet hoppingAmplitudeSet = *this;
+		hoppingAmplitudeSet.setUseCompactStorage(false);
+
+		return hoppingAmplitudeSet.serialize(mode);
+	}
+
 	switch(mode){
 	case Mode::Debug:
 	{
@@ -207,4 +437,468 @@ void HoppingAmplitudeSet::tabulate(
 	}
 }
 
+SparseMatrix<complex<double>> HoppingAmplitudeSet::getSparseMatrix() const{
+	TBTKAssert(
+		isConstructed,
+		"HoppingAmplitudeSet::getSparseMatrix()",
+		"HoppingAmplitudeSet has to be constructed first.",
+		""
+	);
+
+	vector<unsigned int> rows;
+	vector<unsigned int> columns;
+	vector<complex<double>> values;
+	for(
+		ConstIterator iterator = cbegin();
+		iterator != cend();
+		++iterator
+	){
+		const HoppingAmplitude &hoppingAmplitude = *iterator;
+		rows.push_back(getBasisIndex(hoppingAmplitude.getToIndex()));
+		columns.push_back(
+			getBasisIndex(hoppingAmplitude.getFromIndex())
+		);
+		values.push_back(hoppingAmplitude.getAmplitude());
+	}
+
+	unsigned int basisSize = getBasisSize();
+	return SparseMatrix<complex<double>>(
+		SparseMatrix<complex<double>>::StorageFormat::CSC,
+		basisSize,
+		basisSize,
+		rows,
+		columns,
+		values
+	);
+}
+
+const SparseMatrix<complex<double>>& HoppingAmplitudeSet::getSparseMatrix(
+	SparseMatrix<complex<double>>::StorageFormat storageFormat
+) const{
+	TBTKAssert(
+		isConstructed,
+		"HoppingAmplitudeSet::getSparseMatrix()",
+		"HoppingAmplitudeSet has to be constructed first.",
+		""
+	);
+
+	SparseMatrixCache &cache = sparseMatrixCaches[
+		storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR
+			? 0 : 1
+	];
+	lock_guard<mutex> lock(cache.mutex);
+	if(!cache.isGenerated)
+		generateSparseMatrixCache(storageFormat);
+	else if(cache.hasStaleValues)
+		updateSparseMatrixCacheValues(storageFormat);
+
+	//Reevaluate the callback dependent matrix elements. The matrix is only
+	//written to when a callback value has changed, which means that other
+	//threads can keep reading the returned matrix as long as the callback
+	//values are unchanged. Several HoppingAmplitudes can contribute to the
+	//same matrix element, so all values are reset before the callback
+	//values are added.
+	if(cache.callbackHoppingAmplitudes.size() != 0){
+		vector<complex<double>> callbackAmplitudes;
+		callbackAmplitudes.reserve(
+			cache.callbackHoppingAmplitudes.size()
+		);
+		for(
+			unsigned int n = 0;
+			n < cache.callbackHoppingAmplitudes.size();
+			n++
+		){
+			callbackAmplitudes.push_back(
+				cache.callbackHoppingAmplitudes[
+					n
+				]->getAmplitude()
+			);
+		}
+		if(callbackAmplitudes == cache.callbackAmplitudes)
+			return cache.sparseMatrix;
+
+		complex<double> *values;
+		if(
+			storageFormat
+			== SparseMatrix<complex<double>>::StorageFormat::CSR
+		){
+			values = cache.sparseMatrix.getCSRValues();
+		}
+		else{
+			values = cache.sparseMatrix.getCSCValues();
+		}
+
+		for(unsigned int n = 0; n < cache.staticValues.size(); n++){
+			values[cache.callbackValuePositions[n]]
+				= cache.staticValues[n];
+		}
+		for(unsigned int n = 0; n < callbackAmplitudes.size(); n++){
+			values[cache.callbackValuePositions[n]]
+				+= callbackAmplitudes[n];
+		}
+		cache.callbackAmplitudes.swap(callbackAmplitudes);
+		cache.revision++;
+	}
+
+	return cache.sparseMatrix;
+}
+
+unsigned long long HoppingAmplitudeSet::getSparseMatrixRevision(
+	SparseMatrix<complex<double>>::StorageFormat storageFormat
+) const{
+	SparseMatrixCache &cache = sparseMatrixCaches[
+		storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR
+			? 0 : 1
+	];
+	lock_guard<mutex> lock(cache.mutex);
+
+	return cache.revision;
+}
+
+void HoppingAmplitudeSet::generateSparseMatrixCache(
+	SparseMatrix<complex<double>>::StorageFormat storageFormat
+) const{
+	SparseMatrixCache &cache = sparseMatrixCaches[
+		storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR
+			? 0 : 1
+	];
+	cache.clear();
+
+	//Collect the matrix elements on the coordinate format. The callback
+	//dependent HoppingAmplitudes are included with the value zero to make
+	//them part of the sparsity pattern.
+	vector<unsigned int> rows;
+	vector<unsigned int> columns;
+	vector<complex<double>> values;
+	vector<unsigned int> callbackRows;
+	vector<unsigned int> callbackColumns;
+	if(isCompact){
+		//The basis indices are stored directly in the compact storage.
+		rows.assign(compactToIndices.begin(), compactToIndices.end());
+		columns.assign(
+			compactFromIndices.begin(),
+			compactFromIndices.end()
+		);
+		values = compactAmplitudes;
+		for(unsigned int n = 0; n < callbackPositions.size(); n++){
+			values[callbackPositions[n]] = 0;
+			cache.callbackHoppingAmplitudes.push_back(
+				&callbackHoppingAmplitudes[n]
+			);
+			callbackRows.push_back(rows[callbackPositions[n]]);
+			callbackColumns.push_back(
+				columns[callbackPositions[n]]
+			);
+		}
+	}
+	else{
+		for(
+			ConstIterator iterator = cbegin();
+			iterator != cend();
+			++iterator
+		){
+			const HoppingAmplitude &hoppingAmplitude = *iterator;
+			unsigned int row = getBasisIndex(
+				hoppingAmplitude.getToIndex()
+			);
+			unsigned int column = getBasisIndex(
+				hoppingAmplitude.getFromIndex()
+			);
+			rows.push_back(row);
+			columns.push_back(column);
+			if(hoppingAmplitude.getIsCallbackDependent()){
+				values.push_back(0);
+				cache.callbackHoppingAmplitudes.push_back(
+					&hoppingAmplitude
+				);
+				callbackRows.push_back(row);
+				callbackColumns.push_back(column);
+			}
+			else{
+				values.push_back(hoppingAmplitude.getAmplitude());
+			}
+		}
+	}
+
+	unsigned int basisSize = getBasisSize();
+	cache.sparseMatrix = SparseMatrix<complex<double>>(
+		storageFormat,
+		basisSize,
+		basisSize,
+		rows,
+		columns,
+		values
+	);
+
+	//Find the positions of the callback dependent matrix elements. The
+	//elements are sorted within each row/column.
+	const unsigned int *xPointers;
+	const unsigned int *y;
+	complex<double> *matrixValues;
+	vector<unsigned int> *x;
+	vector<unsigned int> *callbackY;
+	if(storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR){
+		xPointers = cache.sparseMatrix.getCSRRowPointers();
+		y = cache.sparseMatrix.getCSRColumns();
+		matrixValues = cache.sparseMatrix.getCSRValues();
+		x = &callbackRows;
+		callbackY = &callbackColumns;
+	}
+	else{
+		xPointers = cache.sparseMatrix.getCSCColumnPointers();
+		y = cache.sparseMatrix.getCSCRows();
+		matrixValues = cache.sparseMatrix.getCSCValues();
+		x = &callbackColumns;
+		callbackY = &callbackRows;
+	}
+	for(unsigned int n = 0; n < callbackRows.size(); n++){
+		unsigned int position = lower_bound(
+			y + xPointers[(*x)[n]],
+			y + xPointers[(*x)[n]+1],
+			(*callbackY)[n]
+		) - y;
+		cache.callbackValuePositions.push_back(position);
+		cache.staticValues.push_back(matrixValues[position]);
+	}
+
+	//Find the positions of all matrix elements, which are needed to
+	//reevaluate the matrix elements after the HoppingAmplitudes have been
+	//accessed through a non-const Iterator. Not needed for compact
+	//storage, where no non-const Iterator can be created.
+	if(!isCompact){
+		if(storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR){
+			x = &rows;
+			callbackY = &columns;
+		}
+		else{
+			x = &columns;
+			callbackY = &rows;
+		}
+		cache.valuePositions.reserve(rows.size());
+		for(unsigned int n = 0; n < rows.size(); n++){
+			cache.valuePositions.push_back(
+				lower_bound(
+					y + xPointers[(*x)[n]],
+					y + xPointers[(*x)[n]+1],
+					(*callbackY)[n]
+				) - y
+			);
+		}
+	}
+
+	cache.isGenerated = true;
+	cache.hasStaleValues = false;
+	cache.revision++;
+}
+
+void HoppingAmplitudeSet::updateSparseMatrixCacheValues(
+	SparseMatrix<complex<double>>::StorageFormat storageFormat
+) const{
+	SparseMatrixCache &cache = sparseMatrixCaches[
+		storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR
+			? 0 : 1
+	];
+
+	complex<double> *values;
+	unsigned int numMatrixElements;
+	if(storageFormat == SparseMatrix<complex<double>>::StorageFormat::CSR){
+		values = cache.sparseMatrix.getCSRValues();
+		numMatrixElements = cache.sparseMatrix.getCSRNumMatrixElements();
+	}
+	else{
+		values = cache.sparseMatrix.getCSCValues();
+		numMatrixElements = cache.sparseMatrix.getCSCNumMatrixElements();
+	}
+
+	//Sum up the amplitudes in the same order as when the cache was
+	//generated. The sparsity pattern can only be reused if the same
+	//HoppingAmplitudes are callback dependent.
+	for(unsigned int n = 0; n < numMatrixElements; n++)
+		values[n] = 0;
+	bool isConsistent = true;
+	unsigned int counter = 0;
+	unsigned int callbackCounter = 0;
+	for(
+		ConstIterator iterator = cbegin();
+		iterator != cend() && isConsistent;
+		++iterator
+	){
+		const HoppingAmplitude &hoppingAmplitude = *iterator;
+		if(counter == cache.valuePositions.size()){
+			isConsistent = false;
+		}
+		else if(hoppingAmplitude.getIsCallbackDependent()){
+			if(
+				callbackCounter
+					== cache.callbackHoppingAmplitudes.size()
+				|| cache.callbackHoppingAmplitudes[
+					callbackCounter
+				] != &hoppingAmplitude
+			){
+				isConsistent = false;
+			}
+			callbackCounter++;
+		}
+		else{
+			values[cache.valuePositions[counter]]
+				+= hoppingAmplitude.getAmplitude();
+		}
+		counter++;
+	}
+	if(
+		!isConsistent
+		|| counter != cache.valuePositions.size()
+		|| callbackCounter != cache.callbackHoppingAmplitudes.size()
+	){
+		generateSparseMatrixCache(storageFormat);
+
+		return;
+	}
+
+	for(unsigned int n = 0; n < cache.staticValues.size(); n++)
+		cache.staticValues[n] = values[cache.callbackValuePositions[n]];
+	cache.callbackAmplitudes.clear();
+
+	cache.hasStaleValues = false;
+	cache.revision++;
+}
+
+HoppingAmplitudeSet::SparseMatrixCache::SparseMatrixCache() :
+	sparseMatrix(SparseMatrix<complex<double>>::StorageFormat::CSR)
+{
+	isGenerated = false;
+	hasStaleValues = false;
+	revision = 0;
+}
+
+HoppingAmplitudeSet::SparseMatrixCache::SparseMatrixCache(
+	const SparseMatrixCache &
+) :
+	sparseMatrix(SparseMatrix<complex<double>>::StorageFormat::CSR)
+{
+	isGenerated = false;
+	hasStaleValues = false;
+	revision = 0;
+}
+
+HoppingAmplitudeSet::SparseMatrixCache&
+HoppingAmplitudeSet::SparseMatrixCache::operator=(
+	const SparseMatrixCache &rhs
+){
+	if(this != &rhs)
+		clear();
+
+	return *this;
+}
+
+void HoppingAmplitudeSet::SparseMatrixCache::clear(){
+	if(!isGenerated)
+		return;
+
+	isGenerated = false;
+	hasStaleValues = false;
+	sparseMatrix = SparseMatrix<complex<double>>(
+		SparseMatrix<complex<double>>::StorageFormat::CSR
+	);
+	vector<const HoppingAmplitude*>().swap(callbackHoppingAmplitudes);
+	vector<unsigned int>().swap(callbackValuePositions);
+	vector<complex<double>>().swap(staticValues);
+	vector<complex<double>>().swap(callbackAmplitudes);
+	vector<unsigned int>().swap(valuePositions);
+}
+
+//The staged HoppingAmplitudes are only sorted and merged in parallel if there
+//are at least this many of them.
+static const unsigned int MIN_PARALLEL_MERGE_SIZE = 4096;
+
+//Orders HoppingAmplitudes lexicographically with respect to the from-Indices
+//and then the to-Indices. An Index is ordered before any longer Index that it
+//is a prefix of, which is the order required by
+//HoppingAmplitudeTree::addSorted().
+static bool compareStagedHoppingAmplitudes(
+	const HoppingAmplitude &lhs,
+	const HoppingAmplitude &rhs
+){
+	const Index *lhsIndices[2] = {&lhs.getFromIndex(), &lhs.getToIndex()};
+	const Index *rhsIndices[2] = {&rhs.getFromIndex(), &rhs.getToIndex()};
+	for(unsigned int n = 0; n < 2; n++){
+		const Index &l = *lhsIndices[n];
+		const Index &r = *rhsIndices[n];
+		unsigned int size = min(l.getSize(), r.getSize());
+		for(unsigned int c = 0; c < size; c++){
+			if(l[c] < r[c])
+				return true;
+			if(l[c] > r[c])
+				return false;
+		}
+		if(l.getSize() != r.getSize())
+			return l.getSize() < r.getSize();
+	}
+
+	return false;
+}
+
+void HoppingAmplitudeSet::createStagingBuffers(){
+	unsigned int numThreads = 1;
+#ifdef TBTK_USE_OPEN_MP
+	numThreads = omp_get_max_threads();
+#endif
+	stagingBuffers.assign(numThreads, StagingBuffer());
+}
+
+void HoppingAmplitudeSet::mergeStagedHoppingAmplitudes(){
+	unsigned int numStagedHoppingAmplitudes = 0;
+	for(unsigned int n = 0; n < stagingBuffers.size(); n++){
+		numStagedHoppingAmplitudes
+			+= stagingBuffers[n].hoppingAmplitudes.size();
+	}
+	if(numStagedHoppingAmplitudes == 0)
+		return;
+	bool isLarge
+		= numStagedHoppingAmplitudes >= MIN_PARALLEL_MERGE_SIZE;
+
+	basisIndexCache.clear();
+
+	//Sort the buffers independently.
+	int numBuffers = stagingBuffers.size();
+	#pragma omp parallel for schedule(dynamic) if(isLarge)
+	for(int n = 0; n < numBuffers; n++){
+		stable_sort(
+			stagingBuffers[n].hoppingAmplitudes.begin(),
+			stagingBuffers[n].hoppingAmplitudes.end(),
+			compareStagedHoppingAmplitudes
+		);
+	}
+
+	//Merge the buffers pairwise until all HoppingAmplitudes are in the
+	//first buffer.
+	for(int step = 1; step < numBuffers; step *= 2){
+		#pragma omp parallel for schedule(dynamic) if(isLarge)
+		for(int n = 0; n < numBuffers - step; n += 2*step){
+			vector<HoppingAmplitude> &first
+				= stagingBuffers[n].hoppingAmplitudes;
+			vector<HoppingAmplitude> &second
+				= stagingBuffers[n + step].hoppingAmplitudes;
+			if(second.size() == 0)
+				continue;
+
+			vector<HoppingAmplitude> merged;
+			merged.reserve(first.size() + second.size());
+			merge(
+				make_move_iterator(first.begin()),
+				make_move_iterator(first.end()),
+				make_move_iterator(second.begin()),
+				make_move_iterator(second.end()),
+				back_inserter(merged),
+				compareStagedHoppingAmplitudes
+			);
+			first.swap(merged);
+			vector<HoppingAmplitude>().swap(second);
+		}
+	}
+
+	HoppingAmplitudeTree::addSorted(stagingBuffers[0].hoppingAmplitudes);
+	vector<HoppingAmplitude>().swap(stagingBuffers[0].hoppingAmplitudes);
+}
+
 };	//End of namespace TBTK
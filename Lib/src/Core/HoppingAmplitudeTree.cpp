@@ -27,10 +27,18 @@
 
 #include "TBTK/json.hpp"
 
+#ifdef TBTK_USE_OPEN_MP
+#	include <omp.h>
+#endif
+
 using namespace std;
 
 namespace TBTK{
 
+//Ranges with fewer HoppingAmplitudes than this are added serially by
+//HoppingAmplitudeTree::addSorted().
+static const unsigned int MIN_PARALLEL_ADD_SORTED_SIZE = 4096;
+
 const HoppingAmplitudeTree HoppingAmplitudeTree::emptyTree;
 
 HoppingAmplitudeTree::HoppingAmplitudeTree(){
@@ -318,6 +326,127 @@ void HoppingAmplitudeTree::_add(HoppingAmplitude &ha, unsigned int subindex){
 	}
 }
 
+void HoppingAmplitudeTree::addSorted(
+	const vector<HoppingAmplitude> &sortedHoppingAmplitudes
+){
+	if(sortedHoppingAmplitudes.size() != 0){
+		_addSorted(
+			sortedHoppingAmplitudes,
+			0,
+			sortedHoppingAmplitudes.size(),
+			0
+		);
+	}
+}
+
+void HoppingAmplitudeTree::_addSorted(
+	const vector<HoppingAmplitude> &sortedHoppingAmplitudes,
+	unsigned int first,
+	unsigned int last,
+	unsigned int subindex
+){
+	//HoppingAmplitudes with from-Indices that end at this node level are
+	//sorted before the longer from-Indices.
+	if(sortedHoppingAmplitudes[first].getFromIndex().getSize() == subindex){
+		const HoppingAmplitude &lastHoppingAmplitude
+			= sortedHoppingAmplitudes[last-1];
+		TBTKAssert(
+			children.size() == 0
+			&& lastHoppingAmplitude.getFromIndex().getSize()
+				== subindex,
+			"HoppingAmplitudeTree::_addSorted()",
+			"Incompatible HoppingAmplitudes. Tried to add a"
+			<< " HoppingAmplitude with from-Index "
+			<< sortedHoppingAmplitudes[first].getFromIndex().toString()
+			<< ", but HoppingAmplitude with from-Index "
+			<< (
+				children.size() == 0 ?
+				lastHoppingAmplitude.getFromIndex()
+				: getFirstHA().getFromIndex()
+			).toString() << " has also been added.",
+			""
+		);
+		hoppingAmplitudes.insert(
+			hoppingAmplitudes.end(),
+			sortedHoppingAmplitudes.begin() + first,
+			sortedHoppingAmplitudes.begin() + last
+		);
+
+		return;
+	}
+
+	TBTKAssert(
+		hoppingAmplitudes.size() == 0,
+		"HoppingAmplitudeTree::_addSorted()",
+		"Incompatible HoppingAmplitudes. Tried to add a"
+		<< " HoppingAmplitude with from-Index "
+		<< sortedHoppingAmplitudes[first].getFromIndex().toString()
+		<< ", but HoppingAmplitude with from-Index "
+		<< hoppingAmplitudes[0].getFromIndex().toString()
+		<< " has already been added.",
+		""
+	);
+
+	//Split the range into groups with the same subindex at this node
+	//level and update isPotentialBlockSeparator.
+	vector<unsigned int> groupBoundaries;
+	for(unsigned int n = first; n < last; n++){
+		const Index &fromIndex
+			= sortedHoppingAmplitudes[n].getFromIndex();
+		const Index &toIndex = sortedHoppingAmplitudes[n].getToIndex();
+		int currentIndex = fromIndex[subindex];
+		TBTKAssert(
+			currentIndex >= 0,
+			"HoppingAmplitudeTree::_addSorted()",
+			"Invalid Index. Only indices with non-negative"
+			<< " subindices can be added. But the from-Index "
+			<< fromIndex.toString() << " has a negative"
+			<< " subindex in position '" << subindex << "'.",
+			""
+		);
+		if(
+			toIndex.getSize() <= subindex
+			|| currentIndex != toIndex[subindex]
+		){
+			isPotentialBlockSeparator = false;
+		}
+		if(
+			n == first
+			|| currentIndex != sortedHoppingAmplitudes[
+				n-1
+			].getFromIndex()[subindex]
+		){
+			groupBoundaries.push_back(n);
+		}
+	}
+	groupBoundaries.push_back(last);
+
+	int maxIndex = sortedHoppingAmplitudes[last-1].getFromIndex()[subindex];
+	for(int n = children.size(); n <= maxIndex; n++)
+		children.push_back(HoppingAmplitudeTree());
+
+	//The groups are added to different child nodes and can therefore be
+	//added in parallel. The parallelization is deferred to the next level
+	//if there is only one group on this level. Nested parallel regions
+	//are executed serially by default.
+	int numGroups = groupBoundaries.size() - 1;
+	#pragma omp parallel for schedule(dynamic) if( \
+		numGroups > 1 && last - first >= MIN_PARALLEL_ADD_SORTED_SIZE \
+	)
+	for(int n = 0; n < numGroups; n++){
+		children[
+			sortedHoppingAmplitudes[
+				groupBoundaries[n]
+			].getFromIndex()[subindex]
+		]._addSorted(
+			sortedHoppingAmplitudes,
+			groupBoundaries[n],
+			groupBoundaries[n+1],
+			subindex + 1
+		);
+	}
+}
+
 HoppingAmplitudeTree* HoppingAmplitudeTree::getSubTree(
 	const Index &subspace
 ){
@@ -703,6 +832,12 @@ string HoppingAmplitudeTree::serialize(Mode mode) const{
 	}
 }
 
+void HoppingAmplitudeTree::clearHoppingAmplitudes(){
+	vector<HoppingAmplitude>().swap(hoppingAmplitudes);
+	for(unsigned int n = 0; n < children.size(); n++)
+		children[n].clearHoppingAmplitudes();
+}
+
 HoppingAmplitude HoppingAmplitudeTree::getFirstHA() const{
 	if(children.size() == 0)
 		return hoppingAmplitudes.at(0);
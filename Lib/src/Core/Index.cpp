@@ -33,16 +33,10 @@ namespace TBTK{
 
 Index::Index(const Index &head, const Index &tail){
 	indices.reserve(head.getSize() + tail.getSize());
-	indices.insert(
-		indices.end(),
-		head.indices.begin(),
-		head.indices.end()
-	);
-	indices.insert(
-		indices.end(),
-		tail.indices.begin(),
-		tail.indices.end()
-	);
+	for(unsigned int n = 0; n < head.getSize(); n++)
+		indices.push_back(head[n]);
+	for(unsigned int n = 0; n < tail.getSize(); n++)
+		indices.push_back(tail[n]);
 }
 
 /*Index::Index(initializer_list<initializer_list<Subindex>> indexList){
@@ -305,7 +299,9 @@ Index::Index(const string &serialization, Serializable::Mode mode){
 
 		try{
 			nlohmann::json j = nlohmann::json::parse(serialization);
-			indices = j.at("indices").get<vector<Subindex>>();
+			indices = SubindexContainer(
+				j.at("indices").get<vector<Subindex>>()
+			);
 		}
 		catch(nlohmann::json::exception &e){
 			TBTKExit(
@@ -417,7 +413,9 @@ string Index::serialize(Serializable::Mode mode) const{
 	{
 		nlohmann::json j;
 		j["id"] = "Index";
-		j["indices"] = nlohmann::json(indices);
+		j["indices"] = nlohmann::json(
+			vector<Subindex>(indices.begin(), indices.end())
+		);
 
 		return j.dump();
 	}
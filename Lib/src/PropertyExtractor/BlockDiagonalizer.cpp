@@ -24,8 +24,13 @@
 #include "TBTK/Functions.h"
 #include "TBTK/Streams.h"
 
+#include <algorithm>
 #include <cmath>
 
+#ifdef TBTK_USE_MPI
+#	include <mpi.h>
+#endif
+
 using namespace std;
 
 static complex<double> i(0, 1);
@@ -34,6 +39,7 @@ namespace TBTK{
 namespace PropertyExtractor{
 
 BlockDiagonalizer::BlockDiagonalizer(){
+	distributedReduction = DistributedReduction::All;
 }
 
 Property::EigenValues BlockDiagonalizer::getEigenValues(){
@@ -43,7 +49,9 @@ Property::EigenValues BlockDiagonalizer::getEigenValues(){
 	Property::EigenValues eigenValues(size);
 	std::vector<double> &data = eigenValues.getDataRW();
 	for(int n = 0; n < size; n++)
-		data[n] = solver.getEigenValue(n);
+		if(solver.isLocalState(n))
+			data[n] = solver.getEigenValue(n);
+	reduce(data);
 
 	return eigenValues;
 }
@@ -85,6 +93,19 @@ Property::WaveFunctions BlockDiagonalizer::calculateWaveFunctions(
 		}
 	}
 
+	for(unsigned int n = 0; n < statesVector.size(); n++){
+		TBTKAssert(
+			!getSolver().isLocalState(statesVector[n])
+			|| getSolver().hasEigenVector(statesVector[n]),
+			"PropertyExtractor::BlockDiagonalizer::calculateWaveFunctions()",
+			"The eigenvector for state '" << statesVector[n] << "' has"
+			<< " not been calculated.",
+			"Use Solver::BlockDiagonalizer::setEigenVectorMode() or"
+			<< " Solver::BlockDiagonalizer::setEigenVectorWindow() to specify"
+			<< " which eigenvectors to calculate."
+		);
+	}
+
 	Property::WaveFunctions waveFunctions(memoryLayout, statesVector);
 
 	Information information;
@@ -95,6 +116,7 @@ Property::WaveFunctions BlockDiagonalizer::calculateWaveFunctions(
 		waveFunctions,
 		information
 	);
+	reduce(waveFunctions.getDataRW());
 
 	return waveFunctions;
 }
@@ -135,6 +157,9 @@ Property::GreensFunction BlockDiagonalizer::calculateGreensFunction(
 	vector<Index> patterns,
 	Property::GreensFunction::Type type
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateGreensFunction()"
+	);
 	PatternValidator::validateGreensFunctionPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -158,6 +183,7 @@ Property::GreensFunction BlockDiagonalizer::calculateGreensFunction(
 			greensFunction,
 			information
 		);
+		reduce(greensFunction.getDataRW());
 
 		return greensFunction;
 	}
@@ -199,6 +225,7 @@ Property::GreensFunction BlockDiagonalizer::calculateGreensFunction(
 			greensFunction,
 			information
 		);
+		reduce(greensFunction.getDataRW());
 
 		return greensFunction;
 	}
@@ -227,10 +254,14 @@ Property::DOS BlockDiagonalizer::calculateDOS(){
 	double dE = dos.getDeltaE();
 	const Solver::BlockDiagonalizer &solver = getSolver();
 	for(int n = 0; n < solver.getModel().getBasisSize(); n++){
+		if(!solver.isLocalState(n))
+			continue;
+
 		int e = round((solver.getEigenValue(n) - energyWindow[0])/dE);
 		if(e >= 0 && e < (int)energyWindow.getResolution())
 			data[e] += 1./dE;
 	}
+	reduce(data);
 
 	return dos;
 }
@@ -239,9 +270,15 @@ complex<double> BlockDiagonalizer::calculateExpectationValue(
 	Index to,
 	Index from
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateExpectationValue()"
+	);
 	complex<double> expectationValue = 0.;
 	const Model &model = getSolver().getModel();
 	for(int n = 0; n < model.getBasisSize(); n++){
+		if(!getSolver().isLocalState(n))
+			continue;
+
 		double weight = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
@@ -252,6 +289,7 @@ complex<double> BlockDiagonalizer::calculateExpectationValue(
 
 		expectationValue += weight*conj(amplitudeTo)*amplitudeFrom;
 	}
+	reduce(reinterpret_cast<double*>(&expectationValue), 2);
 
 	return expectationValue;
 }
@@ -259,6 +297,9 @@ complex<double> BlockDiagonalizer::calculateExpectationValue(
 Property::Density BlockDiagonalizer::calculateDensity(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateDensity()"
+	);
 	PatternValidator::validateDensityPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -272,6 +313,7 @@ Property::Density BlockDiagonalizer::calculateDensity(
 		density,
 		information
 	);
+	reduce(density.getDataRW());
 
 	return density;
 }
@@ -279,6 +321,9 @@ Property::Density BlockDiagonalizer::calculateDensity(
 Property::Magnetization BlockDiagonalizer::calculateMagnetization(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateMagnetization()"
+	);
 	PatternValidator::validateMagnetizationPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -292,6 +337,7 @@ Property::Magnetization BlockDiagonalizer::calculateMagnetization(
 		magnetization,
 		information
 	);
+	reduce(magnetization.getDataRW());
 
 	return magnetization;
 }
@@ -299,6 +345,11 @@ Property::Magnetization BlockDiagonalizer::calculateMagnetization(
 Property::LDOS BlockDiagonalizer::calculateLDOS(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	PatternValidator::validateLDOSPatterns(patterns);
 	TBTKAssert(
 		getEnergyType() == EnergyType::Real,
@@ -319,6 +370,7 @@ Property::LDOS BlockDiagonalizer::calculateLDOS(
 		ldos,
 		information
 	);
+	reduce(ldos.getDataRW());
 
 	return ldos;
 }
@@ -326,6 +378,11 @@ Property::LDOS BlockDiagonalizer::calculateLDOS(
 Property::SpinPolarizedLDOS BlockDiagonalizer::calculateSpinPolarizedLDOS(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::BlockDiagonalizer::calculateSpinPolarizedLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	PatternValidator::validateSpinPolarizedLDOSPatterns(patterns);
 	TBTKAssert(
 		getEnergyType() == EnergyType::Real,
@@ -349,6 +406,7 @@ Property::SpinPolarizedLDOS BlockDiagonalizer::calculateSpinPolarizedLDOS(
 		spinPolarizedLDOS,
 		information
 	);
+	reduce(spinPolarizedLDOS.getDataRW());
 
 	return spinPolarizedLDOS;
 }
@@ -357,12 +415,16 @@ double BlockDiagonalizer::calculateEntropy(){
 	double entropy = 0.;
 	const Model &model = getSolver().getModel();
 	for(int n = 0; n < model.getBasisSize(); n++){
+		if(!getSolver().isLocalState(n))
+			continue;
+
 		double p = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
 		);
 		entropy -= p*log(p);
 	}
+	reduce(&entropy, 1);
 
 	entropy *= UnitHandler::getConstantInNaturalUnits("k_B");
 
@@ -381,9 +443,16 @@ void BlockDiagonalizer::calculateWaveFunctionsCallback(
 		= (Property::WaveFunctions&)property;
 	vector<complex<double>> &data = waveFunctions.getDataRW();
 
+	const Solver::BlockDiagonalizer &solver = propertyExtractor->getSolver();
 	const vector<unsigned int> states = waveFunctions.getStates();
-	for(unsigned int n = 0; n < states.size(); n++)
-		data[offset + n] += propertyExtractor->getAmplitude(states.at(n), index);
+	for(unsigned int n = 0; n < states.size(); n++){
+		if(solver.isLocalState(states.at(n))){
+			data[offset + n] += propertyExtractor->getAmplitude(
+				states.at(n),
+				index
+			);
+		}
+	}
 }
 
 void BlockDiagonalizer::calculateGreensFunctionCallback(
@@ -407,6 +476,8 @@ void BlockDiagonalizer::calculateGreensFunctionCallback(
 	unsigned int lastStateInBlock = solver.getLastStateInBlock(toIndex);
 	if(firstStateInBlock != solver.getFirstStateInBlock(fromIndex))
 		return;
+	if(!solver.isLocalState(firstStateInBlock))
+		return;
 
 	switch(greensFunction.getType()){
 	case Property::GreensFunction::Type::Advanced:
@@ -421,8 +492,8 @@ void BlockDiagonalizer::calculateGreensFunctionCallback(
 		for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
 			double E = energyWindow[e];
 			for(
-				int n = 0;
-				n < solver.getModel().getBasisSize();
+				unsigned int n = firstStateInBlock;
+				n <= lastStateInBlock;
 				n++
 			){
 				double E_n
@@ -508,6 +579,9 @@ void BlockDiagonalizer::calculateDensityCallback(
 
 	int firstStateInBlock = solver.getFirstStateInBlock(index);
 	int lastStateInBlock = solver.getLastStateInBlock(index);
+	if(!solver.isLocalState(firstStateInBlock))
+		return;
+
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			solver.getEigenValue(n),
@@ -537,8 +611,11 @@ void BlockDiagonalizer::calculateMagnetizationCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	int firstStateInBlock = solver.getFirstStateInBlock(index);
-	int lastStateInBlock = solver.getLastStateInBlock(index);
+	int firstStateInBlock = solver.getFirstStateInBlock(index_u);
+	int lastStateInBlock = solver.getLastStateInBlock(index_u);
+	if(!solver.isLocalState(firstStateInBlock))
+		return;
+
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			solver.getEigenValue(n),
@@ -569,6 +646,9 @@ void BlockDiagonalizer::calculateLDOSCallback(
 
 	int firstStateInBlock = solver.getFirstStateInBlock(index);
 	int lastStateInBlock = solver.getLastStateInBlock(index);
+	if(!solver.isLocalState(firstStateInBlock))
+		return;
+
 	double dE = ldos.getDeltaE();
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
@@ -606,8 +686,11 @@ void BlockDiagonalizer::calculateSP_LDOSCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	int firstStateInBlock = solver.getFirstStateInBlock(index);
-	int lastStateInBlock = solver.getLastStateInBlock(index);
+	int firstStateInBlock = solver.getFirstStateInBlock(index_u);
+	int lastStateInBlock = solver.getLastStateInBlock(index_u);
+	if(!solver.isLocalState(firstStateInBlock))
+		return;
+
 	double dE = spinPolarizedLDOS.getDeltaE();
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
@@ -630,5 +713,122 @@ void BlockDiagonalizer::calculateSP_LDOSCallback(
 	}
 }
 
+void BlockDiagonalizer::assertEigenVectorsAvailable(
+	const string &function,
+	double lowerBound,
+	double upperBound
+){
+	const Solver::BlockDiagonalizer &solver = getSolver();
+	for(int n = 0; n < solver.getModel().getBasisSize(); n++){
+		if(!solver.isLocalState(n))
+			continue;
+
+		double eigenValue = solver.getEigenValue(n);
+		if(eigenValue <= lowerBound || eigenValue >= upperBound)
+			continue;
+
+		TBTKAssert(
+			solver.hasEigenVector(n),
+			function,
+			"The eigenvector for state '" << n << "' with eigenvalue '"
+			<< eigenValue << "' is required but has not been"
+			<< " calculated.",
+			"Use Solver::BlockDiagonalizer::setEigenVectorMode() or"
+			<< " Solver::BlockDiagonalizer::setEigenVectorWindow() to specify"
+			<< " which eigenvectors to calculate."
+		);
+	}
+}
+
+void BlockDiagonalizer::reduce(double *data, size_t size) const{
+	if(
+		!getSolver().getDistributedExecution()
+		|| distributedReduction == DistributedReduction::None
+	){
+		return;
+	}
+
+#ifdef TBTK_USE_MPI
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+	//MPI counts elements using int, so large arrays are reduced in
+	//chunks.
+	const size_t MAX_CHUNK_SIZE = numeric_limits<int>::max();
+	for(size_t n = 0; n < size; n += MAX_CHUNK_SIZE){
+		int chunkSize = min(size - n, MAX_CHUNK_SIZE);
+		switch(distributedReduction){
+		case DistributedReduction::All:
+			MPI_Allreduce(
+				MPI_IN_PLACE,
+				data + n,
+				chunkSize,
+				MPI_DOUBLE,
+				MPI_SUM,
+				MPI_COMM_WORLD
+			);
+			break;
+		case DistributedReduction::Root:
+			if(rank == 0){
+				MPI_Reduce(
+					MPI_IN_PLACE,
+					data + n,
+					chunkSize,
+					MPI_DOUBLE,
+					MPI_SUM,
+					0,
+					MPI_COMM_WORLD
+				);
+			}
+			else{
+				MPI_Reduce(
+					data + n,
+					nullptr,
+					chunkSize,
+					MPI_DOUBLE,
+					MPI_SUM,
+					0,
+					MPI_COMM_WORLD
+				);
+			}
+			break;
+		default:
+			TBTKExit(
+				"PropertyExtractor::BlockDiagonalizer::reduce()",
+				"Unknown DistributedReduction.",
+				"This should never happen, contact the developer."
+			);
+		}
+	}
+#else
+	TBTKExit(
+		"PropertyExtractor::BlockDiagonalizer::reduce()",
+		"Distributed execution requires MPI, but TBTK has been"
+		<< " compiled without MPI.",
+		"This should never happen, contact the developer."
+	);
+#endif
+}
+
+void BlockDiagonalizer::reduce(vector<SpinMatrix> &data) const{
+	if(
+		!getSolver().getDistributedExecution()
+		|| distributedReduction == DistributedReduction::None
+	){
+		return;
+	}
+
+	vector<complex<double>> buffer(4*data.size());
+	for(unsigned int n = 0; n < data.size(); n++)
+		for(unsigned int c = 0; c < 4; c++)
+			buffer[4*n + c] = data[n].at(c/2, c%2);
+
+	reduce(buffer);
+
+	for(unsigned int n = 0; n < data.size(); n++)
+		for(unsigned int c = 0; c < 4; c++)
+			data[n].at(c/2, c%2) = buffer[4*n + c];
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -111,7 +111,7 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 	IndexTree memoryLayout;
 	IndexTree fromIndices;
 	set<unsigned int> toIndexSizes;
-	const Solver::ChebyshevExpander &solver = getSolver();
+	Solver::ChebyshevExpander &solver = getSolver();
 	for(unsigned int n = 0; n < patterns.size(); n++){
 		const vector<Index>& pattern = *(patterns.begin() + n);
 
@@ -169,6 +169,8 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 		getEnergyWindow()
 	);
 
+	vector<Index> fromIndexList;
+	vector<vector<Index>> toIndexLists;
 	for(
 		IndexTree::ConstIterator iterator = fromIndices.cbegin();
 		iterator != fromIndices.cend();
@@ -196,34 +198,56 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 				toIndices.push_back(toIndex);
 			}
 		}
+		fromIndexList.push_back(fromIndex);
+		toIndexLists.push_back(toIndices);
+	}
 
-		Property::GreensFunction gf = calculateGreensFunctions(
-			toIndices,
-			fromIndex,
-			type
+	//Calculate the Green's functions for blocks of 'from'-indices to
+	//allow the Solver to perform the recursions for all 'from'-indices in
+	//a block simultaneously.
+	Solver::ChebyshevExpander::Type chebyshevType = getChebyshevType(type);
+	unsigned int blockSize = solver.getBlockSize();
+	std::vector<complex<double>> &data = greensFunction.getDataRW();
+	for(
+		unsigned int blockStart = 0;
+		blockStart < fromIndexList.size();
+		blockStart += blockSize
+	){
+		unsigned int blockEnd = min(
+			blockStart + blockSize,
+			(unsigned int)fromIndexList.size()
 		);
-
-		for(unsigned int n = 0; n < toIndices.size(); n++){
-			std::vector<complex<double>> &data
-				= greensFunction.getDataRW();
-			const std::vector<complex<double>> &dataGF
-				= gf.getData();
-
-			Index compoundIndex = Index({toIndices[n], fromIndex});
-
-			unsigned int offset = greensFunction.getOffset(
-				compoundIndex
-			);
-			unsigned int offsetGF = gf.getOffset(
-				compoundIndex
-			);
-
-			for(
-				unsigned int c = 0;
-				c < getEnergyWindow().getResolution();
-				c++
-			){
-				data[offset + c] = dataGF[offsetGF + c];
+		vector<Index> from(
+			fromIndexList.begin() + blockStart,
+			fromIndexList.begin() + blockEnd
+		);
+		vector<vector<Index>> to(
+			toIndexLists.begin() + blockStart,
+			toIndexLists.begin() + blockEnd
+		);
+		vector<
+			vector<vector<complex<double>>>
+		> coefficients = solver.calculateBlockCoefficients(to, from);
+
+		solver.prepareGreensFunctionGeneration();
+		for(unsigned int b = 0; b < from.size(); b++){
+			#pragma omp parallel for
+			for(unsigned int n = 0; n < to[b].size(); n++){
+				vector<complex<double>> greensFunctionData
+					= solver.generateGreensFunction(
+						coefficients[b][n],
+						chebyshevType
+					);
+				unsigned int offset = greensFunction.getOffset(
+					{to[b][n], from[b]}
+				);
+				for(
+					unsigned int c = 0;
+					c < getEnergyWindow().getResolution();
+					c++
+				){
+					data[offset + c] = greensFunctionData[c];
+				}
 			}
 		}
 	}
@@ -242,27 +266,7 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunctions(
 		from
 	);
 
-	Solver::ChebyshevExpander::Type chebyshevType;
-	switch(type){
-	case Property::GreensFunction::Type::Advanced:
-		chebyshevType = Solver::ChebyshevExpander::Type::Advanced;
-		break;
-	case Property::GreensFunction::Type::Retarded:
-		chebyshevType = Solver::ChebyshevExpander::Type::Retarded;
-		break;
-	case Property::GreensFunction::Type::Principal:
-		chebyshevType = Solver::ChebyshevExpander::Type::Principal;
-		break;
-	case Property::GreensFunction::Type::NonPrincipal:
-		chebyshevType = Solver::ChebyshevExpander::Type::NonPrincipal;
-		break;
-	default:
-		TBTKExit(
-			"PropertyExtractor::ChebyshevExpander::calculateGreensFunctions()",
-			"Unknown GreensFunction type.",
-			"This should never happen, contact the developer."
-		);
-	}
+	Solver::ChebyshevExpander::Type chebyshevType = getChebyshevType(type);
 
 	IndexTree memoryLayout;
 	for(unsigned int n = 0; n < to.size(); n++)
@@ -275,6 +279,7 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunctions(
 	);
 	std::vector<complex<double>> &data = greensFunction.getDataRW();
 
+	solver.prepareGreensFunctionGeneration();
 	#pragma omp parallel for
 	for(unsigned int n = 0; n < to.size(); n++){
 		vector<complex<double>> greensFunctionData = solver.generateGreensFunction(
@@ -337,7 +342,7 @@ Property::Density ChebyshevExpander::calculateDensity(
 
 	Information information;
 	calculate(
-		calculateDensityCallback,
+		collectIndexCallback,
 		density,
 		pattern,
 		ranges,
@@ -345,6 +350,7 @@ Property::Density ChebyshevExpander::calculateDensity(
 		1,
 		information
 	);
+	calculateBatched(accumulateDensity, density);
 
 	return density;
 }
@@ -371,12 +377,13 @@ Property::Density ChebyshevExpander::calculateDensity(
 
 	Information information;
 	calculate(
-		calculateDensityCallback,
+		collectIndexCallback,
 		allIndices,
 		memoryLayout,
 		density,
 		information
 	);
+	calculateBatched(accumulateDensity, density);
 
 	return density;
 }
@@ -452,6 +459,24 @@ Property::Magnetization ChebyshevExpander::calculateMagnetization(
 	return magnetization;
 }
 
+Property::DOS ChebyshevExpander::calculateDOS(){
+	Solver::ChebyshevExpander &solver = getSolver();
+	vector<complex<double>> coefficients
+		= solver.calculateTraceCoefficients();
+	vector<complex<double>> greensFunctionData
+		= solver.generateGreensFunction(
+			coefficients,
+			Solver::ChebyshevExpander::Type::NonPrincipal
+		);
+
+	const Range &energyWindow = getEnergyWindow();
+	Property::DOS dos(energyWindow);
+	for(unsigned int n = 0; n < energyWindow.getResolution(); n++)
+		dos(n) = imag(greensFunctionData[n])/M_PI;
+
+	return dos;
+}
+
 Property::LDOS ChebyshevExpander::calculateLDOS(Index pattern, Index ranges){
 	ensureCompliantRanges(pattern, ranges);
 
@@ -460,7 +485,7 @@ Property::LDOS ChebyshevExpander::calculateLDOS(Index pattern, Index ranges){
 
 	Information information;
 	calculate(
-		calculateLDOSCallback,
+		collectIndexCallback,
 		ldos,
 		pattern,
 		ranges,
@@ -468,6 +493,7 @@ Property::LDOS ChebyshevExpander::calculateLDOS(Index pattern, Index ranges){
 		getEnergyWindow().getResolution(),
 		information
 	);
+	calculateBatched(accumulateLDOS, ldos);
 
 	return ldos;
 }
@@ -494,12 +520,13 @@ Property::LDOS ChebyshevExpander::calculateLDOS(
 
 	Information information;
 	calculate(
-		calculateLDOSCallback,
+		collectIndexCallback,
 		allIndices,
 		memoryLayout,
 		ldos,
 		information
 	);
+	calculateBatched(accumulateLDOS, ldos);
 
 	return ldos;
 }
@@ -581,7 +608,7 @@ Property::SpinPolarizedLDOS ChebyshevExpander::calculateSpinPolarizedLDOS(
 	return spinPolarizedLDOS;
 }
 
-void ChebyshevExpander::calculateDensityCallback(
+void ChebyshevExpander::collectIndexCallback(
 	PropertyExtractor *cb_this,
 	Property::Property &property,
 	const Index &index,
@@ -589,17 +616,78 @@ void ChebyshevExpander::calculateDensityCallback(
 	Information &information
 ){
 	ChebyshevExpander *propertyExtractor = (ChebyshevExpander*)cb_this;
-	Property::Density &density = (Property::Density&)property;
-	vector<double> &data = density.getDataRW();
+	propertyExtractor->batchIndices.push_back(index);
+	propertyExtractor->batchOffsets.push_back(offset);
+}
 
-	Property::GreensFunction greensFunction
-		= propertyExtractor->calculateGreensFunction(
-			index,
-			index,
-			Property::GreensFunction::Type::NonPrincipal
+void ChebyshevExpander::calculateBatched(
+	void (*accumulate)(
+		ChebyshevExpander *propertyExtractor,
+		Property::Property &property,
+		const vector<complex<double>> &greensFunctionData,
+		int offset
+	),
+	Property::Property &property
+){
+	Solver::ChebyshevExpander &solver = getSolver();
+	unsigned int blockSize = solver.getBlockSize();
+	for(
+		unsigned int blockStart = 0;
+		blockStart < batchIndices.size();
+		blockStart += blockSize
+	){
+		unsigned int blockEnd = min(
+			blockStart + blockSize,
+			(unsigned int)batchIndices.size()
 		);
-	const std::vector<complex<double>> &greensFunctionData
-		= greensFunction.getData();
+		vector<Index> from(
+			batchIndices.begin() + blockStart,
+			batchIndices.begin() + blockEnd
+		);
+		vector<vector<Index>> to;
+		for(unsigned int n = 0; n < from.size(); n++)
+			to.push_back({from[n]});
+
+		vector<
+			vector<vector<complex<double>>>
+		> coefficients = solver.calculateBlockCoefficients(to, from);
+
+		vector<vector<complex<double>>> greensFunctionData(
+			from.size()
+		);
+		solver.prepareGreensFunctionGeneration();
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < from.size(); n++){
+			greensFunctionData[n] = solver.generateGreensFunction(
+				coefficients[n][0],
+				Solver::ChebyshevExpander::Type::NonPrincipal
+			);
+		}
+
+		//Accumulated serially since several indices can contribute to
+		//the same offset when summation indices are used.
+		for(unsigned int n = 0; n < from.size(); n++){
+			accumulate(
+				this,
+				property,
+				greensFunctionData[n],
+				batchOffsets[blockStart + n]
+			);
+		}
+	}
+
+	batchIndices.clear();
+	batchOffsets.clear();
+}
+
+void ChebyshevExpander::accumulateDensity(
+	ChebyshevExpander *propertyExtractor,
+	Property::Property &property,
+	const vector<complex<double>> &greensFunctionData,
+	int offset
+){
+	Property::Density &density = (Property::Density&)property;
+	vector<double> &data = density.getDataRW();
 
 	const Model &model = propertyExtractor->getSolver().getModel();
 
@@ -658,26 +746,15 @@ void ChebyshevExpander::calculateMAGCallback(
 	}
 }
 
-void ChebyshevExpander::calculateLDOSCallback(
-	PropertyExtractor *cb_this,
+void ChebyshevExpander::accumulateLDOS(
+	ChebyshevExpander *propertyExtractor,
 	Property::Property &property,
-	const Index &index,
-	int offset,
-	Information &information
+	const vector<complex<double>> &greensFunctionData,
+	int offset
 ){
-	ChebyshevExpander *propertyExtractor = (ChebyshevExpander*)cb_this;
 	Property::LDOS &ldos = (Property::LDOS&)property;
 	vector<double> &data = ldos.getDataRW();
 
-	Property::GreensFunction greensFunction
-		= propertyExtractor->calculateGreensFunction(
-			index,
-			index,
-			Property::GreensFunction::Type::NonPrincipal
-		);
-	const std::vector<complex<double>> &greensFunctionData
-		= greensFunction.getData();
-
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	for(unsigned int n = 0; n < energyWindow.getResolution(); n++)
 		data[offset + n] += imag(greensFunctionData[n])/M_PI;
@@ -719,5 +796,26 @@ void ChebyshevExpander::calculateSP_LDOSCallback(
 	}
 }
 
+Solver::ChebyshevExpander::Type ChebyshevExpander::getChebyshevType(
+	Property::GreensFunction::Type type
+){
+	switch(type){
+	case Property::GreensFunction::Type::Advanced:
+		return Solver::ChebyshevExpander::Type::Advanced;
+	case Property::GreensFunction::Type::Retarded:
+		return Solver::ChebyshevExpander::Type::Retarded;
+	case Property::GreensFunction::Type::Principal:
+		return Solver::ChebyshevExpander::Type::Principal;
+	case Property::GreensFunction::Type::NonPrincipal:
+		return Solver::ChebyshevExpander::Type::NonPrincipal;
+	default:
+		TBTKExit(
+			"PropertyExtractor::ChebyshevExpander::getChebyshevType()",
+			"Unknown GreensFunction type.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
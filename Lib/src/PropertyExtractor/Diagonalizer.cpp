@@ -48,11 +48,11 @@ Property::WaveFunctions Diagonalizer::calculateWaveFunctions(
 	PatternValidator::validateWaveFunctionPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
-	const Model &model = getSolver().getModel();
 
 	vector<unsigned int> statesVector;
 	if(states.size() == 1 && (*states.begin()).isWildcard()){
-		for(int n = 0; n < model.getBasisSize(); n++)
+		int numStates = getSolver().getEigenValues().getSize();
+		for(int n = 0; n < numStates; n++)
 			statesVector.push_back(n);
 	}
 	else{
@@ -67,6 +67,18 @@ Property::WaveFunctions Diagonalizer::calculateWaveFunctions(
 		}
 	}
 
+	for(unsigned int n = 0; n < statesVector.size(); n++){
+		TBTKAssert(
+			getSolver().hasEigenVector(statesVector[n]),
+			"PropertyExtractor::Diagonalizer::calculateWaveFunctions()",
+			"The eigenvector for state '" << statesVector[n] << "' has"
+			<< " not been calculated.",
+			"Use Solver::Diagonalizer::setEigenVectorMode() or"
+			<< " Solver::Diagonalizer::setEigenVectorWindow() to specify"
+			<< " which eigenvectors to calculate."
+		);
+	}
+
 	Property::WaveFunctions waveFunctions(memoryLayout, statesVector);
 	Information information;
 	calculate(
@@ -74,7 +86,8 @@ Property::WaveFunctions Diagonalizer::calculateWaveFunctions(
 		allIndices,
 		memoryLayout,
 		waveFunctions,
-		information
+		information,
+		true
 	);
 
 	return waveFunctions;
@@ -84,6 +97,9 @@ Property::GreensFunction Diagonalizer::calculateGreensFunction(
 	const vector<Index> &patterns,
 	Property::GreensFunction::Type type
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateGreensFunction()"
+	);
 	PatternValidator::validateGreensFunctionPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -107,7 +123,8 @@ Property::GreensFunction Diagonalizer::calculateGreensFunction(
 			allIndices,
 			memoryLayout,
 			greensFunction,
-			information
+			information,
+			true
 		);
 
 		break;
@@ -148,7 +165,8 @@ Property::GreensFunction Diagonalizer::calculateGreensFunction(
 			allIndices,
 			memoryLayout,
 			greensFunction,
-			information
+			information,
+			true
 		);
 
 		break;
@@ -182,9 +200,16 @@ Property::DOS Diagonalizer::calculateDOS(){
 }
 
 complex<double> Diagonalizer::calculateExpectationValue(Index to, Index from){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateExpectationValue()"
+	);
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateExpectationValue()"
+	);
 	complex<double> expectationValue = 0.;
 	const Model &model = getSolver().getModel();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	int numStates = getSolver().getEigenValues().getSize();
+	for(int n = 0; n < numStates; n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
@@ -199,6 +224,12 @@ complex<double> Diagonalizer::calculateExpectationValue(Index to, Index from){
 }
 
 Property::Density Diagonalizer::calculateDensity(Index pattern, Index ranges){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateDensity()"
+	);
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateDensity()"
+	);
 	ensureCompliantRanges(pattern, ranges);
 
 	vector<int> loopRanges = getLoopRanges(pattern, ranges);
@@ -212,13 +243,20 @@ Property::Density Diagonalizer::calculateDensity(Index pattern, Index ranges){
 		ranges,
 		0,
 		1,
-		information
+		information,
+		true
 	);
 
 	return density;
 }
 
 Property::Density Diagonalizer::calculateDensity(vector<Index> patterns){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateDensity()"
+	);
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateDensity()"
+	);
 	PatternValidator::validateDensityPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -230,7 +268,8 @@ Property::Density Diagonalizer::calculateDensity(vector<Index> patterns){
 		allIndices,
 		memoryLayout,
 		density,
-		information
+		information,
+		true
 	);
 
 	return density;
@@ -240,6 +279,12 @@ Property::Magnetization Diagonalizer::calculateMagnetization(
 	Index pattern,
 	Index ranges
 ){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateMagnetization()"
+	);
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateMagnetization()"
+	);
 	Information information;
 	for(unsigned int n = 0; n < pattern.getSize(); n++){
 		if(pattern.at(n).isSpinIndex()){
@@ -269,7 +314,8 @@ Property::Magnetization Diagonalizer::calculateMagnetization(
 		ranges,
 		0,
 		1,
-		information
+		information,
+		true
 	);
 
 	return magnetization;
@@ -278,6 +324,12 @@ Property::Magnetization Diagonalizer::calculateMagnetization(
 Property::Magnetization Diagonalizer::calculateMagnetization(
 	vector<Index> patterns
 ){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateMagnetization()"
+	);
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateMagnetization()"
+	);
 	PatternValidator::validateMagnetizationPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -289,7 +341,8 @@ Property::Magnetization Diagonalizer::calculateMagnetization(
 		allIndices,
 		memoryLayout,
 		magnetization,
-		information
+		information,
+		true
 	);
 
 	return magnetization;
@@ -299,6 +352,11 @@ Property::LDOS Diagonalizer::calculateLDOS(
 	Index pattern,
 	Index ranges
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	ensureCompliantRanges(pattern, ranges);
 
 	vector<int> loopRanges = getLoopRanges(pattern, ranges);
@@ -312,7 +370,8 @@ Property::LDOS Diagonalizer::calculateLDOS(
 		ranges,
 		0,
 		getEnergyWindow().getResolution(),
-		information
+		information,
+		true
 	);
 
 	return ldos;
@@ -321,6 +380,11 @@ Property::LDOS Diagonalizer::calculateLDOS(
 Property::LDOS Diagonalizer::calculateLDOS(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	PatternValidator::validateLDOSPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -332,7 +396,8 @@ Property::LDOS Diagonalizer::calculateLDOS(
 		allIndices,
 		memoryLayout,
 		ldos,
-		information
+		information,
+		true
 	);
 
 	return ldos;
@@ -342,6 +407,11 @@ Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 	Index pattern,
 	Index ranges
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateSpinPolarizedLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	Information information;
 	for(unsigned int n = 0; n < pattern.getSize(); n++){
 		if(pattern.at(n).isSpinIndex()){
@@ -374,7 +444,8 @@ Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 		ranges,
 		0,
 		getEnergyWindow().getResolution(),
-		information
+		information,
+		true
 	);
 
 	return spinPolarizedLDOS;
@@ -383,6 +454,11 @@ Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 	vector<Index> patterns
 ){
+	assertEigenVectorsAvailable(
+		"PropertyExtractor::Diagonalizer::calculateSpinPolarizedLDOS()",
+		getEnergyWindow()[0],
+		getEnergyWindow().getLast()
+	);
 	PatternValidator::validateSpinPolarizedLDOSPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
@@ -397,16 +473,21 @@ Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 		allIndices,
 		memoryLayout,
 		spinPolarizedLDOS,
-		information
+		information,
+		true
 	);
 
 	return spinPolarizedLDOS;
 }
 
 double Diagonalizer::calculateEntropy(){
+	assertFullSpectrum(
+		"PropertyExtractor::Diagonalizer::calculateEntropy()"
+	);
 	double entropy = 0.;
 	const Model &model = getSolver().getModel();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	int numStates = getSolver().getEigenValues().getSize();
+	for(int n = 0; n < numStates; n++){
 		double p = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
@@ -445,6 +526,8 @@ void Diagonalizer::calculateGreensFunctionCallback(
 ){
 	Diagonalizer *propertyExtractor = (Diagonalizer*)cb_this;
 	const Model &model = propertyExtractor->getSolver().getModel();
+	int numStates
+		= propertyExtractor->getSolver().getEigenValues().getSize();
 
 	vector<Index> components = index.split();
 
@@ -477,7 +560,7 @@ void Diagonalizer::calculateGreensFunctionCallback(
 		for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
 			double E = energyWindow[e];;
 
-			for(int n = 0; n < model.getBasisSize(); n++){
+			for(int n = 0; n < numStates; n++){
 				double E_n = propertyExtractor->getEigenValue(n);
 				complex<double> amplitude0
 					= propertyExtractor->getAmplitude(n, components[0]);
@@ -502,7 +585,7 @@ void Diagonalizer::calculateGreensFunctionCallback(
 			complex<double> E = greensFunction.getMatsubaraEnergy(e)
 				+ chemicalPotential;
 
-			for(int n = 0; n < model.getBasisSize(); n++){
+			for(int n = 0; n < numStates; n++){
 				double E_n = propertyExtractor->getEigenValue(n);
 				complex<double> amplitude0
 					= propertyExtractor->getAmplitude(n, components[0]);
@@ -543,7 +626,7 @@ void Diagonalizer::calculateDensityCallback(
 	const Model &model = solver.getModel();
 
 	const CArray<double> &eigenValues = solver.getEigenValues();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(int n = 0; n < (int)eigenValues.getSize(); n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			eigenValues[n],
 			model
@@ -575,7 +658,7 @@ void Diagonalizer::calculateMAGCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(int n = 0; n < (int)eigenValues.getSize(); n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			eigenValues[n],
 			model
@@ -630,7 +713,6 @@ void Diagonalizer::calculateSP_LDOSCallback(
 		= (Property::SpinPolarizedLDOS&)property;
 	vector<SpinMatrix> &data = spinPolarizedLDOS.getDataRW();
 	const Solver::Diagonalizer &solver = propertyExtractor->getSolver();
-	const Model &model = solver.getModel();
 
 	const CArray<double> &eigenValues = solver.getEigenValues();
 
@@ -642,7 +724,7 @@ void Diagonalizer::calculateSP_LDOSCallback(
 	index_d.at(spinIndex) = 1;
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	double dE = spinPolarizedLDOS.getDeltaE();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(int n = 0; n < (int)eigenValues.getSize(); n++){
 		if(
 			eigenValues[n] > energyWindow[0]
 			&& eigenValues[n] < energyWindow.getLast()
@@ -663,5 +745,41 @@ void Diagonalizer::calculateSP_LDOSCallback(
 	}
 }
 
+void Diagonalizer::assertEigenVectorsAvailable(
+	const string &function,
+	double lowerBound,
+	double upperBound
+){
+	const Solver::Diagonalizer &solver = getSolver();
+	int numStates = solver.getEigenValues().getSize();
+	for(int n = 0; n < numStates; n++){
+		double eigenValue = solver.getEigenValue(n);
+		if(eigenValue <= lowerBound || eigenValue >= upperBound)
+			continue;
+
+		TBTKAssert(
+			solver.hasEigenVector(n),
+			function,
+			"The eigenvector for state '" << n << "' with eigenvalue '"
+			<< eigenValue << "' is required but has not been"
+			<< " calculated.",
+			"Use Solver::Diagonalizer::setEigenVectorMode() or"
+			<< " Solver::Diagonalizer::setEigenVectorWindow() to specify"
+			<< " which eigenvectors to calculate."
+		);
+	}
+}
+
+void Diagonalizer::assertFullSpectrum(const string &function){
+	TBTKAssert(
+		getSolver().hasFullSpectrum(),
+		function,
+		"The full spectrum is required but only part of it has been"
+		<< " calculated.",
+		"Use Solver::Diagonalizer::setFullSpectrum() to calculate all"
+		<< " eigenvalues."
+	);
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -470,5 +470,10 @@ MatsubaraSusceptibility::SusceptibilityBlockInformation::SusceptibilityBlockInfo
 	calculateSusceptibilityForAllBlocks = false;
 }
 
+MatsubaraSusceptibility::SusceptibilityBlockInformation* MatsubaraSusceptibility::SusceptibilityBlockInformation::clone(
+) const{
+	return new SusceptibilityBlockInformation(*this);
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -21,6 +21,9 @@
 #include "TBTK/PropertyExtractor/PropertyExtractor.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
+#include <typeinfo>
+
 using namespace std;
 
 namespace TBTK{
@@ -433,9 +436,110 @@ IndexTree PropertyExtractor::generateIndexTree(
 	return indexTree;
 }
 
+void PropertyExtractor::collectIndicesCallback(
+	PropertyExtractor *cb_this,
+	Property::Property &property,
+	const Index &index,
+	int offset,
+	Information &information
+){
+	IndexCollectionInformation &indexCollectionInformation
+		= (IndexCollectionInformation&)information;
+	indexCollectionInformation.indices.push_back(index);
+	indexCollectionInformation.offsets.push_back(offset);
+}
+
+void PropertyExtractor::calculateInParallel(
+	void (*callback)(
+		PropertyExtractor *cb_this,
+		Property::Property &property,
+		const Index &index,
+		int offset,
+		Information &information
+	),
+	Property::Property &property,
+	const vector<Index> &indices,
+	const vector<int> &offsets,
+	const vector<int> &spinIndices,
+	Information &information
+){
+	//Group the Indices by memory offset while preserving the order within
+	//each group, such that summations are performed in the same order as
+	//in a serial calculation.
+	vector<unsigned int> order(indices.size());
+	for(unsigned int n = 0; n < order.size(); n++)
+		order[n] = n;
+	stable_sort(
+		order.begin(),
+		order.end(),
+		[&offsets](unsigned int lhs, unsigned int rhs){
+			return offsets[lhs] < offsets[rhs];
+		}
+	);
+	vector<unsigned int> groupStarts;
+	for(unsigned int n = 0; n < order.size(); n++)
+		if(n == 0 || offsets[order[n]] != offsets[order[n-1]])
+			groupStarts.push_back(n);
+	groupStarts.push_back(order.size());
+	int numGroups = groupStarts.size() - 1;
+
+	//Information::clone() is not pure virtual since the Information is
+	//instantiated directly. Make sure that the threads do not receive a
+	//sliced copy of a class that extends the Information.
+	Information *informationCopy = information.clone();
+	TBTKAssert(
+		typeid(*informationCopy) == typeid(information),
+		"PropertyExtractor::calculateInParallel()",
+		"The Information was cloned into an object of type '"
+		<< typeid(*informationCopy).name() << "', but the original has"
+		<< " type '" << typeid(information).name() << "'.",
+		"This is a bug in the class that extends the Information. It"
+		<< " must override Information::clone()."
+	);
+	delete informationCopy;
+
+	#pragma omp parallel
+	{
+		Information *threadInformation = information.clone();
+
+		#pragma omp for schedule(dynamic)
+		for(int g = 0; g < numGroups; g++){
+			for(
+				unsigned int n = groupStarts[g];
+				n < groupStarts[g+1];
+				n++
+			){
+				unsigned int i = order[n];
+				if(spinIndices.size() != 0 && spinIndices[i] != -1)
+					threadInformation->setSpinIndex(
+						spinIndices[i]
+					);
+
+				callback(
+					this,
+					property,
+					indices[i],
+					offsets[i],
+					*threadInformation
+				);
+			}
+		}
+
+		delete threadInformation;
+	}
+}
+
 PropertyExtractor::Information::Information(){
 	spinIndex = -1;
 }
 
+PropertyExtractor::Information::~Information(){
+}
+
+PropertyExtractor::Information* PropertyExtractor::Information::clone(
+) const{
+	return new Information(*this);
+}
+
 };	//End of namesapce PropertyExtractor
 };	//End of namespace TBTK
@@ -416,5 +416,10 @@ SelfEnergy2::SelfEnergyBlockInformation::SelfEnergyBlockInformation(){
 	calculateSelfEnergyForAllBlocks = false;
 }
 
+SelfEnergy2::SelfEnergyBlockInformation* SelfEnergy2::SelfEnergyBlockInformation::clone(
+) const{
+	return new SelfEnergyBlockInformation(*this);
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -44,7 +44,7 @@ DynamicTypeInformation ArnoldiIterator::dynamicTypeInformation(
 ArnoldiIterator::ArnoldiIterator(
 ) :
 	Communicator(false),
-	matrix(SparseMatrix<complex<double>>::StorageFormat::CSC)
+	matrix(SparseMatrix<complex<double>>::StorageFormat::CSR)
 {
 	mode = Mode::Normal;
 
@@ -655,39 +655,10 @@ bool ArnoldiIterator::executeReverseCommunicationMessage(
 			//workd[ipntr[0]] and y = workd[ipntr[1]]. "-1" is for
 			//conversion between Fortran one based indices and c++
 			//zero based indices.
-			for(int n = 0; n < basisSize; n++)
-				workd[(ipntr[1] - 1) + n] = 0.;
-
-/*			const Model &model = getModel();
-			int numMatrixElements = model.getHoppingAmplitudeSet().getNumMatrixElements();
-			const int *cooRowIndices = model.getHoppingAmplitudeSet().getCOORowIndices();
-			const int *cooColIndices = model.getHoppingAmplitudeSet().getCOOColIndices();
-			const complex<double> *cooValues = model.getHoppingAmplitudeSet().getCOOValues();
-			for(int n = 0; n < numMatrixElements; n++)
-				workd[(ipntr[1] - 1) + cooRowIndices[n]] += cooValues[n]*workd[(ipntr[0] - 1) + cooColIndices[n]];*/
-			const unsigned int *cscRowIndices = matrix.getCSCRows();
-			const unsigned int *cscColPointers = matrix.getCSCColumnPointers();
-			const complex<double> *cscValues
-				= matrix.getCSCValues();
-			for(
-				unsigned int column = 0;
-				column < matrix.getNumColumns();
-				column++
-			){
-				for(
-					unsigned int n = cscColPointers[column];
-					n < cscColPointers[column+1];
-					n++
-				){
-					workd[
-						(ipntr[1] - 1)
-						+ cscRowIndices[n]
-					] += cscValues[n]*workd[
-						(ipntr[0] - 1)
-						+ column
-					];
-				}
-			}
+			matrix.multiply(
+				&workd[ipntr[0] - 1],
+				&workd[ipntr[1] - 1]
+			);
 
 			//Apply shift.
 /*			for(int n = 0; n < basisSize; n++)
@@ -777,53 +748,42 @@ void ArnoldiIterator::initNormal(){
 
 	const Model &model = getModel();
 
-	matrix = SparseMatrix<complex<double>>(
-		SparseMatrix<complex<double>>::StorageFormat::CSC
+	//Copy the cached Hamiltonian and subtract the shift from the diagonal.
+	matrix = model.getHoppingAmplitudeSet().getSparseMatrix(
+		SparseMatrix<complex<double>>::StorageFormat::CSR
 	);
-
-	for(
-		HoppingAmplitudeSet::ConstIterator iterator
-			= getModel().getHoppingAmplitudeSet().cbegin();
-		iterator != getModel().getHoppingAmplitudeSet().cend();
-		++iterator
-	){
-		int from = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getFromIndex()
-		);
-		int to = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getToIndex()
+	if(shift != 0){
+		SparseMatrix<complex<double>> shiftMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR,
+			model.getBasisSize(),
+			model.getBasisSize()
 		);
-		matrix.add(to, from, (*iterator).getAmplitude());
+		for(int n = 0; n < model.getBasisSize(); n++)
+			shiftMatrix.add(n, n, shift);
+		shiftMatrix.construct();
+		matrix -= shiftMatrix;
 	}
-	for(int n = 0; n < model.getBasisSize(); n++)
-		matrix.add(n, n, -shift);
-	matrix.constructCSX();
 }
 
 void ArnoldiIterator::initShiftAndInvert(){
 	const Model &model = getModel();
 
-	SparseMatrix<complex<double>> matrix(
-		SparseMatrix<complex<double>>::StorageFormat::CSC
-	);
-
-	for(
-		HoppingAmplitudeSet::ConstIterator iterator
-			= getModel().getHoppingAmplitudeSet().cbegin();
-		iterator != getModel().getHoppingAmplitudeSet().cend();
-		++iterator
-	){
-		int from = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getFromIndex()
+	//Copy the cached Hamiltonian and subtract the shift from the diagonal.
+	SparseMatrix<complex<double>> matrix
+		= model.getHoppingAmplitudeSet().getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSC
 		);
-		int to = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getToIndex()
+	if(shift != 0){
+		SparseMatrix<complex<double>> shiftMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSC,
+			model.getBasisSize(),
+			model.getBasisSize()
 		);
-		matrix.add(to, from, (*iterator).getAmplitude());
+		for(int n = 0; n < model.getBasisSize(); n++)
+			shiftMatrix.add(n, n, shift);
+		shiftMatrix.construct();
+		matrix -= shiftMatrix;
 	}
-	for(int n = 0; n < model.getBasisSize(); n++)
-		matrix.add(n, n, -shift);
-	matrix.constructCSX();
 
 	luSolver.setMatrix(matrix);
 }
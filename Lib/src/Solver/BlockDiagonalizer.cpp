@@ -19,16 +19,55 @@
  */
 
 #include "TBTK/Solver/BlockDiagonalizer.h"
+#include "TBTK/Solver/HermitianTridiagonalizer.h"
+#include "TBTK/Matrix.h"
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iomanip>
+#include <queue>
+
+#ifdef TBTK_USE_MPI
+#	include <mpi.h>
+#endif
+#ifdef TBTK_USE_OPEN_MP
+#	include <omp.h>
+#endif
+
+//Thread control for threaded BLAS/LAPACK implementations. The symbols are
+//declared weak and are null unless OpenBLAS or MKL is linked.
+#ifdef __GNUC__
+extern "C" void openblas_set_num_threads(int numThreads) __attribute__((weak));
+extern "C" int openblas_get_num_threads() __attribute__((weak));
+extern "C" int mkl_set_num_threads_local(int numThreads) __attribute__((weak));
+#endif
 
 using namespace std;
 
 namespace TBTK{
 namespace Solver{
 
+//Set the number of threads used by BLAS/LAPACK and return the previous
+//value, or zero if the number of threads is unknown. MKL sets the number for
+//the calling thread only. Zero restores MKL's global setting.
+static int setBLASNumThreads(int numThreads){
+	int previousNumThreads = 0;
+#ifdef __GNUC__
+	if(openblas_set_num_threads && openblas_get_num_threads){
+		previousNumThreads = openblas_get_num_threads();
+		if(numThreads > 0)
+			openblas_set_num_threads(numThreads);
+	}
+	if(mkl_set_num_threads_local)
+		previousNumThreads = mkl_set_num_threads_local(numThreads);
+#endif
+
+	return previousNumThreads;
+}
+
 DynamicTypeInformation BlockDiagonalizer::dynamicTypeInformation(
 	"Solver::BlockDiagonalizer",
 	{&Solver::dynamicTypeInformation}
@@ -39,6 +78,12 @@ BlockDiagonalizer::BlockDiagonalizer() : Communicator(false){
 	selfConsistencyCallback = nullptr;
 
 	parallelExecution = false;
+	distributedExecution = false;
+	irreducibleBrillouinZone = nullptr;
+
+	eigenVectorMode = EigenVectorMode::All;
+	eigenVectorWindowLowerBound = 0;
+	eigenVectorWindowUpperBound = 0;
 }
 
 void BlockDiagonalizer::run(){
@@ -69,8 +114,10 @@ void BlockDiagonalizer::run(){
 			break;
 		}
 	}
-	if(getGlobalVerbose() && getVerbose())
+	if(getGlobalVerbose() && getVerbose()){
 		Streams::out << "\n";
+		printBlockTimings();
+	}
 }
 
 void BlockDiagonalizer::init(){
@@ -82,7 +129,14 @@ void BlockDiagonalizer::init(){
 		getModel().getHoppingAmplitudeSet()
 	);
 
-	/** Calculate block sizes and blockOffsets. */
+	//Determine which blocks to diagonalize and which blocks to solve on
+	//this process.
+	reduceBlocks();
+	distributeBlocks();
+
+	/** Calculate block sizes and blockOffsets. Blocks that are solved by
+	 *  other processes are given zero size. Blocks that are reconstructed
+	 *  from an irreducible block do not need a Hamiltonian. */
 	blockSizes.clear();
 	eigenVectorSizes.clear();
 	blockOffsets.clear();
@@ -92,10 +146,19 @@ void BlockDiagonalizer::init(){
 		n < blockStructureDescriptor.getNumBlocks();
 		n++
 	){
-		unsigned int numStates
-			= blockStructureDescriptor.getNumStatesInBlock(n);
-		blockSizes.push_back((numStates*(numStates+1))/2);
-		eigenVectorSizes.push_back(numStates*numStates);
+		unsigned int numStates = localBlocks[n]
+			? blockStructureDescriptor.getNumStatesInBlock(n)
+			: 0;
+		unsigned int numHamiltonianStates = isIrreducibleBlock(n)
+			? numStates
+			: 0;
+		blockSizes.push_back(
+			(numHamiltonianStates*(numHamiltonianStates+1))/2
+		);
+		if(eigenVectorMode == EigenVectorMode::All)
+			eigenVectorSizes.push_back(numStates*numStates);
+		else
+			eigenVectorSizes.push_back(0);
 		if(n == 0){
 			blockOffsets.push_back(0);
 			eigenVectorOffsets.push_back(0);
@@ -120,12 +183,20 @@ void BlockDiagonalizer::init(){
 		n < blockStructureDescriptor.getNumBlocks();
 		n++
 	){
-		unsigned int numStatesInBlock
-			= blockStructureDescriptor.getNumStatesInBlock(n);
-		hamiltonianSize += (numStatesInBlock*(numStatesInBlock + 1))/2;
-		eigenVectorsSize += numStatesInBlock*numStatesInBlock;
+		hamiltonianSize += blockSizes.at(n);
+		eigenVectorsSize += eigenVectorSizes.at(n);
 	}
 
+	//Which eigenvectors that are available is determined in solve().
+	firstEigenVectorInBlock.assign(
+		blockStructureDescriptor.getNumBlocks(),
+		0
+	);
+	numEigenVectorsInBlock.assign(
+		blockStructureDescriptor.getNumBlocks(),
+		0
+	);
+
 	if(getGlobalVerbose() && getVerbose()){
 		size_t numBytesHamiltonian = hamiltonianSize*sizeof(
 			complex<double>
@@ -154,7 +225,11 @@ void BlockDiagonalizer::init(){
 				<< numBytesHamiltonian/1024/1024/1024
 				<< "GB\n";
 		}
-		if(numBytesEigenVectors < 1024){
+		if(eigenVectorMode == EigenVectorMode::Window){
+			Streams::out << "\tEigenvectors size: Determined by"
+				<< " the eigenvector window\n";
+		}
+		else if(numBytesEigenVectors < 1024){
 			Streams::out << "\tEigenvectors size: "
 				<< numBytesEigenVectors << "B\n";
 		}
@@ -171,13 +246,38 @@ void BlockDiagonalizer::init(){
 				<< numBytesEigenVectors/1024/1024/1024
 				<< "GB\n";
 		}
+		if(eigenVectorScratchFile.compare("") != 0){
+			Streams::out << "\tEigenvectors stored in: "
+				<< eigenVectorScratchFile << "\n";
+		}
 		Streams::out << "\tNumber of blocks: "
 			<< blockStructureDescriptor.getNumBlocks() << "\n";
+		if(irreducibleBrillouinZone != nullptr){
+			unsigned int numIrreducibleBlocks = 0;
+			for(
+				unsigned int n = 0;
+				n < blockStructureDescriptor.getNumBlocks();
+				n++
+			){
+				if(isIrreducibleBlock(n))
+					numIrreducibleBlocks++;
+			}
+			Streams::out << "\tNumber of irreducible blocks: "
+				<< numIrreducibleBlocks << "\n";
+		}
+		if(distributedExecution){
+			Streams::out << "\tNumber of local blocks: "
+				<< count(
+					localBlocks.begin(),
+					localBlocks.end(),
+					true
+				) << "\n";
+		}
 	}
 
 	hamiltonian = CArray<complex<double>>(hamiltonianSize);
-	eigenValues = CArray<double>(getModel().getBasisSize());
-	eigenVectors = CArray<complex<double>>(eigenVectorsSize);
+	eigenValues = CArray<double>(getModel().getBasisSize(), 0);
+	allocateEigenVectors(eigenVectorsSize);
 
 	update();
 }
@@ -185,17 +285,7 @@ void BlockDiagonalizer::init(){
 void BlockDiagonalizer::update(){
 	const Model &model = getModel();
 
-	unsigned int hamiltonianSize = 0;
-	for(
-		unsigned int n = 0;
-		n < blockStructureDescriptor.getNumBlocks();
-		n++
-	){
-		unsigned int numStatesInBlock
-			= blockStructureDescriptor.getNumStatesInBlock(n);
-		hamiltonianSize += (numStatesInBlock*(numStatesInBlock + 1))/2;
-	}
-	for(unsigned int n = 0; n < hamiltonianSize; n++)
+	for(unsigned int n = 0; n < hamiltonian.getSize(); n++)
 		hamiltonian[n] = 0.;
 
 	IndexTree blockIndices
@@ -224,6 +314,9 @@ void BlockDiagonalizer::update(){
 
 		#pragma omp parallel for
 		for(unsigned int block = 0; block < iterators.size(); block++){
+			if(!localBlocks[block] || !isIrreducibleBlock(block))
+				continue;
+
 			HoppingAmplitudeSet::ConstIterator &iterator
 				= iterators[block];
 			HoppingAmplitudeSet::ConstIterator &endIterator
@@ -254,6 +347,16 @@ void BlockDiagonalizer::update(){
 	else{
 		unsigned int blockCounter = 0;
 		while(blockIterator != blockIndices.cend()){
+			if(
+				!localBlocks[blockCounter]
+				|| !isIrreducibleBlock(blockCounter)
+			){
+				blockCounter++;
+				++blockIterator;
+
+				continue;
+			}
+
 			Index blockIndex = *blockIterator;
 
 			HoppingAmplitudeSet::ConstIterator iterator
@@ -290,6 +393,22 @@ void BlockDiagonalizer::update(){
 	}
 }
 
+void BlockDiagonalizer::allocateEigenVectors(size_t size){
+	//Release the previous eigenvectors before allocating new memory.
+	eigenVectorStorage = CArray<complex<double>>();
+	eigenVectorScratchStorage = MemoryMappedFile();
+
+	if(eigenVectorScratchFile.compare("") == 0){
+		eigenVectorStorage = CArray<complex<double>>(size);
+	}
+	else{
+		eigenVectorScratchStorage = MemoryMappedFile(
+			eigenVectorScratchFile,
+			size*sizeof(complex<double>)
+		);
+	}
+}
+
 //Lapack function for matrix diagonalization of triangular matrix.
 extern "C" void zhpev_(char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
 			char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
@@ -302,6 +421,23 @@ extern "C" void zhpev_(char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues
 			double *rwork,		//Workspace, dimension = max(1, 3*N-2)
 			int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
+//Lapack function for divide and conquer diagonalization of a Hermitian matrix
+//in full storage.
+extern "C" void zheevd_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Upper triangular storage, 'L' = Lower triangular storage.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, output eigenvectors
+	int *lda,		//Leading dimension of a
+	double *w,		//Eigenvalues, is in accending order if info = 0
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = the algorithm failed to converge.
+
 //Lapack function for matrix diagonalization of banded triangular matrix
 extern "C" void zhbeb_(
 	char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
@@ -317,128 +453,654 @@ extern "C" void zhbeb_(
 	double *rwork,		//Workspace, dimension = max(1, 3*N-2)
 	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
+
+//Blas function for general complex matrix-matrix multiplication.
+extern "C" void zgemm_(
+	char *transA,		//'N' = A, 'T' = A^T, 'C' = A^{\dagger}
+	char *transB,		//'N' = B, 'T' = B^T, 'C' = B^{\dagger}
+	int *m,			//Number of rows of op(A) and C
+	int *n,			//Number of columns of op(B) and C
+	int *k,			//Number of columns of op(A)
+	complex<double> *alpha,	//Factor multiplying op(A)op(B)
+	complex<double> *a,	//Input matrix A
+	int *lda,		//Leading dimension of A
+	complex<double> *b,	//Input matrix B
+	int *ldb,		//Leading dimension of B
+	complex<double> *beta,	//Factor multiplying C
+	complex<double> *c,	//Input/output matrix C
+	int *ldc);		//Leading dimension of C
+
 void BlockDiagonalizer::solve(){
-	if(true){//Currently no support for banded matrices.
-		if(parallelExecution){
-			vector<unsigned int> eigenValuesOffsets;
-			eigenValuesOffsets.push_back(0);
-			for(
-				unsigned int b = 1;
-				b < blockStructureDescriptor.getNumBlocks();
-				b++
-			){
-				eigenValuesOffsets.push_back(
-					eigenValuesOffsets[b-1]
-					+ blockStructureDescriptor.getNumStatesInBlock(b-1)
-				);
-			}
+	if(eigenVectorMode == EigenVectorMode::Window){
+		solveEigenVectorWindow();
 
-			#pragma omp parallel for
-			for(
-				unsigned int b = 0;
-				b < blockStructureDescriptor.getNumBlocks();
-				b++
-			){
-				//Setup zhpev to calculate...
-				char jobz = 'V';						//...eigenvalues and eigenvectors...
-				char uplo = 'U';						//...for an upper triangular...
-				int n = blockStructureDescriptor.getNumStatesInBlock(b);	//...nxn-matrix.
-				//Initialize workspaces
-				CArray<complex<double>> work(2*n-1);
-				CArray<double> rwork(3*n-2);
-				int info;
-				//Solve brop
-				zhpev_(
-					&jobz,
-					&uplo,
-					&n,
-					hamiltonian.getData()
-						+ blockOffsets.at(b),
-					eigenValues.getData()
-						+ eigenValuesOffsets[b],
-					eigenVectors.getData()
-						+ eigenVectorOffsets.at(b),
-					&n,
-					work.getData(),
-					rwork.getData(),
-					&info
-				);
+		return;
+	}
 
-				TBTKAssert(
-					info == 0,
-					"Diagonalizer:solve()",
-					"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
-					"See LAPACK documentation for zhpev for further information."
-				);
+	blockTimings.assign(blockStructureDescriptor.getNumBlocks(), 0);
+	bool calculateEigenVectors = (eigenVectorMode == EigenVectorMode::All);
+	solveBlocks([this, calculateEigenVectors](
+		unsigned int b,
+		bool isLargeBlock
+	){
+		if(isLargeBlock){
+			solveLargeBlock(b, calculateEigenVectors);
+
+			return;
+		}
+
+		//Setup zhpev to calculate...
+		char jobz = calculateEigenVectors ? 'V' : 'N';			//...eigenvalues and possibly eigenvectors...
+		char uplo = 'U';						//...for an upper triangular...
+		int n = blockStructureDescriptor.getNumStatesInBlock(b);	//...nxn-matrix.
+		int ldz = calculateEigenVectors ? n : 1;
+		complex<double> dummyEigenVector;
+		complex<double> *z = calculateEigenVectors
+			? getEigenVectors() + eigenVectorOffsets.at(b)
+			: &dummyEigenVector;
+		//Initialize workspaces
+		CArray<complex<double>> work(2*n-1);
+		CArray<double> rwork(3*n-2);
+		int info;
+		//Solve brop
+		zhpev_(
+			&jobz,
+			&uplo,
+			&n,
+			hamiltonian.getData() + blockOffsets.at(b),
+			eigenValues.getData()
+				+ blockStructureDescriptor.getFirstStateInBlock(b),
+			z,
+			&ldz,
+			work.getData(),
+			rwork.getData(),
+			&info
+		);
+
+		TBTKAssert(
+			info == 0,
+			"Diagonalizer:solve()",
+			"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
+			"See LAPACK documentation for zhpev for further information."
+		);
+
+		firstEigenVectorInBlock[b] = 0;
+		numEigenVectorsInBlock[b] = calculateEigenVectors ? n : 0;
+	});
+
+	reconstructEigenValues();
+	if(calculateEigenVectors)
+		reconstructEigenVectors();
+}
+
+void BlockDiagonalizer::solveLargeBlock(
+	unsigned int block,
+	bool calculateEigenVectors
+){
+	int n = blockStructureDescriptor.getNumStatesInBlock(block);
+
+	//Unpack the upper triangular part of the block to full storage. The
+	//eigenvectors overwrite the matrix and are therefore calculated
+	//directly in the eigenvector storage.
+	CArray<complex<double>> fullMatrix;
+	complex<double> *a;
+	if(calculateEigenVectors){
+		a = getEigenVectors() + eigenVectorOffsets.at(block);
+	}
+	else{
+		fullMatrix = CArray<complex<double>>((size_t)n*n);
+		a = fullMatrix.getData();
+	}
+	const complex<double> *packedMatrix
+		= hamiltonian.getData() + blockOffsets.at(block);
+	for(int col = 0; col < n; col++){
+		for(int row = 0; row <= col; row++){
+			a[(size_t)n*col + row]
+				= packedMatrix[row + (size_t)col*(col+1)/2];
+		}
+	}
+
+	char jobz = calculateEigenVectors ? 'V' : 'N';
+	char uplo = 'U';
+	double *w = eigenValues.getData()
+		+ blockStructureDescriptor.getFirstStateInBlock(block);
+	int info;
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		a,
+		&n,
+		w,
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		a,
+		&n,
+		w,
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"BlockDiagonalizer::solveLargeBlock()",
+		"Diagonalization routine zheevd exited with INFO="
+		<< info << ".",
+		"See LAPACK documentation for zheevd for further"
+		<< " information."
+	);
+
+	firstEigenVectorInBlock[block] = 0;
+	numEigenVectorsInBlock[block] = calculateEigenVectors ? n : 0;
+}
+
+void BlockDiagonalizer::solveEigenVectorWindow(){
+	unsigned int numBlocks = blockStructureDescriptor.getNumBlocks();
+	blockTimings.assign(numBlocks, 0);
+
+	//Reduce each block to real symmetric tridiagonal form
+	//T = Q^{\dagger}HQ and calculate all eigenvalues. The Householder
+	//reflectors that define Q overwrite the packed block, while the
+	//tridiagonal matrix is kept for the calculation of the eigenvectors.
+	vector<CArray<double>> diagonals(numBlocks);
+	vector<CArray<double>> offDiagonals(numBlocks);
+	vector<CArray<complex<double>>> taus(numBlocks);
+	solveBlocks([this, &diagonals, &offDiagonals, &taus](
+		unsigned int b,
+		bool isLargeBlock
+	){
+		int n = blockStructureDescriptor.getNumStatesInBlock(b);
+		diagonals[b] = CArray<double>(n);
+		offDiagonals[b] = CArray<double>(n);
+		taus[b] = CArray<complex<double>>(max(1, n-1));
+		HermitianTridiagonalizer::tridiagonalize(
+			n,
+			hamiltonian.getData() + blockOffsets.at(b),
+			diagonals[b].getData(),
+			offDiagonals[b].getData(),
+			taus[b].getData()
+		);
+		HermitianTridiagonalizer::calculateEigenValues(
+			n,
+			diagonals[b].getData(),
+			offDiagonals[b].getData(),
+			eigenValues.getData()
+				+ blockStructureDescriptor.getFirstStateInBlock(b)
+		);
+	});
+	reconstructEigenValues();
+
+	//Find the states inside the window and allocate memory for the
+	//corresponding eigenvectors.
+	size_t eigenVectorsSize = 0;
+	for(unsigned int b = 0; b < numBlocks; b++){
+		unsigned int numStates = localBlocks[b]
+			? blockStructureDescriptor.getNumStatesInBlock(b)
+			: 0;
+		const double *blockEigenValues = eigenValues.getData()
+			+ blockStructureDescriptor.getFirstStateInBlock(b);
+		unsigned int first = 0;
+		while(
+			first < numStates
+			&& blockEigenValues[first]
+				<= eigenVectorWindowLowerBound
+		){
+			first++;
+		}
+		unsigned int last = first;
+		while(
+			last < numStates
+			&& blockEigenValues[last]
+				<= eigenVectorWindowUpperBound
+		){
+			last++;
+		}
+		firstEigenVectorInBlock[b] = first;
+		numEigenVectorsInBlock[b] = last - first;
+		eigenVectorSizes[b] = numStates*(last - first);
+		eigenVectorOffsets[b] = eigenVectorsSize;
+		eigenVectorsSize += eigenVectorSizes[b];
+	}
+	allocateEigenVectors(eigenVectorsSize);
+
+	//Calculate the eigenvectors of T and transform them back to the
+	//original basis.
+	solveBlocks([this, &diagonals, &offDiagonals, &taus](
+		unsigned int b,
+		bool isLargeBlock
+	){
+		if(numEigenVectorsInBlock[b] == 0)
+			return;
+
+		int n = blockStructureDescriptor.getNumStatesInBlock(b);
+		int numStates = numEigenVectorsInBlock[b];
+		complex<double> *blockEigenVectors
+			= getEigenVectors() + eigenVectorOffsets[b];
+		HermitianTridiagonalizer::calculateEigenVectors(
+			n,
+			diagonals[b].getData(),
+			offDiagonals[b].getData(),
+			firstEigenVectorInBlock[b],
+			firstEigenVectorInBlock[b] + numStates - 1,
+			blockEigenVectors
+		);
+		HermitianTridiagonalizer::transformEigenVectors(
+			n,
+			numStates,
+			hamiltonian.getData() + blockOffsets.at(b),
+			taus[b].getData(),
+			blockEigenVectors
+		);
+	});
+	reconstructEigenVectors();
+}
+
+void BlockDiagonalizer::solveBlocks(
+	const function<void(unsigned int, bool)> &solveBlock
+){
+	unsigned int numBlocks = blockStructureDescriptor.getNumBlocks();
+	if(!parallelExecution){
+		for(unsigned int b = 0; b < numBlocks; b++){
+			if(!localBlocks[b] || !isIrreducibleBlock(b))
+				continue;
+
+			chrono::steady_clock::time_point start
+				= chrono::steady_clock::now();
+			solveBlock(b, false);
+			blockTimings[b] += chrono::duration<double>(
+				chrono::steady_clock::now() - start
+			).count();
+		}
+
+		return;
+	}
+
+#ifdef TBTK_USE_OPEN_MP
+	unsigned int numThreads = omp_get_max_threads();
+#else
+	unsigned int numThreads = 1;
+#endif
+
+	//Collect the local irreducible blocks in order of decreasing cost.
+	vector<unsigned int> blocks;
+	double totalCost = 0;
+	for(unsigned int block : getBlocksByDecreasingCost()){
+		if(localBlocks[block] && isIrreducibleBlock(block)){
+			blocks.push_back(block);
+			totalCost += getBlockCost(block);
+		}
+	}
+	unsigned int numLocalBlocks = blocks.size();
+
+	//A block that costs more than the remaining workload per thread cannot
+	//be balanced against the other blocks. Solve such blocks one at a time
+	//outside of the parallel region with all threads given to BLAS/LAPACK.
+	//At least numThreads blocks are left for the parallel phase.
+	unsigned int numLargeBlocks = 0;
+	double remainingCost = totalCost;
+	while(
+		numThreads > 1
+		&& numLocalBlocks - numLargeBlocks > numThreads
+	){
+		double cost = getBlockCost(blocks[numLargeBlocks]);
+		if(cost <= (remainingCost - cost)/numThreads)
+			break;
+
+		remainingCost -= cost;
+		numLargeBlocks++;
+	}
+
+	if(numLargeBlocks != 0){
+		int previousBLASNumThreads = setBLASNumThreads(numThreads);
+		for(unsigned int n = 0; n < numLargeBlocks; n++){
+			unsigned int b = blocks[n];
+			chrono::steady_clock::time_point start
+				= chrono::steady_clock::now();
+			solveBlock(b, true);
+			blockTimings[b] += chrono::duration<double>(
+				chrono::steady_clock::now() - start
+			).count();
+		}
+		setBLASNumThreads(previousBLASNumThreads);
+	}
+
+	//Dynamically dispatch the remaining blocks one per thread with
+	//BLAS/LAPACK restricted to a single thread. Disabling nested parallel
+	//regions also makes BLAS/LAPACK implementations that are threaded
+	//with OpenMP, such as MKL, run single threaded inside the loop.
+	int previousBLASNumThreads = setBLASNumThreads(1);
+#ifdef TBTK_USE_OPEN_MP
+	int previousMaxActiveLevels = omp_get_max_active_levels();
+	omp_set_max_active_levels(1);
+#endif
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(unsigned int n = numLargeBlocks; n < numLocalBlocks; n++){
+		unsigned int b = blocks[n];
+		chrono::steady_clock::time_point start
+			= chrono::steady_clock::now();
+		solveBlock(b, false);
+		blockTimings[b] += chrono::duration<double>(
+			chrono::steady_clock::now() - start
+		).count();
+	}
+#ifdef TBTK_USE_OPEN_MP
+	omp_set_max_active_levels(previousMaxActiveLevels);
+#endif
+	setBLASNumThreads(previousBLASNumThreads);
+}
+
+void BlockDiagonalizer::reconstructEigenValues(){
+	for(
+		unsigned int b = 0;
+		b < blockStructureDescriptor.getNumBlocks();
+		b++
+	){
+		if(!localBlocks[b] || isIrreducibleBlock(b))
+			continue;
+
+		unsigned int numStates
+			= blockStructureDescriptor.getNumStatesInBlock(b);
+		unsigned int firstState
+			= blockStructureDescriptor.getFirstStateInBlock(b);
+		unsigned int firstIrreducibleState
+			= blockStructureDescriptor.getFirstStateInBlock(
+				irreducibleBlocks[b]
+			);
+		for(unsigned int n = 0; n < numStates; n++){
+			eigenValues[firstState + n]
+				= eigenValues[firstIrreducibleState + n];
+		}
+	}
+}
+
+void BlockDiagonalizer::reconstructEigenVectors(){
+	vector<unsigned int> blocks;
+	for(
+		unsigned int b = 0;
+		b < blockStructureDescriptor.getNumBlocks();
+		b++
+	){
+		if(localBlocks[b] && !isIrreducibleBlock(b))
+			blocks.push_back(b);
+	}
+
+	#pragma omp parallel for schedule(dynamic) if(parallelExecution)
+	for(unsigned int n = 0; n < blocks.size(); n++){
+		unsigned int b = blocks[n];
+		unsigned int irreducibleBlock = irreducibleBlocks[b];
+		firstEigenVectorInBlock[b]
+			= firstEigenVectorInBlock[irreducibleBlock];
+		numEigenVectorsInBlock[b]
+			= numEigenVectorsInBlock[irreducibleBlock];
+		if(numEigenVectorsInBlock[b] == 0)
+			continue;
+
+		//psi = U*psi_irreducible, or U*psi_irreducible^* for
+		//anti-unitary operations.
+		const SymmetryOperation &symmetryOperation
+			= *blockSymmetryOperations[b];
+		const Matrix<complex<double>> &orbitalRepresentation
+			= symmetryOperation.getOrbitalRepresentation();
+		int numStates = blockStructureDescriptor.getNumStatesInBlock(b);
+		int numEigenVectors = numEigenVectorsInBlock[b];
+		CArray<complex<double>> u(numStates*numStates);
+		for(int row = 0; row < numStates; row++)
+			for(int col = 0; col < numStates; col++)
+				u[row + numStates*col]
+					= orbitalRepresentation.at(row, col);
+		CArray<complex<double>> irreducibleEigenVectors(
+			numStates*numEigenVectors
+		);
+		for(int c = 0; c < numStates*numEigenVectors; c++){
+			irreducibleEigenVectors[c] = getEigenVectors()[
+				eigenVectorOffsets[irreducibleBlock] + c
+			];
+			if(symmetryOperation.isAntiUnitary()){
+				irreducibleEigenVectors[c]
+					= conj(irreducibleEigenVectors[c]);
 			}
 		}
-		else{
-			unsigned int eigenValuesOffset = 0;
+
+		char transA = 'N';
+		char transB = 'N';
+		complex<double> alpha = 1;
+		complex<double> beta = 0;
+		zgemm_(
+			&transA,
+			&transB,
+			&numStates,
+			&numEigenVectors,
+			&numStates,
+			&alpha,
+			u.getData(),
+			&numStates,
+			irreducibleEigenVectors.getData(),
+			&numStates,
+			&beta,
+			getEigenVectors() + eigenVectorOffsets[b],
+			&numStates
+		);
+	}
+}
+
+void BlockDiagonalizer::distributeBlocks(){
+	unsigned int numBlocks = blockStructureDescriptor.getNumBlocks();
+	if(!distributedExecution){
+		localBlocks.assign(numBlocks, true);
+
+		return;
+	}
+
+#ifdef TBTK_USE_MPI
+	int isInitialized;
+	MPI_Initialized(&isInitialized);
+	TBTKAssert(
+		isInitialized,
+		"Solver::BlockDiagonalizer::distributeBlocks()",
+		"Distributed execution is enabled, but MPI has not been"
+		<< " initialized.",
+		"Call MPI_Init() before running the BlockDiagonalizer."
+	);
+	int rank;
+	int numProcesses;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+
+	//Assign the irreducible blocks in order of decreasing cost to the
+	//process with the smallest total cost. Ties are resolved in favor of
+	//the lowest rank, which makes the assignment the same on every
+	//process. The remaining blocks are reconstructed by the process that
+	//solves the corresponding irreducible block.
+	typedef pair<double, int> Workload;
+	priority_queue<Workload, vector<Workload>, greater<Workload>>
+		workloads;
+	for(int n = 0; n < numProcesses; n++)
+		workloads.push(Workload(0, n));
+
+	localBlocks.assign(numBlocks, false);
+	for(unsigned int block : getBlocksByDecreasingCost()){
+		if(!isIrreducibleBlock(block))
+			continue;
+
+		Workload workload = workloads.top();
+		workloads.pop();
+		localBlocks[block] = (workload.second == rank);
+		workload.first += getBlockCost(block);
+		workloads.push(workload);
+	}
+	for(unsigned int block = 0; block < numBlocks; block++)
+		localBlocks[block] = localBlocks[irreducibleBlocks[block]];
+#else
+	TBTKExit(
+		"Solver::BlockDiagonalizer::distributeBlocks()",
+		"Distributed execution requires MPI, but TBTK has been"
+		<< " compiled without MPI.",
+		"Recompile TBTK with MPI or disable distributed execution."
+	);
+#endif
+}
+
+void BlockDiagonalizer::reduceBlocks(){
+	unsigned int numBlocks = blockStructureDescriptor.getNumBlocks();
+	irreducibleBlocks.resize(numBlocks);
+	for(unsigned int block = 0; block < numBlocks; block++)
+		irreducibleBlocks[block] = block;
+	blockSymmetryOperations.assign(numBlocks, nullptr);
+	if(irreducibleBrillouinZone == nullptr)
+		return;
+
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+	unsigned int numDimensions
+		= irreducibleBrillouinZone->getNumDimensions();
+	IndexTree blockIndices = hoppingAmplitudeSet.getSubspaceIndices();
+	unsigned int block = 0;
+	for(
+		IndexTree::ConstIterator iterator = blockIndices.cbegin();
+		iterator != blockIndices.cend();
+		++iterator
+	){
+		const Index &blockIndex = *iterator;
+		TBTKAssert(
+			blockIndex.getSize() >= numDimensions,
+			"Solver::BlockDiagonalizer::reduceBlocks()",
+			"The block Index '" << blockIndex.toString() << "' has"
+			<< " fewer subindices than the dimension '"
+			<< numDimensions << "' of the"
+			<< " IrreducibleBrillouinZone.",
+			"The first subindices of each block Index must be the"
+			<< " mesh point."
+		);
+		Index meshPoint = blockIndex.getSubIndex(0, numDimensions - 1);
+		if(!irreducibleBrillouinZone->isIrreducible(meshPoint)){
+			//The irreducible block has the same block Index, except
+			//for the mesh point.
+			Index irreducibleBlockIndex
+				= irreducibleBrillouinZone->getIrreducibleMeshPoint(
+					meshPoint
+				);
 			for(
-				unsigned int b = 0;
-				b < blockStructureDescriptor.getNumBlocks();
-				b++
+				unsigned int n = numDimensions;
+				n < blockIndex.getSize();
+				n++
 			){
-				//Setup zhpev to calculate...
-				char jobz = 'V';						//...eigenvalues and eigenvectors...
-				char uplo = 'U';						//...for an upper triangular...
-				int n = blockStructureDescriptor.getNumStatesInBlock(b);	//...nxn-matrix.
-				//Initialize workspaces
-				CArray<complex<double>> work(2*n-1);
-				CArray<double> rwork(3*n-2);
-				int info;
-				//Solve brop
-				zhpev_(
-					&jobz,
-					&uplo,
-					&n,
-					hamiltonian.getData()
-						+ blockOffsets.at(b),
-					eigenValues.getData()
-						+ eigenValuesOffset,
-					eigenVectors.getData()
-						+ eigenVectorOffsets.at(b),
-					&n,
-					work.getData(),
-					rwork.getData(),
-					&info
+				irreducibleBlockIndex.pushBack(blockIndex[n]);
+			}
+			unsigned int irreducibleBlock
+				= blockStructureDescriptor.getBlockIndex(
+					hoppingAmplitudeSet.getFirstIndexInBlock(
+						irreducibleBlockIndex
+					)
+				);
+			const SymmetryOperation &symmetryOperation
+				= irreducibleBrillouinZone->getSymmetryOperation(
+					meshPoint
 				);
 
-				TBTKAssert(
-					info == 0,
-					"Diagonalizer:solve()",
-					"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
-					"See LAPACK documentation for zhpev for further information."
+			unsigned int numStates
+				= blockStructureDescriptor.getNumStatesInBlock(
+					block
 				);
+			TBTKAssert(
+				blockStructureDescriptor.getNumStatesInBlock(
+					irreducibleBlock
+				) == numStates,
+				"Solver::BlockDiagonalizer::reduceBlocks()",
+				"The block '" << blockIndex.toString() << "' has '"
+				<< numStates << "' states, but the irreducible"
+				<< " block '" << irreducibleBlockIndex.toString()
+				<< "' has '"
+				<< blockStructureDescriptor.getNumStatesInBlock(
+					irreducibleBlock
+				) << "' states.",
+				"Blocks that are related by symmetry must have the"
+				<< " same number of states."
+			);
+			TBTKAssert(
+				symmetryOperation.getNumOrbitals() == numStates,
+				"Solver::BlockDiagonalizer::reduceBlocks()",
+				"The block '" << blockIndex.toString() << "' has '"
+				<< numStates << "' states, but the orbital"
+				<< " representation of the SymmetryOperations has"
+				<< " dimension '"
+				<< symmetryOperation.getNumOrbitals() << "'.",
+				""
+			);
 
-				eigenValuesOffset += blockStructureDescriptor.getNumStatesInBlock(b);
-			}
+			irreducibleBlocks[block] = irreducibleBlock;
+			blockSymmetryOperations[block] = &symmetryOperation;
+		}
+
+		block++;
+	}
+}
+
+vector<unsigned int> BlockDiagonalizer::getBlocksByDecreasingCost() const{
+	vector<unsigned int> blocks(blockStructureDescriptor.getNumBlocks());
+	for(unsigned int n = 0; n < blocks.size(); n++)
+		blocks[n] = n;
+
+	stable_sort(
+		blocks.begin(),
+		blocks.end(),
+		[this](unsigned int lhs, unsigned int rhs){
+			return getBlockCost(lhs) > getBlockCost(rhs);
+		}
+	);
+
+	return blocks;
+}
+
+void BlockDiagonalizer::printBlockTimings() const{
+	if(blockTimings.size() == 0)
+		return;
+
+	double totalTime = 0;
+	double maxTime = 0;
+	unsigned int slowestBlock = 0;
+	for(unsigned int b = 0; b < blockTimings.size(); b++){
+		totalTime += blockTimings[b];
+		if(blockTimings[b] > maxTime){
+			maxTime = blockTimings[b];
+			slowestBlock = b;
 		}
 	}
-/*	else{
-		int kd;
-		if(size_z != 1)
-			kd = orbitals*size_x*size_y*size_z;
-		else if(size_y != 1)
-			kd = orbitals*size_x*size_y;
-		else
-			kd = orbitals*size_x;
-		//Setup zhbev to calculate...
-		char jobz = 'V';			//...eigenvalues and eigenvectors...
-		char uplo = 'U';			//...for and upper triangluar...
-		int n = orbitals*size_x*size_y*size_z;	//...nxn-matrix.
-		int ldab = kd + 1;
-		//Initialize workspaces
-		complex<double> *work = new complex<double>[n];
-		double *rwork = new double[3*n-2];
-		int info;
-		//Solve brop
-		zhbev_(&jobz, &uplo, &n, &kd, hamiltonian, &ldab, eigenValues, eigenVectors, &n, work, rwork, &info);
 
-		//delete workspaces
-		delete [] work;
-		delete [] rwork;
-	}*/
+	Streams::out << "\tBlock timings: " << totalTime << "s in "
+		<< blockTimings.size() << " blocks, slowest block " << slowestBlock
+		<< " (" << blockStructureDescriptor.getNumStatesInBlock(
+			slowestBlock
+		) << " states) " << maxTime << "s\n";
 }
 
 };	//End of namespace Solver
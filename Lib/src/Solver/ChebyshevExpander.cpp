@@ -19,6 +19,7 @@
  */
 
 #include "TBTK/Solver/ChebyshevExpander.h"
+#include "TBTK/Functions.h"
 #include "TBTK/HALinkedList.h"
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
@@ -26,6 +27,9 @@
 
 #include <iostream>
 #include <cmath>
+#include <limits>
+#include <random>
+#include <unordered_map>
 
 using namespace std;
 
@@ -39,13 +43,269 @@ DynamicTypeInformation ChebyshevExpander::dynamicTypeInformation(
 
 namespace{
 	const complex<double> i(0, 1);
+
+	//The number of Lanczos iterations used to estimate the spectral
+	//bounds.
+	const unsigned int NUM_LANCZOS_ITERATIONS = 40;
+
+	//The largest residual, relative to the Gershgorin radius, that the
+	//extremal Ritz values are allowed to have for the Lanczos estimate
+	//to be accepted.
+	const double LANCZOS_CONVERGENCE_TOLERANCE = 1e-3;
+
+	//The number of consecutive moments that have to be below the
+	//adaptive truncation tolerance before an expansion is truncated.
+	//Larger than one since for example odd moments of diagonal elements
+	//vanish identically on bipartite lattices.
+	const unsigned int ADAPTIVE_TRUNCATION_WINDOW = 16;
+
+	//The number of Chebyshev nodes per coefficient used when the result
+	//of the fast transform is interpolated to the energy window. The
+	//error of the cubic interpolation scales as the inverse fourth power
+	//of this number.
+	const unsigned int FAST_TRANSFORM_OVERSAMPLING = 16;
+
+	//The number of quadrature nodes per coefficient used to calculate the
+	//Chebyshev coefficients of the Fermi function at finite temperature.
+	//The number of nodes is rounded up to a power of two.
+	const unsigned int FERMI_FUNCTION_OVERSAMPLING = 4;
+
+	//The number of rows that are summed by each thread at a time when
+	//calculating scalar products between blocks of vectors.
+	const unsigned int SCALAR_PRODUCT_CHUNK_SIZE = 1024;
+
+	//In place radix-2 fast Fourier transform. Calculates
+	//data[k] = sum_n data[n]*exp(sign*2*pi*i*n*k/N), where N is the size
+	//of data and has to be a power of two.
+	void fastFourierTransform(vector<complex<double>> &data, int sign){
+		unsigned int size = data.size();
+
+		//Bit reversal permutation.
+		for(unsigned int n = 1, j = 0; n < size; n++){
+			unsigned int bit = size >> 1;
+			for(; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if(n < j)
+				swap(data[n], data[j]);
+		}
+
+		//The twiddle factors are calculated once for the largest
+		//butterfly and reused with a stride for the smaller ones.
+		vector<complex<double>> twiddleFactors(size/2);
+		for(unsigned int n = 0; n < size/2; n++)
+			twiddleFactors[n] = exp(sign*2.*M_PI*i*(n/(double)size));
+
+		for(unsigned int length = 2; length <= size; length <<= 1){
+			unsigned int stride = size/length;
+			for(unsigned int start = 0; start < size; start += length){
+				for(unsigned int n = 0; n < length/2; n++){
+					complex<double> u = data[start + n];
+					complex<double> v = data[start + n + length/2]
+						*twiddleFactors[n*stride];
+					data[start + n] = u + v;
+					data[start + n + length/2] = u - v;
+				}
+			}
+		}
+	}
+
+	//Adds the states that are one hop further away from 'source' than the
+	//states in the last shell of the local environment, using the matrix
+	//elements of a matrix on CSR format. The last shell consists of the
+	//states sites[shellStart], ..., sites.back(). Returns the position of
+	//the first state in the new shell, which is equal to sites.size() if
+	//no states were added.
+	unsigned int expandLocalEnvironment(
+		const SparseMatrix<complex<double>> &sparseMatrix,
+		vector<unsigned int> &sites,
+		unordered_map<unsigned int, unsigned int> &localIndices,
+		unsigned int shellStart
+	){
+		const unsigned int *rowPointers
+			= sparseMatrix.getCSRRowPointers();
+		const unsigned int *columns = sparseMatrix.getCSRColumns();
+		unsigned int numRows = sparseMatrix.getNumRows();
+
+		unsigned int shellEnd = sites.size();
+		for(unsigned int n = shellStart; n < shellEnd; n++){
+			unsigned int row = sites[n];
+			if(row >= numRows)
+				continue;
+
+			for(
+				unsigned int c = rowPointers[row];
+				c < rowPointers[row+1];
+				c++
+			){
+				if(localIndices.count(columns[c]) == 0){
+					localIndices[columns[c]] = sites.size();
+					sites.push_back(columns[c]);
+				}
+			}
+		}
+
+		return shellEnd;
+	}
+
+	//Finds the states that can be reached from 'source' in at most
+	//'radius' hops using the matrix elements of a matrix on CSR format.
+	//On return, 'sites' contains the basis indices of the states, in
+	//order of increasing distance, and 'localIndices' maps each of them to
+	//its position in 'sites'.
+	void getLocalEnvironment(
+		const SparseMatrix<complex<double>> &sparseMatrix,
+		unsigned int source,
+		unsigned int radius,
+		vector<unsigned int> &sites,
+		unordered_map<unsigned int, unsigned int> &localIndices
+	){
+		sites.assign(1, source);
+		localIndices.clear();
+		localIndices[source] = 0;
+		unsigned int shellStart = 0;
+		for(unsigned int distance = 0; distance < radius; distance++){
+			shellStart = expandLocalEnvironment(
+				sparseMatrix,
+				sites,
+				localIndices,
+				shellStart
+			);
+			if(shellStart == sites.size())
+				break;
+		}
+	}
+
+	//Finds the smallest local environment around 'source' for which the
+	//first numMoments Chebyshev moments <t|T_n(H)|source> are exact for
+	//every target state t. A path of length n from 'source' to a target
+	//at distance d never goes further than (n + d)/2 hops away from
+	//'source', and targets further away than numMoments - 1 hops have
+	//vanishing moments. Arguments are otherwise the same as for
+	//getLocalEnvironment().
+	void getExactLocalEnvironment(
+		const SparseMatrix<complex<double>> &sparseMatrix,
+		unsigned int source,
+		const vector<unsigned int> &targets,
+		unsigned int numMoments,
+		vector<unsigned int> &sites,
+		unordered_map<unsigned int, unsigned int> &localIndices
+	){
+		sites.assign(1, source);
+		localIndices.clear();
+		localIndices[source] = 0;
+
+		unsigned int maxPathLength = numMoments - 1;
+		unsigned int maxTargetDistance = 0;
+		unsigned int numFoundTargets = 0;
+		vector<bool> isFound(targets.size(), false);
+		unsigned int shellStart = 0;
+		for(unsigned int distance = 0; ; distance++){
+			//Register the targets in the last shell.
+			for(unsigned int n = 0; n < targets.size(); n++){
+				if(isFound[n] || localIndices.count(targets[n]) == 0)
+					continue;
+
+				isFound[n] = true;
+				numFoundTargets++;
+				maxTargetDistance = distance;
+			}
+
+			unsigned int requiredRadius
+				= (maxPathLength + maxTargetDistance)/2;
+			bool isSearchingForTargets
+				= numFoundTargets < targets.size()
+					&& distance < maxPathLength;
+			if(distance >= requiredRadius && !isSearchingForTargets)
+				break;
+
+			shellStart = expandLocalEnvironment(
+				sparseMatrix,
+				sites,
+				localIndices,
+				shellStart
+			);
+			if(shellStart == sites.size())
+				break;
+		}
+	}
+
+	//Extracts the submatrix of a matrix on CSR format that acts on the
+	//given sites. The result is on CSR format.
+	SparseMatrix<complex<double>> getSubMatrix(
+		const SparseMatrix<complex<double>> &sparseMatrix,
+		const vector<unsigned int> &sites,
+		const unordered_map<unsigned int, unsigned int> &localIndices
+	){
+		const unsigned int *rowPointers
+			= sparseMatrix.getCSRRowPointers();
+		const unsigned int *columns = sparseMatrix.getCSRColumns();
+		const complex<double> *values = sparseMatrix.getCSRValues();
+		unsigned int numRows = sparseMatrix.getNumRows();
+
+		SparseMatrix<complex<double>> subMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR,
+			sites.size(),
+			sites.size()
+		);
+		for(unsigned int row = 0; row < sites.size(); row++){
+			if(sites[row] >= numRows)
+				continue;
+
+			for(
+				unsigned int c = rowPointers[sites[row]];
+				c < rowPointers[sites[row]+1];
+				c++
+			){
+				unordered_map<
+					unsigned int,
+					unsigned int
+				>::const_iterator iterator
+					= localIndices.find(columns[c]);
+				if(iterator != localIndices.end()){
+					subMatrix.add(
+						row,
+						iterator->second,
+						values[c]
+					);
+				}
+			}
+		}
+		subMatrix.construct();
+
+		return subMatrix;
+	}
 }
 
+extern "C" void dstev_(
+	char *jobz,	//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	int *n,		//Matrix size.
+	double *d,	//Diagonal elements. Eigenvalues in ascending order on exit.
+	double *e,	//Off-diagonal elements. Destroyed on exit.
+	double *z,	//Eigenvectors.
+	int *ldz,	//Leading dimension of z.
+	double *work,	//Workspace, dimension = max(1, 2*n-2).
+	int *info	//0 = successful.
+);
+
 ChebyshevExpander::ChebyshevExpander() : Communicator(false){
 	scaleFactor = 1.1;
+	automaticScaleFactor = false;
+	scaleFactorIsEstimated = false;
+	estimatedHamiltonianRevision = 0;
+	spectralBoundsMethod = SpectralBoundsMethod::Gershgorin;
+	scaleFactorSafetyMargin = 0.01;
 	numCoefficients = 1000;
 	broadening = 1e-6;
 	energyWindow = Range(-1, 1, 1000);
+	useFastTransform = false;
+	adaptiveTruncationTolerance = 0;
+	densityMatrixTruncationRadius = -1;
+	useLocalEnvironment = false;
+	blockSize = 8;
+	numRandomVectors = 10;
+	randomVectorType = RandomVectorType::RandomPhase;
+	randomSeed = 0;
 	calculateCoefficientsOnGPU = false;
 	generateGreensFunctionsOnGPU = false;
 	useLookupTable = false;
@@ -62,23 +322,211 @@ ChebyshevExpander::~ChebyshevExpander(){
 		destroyLookupTableGPU();
 }
 
-void addHamiltonianProduct(
-	const SparseMatrix<complex<double>> &sparseMatrix,
-	const CArray<complex<double>> &vector,
-	CArray<complex<double>> &result
-){
-	const unsigned int *csrRowPointers = sparseMatrix.getCSRRowPointers();
-	const unsigned int *csrColumns = sparseMatrix.getCSRColumns();
+void ChebyshevExpander::setModel(Model &model){
+	Solver::setModel(model);
+	scaleFactorIsEstimated = false;
+}
+
+void ChebyshevExpander::updateScaleFactor(){
+	if(!automaticScaleFactor)
+		return;
+
+	//The cached sparse matrix is updated before its revision is read.
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+	hoppingAmplitudeSet.getSparseMatrix(
+		SparseMatrix<complex<double>>::StorageFormat::CSR
+	);
+	unsigned long long revision
+		= hoppingAmplitudeSet.getSparseMatrixRevision(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+	if(scaleFactorIsEstimated && revision == estimatedHamiltonianRevision)
+		return;
+
+	double spectralRadius = estimateSpectralRadius();
+	//Fall back to a unit scale factor for a Hamiltonian without matrix
+	//elements.
+	if(spectralRadius == 0)
+		spectralRadius = 1;
+	double newScaleFactor = spectralRadius*(1 + scaleFactorSafetyMargin);
+	if(!scaleFactorIsEstimated || newScaleFactor != scaleFactor){
+		destroyLookupTable();
+		if(generatingFunctionLookupTable_device != nullptr)
+			destroyLookupTableGPU();
+	}
+	scaleFactor = newScaleFactor;
+	scaleFactorIsEstimated = true;
+	estimatedHamiltonianRevision = revision;
+
+	assertEnergyWindowIsValid();
+}
+
+double ChebyshevExpander::estimateSpectralRadius() const{
+	const SparseMatrix<complex<double>> &sparseMatrix
+		= getModel().getHoppingAmplitudeSet().getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+	unsigned int basisSize = sparseMatrix.getNumRows();
+	if(basisSize == 0)
+		return 0;
+
+	//Gershgorin bound. For a Hermitian matrix, every eigenvalue lies in
+	//one of the intervals [A_ii - R_i, A_ii + R_i], where R_i is the sum
+	//of the absolute values of the off-diagonal elements on row i.
+	const unsigned int *rowPointers = sparseMatrix.getCSRRowPointers();
+	const unsigned int *columns = sparseMatrix.getCSRColumns();
 	const complex<double> *values = sparseMatrix.getCSRValues();
-	for(unsigned int row = 0; row < sparseMatrix.getNumRows(); row++){
-		for(
-			unsigned int n = csrRowPointers[row];
-			n < csrRowPointers[row+1];
-			n++
-		){
-			result[row] += values[n]*vector[csrColumns[n]];
+	double lowerBound = numeric_limits<double>::max();
+	double upperBound = -numeric_limits<double>::max();
+	for(unsigned int row = 0; row < basisSize; row++){
+		double diagonal = 0;
+		double radius = 0;
+		for(unsigned int n = rowPointers[row]; n < rowPointers[row+1]; n++){
+			if(columns[n] == row)
+				diagonal += real(values[n]);
+			else
+				radius += abs(values[n]);
 		}
+		lowerBound = min(lowerBound, diagonal - radius);
+		upperBound = max(upperBound, diagonal + radius);
 	}
+	double gershgorinRadius = max(abs(lowerBound), abs(upperBound));
+
+	if(
+		spectralBoundsMethod == SpectralBoundsMethod::Gershgorin
+		|| gershgorinRadius == 0
+	){
+		if(getGlobalVerbose() && getVerbose()){
+			Streams::out << "ChebyshevExpander::estimateSpectralRadius\n";
+			Streams::out << "\tGershgorin bounds: [" << lowerBound
+				<< ", " << upperBound << "]\n";
+		}
+
+		return gershgorinRadius;
+	}
+
+	//Lanczos iteration starting from a fixed pseudo random vector.
+	unsigned int numIterations = min(NUM_LANCZOS_ITERATIONS, basisSize);
+	vector<complex<double>> v(basisSize);
+	vector<complex<double>> vPrevious(basisSize, 0);
+	vector<complex<double>> w(basisSize);
+	mt19937_64 generator(0);
+	uniform_real_distribution<double> distribution(-1, 1);
+	double norm = 0;
+	for(unsigned int n = 0; n < basisSize; n++){
+		v[n] = distribution(generator);
+		norm += std::norm(v[n]);
+	}
+	norm = sqrt(norm);
+	for(unsigned int n = 0; n < basisSize; n++)
+		v[n] /= norm;
+
+	vector<double> alpha;
+	vector<double> beta;
+	for(unsigned int k = 0; k < numIterations; k++){
+		//w = Hv - beta_{k-1}v_{k-1}.
+		double betaPrevious = (k == 0 ? 0 : beta.back());
+		sparseMatrix.axpby(
+			1.,
+			v.data(),
+			-betaPrevious,
+			vPrevious.data(),
+			w.data()
+		);
+
+		complex<double> a = 0;
+		for(unsigned int n = 0; n < basisSize; n++)
+			a += conj(v[n])*w[n];
+		alpha.push_back(real(a));
+
+		double b = 0;
+		for(unsigned int n = 0; n < basisSize; n++){
+			w[n] -= alpha.back()*v[n];
+			b += std::norm(w[n]);
+		}
+		b = sqrt(b);
+		beta.push_back(b);
+
+		//Stop if an invariant subspace has been found.
+		if(b < 1e-12*gershgorinRadius)
+			break;
+
+		for(unsigned int n = 0; n < basisSize; n++){
+			vPrevious[n] = v[n];
+			v[n] = w[n]/b;
+		}
+	}
+
+	//Diagonalize the tridiagonal matrix.
+	char jobz = 'V';
+	int size = alpha.size();
+	vector<double> eigenValues = alpha;
+	vector<double> offDiagonal(beta.begin(), beta.end() - 1);
+	offDiagonal.push_back(0);
+	vector<double> eigenVectors(size*size);
+	vector<double> work(max(1, 2*size - 2));
+	int info;
+	dstev_(
+		&jobz,
+		&size,
+		eigenValues.data(),
+		offDiagonal.data(),
+		eigenVectors.data(),
+		&size,
+		work.data(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"Solver::ChebyshevExpander::estimateSpectralRadius()",
+		"Lapack routine dstev failed with error code " << info << ".",
+		""
+	);
+
+	//The distance from a Ritz value to the closest eigenvalue is bounded
+	//by the residual |beta_k s_k|, where s_k is the last component of the
+	//corresponding eigenvector of the tridiagonal matrix.
+	double residualLower = abs(beta.back()*eigenVectors[size - 1]);
+	double residualUpper = abs(
+		beta.back()*eigenVectors[size*(size - 1) + size - 1]
+	);
+
+	//The residual only bounds the distance to some eigenvalue, which is
+	//the extremal one only once the Ritz value has converged. Fall back to
+	//the Gershgorin bound if the extremal Ritz values have not converged.
+	double maxResidual = max(residualLower, residualUpper);
+	if(maxResidual > LANCZOS_CONVERGENCE_TOLERANCE*gershgorinRadius){
+		if(getGlobalVerbose() && getVerbose()){
+			Streams::out << "ChebyshevExpander::estimateSpectralRadius\n";
+			Streams::out << "\tGershgorin bounds: [" << lowerBound
+				<< ", " << upperBound << "]\n";
+			Streams::out << "\tLanczos did not converge (residual "
+				<< maxResidual << "), using the Gershgorin"
+				<< " bounds.\n";
+		}
+
+		return gershgorinRadius;
+	}
+
+	double lanczosLowerBound = max(
+		eigenValues[0] - residualLower,
+		lowerBound
+	);
+	double lanczosUpperBound = min(
+		eigenValues[size - 1] + residualUpper,
+		upperBound
+	);
+
+	if(getGlobalVerbose() && getVerbose()){
+		Streams::out << "ChebyshevExpander::estimateSpectralRadius\n";
+		Streams::out << "\tGershgorin bounds: [" << lowerBound << ", "
+			<< upperBound << "]\n";
+		Streams::out << "\tLanczos bounds: [" << lanczosLowerBound
+			<< ", " << lanczosUpperBound << "]\n";
+	}
+
+	return max(abs(lanczosLowerBound), abs(lanczosUpperBound));
 }
 
 void cyclicSwap(
@@ -92,6 +540,37 @@ void cyclicSwap(
 	jResult = std::move(temp);
 }
 
+//Removes the columns 'columns', which are assumed to be sorted in ascending
+//order, from the row-major interleaved blocks jIn1 and jIn2 with
+//'numColumns' columns, leaving blocks with numColumns - columns.size()
+//columns.
+void removeBlockColumns(
+	CArray<complex<double>> &jIn1,
+	CArray<complex<double>> &jIn2,
+	unsigned int numRows,
+	unsigned int numColumns,
+	const vector<unsigned int> &columns
+){
+	vector<unsigned int> keptColumns;
+	unsigned int nextRemoved = 0;
+	for(unsigned int c = 0; c < numColumns; c++){
+		if(nextRemoved < columns.size() && columns[nextRemoved] == c)
+			nextRemoved++;
+		else
+			keptColumns.push_back(c);
+	}
+
+	unsigned int numKeptColumns = keptColumns.size();
+	for(unsigned int r = 0; r < numRows; r++){
+		for(unsigned int c = 0; c < numKeptColumns; c++){
+			unsigned int target = r*numKeptColumns + c;
+			unsigned int source = r*numColumns + keptColumns[c];
+			jIn1[target] = jIn1[source];
+			jIn2[target] = jIn2[source];
+		}
+	}
+}
+
 vector<complex<double>> ChebyshevExpander::calculateCoefficientsCPU(
 	Index to,
 	Index from
@@ -103,99 +582,758 @@ vector<complex<double>> ChebyshevExpander::calculateCoefficientsCPU(
 vector<vector<complex<double>>> ChebyshevExpander::calculateCoefficientsCPU(
 	vector<Index> &to,
 	Index from
+){
+	return calculateBlockCoefficientsCPU({to}, {from})[0];
+}
+
+vector<
+	vector<vector<complex<double>>>
+> ChebyshevExpander::calculateBlockCoefficientsCPU(
+	const vector<vector<Index>> &to,
+	const vector<Index> &from
 ){
 	TBTKAssert(
 		numCoefficients > 0,
-		"ChebyshevExpander::calculateCoefficients()",
+		"ChebyshevExpander::calculateBlockCoefficients()",
 		"numCoefficients has to be larger than 0.",
 		""
 	);
 
-	vector<vector<complex<double>>> coefficients;
-	for(unsigned int n = 0; n < to.size(); n++){
-		coefficients.push_back(vector<complex<double>>());
-		coefficients[n].reserve(numCoefficients);
-		for(int c = 0; c < numCoefficients; c++)
-			coefficients[n].push_back(0);
-	}
+	if(useLocalEnvironment)
+		return calculateLocalCoefficientsCPU(to, from, -1);
+
+	vector<vector<vector<complex<double>>>> coefficients(from.size());
+	if(from.size() == 0)
+		return coefficients;
 
 	const HoppingAmplitudeSet &hoppingAmplitudeSet
 		= getModel().getHoppingAmplitudeSet();
 	unsigned int basisSize = hoppingAmplitudeSet.getBasisSize();
 
-	int fromBasisIndex = hoppingAmplitudeSet.getBasisIndex(from);
-	CArray<int> coefficientMap(basisSize);
-	for(unsigned int n = 0; n < basisSize; n++)
-		coefficientMap[n] = -1;
-	for(unsigned int n = 0; n < to.size(); n++)
-		coefficientMap[hoppingAmplitudeSet.getBasisIndex(to.at(n))] = n;
+	//Get the Hamiltonian on SparseMatrix format. The scale factor is
+	//applied in the matrix-vector multiplications to avoid copying the
+	//cached matrix.
+	const SparseMatrix<complex<double>> &sparseMatrix
+		= hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+
+	for(
+		unsigned int blockStart = 0;
+		blockStart < from.size();
+		blockStart += blockSize
+	){
+		unsigned int currentBlockSize = min(
+			blockSize,
+			(unsigned int)from.size() - blockStart
+		);
+
+		vector<unsigned int> fromBasisIndices;
+		vector<vector<unsigned int>> toBasisIndices;
+		for(unsigned int b = 0; b < currentBlockSize; b++){
+			const vector<Index> &toIndices = to[blockStart + b];
+			fromBasisIndices.push_back(
+				hoppingAmplitudeSet.getBasisIndex(
+					from[blockStart + b]
+				)
+			);
+			toBasisIndices.push_back(vector<unsigned int>());
+			toBasisIndices.back().reserve(toIndices.size());
+			for(unsigned int n = 0; n < toIndices.size(); n++){
+				toBasisIndices.back().push_back(
+					hoppingAmplitudeSet.getBasisIndex(
+						toIndices[n]
+					)
+				);
+			}
+		}
+
+		if(getGlobalVerbose() && getVerbose()){
+			Streams::out << "ChebyshevExpander::calculateCoefficients\n";
+			Streams::out << "\tFrom Indices: " << blockStart
+				<< "-" << blockStart + currentBlockSize - 1
+				<< " of " << from.size() << "\n";
+			Streams::out << "\tBasis size: " << basisSize << "\n";
+			Streams::out << "\tProgress (100 coefficients per dot): ";
+		}
+
+		vector<vector<vector<complex<double>>>> blockCoefficients
+			= calculateBlockCoefficientsCPU(
+				sparseMatrix,
+				basisSize,
+				fromBasisIndices,
+				toBasisIndices,
+				true
+			);
+		for(unsigned int b = 0; b < currentBlockSize; b++){
+			coefficients[blockStart + b]
+				= std::move(blockCoefficients[b]);
+		}
+
+		if(getGlobalVerbose() && getVerbose())
+			Streams::out << "\n";
+	}
+
+	return coefficients;
+}
+
+vector<
+	vector<vector<complex<double>>>
+> ChebyshevExpander::calculateBlockCoefficientsCPU(
+	const SparseMatrix<complex<double>> &sparseMatrix,
+	unsigned int basisSize,
+	const vector<unsigned int> &fromBasisIndices,
+	const vector<vector<unsigned int>> &toBasisIndices,
+	bool showProgress
+) const{
+	unsigned int numSources = fromBasisIndices.size();
+
+	vector<vector<vector<complex<double>>>> coefficients;
+	for(unsigned int b = 0; b < numSources; b++){
+		coefficients.push_back(
+			vector<vector<complex<double>>>(
+				toBasisIndices[b].size(),
+				vector<complex<double>>(numCoefficients, 0)
+			)
+		);
+	}
+
+	//Workspace for the block of vectors. Element s of row r is stored at
+	//position r*activeSources.size() + s.
+	CArray<complex<double>> jIn1(numSources*basisSize);
+	CArray<complex<double>> jIn2(numSources*basisSize);
+	CArray<complex<double>> jResult(numSources*basisSize);
+
+	//The sources that are still being expanded. The position in
+	//activeSources is the column in the workspace block.
+	vector<unsigned int> activeSources;
+	for(unsigned int b = 0; b < numSources; b++)
+		activeSources.push_back(b);
+	vector<bool> isAboveTolerance(numSources, false);
+	vector<unsigned int> numMomentsBelowTolerance(numSources, 0);
+
+	//Set the initial states (|j0>).
+	for(unsigned int n = 0; n < numSources*basisSize; n++)
+		jIn1[n] = 0;
+	for(unsigned int b = 0; b < numSources; b++)
+		jIn1[numSources*fromBasisIndices[b] + b] = 1.;
+
+	for(int c = 0; c < numCoefficients; c++){
+		unsigned int numActiveSources = activeSources.size();
+		if(c == 1){
+			//Calculate |j1>
+			sparseMatrix.axpby(
+				1/scaleFactor,
+				jIn1.getData(),
+				0.,
+				nullptr,
+				jResult.getData(),
+				numActiveSources
+			);
+			cyclicSwap(jIn1, jIn2, jResult);
+		}
+		else if(c > 1){
+			//Calculate |jn> = 2H|j(n-1)> - |j(n-2)>
+			sparseMatrix.axpby(
+				2/scaleFactor,
+				jIn1.getData(),
+				-1.,
+				jIn2.getData(),
+				jResult.getData(),
+				numActiveSources
+			);
+			cyclicSwap(jIn1, jIn2, jResult);
+		}
+
+		//Extract the Chebyshev coefficients and, if adaptive truncation
+		//is enabled, mark the sources whose coefficients have decayed
+		//below the tolerance for retirement. The columns of the retired
+		//sources are removed after all coefficients have been
+		//extracted, since the stride of the workspace block changes when
+		//columns are removed.
+		vector<unsigned int> retiredColumns;
+		for(unsigned int s = 0; s < numActiveSources; s++){
+			unsigned int b = activeSources[s];
+			vector<vector<complex<double>>> &sourceCoefficients
+				= coefficients[b];
+			double maxAbsoluteValue = 0;
+			for(unsigned int n = 0; n < toBasisIndices[b].size(); n++){
+				sourceCoefficients[n][c] = jIn1[
+					numActiveSources*toBasisIndices[b][n] + s
+				];
+				maxAbsoluteValue = max(
+					maxAbsoluteValue,
+					abs(sourceCoefficients[n][c])
+				);
+			}
+
+			if(adaptiveTruncationTolerance == 0)
+				continue;
+
+			//Only count moments after the first moment above the
+			//tolerance, since moments between distant sites vanish
+			//for small n.
+			if(
+				maxAbsoluteValue*getBroadeningFactor(c)
+				>= adaptiveTruncationTolerance
+			){
+				isAboveTolerance[b] = true;
+				numMomentsBelowTolerance[b] = 0;
+			}
+			else if(isAboveTolerance[b]){
+				numMomentsBelowTolerance[b]++;
+			}
+
+			if(numMomentsBelowTolerance[b] < ADAPTIVE_TRUNCATION_WINDOW)
+				continue;
+
+			//Drop the trailing moments that are below the tolerance.
+			unsigned int numMoments = max(
+				c + 1 - (int)ADAPTIVE_TRUNCATION_WINDOW,
+				1
+			);
+			for(unsigned int n = 0; n < sourceCoefficients.size(); n++)
+				sourceCoefficients[n].resize(numMoments);
+
+			retiredColumns.push_back(s);
+		}
+		if(retiredColumns.size() != 0){
+			removeBlockColumns(
+				jIn1,
+				jIn2,
+				basisSize,
+				numActiveSources,
+				retiredColumns
+			);
+			for(unsigned int n = retiredColumns.size(); n-- > 0;){
+				activeSources.erase(
+					activeSources.begin() + retiredColumns[n]
+				);
+			}
+		}
+		if(activeSources.size() == 0)
+			break;
+
+		if(showProgress && getGlobalVerbose() && getVerbose()){
+			if(c%100 == 0)
+				Streams::out << "." << flush;
+			if(c%1000 == 0)
+				Streams::out << " " << flush;
+		}
+	}
+
+	for(unsigned int b = 0; b < numSources; b++)
+		applyBroadening(coefficients[b]);
+
+	return coefficients;
+}
+
+vector<
+	vector<vector<complex<double>>>
+> ChebyshevExpander::calculateLocalCoefficientsCPU(
+	const vector<vector<Index>> &to,
+	const vector<Index> &from,
+	int radius
+){
+	TBTKAssert(
+		numCoefficients > 0,
+		"ChebyshevExpander::calculateLocalCoefficientsCPU()",
+		"numCoefficients has to be larger than 0.",
+		""
+	);
+
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+
+	//Get the Hamiltonian on SparseMatrix format. The scale factor is
+	//applied in the matrix-vector multiplications to avoid copying the
+	//cached matrix.
+	const SparseMatrix<complex<double>> &sparseMatrix
+		= hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
 
 	if(getGlobalVerbose() && getVerbose()){
-		Streams::out << "ChebyshevExpander::calculateCoefficients\n";
-		Streams::out << "\tFrom Index: " << fromBasisIndex << "\n";
-		Streams::out << "\tBasis size: " << basisSize << "\n";
-		Streams::out << "\tProgress (100 coefficients per dot): ";
+		Streams::out << "ChebyshevExpander::calculateLocalCoefficients\n";
+		Streams::out << "\tNumber of from Indices: " << from.size()
+			<< "\n";
+		if(radius < 0)
+			Streams::out << "\tRadius: Exact\n";
+		else
+			Streams::out << "\tRadius: " << radius << "\n";
 	}
 
-	//Get the Hamiltonian on SparseMatrix format and scale it by the scale
-	//factor.
-	SparseMatrix<complex<double>> sparseMatrix
-		= hoppingAmplitudeSet.getSparseMatrix();
-	sparseMatrix.setStorageFormat(
-		SparseMatrix<complex<double>>::StorageFormat::CSR
+	vector<vector<vector<complex<double>>>> coefficients(from.size());
+	#pragma omp parallel for schedule(dynamic)
+	for(unsigned int f = 0; f < from.size(); f++){
+		unsigned int fromBasisIndex
+			= hoppingAmplitudeSet.getBasisIndex(from[f]);
+		vector<unsigned int> toBasisIndices;
+		for(unsigned int n = 0; n < to[f].size(); n++){
+			toBasisIndices.push_back(
+				hoppingAmplitudeSet.getBasisIndex(to[f][n])
+			);
+		}
+
+		vector<unsigned int> sites;
+		unordered_map<unsigned int, unsigned int> localIndices;
+		if(radius < 0){
+			getExactLocalEnvironment(
+				sparseMatrix,
+				fromBasisIndex,
+				toBasisIndices,
+				numCoefficients,
+				sites,
+				localIndices
+			);
+		}
+		else{
+			getLocalEnvironment(
+				sparseMatrix,
+				fromBasisIndex,
+				radius,
+				sites,
+				localIndices
+			);
+		}
+		SparseMatrix<complex<double>> localMatrix = getSubMatrix(
+			sparseMatrix,
+			sites,
+			localIndices
+		);
+
+		//Only calculate coefficients for 'to'-indices inside the local
+		//environment.
+		vector<unsigned int> toLocalIndices;
+		vector<int> toPositions;
+		for(unsigned int n = 0; n < toBasisIndices.size(); n++){
+			unordered_map<
+				unsigned int,
+				unsigned int
+			>::const_iterator iterator = localIndices.find(
+				toBasisIndices[n]
+			);
+			if(iterator == localIndices.end()){
+				toPositions.push_back(-1);
+			}
+			else{
+				toPositions.push_back(toLocalIndices.size());
+				toLocalIndices.push_back(iterator->second);
+			}
+		}
+
+		vector<vector<complex<double>>> localCoefficients
+			= calculateBlockCoefficientsCPU(
+				localMatrix,
+				sites.size(),
+				{0},
+				{toLocalIndices},
+				false
+			)[0];
+		for(unsigned int n = 0; n < to[f].size(); n++){
+			if(toPositions[n] == -1){
+				coefficients[f].push_back(
+					vector<complex<double>>(
+						numCoefficients,
+						0
+					)
+				);
+			}
+			else{
+				coefficients[f].push_back(
+					std::move(
+						localCoefficients[toPositions[n]]
+					)
+				);
+			}
+		}
+	}
+
+	return coefficients;
+}
+
+vector<double> ChebyshevExpander::calculateFermiFunctionCoefficients(
+) const{
+	const Model &model = getModel();
+	double chemicalPotential = model.getChemicalPotential();
+	double temperature = model.getTemperature();
+
+	vector<double> coefficients(numCoefficients, 0);
+	if(temperature == 0){
+		//The coefficients of the step function
+		//f(x) = theta(mu/scaleFactor - x) are known analytically.
+		double x = chemicalPotential/scaleFactor;
+		if(x >= 1){
+			coefficients[0] = 1;
+		}
+		else if(x > -1){
+			double theta = acos(x);
+			coefficients[0] = 1 - theta/M_PI;
+			for(int n = 1; n < numCoefficients; n++)
+				coefficients[n] = -2*sin(n*theta)/(n*M_PI);
+		}
+	}
+	else{
+		//Chebyshev-Gauss quadrature
+		//a_n = (2 - delta_{n0})/N sum_k f(cos(theta_k))cos(n theta_k),
+		//theta_k = pi(k + 1/2)/N.
+		//The sums over k form a discrete cosine transform, which is
+		//calculated with a fast Fourier transform of the even extension
+		//[f_0, ..., f_{N-1}, f_{N-1}, ..., f_0] of length 2N. Its
+		//elements F_n satisfy
+		//sum_k f_k cos(n theta_k) = Re(exp(-i pi n/2N)F_n)/2.
+		unsigned int numNodes = 1;
+		while(
+			numNodes
+			< FERMI_FUNCTION_OVERSAMPLING*numCoefficients
+		){
+			numNodes <<= 1;
+		}
+		vector<complex<double>> extension(2*numNodes);
+		for(unsigned int k = 0; k < numNodes; k++){
+			double theta = M_PI*(k + 0.5)/numNodes;
+			double occupation = Functions::fermiDiracDistribution(
+				scaleFactor*cos(theta),
+				chemicalPotential,
+				temperature
+			);
+			extension[k] = occupation;
+			extension[2*numNodes - 1 - k] = occupation;
+		}
+		fastFourierTransform(extension, -1);
+		for(int n = 0; n < numCoefficients; n++){
+			coefficients[n] = real(
+				exp(-i*M_PI*(n/(2.*numNodes)))*extension[n]
+			)/2;
+		}
+		for(int n = 0; n < numCoefficients; n++)
+			coefficients[n] *= (n == 0 ? 1. : 2.)/numNodes;
+	}
+
+	return coefficients;
+}
+
+vector<vector<complex<double>>> ChebyshevExpander::calculateDensityMatrix(
+	const vector<vector<Index>> &to,
+	const vector<Index> &from
+){
+	TBTKAssert(
+		to.size() == from.size(),
+		"Solver::ChebyshevExpander::calculateDensityMatrix()",
+		"Incompatible sizes. The number of 'to'-index vectors ("
+		<< to.size() << ") must be equal to the number of"
+		<< " 'from'-indices (" << from.size() << ").",
+		""
 	);
-	sparseMatrix *= 1/scaleFactor;
+	TBTKAssert(
+		getModel().getStatistics() == Statistics::FermiDirac,
+		"Solver::ChebyshevExpander::calculateDensityMatrix()",
+		"Only Fermi-Dirac statistics is supported.",
+		""
+	);
+	updateScaleFactor();
 
-	//Initialize workspace and set the initial state (|j0>).
-	CArray<complex<double>> jIn1(basisSize, 0);
-	CArray<complex<double>> jIn2(basisSize, 0);
-	CArray<complex<double>> jResult(basisSize, 0);
-	jIn1[fromBasisIndex] = 1.;
+	vector<vector<vector<complex<double>>>> coefficients;
+	if(densityMatrixTruncationRadius < 0){
+		coefficients = calculateBlockCoefficients(to, from);
+	}
+	else{
+		coefficients = calculateLocalCoefficientsCPU(
+			to,
+			from,
+			densityMatrixTruncationRadius
+		);
+	}
 
-	for(unsigned int n = 0; n < basisSize; n++)
-		if(coefficientMap[n] != -1)
-			coefficients[coefficientMap[n]][0] = jIn1[n];
+	vector<double> fermiFunctionCoefficients
+		= calculateFermiFunctionCoefficients();
 
-	//Calculate |j1>
-	addHamiltonianProduct(sparseMatrix, jIn1, jResult);
-	cyclicSwap(jIn1, jIn2, jResult);
-	for(unsigned int n = 0; n < basisSize; n++)
-		if(coefficientMap[n] != -1)
-			coefficients[coefficientMap[n]][1] = jIn1[n];
-
-	//Multiply hopping amplitudes by factor two, to speed up calculation of
-	//the first term in 2H|j(n-1)> - |j(n-2)>.
-	sparseMatrix *= 2;
-
-	//Iteratively calculate |jn> and corresponding Chebyshev coefficients.
-	for(int n = 2; n < numCoefficients; n++){
-		for(unsigned int c = 0; c < basisSize; c++)
-			jResult[c] = -jIn2[c];
-		addHamiltonianProduct(sparseMatrix, jIn1, jResult);
-		cyclicSwap(jIn1, jIn2, jResult);
-		for(unsigned int c = 0; c < basisSize; c++)
-			if(coefficientMap[c] != -1)
-				coefficients[coefficientMap[c]][n] = jIn1[c];
+	vector<vector<complex<double>>> densityMatrix;
+	for(unsigned int f = 0; f < coefficients.size(); f++){
+		densityMatrix.push_back(vector<complex<double>>());
+		for(unsigned int t = 0; t < coefficients[f].size(); t++){
+			complex<double> element = 0;
+			for(unsigned int n = 0; n < coefficients[f][t].size(); n++){
+				element += fermiFunctionCoefficients[n]
+					*coefficients[f][t][n];
+			}
+			densityMatrix[f].push_back(element);
+		}
+	}
+
+	return densityMatrix;
+}
+
+vector<complex<double>> ChebyshevExpander::calculateTraceCoefficients(
+	vector<double> &standardErrors
+){
+	updateScaleFactor();
+
+	TBTKAssert(
+		numCoefficients > 0,
+		"ChebyshevExpander::calculateTraceCoefficients()",
+		"numCoefficients has to be larger than 0.",
+		""
+	);
+
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+	unsigned int basisSize = hoppingAmplitudeSet.getBasisSize();
+
+	//Get the Hamiltonian on SparseMatrix format. The scale factor is
+	//applied in the matrix-vector multiplications to avoid copying the
+	//cached matrix.
+	const SparseMatrix<complex<double>> &sparseMatrix
+		= hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+
+	//The coefficients for each random vector, used to calculate both the
+	//average and the error estimate.
+	vector<vector<complex<double>>> samples(
+		numRandomVectors,
+		vector<complex<double>>(numCoefficients, 0)
+	);
+
+	//Workspace for the block of vectors. Element b of row r is stored at
+	//position r*currentBlockSize + b.
+	unsigned int maxBlockSize = min(numRandomVectors, blockSize);
+	CArray<complex<double>> jIn1(maxBlockSize*basisSize);
+	CArray<complex<double>> jIn2(maxBlockSize*basisSize);
+	CArray<complex<double>> jResult(maxBlockSize*basisSize);
+	vector<complex<double>> scalarProducts(maxBlockSize);
+
+	for(
+		unsigned int blockStart = 0;
+		blockStart < numRandomVectors;
+		blockStart += blockSize
+	){
+		unsigned int currentBlockSize = min(
+			blockSize,
+			numRandomVectors - blockStart
+		);
 
 		if(getGlobalVerbose() && getVerbose()){
-			if(n%100 == 0)
-				Streams::out << "." << flush;
-			if(n%1000 == 0)
-				Streams::out << " " << flush;
+			Streams::out << "ChebyshevExpander::calculateTraceCoefficients\n";
+			Streams::out << "\tRandom vectors: " << blockStart
+				<< "-" << blockStart + currentBlockSize - 1
+				<< " of " << numRandomVectors << "\n";
+			Streams::out << "\tBasis size: " << basisSize << "\n";
+			Streams::out << "\tProgress (100 coefficients per dot): ";
+		}
+
+		//Set the initial states (|j0> = |r>). Each random vector is
+		//generated from its own random number stream that is seeded
+		//by the seed and the random vector number. This makes the
+		//result independent of the number of threads and the block
+		//size.
+#ifdef TBTK_USE_OPEN_MP
+		#pragma omp parallel for
+#endif
+		for(unsigned int b = 0; b < currentBlockSize; b++){
+			seed_seq seedSequence{randomSeed, blockStart + b};
+			mt19937_64 generator(seedSequence);
+			switch(randomVectorType){
+			case RandomVectorType::RandomPhase:
+			{
+				uniform_real_distribution<double> distribution(
+					0,
+					2*M_PI
+				);
+				for(unsigned int n = 0; n < basisSize; n++){
+					jIn1[currentBlockSize*n + b] = exp(
+						i*distribution(generator)
+					);
+				}
+				break;
+			}
+			case RandomVectorType::Rademacher:
+			{
+				bernoulli_distribution distribution(0.5);
+				for(unsigned int n = 0; n < basisSize; n++){
+					if(distribution(generator))
+						jIn1[currentBlockSize*n + b] = 1.;
+					else
+						jIn1[currentBlockSize*n + b] = -1.;
+				}
+				break;
+			}
+			default:
+				TBTKExit(
+					"Solver::ChebyshevExpander::calculateTraceCoefficients()",
+					"Unknown random vector type.",
+					"This should never happen, contact the"
+					<< " developer."
+				);
+			}
+		}
+
+		//Calculate <j0|j0> and |j1>.
+		calculateScalarProducts(
+			jIn1,
+			jIn1,
+			basisSize,
+			currentBlockSize,
+			scalarProducts
+		);
+		for(unsigned int b = 0; b < currentBlockSize; b++)
+			samples[blockStart + b][0] = scalarProducts[b];
+		sparseMatrix.axpby(
+			1/scaleFactor,
+			jIn1.getData(),
+			0.,
+			nullptr,
+			jResult.getData(),
+			currentBlockSize
+		);
+		cyclicSwap(jIn1, jIn2, jResult);
+
+		//The relation 2T_m(x)T_n(x) = T_{m+n}(x) + T_{|m-n|}(x) gives
+		//<r|T_{2n}(H)|r> = 2<j_n|j_n> - <r|T_0(H)|r> and
+		//<r|T_{2n-1}(H)|r> = 2<j_n|j_{n-1}> - <r|T_1(H)|r>. Two
+		//coefficients are therefore obtained for each multiplication
+		//by the Hamiltonian.
+		for(unsigned int n = 1; 2*n - 1 < (unsigned int)numCoefficients; n++){
+			if(n > 1){
+				sparseMatrix.axpby(
+					2/scaleFactor,
+					jIn1.getData(),
+					-1.,
+					jIn2.getData(),
+					jResult.getData(),
+					currentBlockSize
+				);
+				cyclicSwap(jIn1, jIn2, jResult);
+			}
+
+			calculateScalarProducts(
+				jIn1,
+				jIn2,
+				basisSize,
+				currentBlockSize,
+				scalarProducts
+			);
+			for(unsigned int b = 0; b < currentBlockSize; b++){
+				vector<complex<double>> &sample
+					= samples[blockStart + b];
+				if(n == 1)
+					sample[1] = scalarProducts[b];
+				else
+					sample[2*n-1] = 2.*scalarProducts[b] - sample[1];
+			}
+
+			if(2*n < (unsigned int)numCoefficients){
+				calculateScalarProducts(
+					jIn1,
+					jIn1,
+					basisSize,
+					currentBlockSize,
+					scalarProducts
+				);
+				for(unsigned int b = 0; b < currentBlockSize; b++){
+					vector<complex<double>> &sample
+						= samples[blockStart + b];
+					sample[2*n] = 2.*scalarProducts[b] - sample[0];
+				}
+			}
+
+			if(getGlobalVerbose() && getVerbose()){
+				if(n%50 == 0)
+					Streams::out << "." << flush;
+				if(n%500 == 0)
+					Streams::out << " " << flush;
+			}
 		}
+		if(getGlobalVerbose() && getVerbose())
+			Streams::out << "\n";
 	}
-	if(getGlobalVerbose() && getVerbose())
-		Streams::out << "\n";
 
-	//Lorentzian convolution
+	//Calculate the average and the standard error of the mean.
+	vector<vector<complex<double>>> coefficients(
+		1,
+		vector<complex<double>>(numCoefficients, 0)
+	);
+	standardErrors = vector<double>(numCoefficients, 0);
+	for(int n = 0; n < numCoefficients; n++){
+		for(unsigned int r = 0; r < numRandomVectors; r++)
+			coefficients[0][n] += samples[r][n];
+		coefficients[0][n] /= (double)numRandomVectors;
+
+		if(numRandomVectors > 1){
+			double variance = 0;
+			for(unsigned int r = 0; r < numRandomVectors; r++)
+				variance += norm(samples[r][n] - coefficients[0][n]);
+			variance /= numRandomVectors - 1;
+			standardErrors[n] = sqrt(variance/numRandomVectors);
+		}
+		else{
+			standardErrors[n] = numeric_limits<double>::infinity();
+		}
+	}
+
+	//Apply the same Lorentzian convolution to the errors as to the
+	//coefficients.
 	if(broadening != 0){
 		double lambda = broadening*numCoefficients;
 		for(int n = 0; n < numCoefficients; n++)
-			for(unsigned int c = 0; c < to.size(); c++)
-				coefficients[c][n] = coefficients[c][n]*sinh(lambda*(1 - n/(double)numCoefficients))/sinh(lambda);
+			standardErrors[n] *= sinh(lambda*(1 - n/(double)numCoefficients))/sinh(lambda);
 	}
+	applyBroadening(coefficients);
 
-	return coefficients;
+	return coefficients[0];
+}
+
+void ChebyshevExpander::calculateScalarProducts(
+	const CArray<complex<double>> &lhs,
+	const CArray<complex<double>> &rhs,
+	unsigned int basisSize,
+	unsigned int numVectors,
+	vector<complex<double>> &result
+) const{
+	//The rows are divided into chunks of fixed size that are summed in
+	//parallel. The partial sums are added up in order afterwards, which
+	//makes the result independent of the number of threads.
+	unsigned int numChunks
+		= (basisSize + SCALAR_PRODUCT_CHUNK_SIZE - 1)
+			/SCALAR_PRODUCT_CHUNK_SIZE;
+	vector<complex<double>> partialSums(numChunks*numVectors, 0);
+#ifdef TBTK_USE_OPEN_MP
+	#pragma omp parallel for
+#endif
+	for(unsigned int chunk = 0; chunk < numChunks; chunk++){
+		complex<double> *partialSum = &partialSums[chunk*numVectors];
+		unsigned int end = min(
+			(chunk + 1)*SCALAR_PRODUCT_CHUNK_SIZE,
+			basisSize
+		);
+		for(
+			unsigned int n = chunk*SCALAR_PRODUCT_CHUNK_SIZE;
+			n < end;
+			n++
+		){
+			for(unsigned int b = 0; b < numVectors; b++){
+				partialSum[b] += conj(lhs[numVectors*n + b])
+					*rhs[numVectors*n + b];
+			}
+		}
+	}
+
+	for(unsigned int b = 0; b < numVectors; b++)
+		result[b] = 0;
+	for(unsigned int chunk = 0; chunk < numChunks; chunk++)
+		for(unsigned int b = 0; b < numVectors; b++)
+			result[b] += partialSums[chunk*numVectors + b];
+}
+
+void ChebyshevExpander::applyBroadening(
+	vector<vector<complex<double>>> &coefficients
+) const{
+	//Lorentzian convolution
+	if(broadening != 0){
+		for(unsigned int c = 0; c < coefficients.size(); c++)
+			for(unsigned int n = 0; n < coefficients[c].size(); n++)
+				coefficients[c][n] *= getBroadeningFactor(n);
+	}
 }
 
 void ChebyshevExpander::generateLookupTable(){
@@ -314,6 +1452,9 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 		<< " factor."
 	);
 
+	if(useFastTransform)
+		return generateGreensFunctionFastTransform(coefficients, type);
+
 	ensureLookupTableIsReady();
 
 	vector<complex<double>> greensFunctionData(
@@ -322,9 +1463,15 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 	);
 
 	if(useLookupTable){
+		//The coefficients can be fewer than numCoefficients if
+		//adaptive truncation is enabled.
+		int numMoments = min(
+			(int)coefficients.size(),
+			lookupTableNumCoefficients
+		);
 		switch(type){
 		case Type::Retarded:
-			for(int n = 0; n < lookupTableNumCoefficients; n++){
+			for(int n = 0; n < numMoments; n++){
 				for(int e = 0; e < lookupTableResolution; e++){
 					greensFunctionData[e]
 						+= generatingFunctionLookupTable[n][e]*coefficients[n];
@@ -332,7 +1479,7 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 			}
 			break;
 		case Type::Advanced:
-			for(int n = 0; n < lookupTableNumCoefficients; n++){
+			for(int n = 0; n < numMoments; n++){
 				for(int e = 0; e < lookupTableResolution; e++){
 					greensFunctionData[e]
 						+= coefficients[n]*conj(generatingFunctionLookupTable[n][e]);
@@ -340,7 +1487,7 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 			}
 			break;
 		case Type::Principal:
-			for(int n = 0; n < lookupTableNumCoefficients; n++){
+			for(int n = 0; n < numMoments; n++){
 				for(int e = 0; e < lookupTableResolution; e++){
 					greensFunctionData[e]
 						+= -coefficients[n]*real(
@@ -350,7 +1497,7 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 			}
 			break;
 		case Type::NonPrincipal:
-			for(int n = 0; n < lookupTableNumCoefficients; n++){
+			for(int n = 0; n < numMoments; n++){
 				for(int e = 0; e < lookupTableResolution; e++){
 					greensFunctionData[e]
 						-= coefficients[n]*i*imag(
@@ -383,7 +1530,7 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 			double acosE = acos(E);
 			switch(type){
 			case Type::Retarded:
-				for(int n = 1; n < numCoefficients; n++){
+				for(int n = 1; n < (int)coefficients.size(); n++){
 					greensFunctionData[e]
 						+= coefficients[n]*exp(
 							-i*((double)n)*acosE
@@ -392,17 +1539,16 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 				greensFunctionData[e] *= -2.*i/scaleFactor;
 				break;
 			case Type::Advanced:
-				for(int n = 1; n < numCoefficients; n++){
-					greensFunctionData[e] += conj(
-						coefficients[n]*exp(
-							-i*((double)n)*acosE
-						)
-					);
+				for(int n = 1; n < (int)coefficients.size(); n++){
+					greensFunctionData[e]
+						+= coefficients[n]*exp(
+							i*((double)n)*acosE
+						);
 				}
 				greensFunctionData[e] *= 2.*i/scaleFactor;
 				break;
 			case Type::Principal:
-				for(int n = 1; n < numCoefficients; n++){
+				for(int n = 1; n < (int)coefficients.size(); n++){
 					greensFunctionData[e]
 						+= coefficients[n]*sin(
 							((double)n)*acosE
@@ -411,7 +1557,7 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 				greensFunctionData[e] *= 2./scaleFactor;
 				break;
 			case Type::NonPrincipal:
-				for(int n = 1; n < numCoefficients; n++){
+				for(int n = 1; n < (int)coefficients.size(); n++){
 					greensFunctionData[e]
 						+= coefficients[n]*cos(
 							((double)n)*acosE
@@ -434,5 +1580,193 @@ vector<complex<double>> ChebyshevExpander::generateGreensFunctionCPU(
 	return greensFunctionData;
 }
 
+vector<double> ChebyshevExpander::getChebyshevNodes(unsigned int numNodes){
+	ensureScaleFactorIsReady();
+
+	vector<double> nodes;
+	nodes.reserve(numNodes);
+	for(unsigned int k = 0; k < numNodes; k++)
+		nodes.push_back(scaleFactor*cos(M_PI*(k + 0.5)/numNodes));
+
+	return nodes;
+}
+
+vector<complex<double>> ChebyshevExpander::generateGreensFunctionOnChebyshevNodes(
+	const vector<complex<double>> &coefficients,
+	unsigned int numNodes,
+	Type type
+){
+	ensureScaleFactorIsReady();
+
+	vector<complex<double>> sums = calculateFastTransformSums(
+		coefficients,
+		numNodes,
+		type
+	);
+	for(unsigned int k = 0; k < numNodes; k++){
+		sums[k] = applyGreensFunctionPrefactor(
+			sums[k],
+			cos(M_PI*(k + 0.5)/numNodes),
+			type
+		);
+	}
+
+	return sums;
+}
+
+vector<complex<double>> ChebyshevExpander::calculateFastTransformSums(
+	const vector<complex<double>> &coefficients,
+	unsigned int numNodes,
+	Type type
+) const{
+	TBTKAssert(
+		numNodes != 0 && (numNodes & (numNodes - 1)) == 0,
+		"Solver::ChebyshevExpander::calculateFastTransformSums()",
+		"The number of nodes (" << numNodes << ") must be a power of"
+		<< " two.",
+		""
+	);
+	TBTKAssert(
+		numNodes >= coefficients.size(),
+		"Solver::ChebyshevExpander::calculateFastTransformSums()",
+		"The number of nodes (" << numNodes << ") must be at least as"
+		<< " large as the number of coefficients ("
+		<< coefficients.size() << ").",
+		""
+	);
+
+	//With theta_k = 2*pi*(k + 1/2)/(2K), the sums
+	//S_{+-}(theta_k) = sum_n b_n exp(+-i*n*theta_k) are discrete Fourier
+	//transforms of length 2K of the coefficients multiplied by
+	//exp(+-i*pi*n/(2K)). The retarded and advanced Green's functions are
+	//given by S_- and S_+, respectively, while the sums over
+	//cos(n*theta_k) and sin(n*theta_k) are obtained as linear
+	//combinations of S_+ and S_-.
+	bool needsMinus = (type != Type::Advanced);
+	bool needsPlus = (type != Type::Retarded);
+	vector<complex<double>> sumsMinus;
+	vector<complex<double>> sumsPlus;
+	if(needsMinus)
+		sumsMinus = vector<complex<double>>(2*numNodes, 0);
+	if(needsPlus)
+		sumsPlus = vector<complex<double>>(2*numNodes, 0);
+	for(unsigned int n = 0; n < coefficients.size(); n++){
+		complex<double> coefficient = coefficients[n];
+		if(n == 0)
+			coefficient /= 2.;
+		complex<double> phase = exp(-i*M_PI*(n/(2.*numNodes)));
+		if(needsMinus)
+			sumsMinus[n] = coefficient*phase;
+		if(needsPlus)
+			sumsPlus[n] = coefficient*conj(phase);
+	}
+	if(needsMinus)
+		fastFourierTransform(sumsMinus, -1);
+	if(needsPlus)
+		fastFourierTransform(sumsPlus, 1);
+
+	vector<complex<double>> sums(numNodes);
+	switch(type){
+	case Type::Retarded:
+		for(unsigned int k = 0; k < numNodes; k++)
+			sums[k] = sumsMinus[k];
+		break;
+	case Type::Advanced:
+		for(unsigned int k = 0; k < numNodes; k++)
+			sums[k] = sumsPlus[k];
+		break;
+	case Type::Principal:
+		for(unsigned int k = 0; k < numNodes; k++)
+			sums[k] = (sumsPlus[k] - sumsMinus[k])/(2.*i);
+		break;
+	case Type::NonPrincipal:
+		for(unsigned int k = 0; k < numNodes; k++)
+			sums[k] = (sumsPlus[k] + sumsMinus[k])/2.;
+		break;
+	default:
+		TBTKExit(
+			"Solver::ChebyshevExpander::calculateFastTransformSums()",
+			"Unkown Green's function type.",
+			"This should never happen, contact the developer."
+		);
+	}
+
+	return sums;
+}
+
+vector<complex<double>> ChebyshevExpander::generateGreensFunctionFastTransform(
+	const vector<complex<double>> &coefficients,
+	Type type
+) const{
+	unsigned int numNodes = 4;
+	while(numNodes < FAST_TRANSFORM_OVERSAMPLING*coefficients.size())
+		numNodes <<= 1;
+
+	vector<complex<double>> sums = calculateFastTransformSums(
+		coefficients,
+		numNodes,
+		type
+	);
+
+	//The sums are smooth functions of theta = acos(E/scaleFactor) and
+	//are therefore interpolated in theta using cubic Lagrange
+	//interpolation, after which the prefactor is applied at the exact
+	//energy.
+	vector<complex<double>> greensFunctionData(
+		energyWindow.getResolution()
+	);
+	for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
+		double E = energyWindow[e]/scaleFactor;
+		double position = acos(E)*numNodes/M_PI - 0.5;
+		int first = (int)floor(position) - 1;
+		if(first < 0)
+			first = 0;
+		if(first > (int)numNodes - 4)
+			first = numNodes - 4;
+
+		complex<double> sum = 0;
+		for(int m = 0; m < 4; m++){
+			double weight = 1;
+			for(int l = 0; l < 4; l++){
+				if(l != m){
+					weight *= (position - (first + l))
+						/(double)(m - l);
+				}
+			}
+			sum += weight*sums[first + m];
+		}
+
+		greensFunctionData[e] = applyGreensFunctionPrefactor(
+			sum,
+			E,
+			type
+		);
+	}
+
+	return greensFunctionData;
+}
+
+complex<double> ChebyshevExpander::applyGreensFunctionPrefactor(
+	complex<double> sum,
+	double E,
+	Type type
+) const{
+	switch(type){
+	case Type::Retarded:
+		return -2.*i*sum/(scaleFactor*sqrt(1 - E*E));
+	case Type::Advanced:
+	case Type::NonPrincipal:
+		return 2.*i*sum/(scaleFactor*sqrt(1 - E*E));
+	case Type::Principal:
+		return 2.*sum/(scaleFactor*sqrt(1 - E*E));
+	default:
+		TBTKExit(
+			"Solver::ChebyshevExpander::applyGreensFunctionPrefactor()",
+			"Unkown Green's function type.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
@@ -19,9 +19,16 @@
  */
 
 #include "TBTK/Solver/Diagonalizer.h"
+#include "TBTK/Solver/HermitianTridiagonalizer.h"
+#include "TBTK/SparseMatrix.h"
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
 using namespace std;
 
 namespace TBTK{
@@ -33,6 +40,20 @@ DynamicTypeInformation Diagonalizer::dynamicTypeInformation(
 );
 
 Diagonalizer::Diagonalizer() : Communicator(false){
+	algorithm = Algorithm::Packed;
+	nonOrthonormalBasisMethod = NonOrthonormalBasisMethod::Cholesky;
+	spectrumRange = SpectrumRange::All;
+	eigenValueWindowLowerBound = 0;
+	eigenValueWindowUpperBound = 0;
+	firstEigenStateIndex = 0;
+	lastEigenStateIndex = 0;
+	eigenVectorMode = EigenVectorMode::All;
+	eigenVectorWindowLowerBound = 0;
+	eigenVectorWindowUpperBound = 0;
+	firstEigenVectorState = 0;
+	numEigenVectors = 0;
+	lobpcgTolerance = 1e-8;
+	lobpcgMaxIterations = 1000;
 	maxIterations = 50;
 	selfConsistencyCallback = nullptr;
 }
@@ -76,10 +97,47 @@ void Diagonalizer::init(){
 	if(getGlobalVerbose() && getVerbose())
 		Streams::out << "\tBasis size: " << basisSize << "\n";
 
-	hamiltonian = CArray<complex<double>>((basisSize*(basisSize+1))/2);
-	eigenValues = CArray<double>(basisSize);
-	eigenVectors = CArray<complex<double>>(basisSize*basisSize);
+	if(algorithm == Algorithm::LOBPCG){
+		TBTKAssert(
+			getModel(
+			).getOverlapAmplitudeSet().getAssumeOrthonormalBasis(),
+			"Solver::Diagonalizer::init()",
+			"Algorithm::LOBPCG only supports orthonormal bases.",
+			"Use another algorithm."
+		);
 
+		//The Hamiltonian is stored as a sparse matrix and the
+		//eigenvalues and eigenvectors are allocated by solveLOBPCG().
+		hamiltonian = CArray<complex<double>>();
+		eigenValues = CArray<double>();
+		eigenVectors = CArray<complex<double>>();
+	}
+	else{
+		hamiltonian = CArray<complex<double>>(
+			(basisSize*(basisSize+1))/2
+		);
+		eigenValues = CArray<double>(basisSize);
+		//Algorithm::MRRR allocates the eigenvectors for the requested
+		//part of the spectrum in solveMRRR().
+		if(
+			eigenVectorMode == EigenVectorMode::All
+			&& algorithm != Algorithm::MRRR
+		){
+			eigenVectors = CArray<complex<double>>(
+				basisSize*basisSize
+			);
+		}
+		else{
+			eigenVectors = CArray<complex<double>>();
+		}
+	}
+	firstEigenVectorState = 0;
+	numEigenVectors = 0;
+	lobpcgSubspace = Matrix<complex<double>>();
+
+	//The overlap matrix does not change between self-consistency steps,
+	//so the basis transformation is only set up once.
+	setupBasisTransformation();
 	update();
 }
 
@@ -87,6 +145,11 @@ void Diagonalizer::update(){
 	const Model &model = getModel();
 	int basisSize = model.getBasisSize();
 
+	//Algorithm::LOBPCG uses the sparse matrix cached by the
+	//HoppingAmplitudeSet, which is requested in solveLOBPCG().
+	if(algorithm == Algorithm::LOBPCG)
+		return;
+
 	for(int n = 0; n < (basisSize*(basisSize+1))/2; n++)
 		hamiltonian[n] = 0.;
 
@@ -106,7 +169,6 @@ void Diagonalizer::update(){
 			hamiltonian[to + (from*(from+1))/2] += (*iterator).getAmplitude();
 	}
 
-	setupBasisTransformation();
 	transformToOrthonormalBasis();
 }
 
@@ -137,11 +199,192 @@ extern "C" void zhbeb_(
 	double *rwork,		//Workspace, dimension = max(1, 3*N-2)
 	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
+//Lapack function for matrix diagonalization of a full matrix using the divide
+//and conquer algorithm.
+extern "C" void zheevd_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Upper triangle stored, 'L' = Lower triangle stored.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, overwritten by the eigenvectors if jobz = 'V'
+	int *lda,		//Leading dimension of a
+	double *w,		//Eigenvalues, is in accending order if info = 0
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = failed to converge.
+
+//Lapack function for matrix diagonalization of a full matrix using multiple
+//relatively robust representations.
+extern "C" void zheevr_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *range,		//'A' = All, 'V' = Eigenvalues in (vl, vu], 'I' = Eigenvalues il to iu.
+	char *uplo,		//'U' = Upper triangle stored, 'L' = Lower triangle stored.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, destroyed on exit
+	int *lda,		//Leading dimension of a
+	double *vl,		//Lower bound of the eigenvalue window
+	double *vu,		//Upper bound of the eigenvalue window
+	int *il,		//Index of the first eigenvalue (1-based)
+	int *iu,		//Index of the last eigenvalue (1-based)
+	double *abstol,		//Absolute error tolerance, <= 0 = default
+	int *m,			//Number of eigenvalues found
+	double *w,		//Eigenvalues, is in accending order if info = 0
+	complex<double> *z,	//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	int *isuppz,		//Support of the eigenvectors, dimension = 2*max(1, m)
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = internal error.
+
+
+//Calls zheevr with a workspace query and returns the number of calculated
+//eigenvalues.
+static int callZheevr(
+	bool calculateEigenVectors,
+	char range,
+	int n,
+	complex<double> *a,
+	double vl,
+	double vu,
+	int il,
+	int iu,
+	double *w,
+	complex<double> *z,
+	int maxNumStates
+){
+	char jobz = calculateEigenVectors ? 'V' : 'N';
+	char uplo = 'U';
+	double abstol = 0;
+	int m;
+	int ldz = calculateEigenVectors ? n : 1;
+	complex<double> dummyEigenVector;
+	if(!calculateEigenVectors)
+		z = &dummyEigenVector;
+	CArray<int> isuppz(2*max(1, maxNumStates));
+	int info;
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	zheevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		a,
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w,
+		z,
+		&ldz,
+		isuppz.getData(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		a,
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w,
+		z,
+		&ldz,
+		isuppz.getData(),
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solve()",
+		"Diagonalization routine zheevr exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zheevr for further information."
+	);
+
+	return m;
+}
+
+//Lapack function for the Cholesky factorization of a packed Hermitian
+//positive definite matrix.
+extern "C" void zpptrf_(
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *ap,	//Input matrix, overwritten by the Cholesky factor
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = not positive definite.
+
+//Lapack function for reducing a packed generalized eigenvalue problem to
+//standard form.
+extern "C" void zhpgst_(
+	int *itype,		//1 = A*x = lambda*B*x
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *ap,	//Input matrix, overwritten by the transformed matrix
+	complex<double> *bp,	//Cholesky factor of B as returned by zpptrf
+	int *info);		//0 = successful, <0 = -info value was illegal.
+
+//Lapack function for solving a packed triangular system of equations.
+extern "C" void ztptrs_(
+	char *uplo,		//'U' = Upper triangular, 'L' = Lower triangular.
+	char *trans,		//'N' = A*X = B, 'T' = A^T*X = B, 'C' = A^H*X = B.
+	char *diag,		//'N' = Non-unit triangular, 'U' = Unit triangular.
+	int *n,			//n*n = Matrix size
+	int *nrhs,		//Number of right hand sides
+	complex<double> *ap,	//Packed triangular matrix
+	complex<double> *b,	//Right hand sides, overwritten by the solution
+	int *ldb,		//Leading dimension of b
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = singular matrix.
+
 void Diagonalizer::setupBasisTransformation(){
 	//Get the OverlapAmplitudeSet.
 	const OverlapAmplitudeSet &overlapAmplitudeSet
 		= getModel().getOverlapAmplitudeSet();
 
+	//Clear any previous basis transformation.
+	basisTransformation = CArray<complex<double>>();
+	overlapFactorization = CArray<complex<double>>();
+
 	//Skip if the basis is assumed to be orthonormal.
 	if(overlapAmplitudeSet.getAssumeOrthonormalBasis())
 		return;
@@ -170,6 +413,30 @@ void Diagonalizer::setupBasisTransformation(){
 		}
 	}
 
+	if(nonOrthonormalBasisMethod == NonOrthonormalBasisMethod::Cholesky){
+		//Factorize the overlap matrix as S = U^{\dagger}U. The
+		//factorization is kept and used to transform the Hamiltonian
+		//and the eigenvectors.
+		char uplo = 'U';
+		int n = basisSize;
+		int info;
+		zpptrf_(&uplo, &n, overlapMatrix.getData(), &info);
+
+		TBTKAssert(
+			info == 0,
+			"Diagonalizer::setupBasisTransformation()",
+			"Cholesky factorization routine zpptrf exited with INFO="
+			<< info << ".",
+			"The overlap matrix must be positive definite. For nearly"
+			<< " linearly dependent bases, try"
+			<< " Diagonalizer::NonOrthonormalBasisMethod::CanonicalOrthogonalization."
+		);
+
+		overlapFactorization = std::move(overlapMatrix);
+
+		return;
+	}
+
 	//Diagonalize the overlap matrix.
 	char jobz = 'V';
 	char uplo = 'U';
@@ -214,18 +481,45 @@ void Diagonalizer::setupBasisTransformation(){
 }
 
 void Diagonalizer::transformToOrthonormalBasis(){
+	int basisSize = getModel().getBasisSize();
+
+	//Perform the transformation H' = U^{-\dagger}HU^{-1}, where
+	//S = U^{\dagger}U is the Cholesky factorization of the overlap
+	//matrix.
+	if(overlapFactorization.getData() != nullptr){
+		int itype = 1;
+		char uplo = 'U';
+		int n = basisSize;
+		int info;
+		zhpgst_(
+			&itype,
+			&uplo,
+			&n,
+			hamiltonian.getData(),
+			overlapFactorization.getData(),
+			&info
+		);
+
+		TBTKAssert(
+			info == 0,
+			"Diagonalizer::transformToOrthonormalBasis()",
+			"Routine zhpgst exited with INFO=" << info << ".",
+			"See LAPACK documentation for zhpgst for further"
+			<< " information."
+		);
+
+		return;
+	}
+
 	//Skip if no basis transformation has been set up (the original basis
 	//is assumed to be orthonormal).
 	if(basisTransformation.getData() == nullptr)
 		return;
 
-	int basisSize = getModel().getBasisSize();
-
 	//Perform the transformation H' = U^{\dagger}HU, where U is the
 	//transform to the orthonormal basis.
 	Matrix<complex<double>> h(basisSize, basisSize);
 	Matrix<complex<double>> U(basisSize, basisSize);
-	Matrix<complex<double>> Udagger(basisSize, basisSize);
 	for(int row = 0; row < basisSize; row++){
 		for(int col = 0; col < basisSize; col++){
 			if(col >= row){
@@ -240,14 +534,12 @@ void Diagonalizer::transformToOrthonormalBasis(){
 
 			U.at(row, col)
 				= basisTransformation[row + basisSize*col];
-
-			Udagger.at(row, col) = conj(
-				basisTransformation[col + basisSize*row]
-			);
 		}
 	}
 
-	Matrix<complex<double>> hp = Udagger*h*U;
+	Matrix<complex<double>> hU = h*U;
+	Matrix<complex<double>> hp;
+	hp.adjointMultiply(U, hU);
 
 	for(int row = 0; row < basisSize; row++){
 		for(int col = 0; col < basisSize; col++){
@@ -260,31 +552,66 @@ void Diagonalizer::transformToOrthonormalBasis(){
 }
 
 void Diagonalizer::transformToOriginalBasis(){
+	int basisSize = getModel().getBasisSize();
+	int numStates = numEigenVectors;
+	if(numStates == 0)
+		return;
+
+	//Perform the transformation v = U^{-1}v', where S = U^{\dagger}U is the
+	//Cholesky factorization of the overlap matrix and v and v' are the
+	//eigenvectors in the original and orthonormal basis, respectively.
+	if(overlapFactorization.getData() != nullptr){
+		char uplo = 'U';
+		char trans = 'N';
+		char diag = 'N';
+		int n = basisSize;
+		int info;
+		ztptrs_(
+			&uplo,
+			&trans,
+			&diag,
+			&n,
+			&numStates,
+			overlapFactorization.getData(),
+			eigenVectors.getData(),
+			&n,
+			&info
+		);
+
+		TBTKAssert(
+			info == 0,
+			"Diagonalizer::transformToOriginalBasis()",
+			"Routine ztptrs exited with INFO=" << info << ".",
+			"See LAPACK documentation for ztptrs for further"
+			<< " information."
+		);
+
+		return;
+	}
+
 	//Skip if no basis transformation has been set up (the original basis
 	//is assumed to be orthonormal).
 	if(basisTransformation.getData() == nullptr)
 		return;
 
-	int basisSize = getModel().getBasisSize();
-
 	//Perform the transformation v = Uv', where U is the transformation to
 	//the orthonormal basis and v and v' are the eigenvectors in the
 	//original and orthonormal basis, respectively.
 	Matrix<complex<double>> U(basisSize, basisSize);
-	Matrix<complex<double>> Vp(basisSize, basisSize);
+	Matrix<complex<double>> Vp(basisSize, numStates);
 	for(int row = 0; row < basisSize; row++){
 		for(int col = 0; col < basisSize; col++){
 			U.at(row, col)
 				= basisTransformation[row + basisSize*col];
-
-			Vp.at(row, col) = eigenVectors[row + basisSize*col];
 		}
+		for(int col = 0; col < numStates; col++)
+			Vp.at(row, col) = eigenVectors[row + basisSize*col];
 	}
 
 	Matrix<complex<double>> V = U*Vp;
 
 	for(int row = 0; row < basisSize; row++){
-		for(int col = 0; col < basisSize; col++){
+		for(int col = 0; col < numStates; col++){
 			eigenVectors[row + basisSize*col]
 				= V.at(row, col);
 		}
@@ -292,62 +619,761 @@ void Diagonalizer::transformToOriginalBasis(){
 }
 
 void Diagonalizer::solve(){
-	if(true){//Currently no support for banded matrices.
-		//Setup zhpev to calculate...
-		char jobz = 'V';		//...eigenvalues and eigenvectors...
-		char uplo = 'U';		//...for an upper triangular...
-		int n = getModel().getBasisSize();	//...nxn-matrix.
-		//Initialize workspaces
-		CArray<complex<double>> work(2*n-1);
-		CArray<double> rwork(3*n-2);
-		int info;
-		//Solve brop
-		zhpev_(
-			&jobz,
-			&uplo,
-			&n,
-			hamiltonian.getData(),
-			eigenValues.getData(),
-			eigenVectors.getData(),
-			&n,
-			work.getData(),
-			rwork.getData(),
-			&info
+	TBTKAssert(
+		spectrumRange == SpectrumRange::All
+		|| algorithm == Algorithm::MRRR
+		|| algorithm == Algorithm::LOBPCG,
+		"Solver::Diagonalizer::solve()",
+		"Only part of the spectrum requested, but the algorithm is not"
+		<< " Algorithm::MRRR or Algorithm::LOBPCG.",
+		"Use Diagonalizer::setAlgorithm(Diagonalizer::Algorithm::MRRR)"
+		<< " or call Diagonalizer::setFullSpectrum()."
+	);
+	TBTKAssert(
+		spectrumRange != SpectrumRange::All
+		|| algorithm != Algorithm::LOBPCG,
+		"Solver::Diagonalizer::solve()",
+		"Algorithm::LOBPCG cannot calculate the full spectrum.",
+		"Use Diagonalizer::setEigenStateIndexRange() or"
+		<< " Diagonalizer::setEigenValueWindow() to select the part"
+		<< " of the spectrum to calculate."
+	);
+	TBTKAssert(
+		spectrumRange == SpectrumRange::All
+		|| eigenVectorMode != EigenVectorMode::Window,
+		"Solver::Diagonalizer::solve()",
+		"An eigenvector window cannot be combined with an eigenvalue"
+		<< " window or eigenstate index range.",
+		"Call Diagonalizer::setFullSpectrum() or use"
+		<< " Diagonalizer::setEigenVectorMode() to calculate all"
+		<< " eigenvectors."
+	);
+
+	if(eigenVectorMode == EigenVectorMode::Window){
+		solveEigenVectorWindow();
+		transformToOriginalBasis();
+
+		return;
+	}
+
+	bool calculateEigenVectors = (eigenVectorMode == EigenVectorMode::All);
+	switch(algorithm){
+	case Algorithm::Packed:
+		solvePacked(calculateEigenVectors);
+		break;
+	case Algorithm::DivideAndConquer:
+		solveDivideAndConquer(calculateEigenVectors);
+		break;
+	case Algorithm::MRRR:
+		solveMRRR(calculateEigenVectors);
+		break;
+	case Algorithm::LOBPCG:
+		solveLOBPCG(calculateEigenVectors);
+		break;
+	default:
+		TBTKExit(
+			"Solver::Diagonalizer::solve()",
+			"Unknown algorithm.",
+			"This should never happen, contact the developer."
 		);
+	}
+
+	firstEigenVectorState = 0;
+	if(calculateEigenVectors)
+		numEigenVectors = eigenValues.getSize();
+	else
+		numEigenVectors = 0;
+
+	transformToOriginalBasis();
+}
+
+void Diagonalizer::solvePacked(bool calculateEigenVectors){
+	//Setup zhpev to calculate...
+	char jobz = calculateEigenVectors ? 'V' : 'N';	//...eigenvalues and possibly eigenvectors...
+	char uplo = 'U';		//...for an upper triangular...
+	int n = getModel().getBasisSize();	//...nxn-matrix.
+	int ldz = calculateEigenVectors ? n : 1;
+	complex<double> dummyEigenVector;
+	complex<double> *z = calculateEigenVectors
+		? eigenVectors.getData()
+		: &dummyEigenVector;
+	//Initialize workspaces
+	CArray<complex<double>> work(2*n-1);
+	CArray<double> rwork(3*n-2);
+	int info;
+	//Solve brop
+	zhpev_(
+		&jobz,
+		&uplo,
+		&n,
+		hamiltonian.getData(),
+		eigenValues.getData(),
+		z,
+		&ldz,
+		work.getData(),
+		rwork.getData(),
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solve()",
+		"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zhpev for further information."
+	);
+}
+
+void Diagonalizer::solveDivideAndConquer(bool calculateEigenVectors){
+	//The eigenvectors overwrite the input matrix. The full matrix is
+	//therefore expanded directly into the eigenvector storage.
+	int n = getModel().getBasisSize();
+	CArray<complex<double>> matrix;
+	complex<double> *a;
+	if(calculateEigenVectors){
+		a = eigenVectors.getData();
+	}
+	else{
+		matrix = CArray<complex<double>>(n*n);
+		a = matrix.getData();
+	}
+	expandHamiltonian(a);
 
+	char jobz = calculateEigenVectors ? 'V' : 'N';
+	char uplo = 'U';
+	int info;
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		a,
+		&n,
+		eigenValues.getData(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		a,
+		&n,
+		eigenValues.getData(),
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solve()",
+		"Diagonalization routine zheevd exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zheevd for further information."
+	);
+}
+
+void Diagonalizer::solveMRRR(bool calculateEigenVectors){
+	int n = getModel().getBasisSize();
+	double vl = eigenValueWindowLowerBound;
+	double vu = eigenValueWindowUpperBound;
+	int il = firstEigenStateIndex + 1;
+	int iu = lastEigenStateIndex + 1;
+	char range;
+	int maxNumStates;
+	switch(spectrumRange){
+	case SpectrumRange::All:
+		range = 'A';
+		maxNumStates = n;
+		break;
+	case SpectrumRange::EigenValueWindow:
+		range = 'V';
+		maxNumStates = n;
+		break;
+	case SpectrumRange::EigenStateIndexRange:
 		TBTKAssert(
-			info == 0,
-			"Diagonalizer:solve()",
-			"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
-			"See LAPACK documentation for zhpev for further information."
+			lastEigenStateIndex < n,
+			"Solver::Diagonalizer::solve()",
+			"The eigenstate index range [" << firstEigenStateIndex
+			<< ", " << lastEigenStateIndex << "] is out of bounds"
+			<< " for the basis size '" << n << "'.",
+			""
+		);
+		range = 'I';
+		maxNumStates = iu - il + 1;
+		break;
+	default:
+		TBTKExit(
+			"Solver::Diagonalizer::solve()",
+			"Unknown spectrum range.",
+			"This should never happen, contact the developer."
 		);
 	}
-/*	else{
-		int kd;
-		if(size_z != 1)
-			kd = orbitals*size_x*size_y*size_z;
-		else if(size_y != 1)
-			kd = orbitals*size_x*size_y;
-		else
-			kd = orbitals*size_x;
-		//Setup zhbev to calculate...
-		char jobz = 'V';			//...eigenvalues and eigenvectors...
-		char uplo = 'U';			//...for and upper triangluar...
-		int n = orbitals*size_x*size_y*size_z;	//...nxn-matrix.
-		int ldab = kd + 1;
-		//Initialize workspaces
-		complex<double> *work = new complex<double>[n];
-		double *rwork = new double[3*n-2];
-		int info;
-		//Solve brop
-		zhbev_(&jobz, &uplo, &n, &kd, hamiltonian, &ldab, eigenValues, eigenVectors, &n, work, rwork, &info);
+	CArray<double> w(n);
+
+	//The eigenvectors from a previous self-consistency step are reused as
+	//output array if they have the right size. Otherwise they are released
+	//before the output array and the full matrix are allocated.
+	CArray<complex<double>> z;
+	if(calculateEigenVectors){
+		if(eigenVectors.getSize() == (unsigned int)(n*maxNumStates)){
+			z = std::move(eigenVectors);
+		}
+		else{
+			eigenVectors = CArray<complex<double>>();
+			z = CArray<complex<double>>(n*maxNumStates);
+		}
+	}
+	CArray<complex<double>> matrix(n*n);
+	expandHamiltonian(matrix.getData());
 
-		//delete workspaces
-		delete [] work;
-		delete [] rwork;
-	}*/
+	int m = callZheevr(
+		calculateEigenVectors,
+		range,
+		n,
+		matrix.getData(),
+		vl,
+		vu,
+		il,
+		iu,
+		w.getData(),
+		z.getData(),
+		maxNumStates
+	);
 
-	transformToOriginalBasis();
+	//Store the m calculated eigenvalues and eigenvectors.
+	eigenValues = CArray<double>(m);
+	for(int state = 0; state < m; state++)
+		eigenValues[state] = w[state];
+	if(!calculateEigenVectors){
+		eigenVectors = CArray<complex<double>>();
+	}
+	else if(m == maxNumStates){
+		eigenVectors = std::move(z);
+	}
+	else{
+		eigenVectors = CArray<complex<double>>(n*m);
+		for(int c = 0; c < n*m; c++)
+			eigenVectors[c] = z[c];
+	}
+}
+
+//Applies the operator that LOBPCG finds the lowest eigenstates of to the
+//columns of x. The operator is H if fold is false and (H - shift)^2
+//otherwise.
+static Matrix<complex<double>> applyLOBPCGOperator(
+	const SparseMatrix<complex<double>> &hamiltonian,
+	const Matrix<complex<double>> &x,
+	bool fold,
+	double shift
+){
+	unsigned int numRows = x.getNumRows();
+	unsigned int numCols = x.getNumCols();
+	Matrix<complex<double>> result(numRows, numCols);
+	if(numCols == 0)
+		return result;
+
+	//SparseMatrix::multiply() stores the vectors of a block row by row.
+	vector<complex<double>> input(numRows*numCols);
+	vector<complex<double>> output(numRows*numCols);
+	for(unsigned int row = 0; row < numRows; row++)
+		for(unsigned int col = 0; col < numCols; col++)
+			input[numCols*row + col] = x.at(row, col);
+
+	hamiltonian.multiply(input.data(), output.data(), numCols);
+	if(fold){
+		for(unsigned int n = 0; n < numRows*numCols; n++)
+			output[n] -= shift*input[n];
+		hamiltonian.multiply(output.data(), input.data(), numCols);
+		for(unsigned int n = 0; n < numRows*numCols; n++)
+			output[n] = input[n] - shift*output[n];
+	}
+
+	for(unsigned int row = 0; row < numRows; row++)
+		for(unsigned int col = 0; col < numCols; col++)
+			result.at(row, col) = output[numCols*row + col];
+
+	return result;
+}
+
+//Orthonormalizes the columns of a matrix using modified Gram-Schmidt with
+//reorthogonalization. The first numOrthonormal columns are assumed to
+//already be orthonormal. Columns that are linearly dependent on the
+//previous columns are dropped.
+static Matrix<complex<double>> orthonormalizeColumns(
+	const Matrix<complex<double>> &matrix,
+	unsigned int numOrthonormal
+){
+	unsigned int numRows = matrix.getNumRows();
+	vector<vector<complex<double>>> columns;
+	for(unsigned int col = 0; col < matrix.getNumCols(); col++){
+		vector<complex<double>> column(numRows);
+		for(unsigned int row = 0; row < numRows; row++)
+			column[row] = matrix.at(row, col);
+
+		if(col < numOrthonormal){
+			columns.push_back(column);
+			continue;
+		}
+
+		double originalNorm = 0;
+		for(unsigned int row = 0; row < numRows; row++)
+			originalNorm += norm(column[row]);
+		originalNorm = sqrt(originalNorm);
+		if(originalNorm == 0)
+			continue;
+
+		for(unsigned int pass = 0; pass < 2; pass++){
+			for(unsigned int c = 0; c < columns.size(); c++){
+				complex<double> projection = 0;
+				for(unsigned int row = 0; row < numRows; row++){
+					projection
+						+= conj(columns[c][row])
+							*column[row];
+				}
+				for(unsigned int row = 0; row < numRows; row++)
+					column[row] -= projection*columns[c][row];
+			}
+		}
+
+		double columnNorm = 0;
+		for(unsigned int row = 0; row < numRows; row++)
+			columnNorm += norm(column[row]);
+		columnNorm = sqrt(columnNorm);
+		if(columnNorm < 1e-10*originalNorm)
+			continue;
+
+		for(unsigned int row = 0; row < numRows; row++)
+			column[row] /= columnNorm;
+		columns.push_back(column);
+	}
+
+	Matrix<complex<double>> result(numRows, columns.size());
+	for(unsigned int col = 0; col < columns.size(); col++)
+		for(unsigned int row = 0; row < numRows; row++)
+			result.at(row, col) = columns[col][row];
+
+	return result;
+}
+
+//Returns the block of a matrix that starts at (firstRow, firstCol).
+static Matrix<complex<double>> getMatrixBlock(
+	const Matrix<complex<double>> &matrix,
+	unsigned int firstRow,
+	unsigned int numRows,
+	unsigned int firstCol,
+	unsigned int numCols
+){
+	Matrix<complex<double>> block(numRows, numCols);
+	for(unsigned int row = 0; row < numRows; row++){
+		for(unsigned int col = 0; col < numCols; col++){
+			block.at(row, col)
+				= matrix.at(firstRow + row, firstCol + col);
+		}
+	}
+
+	return block;
+}
+
+//Creates numStates starting vectors for LOBPCG. The columns of the previous
+//subspace are used first and the remaining columns are filled with
+//pseudo random vectors.
+static Matrix<complex<double>> createLOBPCGStartingSubspace(
+	const Matrix<complex<double>> &previousSubspace,
+	unsigned int basisSize,
+	unsigned int numStates
+){
+	Matrix<complex<double>> subspace(basisSize, numStates);
+	unsigned int numPrevious = 0;
+	if(previousSubspace.getNumRows() == basisSize)
+		numPrevious = min(previousSubspace.getNumCols(), numStates);
+
+	for(unsigned int col = 0; col < numPrevious; col++)
+		for(unsigned int row = 0; row < basisSize; row++)
+			subspace.at(row, col) = previousSubspace.at(row, col);
+
+	uniform_real_distribution<double> distribution(-1, 1);
+	for(unsigned int col = numPrevious; col < numStates; col++){
+		mt19937_64 generator(col);
+		for(unsigned int row = 0; row < basisSize; row++){
+			subspace.at(row, col) = complex<double>(
+				distribution(generator),
+				distribution(generator)
+			);
+		}
+	}
+
+	return subspace;
+}
+
+//Runs LOBPCG for the lowest eigenstates of the operator defined by
+//applyLOBPCGOperator(). On input, the columns of x are the starting
+//vectors. On output, they are the Ritz vectors, ordered in accending order
+//of the Ritz values that are written to ritzValues. Returns true if the
+//residuals of all states are smaller than the tolerance.
+static bool iterateLOBPCG(
+	const SparseMatrix<complex<double>> &hamiltonian,
+	Matrix<complex<double>> &x,
+	vector<double> &ritzValues,
+	bool fold,
+	double shift,
+	double tolerance,
+	int maxIterations
+){
+	unsigned int basisSize = x.getNumRows();
+	unsigned int numStates = x.getNumCols();
+
+	x = orthonormalizeColumns(x, 0);
+	TBTKAssert(
+		x.getNumCols() == numStates,
+		"Solver::Diagonalizer::solve()",
+		"The starting vectors for LOBPCG are linearly dependent.",
+		"This should never happen, contact the developer."
+	);
+
+	//Rayleigh-Ritz in the space spanned by the starting vectors.
+	Matrix<complex<double>> ax = applyLOBPCGOperator(
+		hamiltonian,
+		x,
+		fold,
+		shift
+	);
+	Matrix<complex<double>> projected;
+	Matrix<complex<double>> coefficients;
+	projected.adjointMultiply(x, ax);
+	projected.diagonalizeHermitian(ritzValues, coefficients);
+	x = x*coefficients;
+	ax = ax*coefficients;
+
+	Matrix<complex<double>> p;
+	for(int iteration = 0; ; iteration++){
+		//Calculate the residuals R = AX - X\Lambda.
+		Matrix<complex<double>> r(basisSize, numStates);
+		bool converged = true;
+		for(unsigned int col = 0; col < numStates; col++){
+			double residualNorm = 0;
+			for(unsigned int row = 0; row < basisSize; row++){
+				r.at(row, col) = ax.at(row, col)
+					- ritzValues[col]*x.at(row, col);
+				residualNorm += norm(r.at(row, col));
+			}
+			if(sqrt(residualNorm) > tolerance)
+				converged = false;
+		}
+		if(converged)
+			return true;
+		if(iteration == maxIterations)
+			return false;
+
+		//Rayleigh-Ritz in the space spanned by [X, R, P].
+		unsigned int numP = p.getNumCols();
+		Matrix<complex<double>> s(basisSize, 2*numStates + numP);
+		for(unsigned int row = 0; row < basisSize; row++){
+			for(unsigned int col = 0; col < numStates; col++){
+				s.at(row, col) = x.at(row, col);
+				s.at(row, numStates + col) = r.at(row, col);
+			}
+			for(unsigned int col = 0; col < numP; col++)
+				s.at(row, 2*numStates + col) = p.at(row, col);
+		}
+		s = orthonormalizeColumns(s, numStates);
+		Matrix<complex<double>> as = applyLOBPCGOperator(
+			hamiltonian,
+			s,
+			fold,
+			shift
+		);
+		vector<double> values;
+		projected.adjointMultiply(s, as);
+		projected.diagonalizeHermitian(values, coefficients);
+
+		unsigned int subspaceSize = s.getNumCols();
+		Matrix<complex<double>> lowestCoefficients = getMatrixBlock(
+			coefficients,
+			0,
+			subspaceSize,
+			0,
+			numStates
+		);
+		x = s*lowestCoefficients;
+		ax = as*lowestCoefficients;
+		for(unsigned int n = 0; n < numStates; n++)
+			ritzValues[n] = values[n];
+
+		//The new search direction is the part of the update that lies
+		//outside of the previous X.
+		if(subspaceSize > numStates){
+			p = getMatrixBlock(
+				s,
+				0,
+				basisSize,
+				numStates,
+				subspaceSize - numStates
+			)*getMatrixBlock(
+				coefficients,
+				numStates,
+				subspaceSize - numStates,
+				0,
+				numStates
+			);
+		}
+		else{
+			p = Matrix<complex<double>>();
+		}
+	}
+}
+
+void Diagonalizer::solveLOBPCG(bool calculateEigenVectors){
+	int basisSize = getModel().getBasisSize();
+	const SparseMatrix<complex<double>> &sparseHamiltonian
+		= getModel().getHoppingAmplitudeSet().getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+
+	Matrix<complex<double>> x;
+	vector<double> values;
+	bool converged;
+	int firstState;
+	int numStates;
+	switch(spectrumRange){
+	case SpectrumRange::EigenStateIndexRange:
+	{
+		TBTKAssert(
+			lastEigenStateIndex < basisSize,
+			"Solver::Diagonalizer::solve()",
+			"The eigenstate index range [" << firstEigenStateIndex
+			<< ", " << lastEigenStateIndex << "] is out of bounds"
+			<< " for the basis size '" << basisSize << "'.",
+			""
+		);
+
+		//Iterate all states up to the last state in the range.
+		x = createLOBPCGStartingSubspace(
+			lobpcgSubspace,
+			basisSize,
+			lastEigenStateIndex + 1
+		);
+		converged = iterateLOBPCG(
+			sparseHamiltonian,
+			x,
+			values,
+			false,
+			0,
+			lobpcgTolerance,
+			lobpcgMaxIterations
+		);
+		firstState = firstEigenStateIndex;
+		numStates = lastEigenStateIndex - firstEigenStateIndex + 1;
+
+		break;
+	}
+	case SpectrumRange::EigenValueWindow:
+	{
+		//Iterate the states closest to the center of the window. The
+		//number of states is doubled until at least one of them lies
+		//outside of the window, which guarantees that all states in
+		//the window have been found.
+		double center = (eigenValueWindowLowerBound
+			+ eigenValueWindowUpperBound)/2;
+		int numIteratedStates = min(basisSize, 16);
+		if(lobpcgSubspace.getNumRows() == (unsigned int)basisSize)
+			numIteratedStates = lobpcgSubspace.getNumCols();
+		while(true){
+			x = createLOBPCGStartingSubspace(
+				lobpcgSubspace,
+				basisSize,
+				numIteratedStates
+			);
+			converged = iterateLOBPCG(
+				sparseHamiltonian,
+				x,
+				values,
+				true,
+				center,
+				lobpcgTolerance,
+				lobpcgMaxIterations
+			);
+
+			//Rayleigh-Ritz with the Hamiltonian to separate the
+			//states with the same distance to the center.
+			Matrix<complex<double>> hx = applyLOBPCGOperator(
+				sparseHamiltonian,
+				x,
+				false,
+				0
+			);
+			Matrix<complex<double>> projected;
+			Matrix<complex<double>> coefficients;
+			projected.adjointMultiply(x, hx);
+			projected.diagonalizeHermitian(values, coefficients);
+			x = x*coefficients;
+			lobpcgSubspace = x;
+
+			firstState = 0;
+			while(
+				firstState < numIteratedStates
+				&& values[firstState]
+					<= eigenValueWindowLowerBound
+			){
+				firstState++;
+			}
+			numStates = 0;
+			while(
+				firstState + numStates < numIteratedStates
+				&& values[firstState + numStates]
+					<= eigenValueWindowUpperBound
+			){
+				numStates++;
+			}
+
+			if(
+				numStates < numIteratedStates
+				|| numIteratedStates == basisSize
+			){
+				break;
+			}
+			numIteratedStates = min(basisSize, 2*numIteratedStates);
+		}
+
+		break;
+	}
+	default:
+		TBTKExit(
+			"Solver::Diagonalizer::solve()",
+			"Algorithm::LOBPCG requires an eigenstate index range or"
+			<< " an eigenvalue window.",
+			"This should never happen, contact the developer."
+		);
+	}
+	lobpcgSubspace = x;
+
+	if(!converged){
+		Streams::log << "Warning in Solver::Diagonalizer::solve():"
+			<< " LOBPCG did not converge within '"
+			<< lobpcgMaxIterations << "' iterations.\n";
+	}
+
+	eigenValues = CArray<double>(numStates);
+	for(int state = 0; state < numStates; state++)
+		eigenValues[state] = values[firstState + state];
+
+	if(calculateEigenVectors){
+		eigenVectors = CArray<complex<double>>(basisSize*numStates);
+		for(int state = 0; state < numStates; state++){
+			for(int row = 0; row < basisSize; row++){
+				eigenVectors[row + basisSize*state]
+					= x.at(row, firstState + state);
+			}
+		}
+	}
+	else{
+		eigenVectors = CArray<complex<double>>();
+	}
+}
+
+void Diagonalizer::solveEigenVectorWindow(){
+	//Reduce the Hamiltonian to real symmetric tridiagonal form
+	//T = Q^{\dagger}HQ. The Householder reflectors that define Q
+	//overwrite the packed Hamiltonian.
+	int n = getModel().getBasisSize();
+	CArray<double> diagonal(n);
+	CArray<double> offDiagonal(n);
+	CArray<complex<double>> tau(max(1, n-1));
+	HermitianTridiagonalizer::tridiagonalize(
+		n,
+		hamiltonian.getData(),
+		diagonal.getData(),
+		offDiagonal.getData(),
+		tau.getData()
+	);
+
+	//Calculate all eigenvalues.
+	if(eigenValues.getSize() != (unsigned int)n)
+		eigenValues = CArray<double>(n);
+	HermitianTridiagonalizer::calculateEigenValues(
+		n,
+		diagonal.getData(),
+		offDiagonal.getData(),
+		eigenValues.getData()
+	);
+
+	//Find the states inside the window.
+	int first = 0;
+	while(
+		first < n
+		&& eigenValues[first] <= eigenVectorWindowLowerBound
+	){
+		first++;
+	}
+	int last = first;
+	while(
+		last < n
+		&& eigenValues[last] <= eigenVectorWindowUpperBound
+	){
+		last++;
+	}
+
+	firstEigenVectorState = first;
+	numEigenVectors = last - first;
+	if(numEigenVectors == 0){
+		eigenVectors = CArray<complex<double>>();
+
+		return;
+	}
+
+	//Calculate the eigenvectors of T and transform them back to the
+	//original basis.
+	eigenVectors = CArray<complex<double>>(n*numEigenVectors);
+	HermitianTridiagonalizer::calculateEigenVectors(
+		n,
+		diagonal.getData(),
+		offDiagonal.getData(),
+		first,
+		last - 1,
+		eigenVectors.getData()
+	);
+	HermitianTridiagonalizer::transformEigenVectors(
+		n,
+		numEigenVectors,
+		hamiltonian.getData(),
+		tau.getData(),
+		eigenVectors.getData()
+	);
+}
+
+void Diagonalizer::expandHamiltonian(complex<double> *matrix) const{
+	int basisSize = getModel().getBasisSize();
+	for(int col = 0; col < basisSize; col++){
+		for(int row = 0; row <= col; row++){
+			matrix[row + basisSize*col]
+				= hamiltonian[row + (col*(col+1))/2];
+		}
+		for(int row = col+1; row < basisSize; row++)
+			matrix[row + basisSize*col] = 0;
+	}
 }
 
 };	//End of namespace Solver
@@ -38,7 +38,10 @@ DynamicTypeInformation HartreeFock::dynamicTypeInformation(
 	{&Solver::dynamicTypeInformation}
 );
 
-HartreeFock::HartreeFock() : selfConsistencyCallback(*this){
+HartreeFock::HartreeFock() :
+	mixer(Mixer::Method::Linear, 1),
+	selfConsistencyCallback(*this)
+{
 	occupationNumber = 0;
 	totalEnergy = 0;
 }
@@ -72,6 +75,7 @@ void HartreeFock::run(){
 		basisStates.size(),
 		basisStates.size()
 	);
+	mixer.reset();
 
 	setSelfConsistencyCallback(selfConsistencyCallback);
 
@@ -272,28 +276,44 @@ bool HartreeFock::SelfConsistencyCallback::selfConsistencyCallback(
 			{IDX_ALL}
 		);
 
-	solver.densityMatrix = Matrix<complex<double>>(
-		basisIndices.size(),
+	//Calculate the density matrix D = W^{*}W^{T}, where the columns of W
+	//are the occupied wave functions. W^{T} is stored to allow for D to be
+	//calculated as a single matrix product.
+	Matrix<complex<double>> occupiedWaveFunctions(
+		solver.occupationNumber,
 		basisIndices.size()
 	);
-	for(unsigned int m = 0; m < basisIndices.size(); m++){
+	for(unsigned int c = 0; c < solver.occupationNumber; c++){
 		for(unsigned int n = 0; n < basisIndices.size(); n++){
-			solver.densityMatrix.at(m, n) = 0;
-			for(
-				unsigned int c = 0;
-				c < solver.occupationNumber;
-				c++
-			){
-				solver.densityMatrix.at(m, n) += conj(
-					waveFunctions(
-						basisIndices[m],
-						c
-					)
-				)*waveFunctions(
-					basisIndices[n],
-					c
-				);
-			}
+			occupiedWaveFunctions.at(c, n)
+				= waveFunctions(basisIndices[n], c);
+		}
+	}
+	Matrix<complex<double>> outputDensityMatrix;
+	outputDensityMatrix.adjointMultiply(
+		occupiedWaveFunctions,
+		occupiedWaveFunctions
+	);
+
+	//Mix the density matrix used in this iteration with the newly
+	//calculated one.
+	unsigned int numRows = solver.densityMatrix.getNumRows();
+	unsigned int numCols = solver.densityMatrix.getNumCols();
+	vector<complex<double>> input(numRows*numCols);
+	vector<complex<double>> output(numRows*numCols);
+	for(unsigned int row = 0; row < numRows; row++){
+		for(unsigned int col = 0; col < numCols; col++){
+			input[row + numRows*col]
+				= solver.densityMatrix.at(row, col);
+			output[row + numRows*col]
+				= outputDensityMatrix.at(row, col);
+		}
+	}
+	solver.mixer.update(input, output);
+	for(unsigned int row = 0; row < numRows; row++){
+		for(unsigned int col = 0; col < numCols; col++){
+			solver.densityMatrix.at(row, col)
+				= input[row + numRows*col];
 		}
 	}
 
@@ -0,0 +1,295 @@
+/* Copyright 2016 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file HermitianTridiagonalizer.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/CArray.h"
+#include "TBTK/Solver/HermitianTridiagonalizer.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+//Lapack function for reducing a packed Hermitian matrix to real symmetric
+//tridiagonal form.
+extern "C" void zhptrd_(
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *ap,	//Input matrix, overwritten by the Householder reflectors
+	double *d,		//Diagonal elements of the tridiagonal matrix, dimension = n
+	double *e,		//Off-diagonal elements of the tridiagonal matrix, dimension = n-1
+	complex<double> *tau,	//Scalar factors of the Householder reflectors, dimension = n-1
+	int *info);		//0 = successful, <0 = -info value was illegal.
+
+//Lapack function for calculating all eigenvalues of a real symmetric
+//tridiagonal matrix.
+extern "C" void dsterf_(
+	int *n,			//n*n = Matrix size
+	double *d,		//Diagonal elements, overwritten by the eigenvalues in accending order
+	double *e,		//Off-diagonal elements, destroyed on exit
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = failed to converge.
+
+//Lapack function for calculating selected eigenvalues of a real symmetric
+//tridiagonal matrix using bisection.
+extern "C" void dstebz_(
+	char *range,		//'A' = All, 'V' = Eigenvalues in (vl, vu], 'I' = Eigenvalues il to iu.
+	char *order,		//'B' = Grouped by split-off block, 'E' = Ordered across the whole matrix.
+	int *n,			//n*n = Matrix size
+	double *vl,		//Lower bound of the eigenvalue window
+	double *vu,		//Upper bound of the eigenvalue window
+	int *il,		//Index of the first eigenvalue (1-based)
+	int *iu,		//Index of the last eigenvalue (1-based)
+	double *abstol,		//Absolute error tolerance, <= 0 = default
+	double *d,		//Diagonal elements
+	double *e,		//Off-diagonal elements, dimension = n-1
+	int *m,			//Number of eigenvalues found
+	int *nsplit,		//Number of diagonal blocks
+	double *w,		//Eigenvalues
+	int *iblock,		//Block number of each eigenvalue
+	int *isplit,		//Splitting points between the blocks
+	double *work,		//Workspace, dimension = 4*n
+	int *iwork,		//Workspace, dimension = 3*n
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = failed to converge.
+
+//Lapack function for calculating the eigenvectors of a real symmetric
+//tridiagonal matrix for given eigenvalues using inverse iteration.
+extern "C" void zstein_(
+	int *n,			//n*n = Matrix size
+	double *d,		//Diagonal elements
+	double *e,		//Off-diagonal elements, dimension = n-1
+	int *m,			//Number of eigenvectors to calculate
+	double *w,		//Eigenvalues as returned by dstebz with order = 'B'
+	int *iblock,		//Block number of each eigenvalue as returned by dstebz
+	int *isplit,		//Splitting points as returned by dstebz
+	complex<double> *z,	//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	double *work,		//Workspace, dimension = 5*n
+	int *iwork,		//Workspace, dimension = n
+	int *ifail,		//Indices of eigenvectors that failed to converge
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of eigenvectors failed to converge.
+
+//Lapack function for multiplying a matrix by the unitary matrix defined by
+//the Householder reflectors returned by zhptrd.
+extern "C" void zupmtr_(
+	char *side,		//'L' = Q*C, 'R' = C*Q
+	char *uplo,		//Must be the same as in the call to zhptrd
+	char *trans,		//'N' = Q, 'C' = Q^H
+	int *m,			//Number of rows of c
+	int *n,			//Number of columns of c
+	complex<double> *ap,	//Householder reflectors returned by zhptrd
+	complex<double> *tau,	//Scalar factors returned by zhptrd
+	complex<double> *c,	//Input matrix, overwritten by the product
+	int *ldc,		//Leading dimension of c
+	complex<double> *work,	//Workspace, dimension = n if side = 'L'
+	int *info);		//0 = successful, <0 = -info value was illegal.
+
+namespace TBTK{
+namespace Solver{
+
+void HermitianTridiagonalizer::tridiagonalize(
+	int n,
+	complex<double> *matrix,
+	double *diagonal,
+	double *offDiagonal,
+	complex<double> *tau
+){
+	char uplo = 'U';
+	int info;
+	zhptrd_(
+		&uplo,
+		&n,
+		matrix,
+		diagonal,
+		offDiagonal,
+		tau,
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"HermitianTridiagonalizer::tridiagonalize()",
+		"Tridiagonalization routine zhptrd exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zhptrd for further information."
+	);
+}
+
+void HermitianTridiagonalizer::calculateEigenValues(
+	int n,
+	const double *diagonal,
+	const double *offDiagonal,
+	double *eigenValues
+){
+	//dsterf destroys its input, so the tridiagonal matrix is copied.
+	CArray<double> e(n);
+	for(int c = 0; c < n; c++){
+		eigenValues[c] = diagonal[c];
+		e[c] = offDiagonal[c];
+	}
+	int info;
+	dsterf_(&n, eigenValues, e.getData(), &info);
+	TBTKAssert(
+		info == 0,
+		"HermitianTridiagonalizer::calculateEigenValues()",
+		"Diagonalization routine dsterf exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for dsterf for further information."
+	);
+}
+
+void HermitianTridiagonalizer::calculateEigenVectors(
+	int n,
+	double *diagonal,
+	double *offDiagonal,
+	int first,
+	int last,
+	complex<double> *eigenVectors
+){
+	int il = first + 1;
+	int iu = last + 1;
+	char range = 'I';
+	char order = 'B';
+	double vl = 0;
+	double vu = 0;
+	double abstol = 0;
+	int m;
+	int nsplit;
+	CArray<double> w(n);
+	CArray<int> iblock(n);
+	CArray<int> isplit(n);
+	CArray<double> work(5*n);
+	CArray<int> iwork(3*n);
+	int info;
+	dstebz_(
+		&range,
+		&order,
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		diagonal,
+		offDiagonal,
+		&m,
+		&nsplit,
+		w.getData(),
+		iblock.getData(),
+		isplit.getData(),
+		work.getData(),
+		iwork.getData(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"HermitianTridiagonalizer::calculateEigenVectors()",
+		"Diagonalization routine dstebz exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for dstebz for further information."
+	);
+	TBTKAssert(
+		m == iu - il + 1,
+		"HermitianTridiagonalizer::calculateEigenVectors()",
+		"Expected '" << iu - il + 1 << "' eigenvalues, but '" << m
+		<< "' were calculated.",
+		"This should never happen, contact the developer."
+	);
+
+	CArray<int> ifail(m);
+	zstein_(
+		&n,
+		diagonal,
+		offDiagonal,
+		&m,
+		w.getData(),
+		iblock.getData(),
+		isplit.getData(),
+		eigenVectors,
+		&n,
+		work.getData(),
+		iwork.getData(),
+		ifail.getData(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"HermitianTridiagonalizer::calculateEigenVectors()",
+		"Inverse iteration routine zstein exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zstein for further information."
+	);
+
+	//The eigenvalues returned by dstebz are grouped by split-off block.
+	//Sort the eigenvectors by their eigenvalues.
+	vector<int> permutation(m);
+	for(int c = 0; c < m; c++)
+		permutation[c] = c;
+	stable_sort(
+		permutation.begin(),
+		permutation.end(),
+		[&w](int a, int b){
+			return w[a] < w[b];
+		}
+	);
+	bool isSorted = true;
+	for(int c = 0; c < m; c++)
+		if(permutation[c] != c)
+			isSorted = false;
+	if(isSorted)
+		return;
+
+	CArray<complex<double>> unsorted(n*m);
+	for(int c = 0; c < n*m; c++)
+		unsorted[c] = eigenVectors[c];
+	for(int col = 0; col < m; col++)
+		for(int row = 0; row < n; row++)
+			eigenVectors[row + n*col] = unsorted[row + n*permutation[col]];
+}
+
+void HermitianTridiagonalizer::transformEigenVectors(
+	int n,
+	int numEigenVectors,
+	complex<double> *matrix,
+	complex<double> *tau,
+	complex<double> *eigenVectors
+){
+	char side = 'L';
+	char uplo = 'U';
+	char trans = 'N';
+	CArray<complex<double>> work(numEigenVectors);
+	int info;
+	zupmtr_(
+		&side,
+		&uplo,
+		&trans,
+		&n,
+		&numEigenVectors,
+		matrix,
+		tau,
+		eigenVectors,
+		&n,
+		work.getData(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"HermitianTridiagonalizer::transformEigenVectors()",
+		"Transformation routine zupmtr exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zupmtr for further information."
+	);
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
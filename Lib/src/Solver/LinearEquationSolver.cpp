@@ -45,7 +45,11 @@ void LinearEquationSolver::run(){
 		= model.getSourceAmplitudeSet();
 
 	LUSolver luSolver;
-	luSolver.setMatrix(hoppingAmplitudeSet.getSparseMatrix());
+	luSolver.setMatrix(
+		hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSC
+		)
+	);
 
 	source = Matrix<complex<double>>(model.getBasisSize(), 1);
 	for(int n = 0; n < model.getBasisSize(); n++)
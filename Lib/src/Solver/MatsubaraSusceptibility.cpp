@@ -167,6 +167,21 @@ vector<complex<double>> MatsubaraSusceptibility::calculateSusceptibility(
 			numMeshPoints
 		);
 
+		//The compound Indices only depend on the mesh point and are
+		//therefore constructed once outside of the energy loops.
+		Index greensFunction0Index(
+			{
+				Index(qIndex, intraBlockIndices[3]),
+				Index(qIndex, intraBlockIndices[0])
+			}
+		);
+		Index greensFunction1Index(
+			{
+				Index(kPlusQIndex, intraBlockIndices[1]),
+				Index(kPlusQIndex, intraBlockIndices[2])
+			}
+		);
+
 		for(
 			int susceptibilityEnergyIndex = 0;
 			susceptibilityEnergyIndex
@@ -205,28 +220,10 @@ vector<complex<double>> MatsubaraSusceptibility::calculateSusceptibility(
 
 				susceptibility[susceptibilityEnergyIndex]
 					-= greensFunction(
-						{
-							Index(
-								qIndex,
-								intraBlockIndices[3]
-							),
-							Index(
-								qIndex,
-								intraBlockIndices[0]
-							)
-						},
+						greensFunction0Index,
 						firstEnergyIndex
 					)*greensFunction(
-						{
-							Index(
-								kPlusQIndex,
-								intraBlockIndices[1]
-							),
-							Index(
-								kPlusQIndex,
-								intraBlockIndices[2]
-							)
-						},
+						greensFunction1Index,
 						secondEnergyIndex
 					);
 			}
@@ -331,6 +328,21 @@ Property::Susceptibility MatsubaraSusceptibility::calculateSusceptibilityAllBloc
 			numMeshPoints
 		);
 
+		//The compound Indices only depend on the mesh point and are
+		//therefore constructed once outside of the energy loop.
+		Index greensFunction0Index(
+			{
+				Index(qIndex, intraBlockIndices[3]),
+				Index(qIndex, intraBlockIndices[0])
+			}
+		);
+		Index greensFunction1Index(
+			{
+				Index(qIndex, intraBlockIndices[1]),
+				Index(qIndex, intraBlockIndices[2])
+			}
+		);
+
 		for(
 			unsigned int n = 0;
 			n < numMatsubaraEnergiesGreensFunction;
@@ -340,24 +352,12 @@ Property::Susceptibility MatsubaraSusceptibility::calculateSusceptibilityAllBloc
 				(unsigned int)qIndex[0],
 				(unsigned int)qIndex[1],
 				n
-			}] = conj(greensFunction(
-				{
-					Index(qIndex, intraBlockIndices[3]),
-					Index(qIndex, intraBlockIndices[0])
-				},
-				n
-			));
+			}] = conj(greensFunction(greensFunction0Index, n));
 			greensFunction1In[{
 				(unsigned int)qIndex[0],
 				(unsigned int)qIndex[1],
 				n
-			}] = greensFunction(
-				{
-					Index(qIndex, intraBlockIndices[1]),
-					Index(qIndex, intraBlockIndices[2])
-				},
-				n
-			);
+			}] = greensFunction(greensFunction1Index, n);
 		}
 	}
 
@@ -400,6 +400,15 @@ Property::Susceptibility MatsubaraSusceptibility::calculateSusceptibilityAllBloc
 	#pragma omp parallel for
 	for(unsigned int kx = 0; kx < numMeshPoints[0]; kx++){
 		for(unsigned int ky = 0; ky < numMeshPoints[1]; ky++){
+			Index susceptibilityIndex(
+				{
+					{kx, ky},
+					intraBlockIndices[0],
+					intraBlockIndices[1],
+					intraBlockIndices[2],
+					intraBlockIndices[3]
+				}
+			);
 			for(
 				unsigned int n = 0;
 				n < numMatsubaraEnergiesSusceptibility;
@@ -414,31 +423,13 @@ Property::Susceptibility MatsubaraSusceptibility::calculateSusceptibilityAllBloc
 					|| energyIndex
 						> (int)numMatsubaraEnergiesGreensFunction
 				){
-					susceptibility(
-						{
-							{kx, ky},
-							intraBlockIndices[0],
-							intraBlockIndices[1],
-							intraBlockIndices[2],
-							intraBlockIndices[3]
-						},
-						n
-					) = 0;
+					susceptibility(susceptibilityIndex, n) = 0;
 				}
 				else{
 					if(energyIndex < 0)
 						energyIndex += 2*(int)numMatsubaraEnergiesGreensFunction;
 
-					susceptibility(
-						{
-							{kx, ky},
-							intraBlockIndices[0],
-							intraBlockIndices[1],
-							intraBlockIndices[2],
-							intraBlockIndices[3]
-						},
-						n
-					) = -susceptibilityOut[
+					susceptibility(susceptibilityIndex, n) = -susceptibilityOut[
 						2*numMatsubaraEnergiesGreensFunction*(
 							numMeshPoints[1]*kx + ky
 						) + energyIndex
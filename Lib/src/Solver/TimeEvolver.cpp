@@ -23,8 +23,9 @@
 #include "TBTK/TBTKMacros.h"
 #include "TBTK/Solver/TimeEvolver.h"
 
-#include <complex>
+#include <algorithm>
 #include <cmath>
+#include <complex>
 
 using namespace std;
 
@@ -38,8 +39,189 @@ DynamicTypeInformation TimeEvolver::dynamicTypeInformation(
 
 const complex<double> i(0, 1);
 
+namespace{
+	//Relative margin added to the Gershgorin bounds of the spectrum when
+	//the Hamiltonian is mapped to [-1, 1] for the Chebyshev propagator.
+	const double SPECTRAL_BOUNDS_MARGIN = 0.01;
+
+	//Magnitude below which the Chebyshev propagator coefficients are
+	//truncated.
+	const double PROPAGATOR_TOLERANCE = 1e-17;
+
+	//Number of states that are propagated simultaneously by the
+	//Chebyshev propagator.
+	const unsigned int PROPAGATOR_BLOCK_SIZE = 8;
+
+	//Calculates bounds for the spectrum of a Hamiltonian on CSR format
+	//using the Gershgorin circle theorem. Rows that are not present in
+	//the matrix correspond to zero eigenvalues.
+	void getGershgorinBounds(
+		const SparseMatrix<complex<double>> &hamiltonian,
+		unsigned int basisSize,
+		double &lowerBound,
+		double &upperBound
+	){
+		const unsigned int *rowPointers
+			= hamiltonian.getCSRRowPointers();
+		const unsigned int *columns = hamiltonian.getCSRColumns();
+		const complex<double> *values = hamiltonian.getCSRValues();
+		unsigned int numRows = hamiltonian.getNumRows();
+
+		lowerBound = numRows < basisSize ? 0 : INFINITY;
+		upperBound = numRows < basisSize ? 0 : -INFINITY;
+		for(unsigned int r = 0; r < numRows; r++){
+			double diagonal = 0;
+			double radius = 0;
+			for(
+				unsigned int n = rowPointers[r];
+				n < rowPointers[r+1];
+				n++
+			){
+				if(columns[n] == r)
+					diagonal += real(values[n]);
+				else
+					radius += abs(values[n]);
+			}
+			lowerBound = min(lowerBound, diagonal - radius);
+			upperBound = max(upperBound, diagonal + radius);
+		}
+	}
+
+	//Calculates the Bessel functions J_k(x) for k = 0, ..., maxOrder
+	//using Miller's backward recurrence normalized by
+	//J_0(x) + 2 sum_k J_{2k}(x) = 1.
+	vector<double> calculateBesselFunctions(double x, unsigned int maxOrder){
+		vector<double> besselFunctions(maxOrder + 1, 0);
+		if(x == 0){
+			besselFunctions[0] = 1;
+			return besselFunctions;
+		}
+
+		//J_k(-x) = (-1)^k J_k(x).
+		double sign = 1;
+		if(x < 0){
+			x = -x;
+			sign = -1;
+		}
+
+		unsigned int largestOrder = max(maxOrder, (unsigned int)x);
+		unsigned int startOrder
+			= largestOrder + 20 + (unsigned int)sqrt(40.*largestOrder);
+		if(startOrder%2 == 1)
+			startOrder++;
+
+		double jNext = 0;
+		double jCurrent = 1;
+		double normalization = 2*jCurrent;
+		for(unsigned int k = startOrder; k > 0; k--){
+			double jPrevious = 2*k*jCurrent/x - jNext;
+			jNext = jCurrent;
+			jCurrent = jPrevious;
+
+			if(k - 1 <= maxOrder)
+				besselFunctions[k - 1] = jCurrent;
+			if((k - 1)%2 == 0)
+				normalization += (k == 1 ? 1 : 2)*jCurrent;
+
+			//Rescale to avoid overflow.
+			if(abs(jCurrent) > 1e200){
+				jCurrent *= 1e-200;
+				jNext *= 1e-200;
+				normalization *= 1e-200;
+				for(unsigned int m = k - 1; m <= maxOrder; m++)
+					besselFunctions[m] *= 1e-200;
+			}
+		}
+
+		for(unsigned int k = 0; k <= maxOrder; k++){
+			besselFunctions[k] /= normalization;
+			if(sign < 0 && k%2 == 1)
+				besselFunctions[k] *= -1;
+		}
+
+		return besselFunctions;
+	}
+
+	//Calculates the Chebyshev coefficients c_0 = J_0(x),
+	//c_k = 2(-i)^k J_k(x) of exp(-ixH'). The expansion is truncated once
+	//the Bessel functions have decayed below PROPAGATOR_TOLERANCE, which
+	//happens rapidly for k > |x|.
+	vector<complex<double>> calculatePropagatorCoefficients(double x){
+		unsigned int maxOrder = (unsigned int)(1.5*abs(x)) + 50;
+		vector<double> besselFunctions
+			= calculateBesselFunctions(x, maxOrder);
+
+		vector<complex<double>> coefficients;
+		complex<double> minusIToTheK = 1;
+		for(unsigned int k = 0; k <= maxOrder; k++){
+			if(
+				k > abs(x)
+				&& abs(besselFunctions[k]) < PROPAGATOR_TOLERANCE
+			){
+				break;
+			}
+
+			coefficients.push_back(
+				(k == 0 ? 1. : 2.)*minusIToTheK*besselFunctions[k]
+			);
+			minusIToTheK *= -i;
+		}
+
+		return coefficients;
+	}
+
+	//Completes result = alpha*(H' - shift)x + beta*y, given that result
+	//contains alpha*H'x + beta*y for the rows that are present in H'.
+	//y is not accessed if beta is zero.
+	void applyShift(
+		vector<complex<double>> &result,
+		const vector<complex<double>> &x,
+		const vector<complex<double>> &y,
+		double alpha,
+		double beta,
+		double shift,
+		unsigned int numRows,
+		unsigned int blockElements,
+		unsigned int blockSize
+	){
+		for(
+			unsigned int n = numRows*blockSize;
+			n < blockElements;
+			n++
+		){
+			if(beta == 0)
+				result[n] = 0;
+			else
+				result[n] = beta*y[n];
+		}
+
+		if(shift != 0)
+			for(unsigned int n = 0; n < blockElements; n++)
+				result[n] -= alpha*shift*x[n];
+	}
+
+	//Writes a block of propagated states back to the eigenvectors.
+	void storePropagatedStates(
+		complex<double> **eigenVectorsMap,
+		unsigned int basisSize,
+		const vector<complex<double>> &block,
+		const vector<unsigned int> &states,
+		unsigned int blockStart,
+		unsigned int blockSize,
+		complex<double> phase
+	){
+		for(unsigned int r = 0; r < basisSize; r++){
+			for(unsigned int v = 0; v < blockSize; v++){
+				eigenVectorsMap[states[blockStart + v]][r]
+					= phase*block[blockSize*r + v];
+			}
+		}
+	}
+};
+
 vector<TimeEvolver*> TimeEvolver::timeEvolvers;
 vector<Diagonalizer*> TimeEvolver::dSolvers;
+TimeEvolver::SelfConsistencyCallback TimeEvolver::selfConsistencyCallback;
 
 TimeEvolver::TimeEvolver(){
 	eigenValues = NULL;
@@ -55,6 +237,7 @@ TimeEvolver::TimeEvolver(){
 	currentTimeStep = -1;
 	orthogonalityError = 0.;
 	orthogonalityCheckInterval = 0;
+	propagationMethod = PropagationMethod::Euler;
 
 	dSolvers.push_back(&dSolver);
 	timeEvolvers.push_back(this);
@@ -101,68 +284,281 @@ void TimeEvolver::run(){
 	}
 
 	double hbar = UnitHandler::getConstantInBaseUnits("hbar");
-	complex<double> *dPsi = new complex<double>[basisSize*basisSize];
 	for(int t = 0; t < numTimeSteps; t++){
 		currentTimeStep = t;
 		callback(this);
 
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize*basisSize; n++)
-			dPsi[n] = 0.;
+		//The Hamiltonian is requested every time step since the
+		//callback may have changed the HoppingAmplitudes. Only the
+		//callback dependent matrix elements are reevaluated.
+		const SparseMatrix<complex<double>> &hamiltonian
+			= model.getHoppingAmplitudeSet().getSparseMatrix(
+				SparseMatrix<complex<double>>::StorageFormat::CSR
+			);
+		double timeStep = UnitHandler::convertNaturalToBase<
+			Quantity::Time
+		>(dt)/hbar;
 
-		for(
-			HoppingAmplitudeSet::ConstIterator iterator
-				= model.getHoppingAmplitudeSet().cbegin();
-			iterator != model.getHoppingAmplitudeSet().cend();
-			++iterator
-		){
-			int fromIndex = model.getHoppingAmplitudeSet().getBasisIndex((*iterator).getFromIndex());
-			int toIndex = model.getHoppingAmplitudeSet().getBasisIndex((*iterator).getToIndex());
-			complex<double> amplitude = (*iterator).getAmplitude();
-			#pragma omp parallel for
-			for(int n = 0; n < basisSize; n++){
-				dPsi[basisSize*n + toIndex] += amplitude*eigenVectorsMap[n][fromIndex];
-			}
+		switch(propagationMethod){
+		case PropagationMethod::Euler:
+			stepEuler(hamiltonian, timeStep);
+			break;
+		case PropagationMethod::Chebyshev:
+			stepChebyshev(hamiltonian, timeStep);
+			break;
+		default:
+			TBTKExit(
+				"TimeEvolver::run()",
+				"Unknown PropagationMethod.",
+				"This should never happen, contact the"
+				<< " developer."
+			);
 		}
 
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
-			double energy = 0.;
-			for(int c = 0; c < basisSize; c++){
-				energy += real(conj(eigenVectorsMap[n][c])*dPsi[basisSize*n + c]);
-			}
-			eigenValues[n] = energy;
+		sort();
+
+		updateOccupancy();
+
+		if(orthogonalityCheckInterval != 0 && t%orthogonalityCheckInterval == 0)
+			calculateOrthogonalityError();
+	}
+}
+
+void TimeEvolver::stepEuler(
+	const SparseMatrix<complex<double>> &hamiltonian,
+	double timeStep
+){
+	int basisSize = getModel().getBasisSize();
+	unsigned int numRows = hamiltonian.getNumRows();
+	vector<complex<double>> dPsi(basisSize*basisSize);
+
+	#pragma omp parallel for
+	for(int n = 0; n < basisSize; n++){
+		hamiltonian.multiply(
+			eigenVectorsMap[n],
+			&dPsi[basisSize*n]
+		);
+		for(int c = numRows; c < basisSize; c++)
+			dPsi[basisSize*n + c] = 0.;
+	}
+
+	#pragma omp parallel for
+	for(int n = 0; n < basisSize; n++){
+		double energy = 0.;
+		for(int c = 0; c < basisSize; c++){
+			energy += real(conj(eigenVectorsMap[n][c])*dPsi[basisSize*n + c]);
 		}
+		eigenValues[n] = energy;
+	}
 
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
-			for(int c = 0; c < basisSize; c++)
-				eigenVectorsMap[n][c] -= i*dPsi[
-					basisSize*n + c
-				]*UnitHandler::convertNaturalToBase<
-					Quantity::Time
-				>(dt)/hbar;
+	#pragma omp parallel for
+	for(int n = 0; n < basisSize; n++){
+		for(int c = 0; c < basisSize; c++)
+			eigenVectorsMap[n][c] -= i*dPsi[basisSize*n + c]*timeStep;
+	}
+
+	#pragma omp parallel for
+	for(int n = 0; n < basisSize; n++){
+		//No need to use eigenVectorsMap here because
+		//noramlization procedure is independent of ordering.
+		double normalizationFactor = 0.;
+		for(int c = 0; c < basisSize; c++){
+			normalizationFactor += pow(abs(eigenVectors[n*basisSize + c]), 2);
 		}
+		normalizationFactor = sqrt(normalizationFactor);
+		for(int c = 0; c < basisSize; c++)
+			eigenVectors[basisSize*n + c] /= normalizationFactor;
+	}
+}
 
-		sort();
+void TimeEvolver::stepChebyshev(
+	const SparseMatrix<complex<double>> &hamiltonian,
+	double timeStep
+){
+	unsigned int basisSize = getModel().getBasisSize();
+	unsigned int numRows = hamiltonian.getNumRows();
+
+	//Write the Hamiltonian as H = halfWidth*H' + center, where the
+	//spectrum of H' lies in [-1, 1]. Then
+	//exp(-iH*timeStep) = exp(-i*center*timeStep)
+	//	*sum_k c_k T_k(H'),
+	//where c_0 = J_0(halfWidth*timeStep) and
+	//c_k = 2(-i)^k J_k(halfWidth*timeStep).
+	double lowerBound;
+	double upperBound;
+	getGershgorinBounds(hamiltonian, basisSize, lowerBound, upperBound);
+	double center = (upperBound + lowerBound)/2.;
+	double halfWidth
+		= (upperBound - lowerBound)/2.*(1 + SPECTRAL_BOUNDS_MARGIN);
+	if(halfWidth == 0)
+		halfWidth = 1;
+
+	vector<complex<double>> coefficients
+		= calculatePropagatorCoefficients(halfWidth*timeStep);
+	complex<double> phase = exp(-i*center*timeStep);
+	double shift = center/halfWidth;
+
+	//H' is applied by scaling the product with the Hamiltonian through the
+	//alpha argument of SparseMatrix::axpby(), which avoids copying the
+	//Hamiltonian.
+	complex<double> inverseHalfWidth = 1/halfWidth;
+
+	//Unoccupied states only need to be propagated if the occupation can
+	//be transfered to them.
+	vector<unsigned int> states;
+	vector<unsigned int> unpropagatedStates;
+	for(unsigned int n = 0; n < basisSize; n++){
+		if(decayMode != DecayMode::None || occupancy[n] != 0)
+			states.push_back(n);
+		else
+			unpropagatedStates.push_back(n);
+	}
 
-		updateOccupancy();
+	//The energies of the states that are not propagated are the
+	//expectation values of the current Hamiltonian.
+	#pragma omp parallel
+	{
+		vector<complex<double>> hPsi(basisSize);
+		#pragma omp for
+		for(unsigned int n = 0; n < unpropagatedStates.size(); n++){
+			const complex<double> *psi
+				= eigenVectorsMap[unpropagatedStates[n]];
+			hamiltonian.multiply(psi, hPsi.data());
+			double expectationValue = 0;
+			double normSquared = 0;
+			for(unsigned int r = 0; r < numRows; r++)
+				expectationValue += real(conj(psi[r])*hPsi[r]);
+			for(unsigned int r = 0; r < basisSize; r++)
+				normSquared += norm(psi[r]);
+			eigenValues[unpropagatedStates[n]]
+				= expectationValue/normSquared;
+		}
+	}
 
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
-			//No need to use eigenVectorsMap here because
-			//noramlization procedure is independent of ordering.
-			double normalizationFactor = 0.;
-			for(int c = 0; c < basisSize; c++){
-				normalizationFactor += pow(abs(eigenVectors[n*basisSize + c]), 2);
+	//Workspace for blocks of states. Element v of row r is stored at
+	//position r*blockSize + v.
+	unsigned int maxBlockSize = min(
+		(unsigned int)states.size(),
+		PROPAGATOR_BLOCK_SIZE
+	);
+	vector<complex<double>> jIn1(maxBlockSize*basisSize);
+	vector<complex<double>> jIn2(maxBlockSize*basisSize);
+	vector<complex<double>> jResult(maxBlockSize*basisSize);
+	vector<complex<double>> result(maxBlockSize*basisSize);
+	for(
+		unsigned int blockStart = 0;
+		blockStart < states.size();
+		blockStart += PROPAGATOR_BLOCK_SIZE
+	){
+		unsigned int blockSize = min(
+			PROPAGATOR_BLOCK_SIZE,
+			(unsigned int)states.size() - blockStart
+		);
+		unsigned int blockElements = blockSize*basisSize;
+
+		//|j0> = |Psi>
+		for(unsigned int r = 0; r < basisSize; r++){
+			for(unsigned int v = 0; v < blockSize; v++){
+				jIn1[blockSize*r + v]
+					= eigenVectorsMap[states[blockStart + v]][r];
 			}
-			normalizationFactor = sqrt(normalizationFactor);
-			for(int c = 0; c < basisSize; c++)
-				eigenVectors[basisSize*n + c] /= normalizationFactor;
+		}
+		for(unsigned int n = 0; n < blockElements; n++)
+			result[n] = coefficients[0]*jIn1[n];
+
+		if(coefficients.size() == 1){
+			storePropagatedStates(
+				eigenVectorsMap,
+				basisSize,
+				result,
+				states,
+				blockStart,
+				blockSize,
+				phase
+			);
+			continue;
 		}
 
-		if(orthogonalityCheckInterval != 0 && t%orthogonalityCheckInterval == 0)
-			calculateOrthogonalityError();
+		//|j1> = H'|j0>
+		hamiltonian.axpby(
+			inverseHalfWidth,
+			jIn1.data(),
+			0.,
+			jResult.data(),
+			jResult.data(),
+			blockSize
+		);
+		applyShift(
+			jResult,
+			jIn1,
+			jIn2,
+			1,
+			0,
+			shift,
+			numRows,
+			blockElements,
+			blockSize
+		);
+
+		//The energies are the expectation values of H before the time
+		//step.
+		for(unsigned int v = 0; v < blockSize; v++){
+			double expectationValue = 0;
+			double normSquared = 0;
+			for(unsigned int r = 0; r < basisSize; r++){
+				expectationValue += real(
+					conj(jIn1[blockSize*r + v])
+					*jResult[blockSize*r + v]
+				);
+				normSquared += norm(jIn1[blockSize*r + v]);
+			}
+			eigenValues[states[blockStart + v]]
+				= halfWidth*expectationValue/normSquared
+					+ center;
+		}
+
+		for(unsigned int n = 0; n < blockElements; n++)
+			result[n] += coefficients[1]*jResult[n];
+		jIn2.swap(jIn1);
+		jIn1.swap(jResult);
+
+		//|jk> = 2H'|j(k-1)> - |j(k-2)>
+		for(unsigned int k = 2; k < coefficients.size(); k++){
+			hamiltonian.axpby(
+				2.*inverseHalfWidth,
+				jIn1.data(),
+				-1.,
+				jIn2.data(),
+				jResult.data(),
+				blockSize
+			);
+			applyShift(
+				jResult,
+				jIn1,
+				jIn2,
+				2,
+				-1,
+				shift,
+				numRows,
+				blockElements,
+				blockSize
+			);
+
+			for(unsigned int n = 0; n < blockElements; n++)
+				result[n] += coefficients[k]*jResult[n];
+			jIn2.swap(jIn1);
+			jIn1.swap(jResult);
+		}
+
+		storePropagatedStates(
+			eigenVectorsMap,
+			basisSize,
+			result,
+			states,
+			blockStart,
+			blockSize,
+			phase
+		);
 	}
 }
 
@@ -28,6 +28,7 @@ namespace RPA{
 MomentumSpaceContext::MomentumSpaceContext(){
 	brillouinZone = nullptr;
 	numOrbitals = 0;
+	irreducibleBrillouinZone = nullptr;
 	propertyExtractor = nullptr;
 	energies = nullptr;
 	amplitudes = nullptr;
@@ -35,6 +36,8 @@ MomentumSpaceContext::MomentumSpaceContext(){
 }
 
 MomentumSpaceContext::~MomentumSpaceContext(){
+	if(irreducibleBrillouinZone != nullptr)
+		delete irreducibleBrillouinZone;
 	if(propertyExtractor != nullptr)
 		delete propertyExtractor;
 	if(energies != nullptr)
@@ -92,9 +95,23 @@ void MomentumSpaceContext::init(){
 		<< " are set using MomentumSpaceContext::setNumOrbitals()."
 	);
 
+	if(irreducibleBrillouinZone != nullptr){
+		delete irreducibleBrillouinZone;
+		irreducibleBrillouinZone = nullptr;
+	}
+	if(symmetryOperations.size() != 0){
+		irreducibleBrillouinZone = new IrreducibleBrillouinZone(
+			*brillouinZone,
+			numMeshPoints,
+			symmetryOperations
+		);
+	}
+
 	Timer::tick("Diagonalize");
 	solver = Solver::BlockDiagonalizer();
 	solver.setModel(*model);
+	if(irreducibleBrillouinZone != nullptr)
+		solver.setIrreducibleBrillouinZone(*irreducibleBrillouinZone);
 	solver.run();
 	Timer::tock();
 
@@ -0,0 +1,273 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file IrreducibleBrillouinZone.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/IrreducibleBrillouinZone.h"
+#include "TBTK/TBTKMacros.h"
+#include "TBTK/Vector3d.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace TBTK{
+
+//The largest symmetry group that is expected, which is the full point group
+//of a cubic lattice combined with time reversal.
+static const unsigned int MAX_GROUP_SIZE = 96;
+
+//Tolerance used when checking whether a SymmetryOperation maps a mesh point
+//onto another mesh point.
+static const double MESH_TOLERANCE = 1e-6;
+
+IrreducibleBrillouinZone::IrreducibleBrillouinZone(
+	const BrillouinZone &brillouinZone,
+	const vector<unsigned int> &numMeshPoints,
+	const vector<SymmetryOperation> &symmetryOperations
+) :
+	numMeshPoints(numMeshPoints)
+{
+	unsigned int numDimensions = brillouinZone.getNumDimensions();
+	TBTKAssert(
+		numMeshPoints.size() == numDimensions,
+		"IrreducibleBrillouinZone::IrreducibleBrillouinZone()",
+		"Incompatible dimensions. 'numMeshPoints' has '"
+		<< numMeshPoints.size() << "' components, but the"
+		<< " BrillouinZone has dimension '" << numDimensions << "'.",
+		""
+	);
+	unsigned int numPoints = 1;
+	for(unsigned int n = 0; n < numDimensions; n++){
+		TBTKAssert(
+			numMeshPoints[n] > 0,
+			"IrreducibleBrillouinZone::IrreducibleBrillouinZone()",
+			"The number of mesh points must be positive.",
+			""
+		);
+		numPoints *= numMeshPoints[n];
+	}
+	for(unsigned int n = 0; n < symmetryOperations.size(); n++){
+		TBTKAssert(
+			symmetryOperations[n].getNumDimensions()
+				== numDimensions,
+			"IrreducibleBrillouinZone::IrreducibleBrillouinZone()",
+			"Incompatible dimensions. SymmetryOperation '" << n
+			<< "' has dimension '"
+			<< symmetryOperations[n].getNumDimensions() << "', but"
+			<< " the BrillouinZone has dimension '"
+			<< numDimensions << "'.",
+			""
+		);
+	}
+
+	generateSymmetryGroup(symmetryOperations);
+
+	//Vectors that are dual to the reciprocal basis vectors. The
+	//component of a k-vector along the nth basis vector, in units of the
+	//basis vector, is given by the scalar product with the nth dual
+	//vector.
+	const vector<Vector3d> &basisVectors = brillouinZone.getBasisVectors();
+	vector<Vector3d> dualVectors;
+	for(unsigned int n = 0; n < 3; n++){
+		const Vector3d &v0 = basisVectors[n];
+		const Vector3d &v1 = basisVectors[(n+1)%3];
+		const Vector3d &v2 = basisVectors[(n+2)%3];
+		Vector3d normal = v1*v2;
+		dualVectors.push_back(normal/Vector3d::dotProduct(normal, v0));
+	}
+
+	//The mesh points of an interior mesh are shifted by half a mesh cell
+	//from the origin.
+	double meshOffset;
+	switch(brillouinZone.getMeshType()){
+	case SpacePartition::MeshType::Nodal:
+		meshOffset = 0;
+		break;
+	case SpacePartition::MeshType::Interior:
+		meshOffset = 1/2.;
+		break;
+	default:
+		TBTKExit(
+			"IrreducibleBrillouinZone::IrreducibleBrillouinZone()",
+			"Unknown mesh type.",
+			"Notify the developer about this bug."
+		);
+	}
+
+	//Divide the mesh points into stars. The first mesh point that is
+	//encountered in each star is the irreducible mesh point.
+	stars.assign(numPoints, 0);
+	this->symmetryOperations.assign(numPoints, 0);
+	vector<bool> isAssigned(numPoints, false);
+	vector<unsigned int> meshPoint(numDimensions, 0);
+	for(unsigned int point = 0; point < numPoints; point++){
+		//Row major mesh point corresponding to the linear index.
+		unsigned int remainder = point;
+		for(int n = numDimensions - 1; n >= 0; n--){
+			meshPoint[n] = remainder%numMeshPoints[n];
+			remainder /= numMeshPoints[n];
+		}
+
+		if(isAssigned[point])
+			continue;
+
+		unsigned int star = irreducibleMeshPoints.size();
+		irreducibleMeshPoints.push_back(Index());
+		for(unsigned int n = 0; n < numDimensions; n++)
+			irreducibleMeshPoints.back().pushBack(meshPoint[n]);
+		starSizes.push_back(0);
+
+		Vector3d kVector({0, 0, 0});
+		for(unsigned int n = 0; n < numDimensions; n++){
+			kVector = kVector + (meshPoint[n] + meshOffset)
+				*basisVectors[n]/numMeshPoints[n];
+		}
+		vector<double> k = {kVector.x, kVector.y, kVector.z};
+		k.resize(numDimensions);
+
+		for(
+			unsigned int operation = 0;
+			operation < symmetryGroup.size();
+			operation++
+		){
+			vector<double> image = symmetryGroup[operation].apply(
+				k
+			);
+			image.resize(3, 0);
+			Vector3d imageVector(image);
+
+			unsigned int imagePoint = 0;
+			for(unsigned int n = 0; n < numDimensions; n++){
+				double coordinate = Vector3d::dotProduct(
+					imageVector,
+					dualVectors[n]
+				)*numMeshPoints[n] - meshOffset;
+				double rounded = round(coordinate);
+				if(abs(coordinate - rounded) > MESH_TOLERANCE){
+					TBTKExit(
+						"IrreducibleBrillouinZone::IrreducibleBrillouinZone()",
+						"Symmetry operation '" << operation
+						<< "' of the symmetry group does not"
+						<< " map the mesh onto itself.",
+						"Make sure that the number of mesh"
+						<< " points is compatible with the"
+						<< " symmetry operations."
+					);
+				}
+				int m = ((long)rounded)%(long)numMeshPoints[n];
+				if(m < 0)
+					m += numMeshPoints[n];
+
+				imagePoint = imagePoint*numMeshPoints[n] + m;
+			}
+
+			if(!isAssigned[imagePoint]){
+				isAssigned[imagePoint] = true;
+				stars[imagePoint] = star;
+				this->symmetryOperations[imagePoint] = operation;
+				starSizes[star]++;
+			}
+		}
+	}
+}
+
+void IrreducibleBrillouinZone::generateSymmetryGroup(
+	const vector<SymmetryOperation> &generators
+){
+	unsigned int numOrbitals = 0;
+	if(generators.size() != 0)
+		numOrbitals = generators[0].getNumOrbitals();
+	for(unsigned int n = 0; n < generators.size(); n++){
+		TBTKAssert(
+			generators[n].getNumOrbitals() == numOrbitals,
+			"IrreducibleBrillouinZone::generateSymmetryGroup()",
+			"All SymmetryOperations must have the same number of"
+			<< " orbitals, but SymmetryOperation '" << n << "' has '"
+			<< generators[n].getNumOrbitals() << "' orbitals while"
+			<< " SymmetryOperation '0' has '" << numOrbitals << "'.",
+			""
+		);
+	}
+
+	//Multiply the group elements by the generators until no new elements
+	//appear.
+	symmetryGroup.clear();
+	symmetryGroup.push_back(
+		SymmetryOperation::createIdentity(
+			numMeshPoints.size(),
+			numOrbitals
+		)
+	);
+	for(unsigned int n = 0; n < symmetryGroup.size(); n++){
+		for(unsigned int c = 0; c < generators.size(); c++){
+			SymmetryOperation product
+				= generators[c]*symmetryGroup[n];
+			bool isNew = true;
+			for(unsigned int m = 0; m < symmetryGroup.size(); m++){
+				if(product.hasSameAction(symmetryGroup[m])){
+					isNew = false;
+					break;
+				}
+			}
+			if(isNew)
+				symmetryGroup.push_back(product);
+
+			if(symmetryGroup.size() > MAX_GROUP_SIZE){
+				TBTKExit(
+					"IrreducibleBrillouinZone::generateSymmetryGroup()",
+					"The SymmetryOperations generate more than '"
+					<< MAX_GROUP_SIZE << "' operations.",
+					"Make sure that the SymmetryOperations"
+					<< " are point group operations."
+				);
+			}
+		}
+	}
+}
+
+unsigned int IrreducibleBrillouinZone::getLinearIndex(
+	const Index &meshPoint
+) const{
+	TBTKAssert(
+		meshPoint.getSize() == numMeshPoints.size(),
+		"IrreducibleBrillouinZone::getLinearIndex()",
+		"Incompatible dimensions. The mesh point '"
+		<< meshPoint.toString() << "' has '" << meshPoint.getSize()
+		<< "' subindices, but the IrreducibleBrillouinZone has"
+		<< " dimension '" << numMeshPoints.size() << "'.",
+		""
+	);
+
+	unsigned int linearIndex = 0;
+	for(unsigned int n = 0; n < numMeshPoints.size(); n++){
+		TBTKAssert(
+			meshPoint[n] >= 0 && meshPoint[n] < (int)numMeshPoints[n],
+			"IrreducibleBrillouinZone::getLinearIndex()",
+			"The mesh point '" << meshPoint.toString() << "' is out"
+			<< " of range.",
+			"Subindex '" << n << "' must be in the range [0, "
+			<< numMeshPoints[n] << ")."
+		);
+		linearIndex = linearIndex*numMeshPoints[n] + meshPoint[n];
+	}
+
+	return linearIndex;
+}
+
+};	//End of namespace TBTK
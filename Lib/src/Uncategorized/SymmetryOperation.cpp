@@ -0,0 +1,179 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file SymmetryOperation.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/SymmetryOperation.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace TBTK{
+
+SymmetryOperation::SymmetryOperation(
+	const vector<vector<double>> &rotation,
+	const Matrix<complex<double>> &orbitalRepresentation,
+	bool isAntiUnitary
+) :
+	rotation(rotation),
+	orbitalRepresentation(orbitalRepresentation),
+	antiUnitary(isAntiUnitary)
+{
+	TBTKAssert(
+		rotation.size() >= 1 && rotation.size() <= 3,
+		"SymmetryOperation::SymmetryOperation()",
+		"Unsupported dimension '" << rotation.size() << "'.",
+		"Only 1-3 dimensions are supported."
+	);
+	for(unsigned int n = 0; n < rotation.size(); n++){
+		TBTKAssert(
+			rotation[n].size() == rotation.size(),
+			"SymmetryOperation::SymmetryOperation()",
+			"The rotation must be a square matrix, but row '" << n
+			<< "' has '" << rotation[n].size() << "' elements"
+			<< " while there are '" << rotation.size() << "' rows.",
+			""
+		);
+	}
+	TBTKAssert(
+		orbitalRepresentation.getNumRows()
+			== orbitalRepresentation.getNumCols(),
+		"SymmetryOperation::SymmetryOperation()",
+		"The orbital representation must be a square matrix, but it"
+		<< " has dimensions '" << orbitalRepresentation.getNumRows()
+		<< "x" << orbitalRepresentation.getNumCols() << "'.",
+		""
+	);
+}
+
+SymmetryOperation SymmetryOperation::createIdentity(
+	unsigned int numDimensions,
+	unsigned int numOrbitals
+){
+	vector<vector<double>> rotation(
+		numDimensions,
+		vector<double>(numDimensions, 0)
+	);
+	for(unsigned int n = 0; n < numDimensions; n++)
+		rotation[n][n] = 1;
+
+	Matrix<complex<double>> orbitalRepresentation(
+		numOrbitals,
+		numOrbitals
+	);
+	for(unsigned int row = 0; row < numOrbitals; row++)
+		for(unsigned int col = 0; col < numOrbitals; col++)
+			orbitalRepresentation.at(row, col) = (row == col);
+
+	return SymmetryOperation(rotation, orbitalRepresentation);
+}
+
+vector<double> SymmetryOperation::apply(const vector<double> &k) const{
+	TBTKAssert(
+		k.size() == rotation.size(),
+		"SymmetryOperation::apply()",
+		"Incompatible dimensions. The k-vector has '" << k.size()
+		<< "' components, but the SymmetryOperation has dimension '"
+		<< rotation.size() << "'.",
+		""
+	);
+
+	vector<double> result(k.size(), 0);
+	for(unsigned int row = 0; row < rotation.size(); row++)
+		for(unsigned int col = 0; col < rotation.size(); col++)
+			result[row] += rotation[row][col]*k[col];
+
+	return result;
+}
+
+SymmetryOperation SymmetryOperation::operator*(
+	const SymmetryOperation &rhs
+) const{
+	TBTKAssert(
+		getNumDimensions() == rhs.getNumDimensions()
+		&& getNumOrbitals() == rhs.getNumOrbitals(),
+		"SymmetryOperation::operator*()",
+		"Incompatible SymmetryOperations.",
+		"Both SymmetryOperations must have the same dimension and"
+		<< " number of orbitals."
+	);
+
+	unsigned int numDimensions = getNumDimensions();
+	vector<vector<double>> product(
+		numDimensions,
+		vector<double>(numDimensions, 0)
+	);
+	for(unsigned int row = 0; row < numDimensions; row++){
+		for(unsigned int col = 0; col < numDimensions; col++){
+			for(unsigned int n = 0; n < numDimensions; n++){
+				product[row][col]
+					+= rotation[row][n]*rhs.rotation[n][col];
+			}
+		}
+	}
+
+	//An anti-unitary left hand side conjugates the right hand side
+	//representation, U_1K U_2 = U_1U_2^{*}K.
+	Matrix<complex<double>> rhsRepresentation = rhs.orbitalRepresentation;
+	if(antiUnitary){
+		for(unsigned int row = 0; row < getNumOrbitals(); row++){
+			for(unsigned int col = 0; col < getNumOrbitals(); col++){
+				rhsRepresentation.at(row, col) = conj(
+					rhsRepresentation.at(row, col)
+				);
+			}
+		}
+	}
+
+	return SymmetryOperation(
+		product,
+		orbitalRepresentation*rhsRepresentation,
+		antiUnitary != rhs.antiUnitary
+	);
+}
+
+bool SymmetryOperation::hasSameAction(
+	const SymmetryOperation &symmetryOperation,
+	double tolerance
+) const{
+	if(
+		getNumDimensions() != symmetryOperation.getNumDimensions()
+		|| antiUnitary != symmetryOperation.antiUnitary
+	){
+		return false;
+	}
+
+	for(unsigned int row = 0; row < getNumDimensions(); row++){
+		for(unsigned int col = 0; col < getNumDimensions(); col++){
+			if(
+				abs(
+					rotation[row][col]
+					- symmetryOperation.rotation[row][col]
+				) > tolerance
+			){
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+};	//End of namespace TBTK
@@ -0,0 +1,407 @@
+/* Copyright 2017 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file Matrix.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/Matrix.h"
+
+using namespace std;
+
+extern "C"{
+	void dgemm_(
+		char *transA,		//'N' = A, 'T' = A^T, 'C' = A^T
+		char *transB,		//'N' = B, 'T' = B^T, 'C' = B^T
+		int *m,			//Number of rows of op(A) and C
+		int *n,			//Number of columns of op(B) and C
+		int *k,			//Number of columns of op(A)
+		double *alpha,		//Factor multiplying op(A)op(B)
+		double *a,		//Input matrix A
+		int *lda,		//Leading dimension of A
+		double *b,		//Input matrix B
+		int *ldb,		//Leading dimension of B
+		double *beta,		//Factor multiplying C
+		double *c,		//Input/output matrix C
+		int *ldc		//Leading dimension of C
+	);
+	void zgemm_(
+		char *transA,			//'N' = A, 'T' = A^T,
+						//'C' = A^{\dagger}
+		char *transB,			//'N' = B, 'T' = B^T,
+						//'C' = B^{\dagger}
+		int *m,				//Number of rows of op(A) and C
+		int *n,				//Number of columns of op(B) and C
+		int *k,				//Number of columns of op(A)
+		std::complex<double> *alpha,	//Factor multiplying op(A)op(B)
+		std::complex<double> *a,	//Input matrix A
+		int *lda,			//Leading dimension of A
+		std::complex<double> *b,	//Input matrix B
+		int *ldb,			//Leading dimension of B
+		std::complex<double> *beta,	//Factor multiplying C
+		std::complex<double> *c,	//Input/output matrix C
+		int *ldc			//Leading dimension of C
+	);
+	void zheevd_(
+		char *jobz,			//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors
+		char *uplo,			//'U' = Upper triangular storage
+		int *n,				//Matrix dimension
+		std::complex<double> *a,	//Input matrix, output eigenvectors
+		int *lda,			//Leading dimension of a
+		double *w,			//Eigenvalues, in ascending order
+		std::complex<double> *work,	//Workspace
+		int *lwork,			//Size of work
+		double *rwork,			//Workspace
+		int *lrwork,			//Size of rwork
+		int *iwork,			//Workspace
+		int *liwork,			//Size of iwork
+		int *info			//0 on successful exit
+	);
+};
+
+namespace TBTK{
+
+template<>
+void Matrix<double, 0, 0>::multiply(
+	const Matrix<double, 0, 0> &lhs,
+	const Matrix<double, 0, 0> &rhs,
+	double alpha,
+	double beta
+){
+	TBTKAssert(
+		lhs.cols == rhs.rows,
+		"Matrix::multiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.rows << "x" << lhs.cols
+		<< " and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::multiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == 0){
+		resize(lhs.rows, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.rows && cols == rhs.cols,
+			"Matrix::multiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.rows << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+	if(rows == 0 || cols == 0)
+		return;
+
+	char transA = 'N';
+	char transB = 'N';
+	int m = rows;
+	int n = cols;
+	int k = lhs.cols;
+	int lda = std::max(1u, lhs.rows);
+	int ldb = std::max(1u, rhs.rows);
+	int ldc = rows;
+	dgemm_(
+		&transA,
+		&transB,
+		&m,
+		&n,
+		&k,
+		&alpha,
+		lhs.data,
+		&lda,
+		rhs.data,
+		&ldb,
+		&beta,
+		data,
+		&ldc
+	);
+}
+
+template<>
+void Matrix<double, 0, 0>::adjointMultiply(
+	const Matrix<double, 0, 0> &lhs,
+	const Matrix<double, 0, 0> &rhs,
+	double alpha,
+	double beta
+){
+	TBTKAssert(
+		lhs.rows == rhs.rows,
+		"Matrix::adjointMultiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.cols << "x" << lhs.rows
+		<< " (adjoint) and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::adjointMultiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == 0){
+		resize(lhs.cols, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.cols && cols == rhs.cols,
+			"Matrix::adjointMultiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.cols << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+	if(rows == 0 || cols == 0)
+		return;
+
+	char transA = 'T';
+	char transB = 'N';
+	int m = rows;
+	int n = cols;
+	int k = lhs.rows;
+	int lda = std::max(1u, lhs.rows);
+	int ldb = std::max(1u, rhs.rows);
+	int ldc = rows;
+	dgemm_(
+		&transA,
+		&transB,
+		&m,
+		&n,
+		&k,
+		&alpha,
+		lhs.data,
+		&lda,
+		rhs.data,
+		&ldb,
+		&beta,
+		data,
+		&ldc
+	);
+}
+
+void Matrix<std::complex<double>, 0, 0>::multiply(
+	const Matrix<std::complex<double>, 0, 0> &lhs,
+	const Matrix<std::complex<double>, 0, 0> &rhs,
+	std::complex<double> alpha,
+	std::complex<double> beta
+){
+	TBTKAssert(
+		lhs.cols == rhs.rows,
+		"Matrix::multiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.rows << "x" << lhs.cols
+		<< " and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::multiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == 0.){
+		resize(lhs.rows, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.rows && cols == rhs.cols,
+			"Matrix::multiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.rows << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+	if(rows == 0 || cols == 0)
+		return;
+
+	char transA = 'N';
+	char transB = 'N';
+	int m = rows;
+	int n = cols;
+	int k = lhs.cols;
+	int lda = std::max(1u, lhs.rows);
+	int ldb = std::max(1u, rhs.rows);
+	int ldc = rows;
+	zgemm_(
+		&transA,
+		&transB,
+		&m,
+		&n,
+		&k,
+		&alpha,
+		lhs.data,
+		&lda,
+		rhs.data,
+		&ldb,
+		&beta,
+		data,
+		&ldc
+	);
+}
+
+void Matrix<std::complex<double>, 0, 0>::adjointMultiply(
+	const Matrix<std::complex<double>, 0, 0> &lhs,
+	const Matrix<std::complex<double>, 0, 0> &rhs,
+	std::complex<double> alpha,
+	std::complex<double> beta
+){
+	TBTKAssert(
+		lhs.rows == rhs.rows,
+		"Matrix::adjointMultiply()",
+		"Incompatible matrix dimensions.",
+		"The matrix dimensions are " << lhs.cols << "x" << lhs.rows
+		<< " (adjoint) and " << rhs.rows << "x" << rhs.cols << "\n"
+	);
+	TBTKAssert(
+		this != &lhs && this != &rhs,
+		"Matrix::adjointMultiply()",
+		"The result cannot be stored in one of the factors.",
+		""
+	);
+	if(beta == 0.){
+		resize(lhs.cols, rhs.cols);
+	}
+	else{
+		TBTKAssert(
+			rows == lhs.cols && cols == rhs.cols,
+			"Matrix::adjointMultiply()",
+			"Incompatible matrix dimensions. The product has"
+			<< " dimension " << lhs.cols << "x" << rhs.cols
+			<< " but the matrix has dimension " << rows << "x"
+			<< cols << ".",
+			"Use beta = 0 to overwrite the matrix."
+		);
+	}
+	if(rows == 0 || cols == 0)
+		return;
+
+	char transA = 'C';
+	char transB = 'N';
+	int m = rows;
+	int n = cols;
+	int k = lhs.rows;
+	int lda = std::max(1u, lhs.rows);
+	int ldb = std::max(1u, rhs.rows);
+	int ldc = rows;
+	zgemm_(
+		&transA,
+		&transB,
+		&m,
+		&n,
+		&k,
+		&alpha,
+		lhs.data,
+		&lda,
+		rhs.data,
+		&ldb,
+		&beta,
+		data,
+		&ldc
+	);
+}
+
+void Matrix<std::complex<double>, 0, 0>::diagonalizeHermitian(
+	std::vector<double> &eigenValues,
+	Matrix<std::complex<double>, 0, 0> &eigenVectors
+) const{
+	TBTKAssert(
+		rows == cols,
+		"Matrix::diagonalizeHermitian()",
+		"Invalid matrix dimension. Only square matrices can be"
+		<< " diagonalized, but the matrix has size " << rows << "x"
+		<< cols << "\n",
+		""
+	);
+	TBTKAssert(
+		this != &eigenVectors,
+		"Matrix::diagonalizeHermitian()",
+		"The eigenvectors cannot be stored in the matrix itself.",
+		""
+	);
+
+	eigenVectors = *this;
+	eigenValues.resize(rows);
+	if(rows == 0)
+		return;
+
+	char jobz = 'V';
+	char uplo = 'U';
+	int n = rows;
+	int info;
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	std::complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		eigenVectors.data,
+		&n,
+		eigenValues.data(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	std::vector<std::complex<double>> work(lwork);
+	std::vector<double> rwork(lrwork);
+	std::vector<int> iwork(liwork);
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		eigenVectors.data,
+		&n,
+		eigenValues.data(),
+		work.data(),
+		&lwork,
+		rwork.data(),
+		&lrwork,
+		iwork.data(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Matrix::diagonalizeHermitian()",
+		"Diagonalization failed with error code 'INFO = " << info
+		<< "'.",
+		"See the documentation for the lapack function zheevd_() for"
+		<< " further information."
+	);
+}
+
+};	//End of namespace TBTK
@@ -0,0 +1,140 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file MemoryMappedFile.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/MemoryMappedFile.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace TBTK{
+
+MemoryMappedFile::MemoryMappedFile(){
+	size = 0;
+	data = nullptr;
+}
+
+MemoryMappedFile::MemoryMappedFile(const string &filename, size_t size){
+	this->filename = filename;
+	this->size = size;
+	data = nullptr;
+	if(size == 0)
+		return;
+
+	int fileDescriptor = open(
+		filename.c_str(),
+		O_RDWR | O_CREAT | O_TRUNC,
+		S_IRUSR | S_IWUSR
+	);
+	if(fileDescriptor == -1){
+		TBTKExit(
+			"MemoryMappedFile::MemoryMappedFile()",
+			"Unable to open file '" << filename << "'. "
+			<< strerror(errno),
+			""
+		);
+	}
+
+	if(ftruncate(fileDescriptor, size) != 0){
+		int error = errno;
+		close(fileDescriptor);
+		remove(filename.c_str());
+		TBTKExit(
+			"MemoryMappedFile::MemoryMappedFile()",
+			"Unable to resize file '" << filename << "' to " << size
+			<< " bytes. " << strerror(error),
+			"Make sure that there is enough disk space."
+		);
+	}
+
+	data = mmap(
+		nullptr,
+		size,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED,
+		fileDescriptor,
+		0
+	);
+	int error = errno;
+	//The mapping remains valid after the file descriptor is closed.
+	close(fileDescriptor);
+	if(data == MAP_FAILED){
+		data = nullptr;
+		remove(filename.c_str());
+		TBTKExit(
+			"MemoryMappedFile::MemoryMappedFile()",
+			"Unable to map file '" << filename << "' into memory. "
+			<< strerror(error),
+			""
+		);
+	}
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile &&memoryMappedFile){
+	filename = std::move(memoryMappedFile.filename);
+	size = memoryMappedFile.size;
+	data = memoryMappedFile.data;
+
+	memoryMappedFile.filename = "";
+	memoryMappedFile.size = 0;
+	memoryMappedFile.data = nullptr;
+}
+
+MemoryMappedFile::~MemoryMappedFile(){
+	release();
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(
+	MemoryMappedFile &&memoryMappedFile
+){
+	if(this != &memoryMappedFile){
+		release();
+
+		filename = std::move(memoryMappedFile.filename);
+		size = memoryMappedFile.size;
+		data = memoryMappedFile.data;
+
+		memoryMappedFile.filename = "";
+		memoryMappedFile.size = 0;
+		memoryMappedFile.data = nullptr;
+	}
+
+	return *this;
+}
+
+void MemoryMappedFile::release(){
+	if(data != nullptr){
+		munmap(data, size);
+		remove(filename.c_str());
+	}
+
+	filename = "";
+	size = 0;
+	data = nullptr;
+}
+
+};	//End of namespace TBTK
@@ -0,0 +1,315 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file Mixer.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/Mixer.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+//Lapack function for solving a general linear system.
+extern "C" void zgesv_(
+	int *n,			//Matrix dimension
+	int *nrhs,		//Number of right hand sides
+	complex<double> *a,	//Input matrix, overwritten by its LU factorization
+	int *lda,		//Leading dimension of a
+	int *ipiv,		//Pivot indices
+	complex<double> *b,	//Right hand side, overwritten by the solution
+	int *ldb,		//Leading dimension of b
+	int *info		//0 = successful, >0 = the matrix is singular
+);
+
+namespace TBTK{
+
+namespace{
+	//Calculates <lhs|rhs>.
+	complex<double> innerProduct(
+		const vector<complex<double>> &lhs,
+		const vector<complex<double>> &rhs
+	){
+		complex<double> result = 0;
+		for(unsigned int n = 0; n < lhs.size(); n++)
+			result += conj(lhs[n])*rhs[n];
+
+		return result;
+	}
+};
+
+Mixer::Mixer(
+	Method method,
+	double mixingParameter,
+	unsigned int historySize
+){
+	this->method = method;
+	setMixingParameter(mixingParameter);
+	setHistorySize(historySize);
+	tolerance = 1e-6;
+}
+
+vector<complex<double>> Mixer::mix(
+	const vector<complex<double>> &input,
+	const vector<complex<double>> &output
+){
+	TBTKAssert(
+		input.size() == output.size(),
+		"Mixer::mix()",
+		"Incompatible sizes. The input has size '" << input.size()
+		<< "' while the output has size '" << output.size() << "'.",
+		""
+	);
+	TBTKAssert(
+		inputs.size() == 0 || inputs.back().size() == input.size(),
+		"Mixer::mix()",
+		"The order parameter has size '" << input.size() << "' but"
+		<< " previous iterations have size '" << inputs.back().size()
+		<< "'.",
+		"Call Mixer::reset() before starting a new calculation."
+	);
+
+	vector<complex<double>> residual(input.size());
+	double squaredNorm = 0;
+	for(unsigned int n = 0; n < input.size(); n++){
+		residual[n] = output[n] - input[n];
+		squaredNorm += norm(residual[n]);
+	}
+	residualHistory.push_back(sqrt(squaredNorm));
+
+	inputs.push_back(input);
+	residuals.push_back(residual);
+	if(inputs.size() > historySize){
+		inputs.erase(inputs.begin());
+		residuals.erase(residuals.begin());
+	}
+
+	switch(method){
+	case Method::Linear:
+		return mixLinear();
+	case Method::Anderson:
+		return mixAndersonBroyden(0);
+	case Method::Pulay:
+		return mixPulay();
+	case Method::Broyden:
+		return mixAndersonBroyden(0.01);
+	default:
+		TBTKExit(
+			"Mixer::mix()",
+			"Unknown mixing method.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+bool Mixer::update(
+	vector<complex<double>> &orderParameter,
+	const vector<complex<double>> &output
+){
+	orderParameter = mix(orderParameter, output);
+
+	return isConverged();
+}
+
+string Mixer::toString() const{
+	stringstream stream;
+	stream << "Mixer\n";
+	stream << "\tMethod: ";
+	switch(method){
+	case Method::Linear:
+		stream << "Linear\n";
+		break;
+	case Method::Anderson:
+		stream << "Anderson\n";
+		break;
+	case Method::Pulay:
+		stream << "Pulay\n";
+		break;
+	case Method::Broyden:
+		stream << "Broyden\n";
+		break;
+	default:
+		TBTKExit(
+			"Mixer::toString()",
+			"Unknown mixing method.",
+			"This should never happen, contact the developer."
+		);
+	}
+	stream << "\tMixing parameter: " << mixingParameter << "\n";
+	stream << "\tHistory size: " << historySize << "\n";
+	stream << "\tTolerance: " << tolerance << "\n";
+	stream << "\tIterations: " << residualHistory.size() << "\n";
+	stream << "\tConverged: " << (isConverged() ? "Yes" : "No") << "\n";
+	stream << "\tResiduals:";
+	for(unsigned int n = 0; n < residualHistory.size(); n++)
+		stream << "\n\t\t" << n << ": " << residualHistory[n];
+
+	return stream.str();
+}
+
+vector<complex<double>> Mixer::mixLinear() const{
+	const vector<complex<double>> &input = inputs.back();
+	const vector<complex<double>> &residual = residuals.back();
+
+	vector<complex<double>> result(input.size());
+	for(unsigned int n = 0; n < input.size(); n++)
+		result[n] = input[n] + mixingParameter*residual[n];
+
+	return result;
+}
+
+vector<complex<double>> Mixer::mixAndersonBroyden(double w0) const{
+	//Differences between consecutive iterations, normalized by the norm
+	//of the residual difference.
+	vector<vector<complex<double>>> residualDifferences;
+	vector<vector<complex<double>>> inputDifferences;
+	for(unsigned int n = 0; n + 1 < inputs.size(); n++){
+		vector<complex<double>> residualDifference(inputs[n].size());
+		vector<complex<double>> inputDifference(inputs[n].size());
+		double squaredNorm = 0;
+		for(unsigned int c = 0; c < inputs[n].size(); c++){
+			residualDifference[c]
+				= residuals[n+1][c] - residuals[n][c];
+			inputDifference[c] = inputs[n+1][c] - inputs[n][c];
+			squaredNorm += norm(residualDifference[c]);
+		}
+		if(squaredNorm == 0)
+			continue;
+
+		double residualDifferenceNorm = sqrt(squaredNorm);
+		for(unsigned int c = 0; c < inputs[n].size(); c++){
+			residualDifference[c] /= residualDifferenceNorm;
+			inputDifference[c] /= residualDifferenceNorm;
+		}
+		residualDifferences.push_back(residualDifference);
+		inputDifferences.push_back(inputDifference);
+	}
+
+	vector<complex<double>> result = mixLinear();
+	unsigned int numDifferences = residualDifferences.size();
+	if(numDifferences == 0)
+		return result;
+
+	//Solve (w0^2 + <dF_i|dF_j>)gamma_j = <dF_i|F>.
+	const vector<complex<double>> &residual = residuals.back();
+	vector<complex<double>> a(numDifferences*numDifferences);
+	vector<complex<double>> gamma(numDifferences);
+	for(unsigned int row = 0; row < numDifferences; row++){
+		for(unsigned int col = 0; col < numDifferences; col++){
+			a[row + numDifferences*col] = innerProduct(
+				residualDifferences[row],
+				residualDifferences[col]
+			);
+		}
+		a[row + numDifferences*row] += w0*w0;
+		gamma[row] = innerProduct(residualDifferences[row], residual);
+	}
+	if(!solveLinearSystem(a, gamma))
+		return result;
+
+	//x_{n+1} = x_n + alpha*F - sum_j gamma_j(dx_j + alpha*dF_j).
+	for(unsigned int n = 0; n < numDifferences; n++){
+		for(unsigned int c = 0; c < result.size(); c++){
+			result[c] -= gamma[n]*(
+				inputDifferences[n][c]
+				+ mixingParameter*residualDifferences[n][c]
+			);
+		}
+	}
+
+	return result;
+}
+
+vector<complex<double>> Mixer::mixPulay() const{
+	//Use as many of the most recent iterations as possible. Older
+	//iterations are dropped if the residuals are linearly dependent.
+	for(unsigned int first = 0; first + 1 < inputs.size(); first++){
+		unsigned int size = inputs.size() - first;
+
+		//Solve the system
+		//[B 1][c     ]   [0]
+		//[1 0][lambda] = [1],
+		//where B_ij = <F_i|F_j>. B is normalized by its largest
+		//diagonal element to improve the conditioning.
+		double scale = 0;
+		for(unsigned int n = first; n < inputs.size(); n++){
+			scale = max(
+				scale,
+				real(innerProduct(residuals[n], residuals[n]))
+			);
+		}
+		if(scale == 0)
+			break;
+
+		vector<complex<double>> a((size+1)*(size+1), 0.);
+		vector<complex<double>> coefficients(size+1, 0.);
+		for(unsigned int row = 0; row < size; row++){
+			for(unsigned int col = 0; col < size; col++){
+				a[row + (size+1)*col] = innerProduct(
+					residuals[first + row],
+					residuals[first + col]
+				)/scale;
+			}
+			a[row + (size+1)*size] = 1;
+			a[size + (size+1)*row] = 1;
+		}
+		coefficients[size] = 1;
+		if(!solveLinearSystem(a, coefficients))
+			continue;
+
+		//x_{n+1} = sum_i c_i(x_i + alpha*F_i).
+		vector<complex<double>> result(inputs.back().size(), 0.);
+		for(unsigned int n = 0; n < size; n++){
+			const vector<complex<double>> &input
+				= inputs[first + n];
+			const vector<complex<double>> &residual
+				= residuals[first + n];
+			for(unsigned int c = 0; c < result.size(); c++){
+				result[c] += coefficients[n]*(
+					input[c] + mixingParameter*residual[c]
+				);
+			}
+		}
+
+		return result;
+	}
+
+	return mixLinear();
+}
+
+bool Mixer::solveLinearSystem(
+	vector<complex<double>> &A,
+	vector<complex<double>> &b
+){
+	int n = b.size();
+	int nrhs = 1;
+	vector<int> ipiv(n);
+	int info;
+	zgesv_(&n, &nrhs, A.data(), &n, ipiv.data(), b.data(), &n, &info);
+
+	TBTKAssert(
+		info >= 0,
+		"Mixer::solveLinearSystem()",
+		"Argument '" << -info << "' to zgesv_() is invalid.",
+		"This should never happen, contact the developer."
+	);
+
+	return info == 0;
+}
+
+};	//End of namespace TBTK
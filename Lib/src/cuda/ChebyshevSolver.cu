@@ -150,8 +150,9 @@ vector<
 			coefficients[coefficientMap[n]][0] = jIn1[n];
 //			coefficients[coefficientMap[n]*numCoefficients] = jIn1[n];
 
-	SparseMatrix<complex<double>> sparseMatrix = hoppingAmplitudeSet.getSparseMatrix();
-	sparseMatrix.setStorageFormat(SparseMatrix<complex<double>>::StorageFormat::CSR);
+	const SparseMatrix<complex<double>> &sparseMatrix = hoppingAmplitudeSet.getSparseMatrix(
+		SparseMatrix<complex<double>>::StorageFormat::CSR
+	);
 
 	const int numHoppingAmplitudes = sparseMatrix.getCSRNumMatrixElements();
 	const unsigned int *csrRowPointers = sparseMatrix.getCSRRowPointers();
@@ -0,0 +1,193 @@
+#include "TBTK/BasisIndexCache.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+
+TEST(BasisIndexCache, Constructor){
+	BasisIndexCache basisIndexCache;
+	EXPECT_FALSE(basisIndexCache.getIsGenerated());
+	EXPECT_EQ(basisIndexCache.getSize(), 0);
+}
+
+TEST(BasisIndexCache, add){
+	BasisIndexCache basisIndexCache;
+	basisIndexCache.add({0, 1});
+	basisIndexCache.add({0, 2});
+	EXPECT_EQ(basisIndexCache.getSize(), 2);
+
+	//Fail to add Indices after the cache has been generated.
+	basisIndexCache.generate();
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			basisIndexCache.add({1, 1});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(BasisIndexCache, generate){
+	//Indices that fill a rectangular range use the dense storage format.
+	BasisIndexCache dense;
+	for(int x = 0; x < 3; x++)
+		for(int y = 0; y < 4; y++)
+			if(x != 1 || y != 2)
+				dense.add({x, y});
+	dense.generate();
+	EXPECT_TRUE(dense.getIsGenerated());
+	EXPECT_EQ(
+		dense.getStorageFormat(),
+		BasisIndexCache::StorageFormat::Dense
+	);
+
+	//Indices with different number of subindices use the hash storage
+	//format.
+	BasisIndexCache mixed;
+	mixed.add({0, 0});
+	mixed.add({1, 0, 0});
+	mixed.add({1, 0, 1});
+	mixed.generate();
+	EXPECT_EQ(
+		mixed.getStorageFormat(),
+		BasisIndexCache::StorageFormat::Hash
+	);
+
+	//Indices that are sparse in their range use the hash storage format.
+	BasisIndexCache sparse;
+	sparse.add({0, 0});
+	sparse.add({100, 100});
+	sparse.generate();
+	EXPECT_EQ(
+		sparse.getStorageFormat(),
+		BasisIndexCache::StorageFormat::Hash
+	);
+
+	//Fail to generate twice.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			sparse.generate();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(BasisIndexCache, clear){
+	BasisIndexCache basisIndexCache;
+	basisIndexCache.add({0, 1});
+	basisIndexCache.generate();
+	basisIndexCache.clear();
+	EXPECT_FALSE(basisIndexCache.getIsGenerated());
+	EXPECT_EQ(basisIndexCache.getSize(), 0);
+	EXPECT_EQ(basisIndexCache.getBasisIndex({0, 1}), -1);
+
+	//Indices can be added again after the cache has been cleared.
+	basisIndexCache.add({0, 2});
+	basisIndexCache.generate();
+	EXPECT_EQ(basisIndexCache.getBasisIndex({0, 2}), 0);
+}
+
+TEST(BasisIndexCache, getIsGenerated){
+	//Tested through BasisIndexCache::generate and BasisIndexCache::clear.
+}
+
+TEST(BasisIndexCache, getStorageFormat){
+	BasisIndexCache basisIndexCache;
+	EXPECT_EQ(
+		basisIndexCache.getStorageFormat(),
+		BasisIndexCache::StorageFormat::None
+	);
+	//Remaining cases tested through BasisIndexCache::generate.
+}
+
+TEST(BasisIndexCache, getSize){
+	//Tested through BasisIndexCache::add and BasisIndexCache::clear.
+}
+
+TEST(BasisIndexCache, getBasisIndex){
+	std::vector<Index> indices;
+	for(int x = 0; x < 3; x++)
+		for(int y = 0; y < 4; y++)
+			if(x != 1 || y != 2)
+				indices.push_back({x, y});
+	std::vector<Index> mixedIndices = {
+		{0, 0},
+		{1, 0, 0},
+		{1, 0, 1},
+		{2},
+		{100, 100}
+	};
+
+	for(unsigned int n = 0; n < 2; n++){
+		const std::vector<Index> &currentIndices
+			= (n == 0 ? indices : mixedIndices);
+		BasisIndexCache basisIndexCache;
+		for(unsigned int c = 0; c < currentIndices.size(); c++)
+			basisIndexCache.add(currentIndices[c]);
+
+		//No lookup is possible before the cache has been generated.
+		EXPECT_EQ(basisIndexCache.getBasisIndex(currentIndices[0]), -1);
+
+		basisIndexCache.generate();
+		for(unsigned int c = 0; c < currentIndices.size(); c++){
+			EXPECT_EQ(
+				basisIndexCache.getBasisIndex(currentIndices[c]),
+				c
+			);
+		}
+
+		//Indices that are not in the cache.
+		EXPECT_EQ(basisIndexCache.getBasisIndex({1, 2}), -1);
+		EXPECT_EQ(basisIndexCache.getBasisIndex({3, 0}), -1);
+		EXPECT_EQ(basisIndexCache.getBasisIndex({-1, 0}), -1);
+		EXPECT_EQ(basisIndexCache.getBasisIndex({0}), -1);
+		EXPECT_EQ(basisIndexCache.getBasisIndex({0, 0, 0}), -1);
+		EXPECT_EQ(basisIndexCache.getBasisIndex({}), -1);
+	}
+}
+
+TEST(BasisIndexCache, getPhysicalIndex){
+	BasisIndexCache basisIndexCache;
+	basisIndexCache.add({0, 0});
+	basisIndexCache.add({1, 0, 0});
+	basisIndexCache.add({2});
+	basisIndexCache.generate();
+	EXPECT_TRUE(basisIndexCache.getPhysicalIndex(0).equals({0, 0}));
+	EXPECT_TRUE(basisIndexCache.getPhysicalIndex(1).equals({1, 0, 0}));
+	EXPECT_TRUE(basisIndexCache.getPhysicalIndex(2).equals({2}));
+
+	//Fail for basis indices out of bound.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			basisIndexCache.getPhysicalIndex(-1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			basisIndexCache.getPhysicalIndex(3);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(BasisIndexCache, getSizeInBytes){
+	BasisIndexCache basisIndexCache;
+	unsigned int emptySize = basisIndexCache.getSizeInBytes();
+	EXPECT_TRUE(emptySize >= sizeof(BasisIndexCache));
+	for(int n = 0; n < 100; n++)
+		basisIndexCache.add({n, 0});
+	basisIndexCache.generate();
+	EXPECT_TRUE(
+		basisIndexCache.getSizeInBytes() >= emptySize + 300*sizeof(int)
+	);
+}
+
+};
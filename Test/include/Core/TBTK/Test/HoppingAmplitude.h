@@ -72,6 +72,56 @@ TEST(HoppingAmplitude, CopyConstructor){
 	EXPECT_TRUE(hoppingAmplitude3.getFromIndex().equals({3, 4, 5})) << errorMessage;
 }
 
+TEST(HoppingAmplitude, MoveConstructor){
+	HoppingAmplitude hoppingAmplitude0(std::complex<double>(1, 2), {1, 2, 3}, {4, 5});
+	HoppingAmplitude hoppingAmplitude1(amplitudeCallback, {1, 2}, {3, 4, 5});
+
+	HoppingAmplitude hoppingAmplitude2 = std::move(hoppingAmplitude0);
+	EXPECT_EQ(hoppingAmplitude2.getAmplitude(), std::complex<double>(1, 2));
+	EXPECT_TRUE(hoppingAmplitude2.getToIndex().equals({1, 2, 3}));
+	EXPECT_TRUE(hoppingAmplitude2.getFromIndex().equals({4, 5}));
+
+	HoppingAmplitude hoppingAmplitude3 = std::move(hoppingAmplitude1);
+	EXPECT_EQ(hoppingAmplitude3.getAmplitude(), std::complex<double>(3, 4));
+	EXPECT_TRUE(hoppingAmplitude3.getToIndex().equals({1, 2}));
+	EXPECT_TRUE(hoppingAmplitude3.getFromIndex().equals({3, 4, 5}));
+}
+
+TEST(HoppingAmplitude, operatorAssignment){
+	HoppingAmplitude hoppingAmplitude0(std::complex<double>(1, 2), {1, 2, 3}, {4, 5});
+	HoppingAmplitude hoppingAmplitude1(amplitudeCallback, {1, 2}, {3, 4, 5});
+
+	HoppingAmplitude hoppingAmplitude2;
+	hoppingAmplitude2 = hoppingAmplitude0;
+	EXPECT_EQ(hoppingAmplitude2.getAmplitude(), std::complex<double>(1, 2));
+	EXPECT_TRUE(hoppingAmplitude2.getToIndex().equals({1, 2, 3}));
+	EXPECT_TRUE(hoppingAmplitude2.getFromIndex().equals({4, 5}));
+
+	//A callback dependent HoppingAmplitude replaces a regular one.
+	hoppingAmplitude2 = hoppingAmplitude1;
+	EXPECT_EQ(hoppingAmplitude2.getAmplitude(), std::complex<double>(3, 4));
+	EXPECT_TRUE(hoppingAmplitude2.getIsCallbackDependent());
+	EXPECT_TRUE(hoppingAmplitude2.getToIndex().equals({1, 2}));
+	EXPECT_TRUE(hoppingAmplitude2.getFromIndex().equals({3, 4, 5}));
+}
+
+TEST(HoppingAmplitude, operatorMoveAssignment){
+	HoppingAmplitude hoppingAmplitude0(std::complex<double>(1, 2), {1, 2, 3}, {4, 5});
+	HoppingAmplitude hoppingAmplitude1(amplitudeCallback, {1, 2}, {3, 4, 5});
+
+	HoppingAmplitude hoppingAmplitude2;
+	hoppingAmplitude2 = std::move(hoppingAmplitude0);
+	EXPECT_EQ(hoppingAmplitude2.getAmplitude(), std::complex<double>(1, 2));
+	EXPECT_TRUE(hoppingAmplitude2.getToIndex().equals({1, 2, 3}));
+	EXPECT_TRUE(hoppingAmplitude2.getFromIndex().equals({4, 5}));
+
+	hoppingAmplitude2 = std::move(hoppingAmplitude1);
+	EXPECT_EQ(hoppingAmplitude2.getAmplitude(), std::complex<double>(3, 4));
+	EXPECT_TRUE(hoppingAmplitude2.getIsCallbackDependent());
+	EXPECT_TRUE(hoppingAmplitude2.getToIndex().equals({1, 2}));
+	EXPECT_TRUE(hoppingAmplitude2.getFromIndex().equals({3, 4, 5}));
+}
+
 //TBTKFeature Core.HoppingAmplitude.Serialization.1 2019-09-23
 TEST(HoppingAmplitude, SerializeToJSON){
 	std::string errorMessage = "JSON serialization failed.";
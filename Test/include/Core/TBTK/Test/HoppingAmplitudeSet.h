@@ -151,6 +151,175 @@ TEST(HoppingAmplitudeSet, add){
 	);
 }
 
+TEST(HoppingAmplitudeSet, addConcurrently){
+	const int SIZE_X = 40;
+	const int SIZE_Y = 30;
+	HoppingAmplitudeSet serialHoppingAmplitudeSet;
+	HoppingAmplitudeSet concurrentHoppingAmplitudeSet;
+	for(int x = 0; x < SIZE_X; x++){
+		for(int y = 0; y < SIZE_Y; y++){
+			for(int s = 0; s < 2; s++){
+				serialHoppingAmplitudeSet.add(
+					HoppingAmplitude(
+						x + 10*y + 100*s,
+						{x, y, s},
+						{x, y, s}
+					)
+				);
+				if(x+1 < SIZE_X){
+					serialHoppingAmplitudeSet.add(
+						HoppingAmplitude(
+							x + 10*y + 100*s + 1000,
+							{x+1, y, s},
+							{x, y, s}
+						)
+					);
+				}
+			}
+		}
+	}
+	serialHoppingAmplitudeSet.construct();
+
+	//The lattice is added in reversed order and the HoppingAmplitudes
+	//that end up in the same leaf node are split between the threads.
+	#pragma omp parallel for
+	for(int x = SIZE_X-1; x >= 0; x--){
+		for(int y = SIZE_Y-1; y >= 0; y--){
+			for(int s = 1; s >= 0; s--){
+				if(x+1 < SIZE_X){
+					concurrentHoppingAmplitudeSet.addConcurrently(
+						HoppingAmplitude(
+							x + 10*y + 100*s + 1000,
+							{x+1, y, s},
+							{x, y, s}
+						)
+					);
+				}
+				concurrentHoppingAmplitudeSet.addConcurrently(
+					HoppingAmplitude(
+						x + 10*y + 100*s,
+						{x, y, s},
+						{x, y, s}
+					)
+				);
+			}
+		}
+	}
+	concurrentHoppingAmplitudeSet.construct();
+
+	ASSERT_EQ(
+		concurrentHoppingAmplitudeSet.getBasisSize(),
+		serialHoppingAmplitudeSet.getBasisSize()
+	);
+	for(int n = 0; n < serialHoppingAmplitudeSet.getBasisSize(); n++){
+		EXPECT_TRUE(
+			concurrentHoppingAmplitudeSet.getPhysicalIndex(n).equals(
+				serialHoppingAmplitudeSet.getPhysicalIndex(n)
+			)
+		);
+	}
+
+	SparseMatrix<std::complex<double>> serialSparseMatrix
+		= serialHoppingAmplitudeSet.getSparseMatrix();
+	SparseMatrix<std::complex<double>> concurrentSparseMatrix
+		= concurrentHoppingAmplitudeSet.getSparseMatrix();
+	ASSERT_EQ(
+		concurrentSparseMatrix.getCSCNumMatrixElements(),
+		serialSparseMatrix.getCSCNumMatrixElements()
+	);
+	for(int n = 0; n < serialHoppingAmplitudeSet.getBasisSize() + 1; n++){
+		EXPECT_EQ(
+			concurrentSparseMatrix.getCSCColumnPointers()[n],
+			serialSparseMatrix.getCSCColumnPointers()[n]
+		);
+	}
+	for(
+		unsigned int n = 0;
+		n < serialSparseMatrix.getCSCNumMatrixElements();
+		n++
+	){
+		EXPECT_EQ(
+			concurrentSparseMatrix.getCSCRows()[n],
+			serialSparseMatrix.getCSCRows()[n]
+		);
+		EXPECT_DOUBLE_EQ(
+			real(concurrentSparseMatrix.getCSCValues()[n]),
+			real(serialSparseMatrix.getCSCValues()[n])
+		);
+	}
+
+	//HoppingAmplitudes that are added using add() and addConcurrently()
+	//end up in the same HoppingAmplitudeSet.
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	hoppingAmplitudeSet.add(HoppingAmplitude(1, {1, 0}, {1, 0}));
+	hoppingAmplitudeSet.addConcurrently(HoppingAmplitude(2, {0, 1}, {0, 1}));
+	hoppingAmplitudeSet.addConcurrently(HoppingAmplitude(3, {1, 0}, {0, 0}));
+	hoppingAmplitudeSet.construct();
+	EXPECT_EQ(hoppingAmplitudeSet.getBasisSize(), 3);
+	EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({0, 0}), 0);
+	EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({0, 1}), 1);
+	EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({1, 0}), 2);
+	EXPECT_EQ(hoppingAmplitudeSet.getHoppingAmplitudes({0, 0}).size(), 1);
+	EXPECT_EQ(hoppingAmplitudeSet.getHoppingAmplitudes({1, 0}).size(), 1);
+
+	//Fail to add HoppingAmplitudes with conflicting Index structures.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			HoppingAmplitudeSet hoppingAmplitudeSet;
+			hoppingAmplitudeSet.add(
+				HoppingAmplitude(1, {1, 2}, {3, 4})
+			);
+			hoppingAmplitudeSet.addConcurrently(
+				HoppingAmplitude(1, {1, 2}, {3, 4, 5})
+			);
+			hoppingAmplitudeSet.construct();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail to add HoppingAmplitude to a constructed HoppingAmplitudeSet.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			HoppingAmplitudeSet hoppingAmplitudeSet;
+			hoppingAmplitudeSet.add(
+				HoppingAmplitude(1, {1, 2}, {1, 2})
+			);
+			hoppingAmplitudeSet.construct();
+			hoppingAmplitudeSet.addConcurrently(
+				HoppingAmplitude(1, {1, 2}, {1, 2})
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+#ifdef TBTK_USE_OPEN_MP
+	//Fail to add HoppingAmplitudes from a nested parallel region.
+	::testing::FLAGS_gtest_death_test_style = "threadsafe";
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			HoppingAmplitudeSet hoppingAmplitudeSet;
+			#pragma omp parallel num_threads(1)
+			{
+				#pragma omp parallel num_threads(1)
+				{
+					hoppingAmplitudeSet.addConcurrently(
+						HoppingAmplitude(1, {1, 2}, {1, 2})
+					);
+				}
+			}
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	::testing::FLAGS_gtest_death_test_style = "fast";
+#endif
+}
+
 /*TEST(HoppingAmplitudeSet, addHoppingAmplitudeAndHermitianConjugate){
 	HoppingAmplitudeSet hoppingAmplitudeSet;
 	hoppingAmplitudeSet.addHoppingAmplitudeAndHermitianConjugate(HoppingAmplitude(1, {1, 2}, {3, 4}));
@@ -370,6 +539,312 @@ TEST(HoppingAmplitudeSet, getIsConstructed){
 	EXPECT_TRUE(hoppingAmplitudeSet.getIsConstructed());
 }
 
+TEST(HoppingAmplitudeSet, setUseBasisIndexCache){
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	hoppingAmplitudeSet.add(HoppingAmplitude(1, {0, 0, 0}, {0, 0, 0}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(1, {0, 0, 1}, {0, 0, 1}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(1, {1, 1}, {1, 1}));
+	hoppingAmplitudeSet.construct();
+	EXPECT_TRUE(hoppingAmplitudeSet.getBasisIndexCache().getIsGenerated());
+
+	//The same basis indices and physical indices are obtained with and
+	//without the cache.
+	for(unsigned int n = 0; n < 2; n++){
+		hoppingAmplitudeSet.setUseBasisIndexCache(n == 0);
+		EXPECT_EQ(
+			hoppingAmplitudeSet.getBasisIndexCache().getIsGenerated(),
+			n == 0
+		);
+		EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({0, 0, 0}), 0);
+		EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({0, 0, 1}), 1);
+		EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({1, 1}), 2);
+		EXPECT_TRUE(
+			hoppingAmplitudeSet.getPhysicalIndex(0).equals({0, 0, 0})
+		);
+		EXPECT_TRUE(
+			hoppingAmplitudeSet.getPhysicalIndex(1).equals({0, 0, 1})
+		);
+		EXPECT_TRUE(
+			hoppingAmplitudeSet.getPhysicalIndex(2).equals({1, 1})
+		);
+
+		//Indices that are not in the HoppingAmplitudeSet are handled
+		//in the same way.
+		EXPECT_EQ(hoppingAmplitudeSet.getBasisIndex({0, 0}), -1);
+		EXPECT_EXIT(
+			{
+				Streams::setStdMuteErr();
+				hoppingAmplitudeSet.getBasisIndex({2, 0});
+			},
+			::testing::ExitedWithCode(1),
+			""
+		);
+	}
+
+	//The cache is generated when the HoppingAmplitudeSet is constructed
+	//and is invalidated when HoppingAmplitudes are added.
+	HoppingAmplitudeSet hoppingAmplitudeSet2;
+	hoppingAmplitudeSet2.setUseBasisIndexCache(false);
+	hoppingAmplitudeSet2.add(HoppingAmplitude(1, {0}, {0}));
+	hoppingAmplitudeSet2.construct();
+	EXPECT_FALSE(
+		hoppingAmplitudeSet2.getBasisIndexCache().getIsGenerated()
+	);
+	hoppingAmplitudeSet2.setUseBasisIndexCache(true);
+	EXPECT_TRUE(hoppingAmplitudeSet2.getBasisIndexCache().getIsGenerated());
+	hoppingAmplitudeSet2.add(HoppingAmplitude(1, {1}, {1}));
+	EXPECT_FALSE(
+		hoppingAmplitudeSet2.getBasisIndexCache().getIsGenerated()
+	);
+}
+
+TEST(HoppingAmplitudeSet, getUseBasisIndexCache){
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	EXPECT_TRUE(hoppingAmplitudeSet.getUseBasisIndexCache());
+	hoppingAmplitudeSet.setUseBasisIndexCache(false);
+	EXPECT_FALSE(hoppingAmplitudeSet.getUseBasisIndexCache());
+}
+
+TEST(HoppingAmplitudeSet, getBasisIndexCache){
+	//Tested through HoppingAmplitudeSet::setUseBasisIndexCache.
+}
+
+class CompactStorageCallback : public HoppingAmplitude::AmplitudeCallback{
+public:
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		return 10*to[0] + from[0];
+	}
+};
+
+HoppingAmplitudeSet createCompactStorageTestSet(
+	const CompactStorageCallback &callback
+){
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	for(int x = 0; x < 3; x++){
+		for(int s = 0; s < 2; s++){
+			hoppingAmplitudeSet.add(
+				HoppingAmplitude(x + s, {x, s}, {x, s})
+			);
+			hoppingAmplitudeSet.add(
+				HoppingAmplitude(
+					std::complex<double>(1, s),
+					{x, (s+1)%2},
+					{x, s}
+				)
+			);
+		}
+	}
+	hoppingAmplitudeSet.add(HoppingAmplitude(callback, {0, 1}, {2, 0}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(callback, {2, 0}, {0, 1}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(callback, {1, 0}, {1, 1}));
+
+	return hoppingAmplitudeSet;
+}
+
+TEST(HoppingAmplitudeSet, setUseCompactStorage){
+	CompactStorageCallback callback;
+	HoppingAmplitudeSet reference = createCompactStorageTestSet(callback);
+	reference.construct();
+
+	HoppingAmplitudeSet hoppingAmplitudeSet0
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet0.setUseCompactStorage(true);
+	hoppingAmplitudeSet0.construct();
+
+	HoppingAmplitudeSet hoppingAmplitudeSet1
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet1.construct();
+	hoppingAmplitudeSet1.setUseCompactStorage(true);
+
+	//Compact storage requires less memory.
+	EXPECT_LT(
+		hoppingAmplitudeSet0.getSizeInBytes(),
+		reference.getSizeInBytes()
+	);
+
+	//Compact storage can be turned on both before and after construction
+	//and can be turned off again.
+	HoppingAmplitudeSet hoppingAmplitudeSet2
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet2.setUseCompactStorage(true);
+	hoppingAmplitudeSet2.construct();
+	hoppingAmplitudeSet2.setUseCompactStorage(false);
+
+	for(
+		const HoppingAmplitudeSet *hoppingAmplitudeSet : {
+			&hoppingAmplitudeSet0,
+			&hoppingAmplitudeSet1,
+			&hoppingAmplitudeSet2
+		}
+	){
+		//The iteration gives the same HoppingAmplitudes in the same
+		//order.
+		HoppingAmplitudeSet::ConstIterator iterator
+			= hoppingAmplitudeSet->cbegin();
+		for(
+			HoppingAmplitudeSet::ConstIterator referenceIterator
+				= reference.cbegin();
+			referenceIterator != reference.cend();
+			++referenceIterator
+		){
+			ASSERT_TRUE(iterator != hoppingAmplitudeSet->cend());
+			const HoppingAmplitude &hoppingAmplitude = *iterator;
+			const HoppingAmplitude &referenceHoppingAmplitude
+				= *referenceIterator;
+			EXPECT_TRUE(
+				hoppingAmplitude.getToIndex().equals(
+					referenceHoppingAmplitude.getToIndex()
+				)
+			);
+			EXPECT_TRUE(
+				hoppingAmplitude.getFromIndex().equals(
+					referenceHoppingAmplitude.getFromIndex()
+				)
+			);
+			EXPECT_EQ(
+				hoppingAmplitude.getAmplitude(),
+				referenceHoppingAmplitude.getAmplitude()
+			);
+			EXPECT_EQ(
+				hoppingAmplitude.getIsCallbackDependent(),
+				referenceHoppingAmplitude.getIsCallbackDependent()
+			);
+			++iterator;
+		}
+		EXPECT_TRUE(iterator == hoppingAmplitudeSet->cend());
+
+		//Iteration over a subspace.
+		unsigned int counter = 0;
+		for(
+			HoppingAmplitudeSet::ConstIterator iterator
+				= hoppingAmplitudeSet->cbegin({1});
+			iterator != hoppingAmplitudeSet->cend({1});
+			++iterator
+		){
+			EXPECT_EQ((*iterator).getFromIndex()[0], 1);
+			counter++;
+		}
+		EXPECT_EQ(counter, 5);
+		EXPECT_TRUE(
+			hoppingAmplitudeSet->cbegin({5})
+			== hoppingAmplitudeSet->cend({5})
+		);
+
+		//The sparse matrices are equal.
+		SparseMatrix<std::complex<double>> sparseMatrix
+			= hoppingAmplitudeSet->getSparseMatrix();
+		SparseMatrix<std::complex<double>> referenceSparseMatrix
+			= reference.getSparseMatrix();
+		ASSERT_EQ(
+			sparseMatrix.getCSCNumMatrixElements(),
+			referenceSparseMatrix.getCSCNumMatrixElements()
+		);
+		for(
+			unsigned int n = 0;
+			n < referenceSparseMatrix.getNumColumns() + 1;
+			n++
+		){
+			EXPECT_EQ(
+				sparseMatrix.getCSCColumnPointers()[n],
+				referenceSparseMatrix.getCSCColumnPointers()[n]
+			);
+		}
+		for(
+			unsigned int n = 0;
+			n < referenceSparseMatrix.getCSCNumMatrixElements();
+			n++
+		){
+			EXPECT_EQ(
+				sparseMatrix.getCSCRows()[n],
+				referenceSparseMatrix.getCSCRows()[n]
+			);
+			EXPECT_EQ(
+				sparseMatrix.getCSCValues()[n],
+				referenceSparseMatrix.getCSCValues()[n]
+			);
+		}
+
+		//Index lists.
+		std::vector<Index> indices = hoppingAmplitudeSet->getIndexList(
+			{{IDX_ALL, 1}}
+		);
+		ASSERT_EQ(indices.size(), 3);
+		EXPECT_TRUE(indices[0].equals({0, 1}));
+		EXPECT_TRUE(indices[1].equals({1, 1}));
+		EXPECT_TRUE(indices[2].equals({2, 1}));
+	}
+
+	//Serialization.
+	HoppingAmplitudeSet hoppingAmplitudeSet3;
+	hoppingAmplitudeSet3.add(HoppingAmplitude(1, {0}, {1}));
+	hoppingAmplitudeSet3.add(HoppingAmplitude(2, {1}, {0}));
+	hoppingAmplitudeSet3.setUseCompactStorage(true);
+	hoppingAmplitudeSet3.construct();
+	HoppingAmplitudeSet deserialized(
+		hoppingAmplitudeSet3.serialize(Serializable::Mode::JSON),
+		Serializable::Mode::JSON
+	);
+	EXPECT_EQ(deserialized.getHoppingAmplitudes({0}).size(), 1);
+	EXPECT_EQ(deserialized.getHoppingAmplitudes({1}).size(), 1);
+	EXPECT_EQ(
+		deserialized.getHoppingAmplitudes({1})[0].getAmplitude(),
+		std::complex<double>(1)
+	);
+
+	//The HoppingAmplitudes are not available as vectors.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet0.getHoppingAmplitudes({0, 0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EQ(hoppingAmplitudeSet2.getHoppingAmplitudes({0, 0}).size(), 2);
+
+	//The HoppingAmplitudes cannot be modified through an Iterator.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet0.begin();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet0.begin({1});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Modifications through an Iterator are kept once the compact storage
+	//has been turned off.
+	hoppingAmplitudeSet0.setUseCompactStorage(false);
+	HoppingAmplitudeSet::Iterator iterator = hoppingAmplitudeSet0.begin();
+	*iterator = HoppingAmplitude(
+		10,
+		(*iterator).getToIndex(),
+		(*iterator).getFromIndex()
+	);
+	EXPECT_EQ(
+		(*hoppingAmplitudeSet0.cbegin()).getAmplitude(),
+		std::complex<double>(10)
+	);
+}
+
+TEST(HoppingAmplitudeSet, getUseCompactStorage){
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	EXPECT_FALSE(hoppingAmplitudeSet.getUseCompactStorage());
+	hoppingAmplitudeSet.setUseCompactStorage(true);
+	EXPECT_TRUE(hoppingAmplitudeSet.getUseCompactStorage());
+}
+
 TEST(HoppingAmplitudeSet, getIndexList){
 	HoppingAmplitudeSet hoppingAmplitudeSet;
 	hoppingAmplitudeSet.add(HoppingAmplitude(1, {0, 0, 0}, {0, 0, 0}));
@@ -500,8 +975,11 @@ TEST(HoppingAmplitudeSet, getSparseMatrix){
 	hoppingAmplitudeSet.add(HoppingAmplitude(5, {3}, {4}));
 	hoppingAmplitudeSet.construct();
 
+	//The matrix is not cached in the HoppingAmplitudeSet.
+	unsigned int sizeInBytes = hoppingAmplitudeSet.getSizeInBytes();
 	SparseMatrix<std::complex<double>> sparseMatrix
 		= hoppingAmplitudeSet.getSparseMatrix();
+	EXPECT_EQ(hoppingAmplitudeSet.getSizeInBytes(), sizeInBytes);
 
 	ASSERT_EQ(sparseMatrix.getNumRows(), 5);
 	ASSERT_EQ(sparseMatrix.getNumColumns(), 5);
@@ -539,6 +1017,351 @@ TEST(HoppingAmplitudeSet, getSparseMatrix){
 	EXPECT_DOUBLE_EQ(imag(values[4]), 0);
 }
 
+class ScaledCompactStorageCallback : public CompactStorageCallback{
+public:
+	double scale = 1;
+
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		return scale*CompactStorageCallback::getHoppingAmplitude(
+			to,
+			from
+		);
+	}
+};
+
+void expectSparseMatrixEquals(
+	const HoppingAmplitudeSet &hoppingAmplitudeSet,
+	const SparseMatrix<std::complex<double>> &sparseMatrix,
+	SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+){
+	unsigned int basisSize = hoppingAmplitudeSet.getBasisSize();
+	std::vector<std::vector<std::complex<double>>> reference(
+		basisSize,
+		std::vector<std::complex<double>>(basisSize, 0)
+	);
+	for(
+		HoppingAmplitudeSet::ConstIterator iterator
+			= hoppingAmplitudeSet.cbegin();
+		iterator != hoppingAmplitudeSet.cend();
+		++iterator
+	){
+		reference[
+			hoppingAmplitudeSet.getBasisIndex(
+				(*iterator).getToIndex()
+			)
+		][
+			hoppingAmplitudeSet.getBasisIndex(
+				(*iterator).getFromIndex()
+			)
+		] += (*iterator).getAmplitude();
+	}
+
+	ASSERT_EQ(sparseMatrix.getNumRows(), basisSize);
+	ASSERT_EQ(sparseMatrix.getNumColumns(), basisSize);
+	std::vector<std::vector<std::complex<double>>> result(
+		basisSize,
+		std::vector<std::complex<double>>(basisSize, 0)
+	);
+	if(storageFormat == SparseMatrix<std::complex<double>>::StorageFormat::CSR){
+		const unsigned int *rowPointers
+			= sparseMatrix.getCSRRowPointers();
+		const unsigned int *columns = sparseMatrix.getCSRColumns();
+		const std::complex<double> *values
+			= sparseMatrix.getCSRValues();
+		for(unsigned int row = 0; row < basisSize; row++){
+			for(
+				unsigned int n = rowPointers[row];
+				n < rowPointers[row+1];
+				n++
+			){
+				result[row][columns[n]] += values[n];
+			}
+		}
+	}
+	else{
+		const unsigned int *columnPointers
+			= sparseMatrix.getCSCColumnPointers();
+		const unsigned int *rows = sparseMatrix.getCSCRows();
+		const std::complex<double> *values
+			= sparseMatrix.getCSCValues();
+		for(unsigned int column = 0; column < basisSize; column++){
+			for(
+				unsigned int n = columnPointers[column];
+				n < columnPointers[column+1];
+				n++
+			){
+				result[rows[n]][column] += values[n];
+			}
+		}
+	}
+
+	for(unsigned int row = 0; row < basisSize; row++){
+		for(unsigned int column = 0; column < basisSize; column++){
+			EXPECT_DOUBLE_EQ(
+				real(result[row][column]),
+				real(reference[row][column])
+			);
+			EXPECT_DOUBLE_EQ(
+				imag(result[row][column]),
+				imag(reference[row][column])
+			);
+		}
+	}
+}
+
+TEST(HoppingAmplitudeSet, getSparseMatrixStorageFormat){
+	for(unsigned int n = 0; n < 2; n++){
+		ScaledCompactStorageCallback callback;
+		HoppingAmplitudeSet hoppingAmplitudeSet
+			= createCompactStorageTestSet(callback);
+		hoppingAmplitudeSet.setUseCompactStorage(n == 1);
+		hoppingAmplitudeSet.construct();
+
+		for(unsigned int c = 0; c < 2; c++){
+			SparseMatrix<std::complex<double>>::StorageFormat
+				storageFormat = (c == 0)
+				? SparseMatrix<
+					std::complex<double>
+				>::StorageFormat::CSR
+				: SparseMatrix<
+					std::complex<double>
+				>::StorageFormat::CSC;
+
+			callback.scale = 1;
+			const SparseMatrix<std::complex<double>> &sparseMatrix
+				= hoppingAmplitudeSet.getSparseMatrix(
+					storageFormat
+				);
+			expectSparseMatrixEquals(
+				hoppingAmplitudeSet,
+				sparseMatrix,
+				storageFormat
+			);
+
+			//The cached matrix is reused and the callback
+			//dependent matrix elements are reevaluated.
+			callback.scale = 2;
+			EXPECT_EQ(
+				&hoppingAmplitudeSet.getSparseMatrix(
+					storageFormat
+				),
+				&sparseMatrix
+			);
+			expectSparseMatrixEquals(
+				hoppingAmplitudeSet,
+				sparseMatrix,
+				storageFormat
+			);
+		}
+
+		//The cache is cleared when the storage mode changes.
+		unsigned int sizeInBytes = hoppingAmplitudeSet.getSizeInBytes();
+		hoppingAmplitudeSet.setUseCompactStorage(n == 0);
+		hoppingAmplitudeSet.setUseCompactStorage(n == 1);
+		EXPECT_LT(hoppingAmplitudeSet.getSizeInBytes(), sizeInBytes);
+		expectSparseMatrixEquals(
+			hoppingAmplitudeSet,
+			hoppingAmplitudeSet.getSparseMatrix(
+				SparseMatrix<std::complex<double>>::StorageFormat::CSR
+			),
+			SparseMatrix<std::complex<double>>::StorageFormat::CSR
+		);
+	}
+
+	//Fail if the HoppingAmplitudeSet is not constructed.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			HoppingAmplitudeSet hoppingAmplitudeSet;
+			hoppingAmplitudeSet.add(HoppingAmplitude(1, {0}, {0}));
+			hoppingAmplitudeSet.getSparseMatrix(
+				SparseMatrix<std::complex<double>>::StorageFormat::CSR
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(HoppingAmplitudeSet, getSparseMatrixNonConstIterator){
+	ScaledCompactStorageCallback callback;
+	HoppingAmplitudeSet hoppingAmplitudeSet
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet.construct();
+
+	for(unsigned int c = 0; c < 2; c++){
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+			= (c == 0)
+			? SparseMatrix<std::complex<double>>::StorageFormat::CSR
+			: SparseMatrix<std::complex<double>>::StorageFormat::CSC;
+
+		const SparseMatrix<std::complex<double>> &sparseMatrix
+			= hoppingAmplitudeSet.getSparseMatrix(storageFormat);
+
+		//The cached matrix is kept when the HoppingAmplitudes are only
+		//read through a non-const Iterator.
+		unsigned int numHoppingAmplitudes = 0;
+		for(
+			HoppingAmplitudeSet::Iterator iterator
+				= hoppingAmplitudeSet.begin();
+			iterator != hoppingAmplitudeSet.end();
+			++iterator
+		){
+			numHoppingAmplitudes++;
+		}
+		EXPECT_EQ(numHoppingAmplitudes, 15);
+		EXPECT_EQ(
+			&hoppingAmplitudeSet.getSparseMatrix(storageFormat),
+			&sparseMatrix
+		);
+		expectSparseMatrixEquals(
+			hoppingAmplitudeSet,
+			sparseMatrix,
+			storageFormat
+		);
+
+		//Modified amplitudes are picked up without regenerating the
+		//cache.
+		for(
+			HoppingAmplitudeSet::Iterator iterator
+				= hoppingAmplitudeSet.begin();
+			iterator != hoppingAmplitudeSet.end();
+			++iterator
+		){
+			if((*iterator).getIsCallbackDependent())
+				continue;
+
+			*iterator = HoppingAmplitude(
+				(*iterator).getAmplitude() + 10.,
+				(*iterator).getToIndex(),
+				(*iterator).getFromIndex()
+			);
+		}
+		EXPECT_EQ(
+			&hoppingAmplitudeSet.getSparseMatrix(storageFormat),
+			&sparseMatrix
+		);
+		expectSparseMatrixEquals(
+			hoppingAmplitudeSet,
+			sparseMatrix,
+			storageFormat
+		);
+	}
+
+	//The cache is regenerated if a HoppingAmplitude is made callback
+	//dependent through a non-const Iterator.
+	HoppingAmplitudeSet::Iterator iterator = hoppingAmplitudeSet.begin();
+	while((*iterator).getIsCallbackDependent())
+		++iterator;
+	*iterator = HoppingAmplitude(
+		callback,
+		(*iterator).getToIndex(),
+		(*iterator).getFromIndex()
+	);
+	callback.scale = 3;
+	for(unsigned int c = 0; c < 2; c++){
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+			= (c == 0)
+			? SparseMatrix<std::complex<double>>::StorageFormat::CSR
+			: SparseMatrix<std::complex<double>>::StorageFormat::CSC;
+		expectSparseMatrixEquals(
+			hoppingAmplitudeSet,
+			hoppingAmplitudeSet.getSparseMatrix(storageFormat),
+			storageFormat
+		);
+	}
+}
+
+TEST(HoppingAmplitudeSet, getSparseMatrixRevision){
+	ScaledCompactStorageCallback callback;
+	HoppingAmplitudeSet hoppingAmplitudeSet
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet.construct();
+	const SparseMatrix<std::complex<double>>::StorageFormat CSR
+		= SparseMatrix<std::complex<double>>::StorageFormat::CSR;
+
+	hoppingAmplitudeSet.getSparseMatrix(CSR);
+	unsigned long long revision0
+		= hoppingAmplitudeSet.getSparseMatrixRevision(CSR);
+
+	//The revision is unchanged as long as the matrix is unchanged.
+	hoppingAmplitudeSet.getSparseMatrix(CSR);
+	EXPECT_EQ(hoppingAmplitudeSet.getSparseMatrixRevision(CSR), revision0);
+
+	//The revision changes when a callback value changes.
+	callback.scale = 2;
+	hoppingAmplitudeSet.getSparseMatrix(CSR);
+	unsigned long long revision1
+		= hoppingAmplitudeSet.getSparseMatrixRevision(CSR);
+	EXPECT_NE(revision1, revision0);
+
+	//The revision changes when the amplitudes may have been modified
+	//through a non-const Iterator.
+	hoppingAmplitudeSet.begin();
+	hoppingAmplitudeSet.getSparseMatrix(CSR);
+	unsigned long long revision2
+		= hoppingAmplitudeSet.getSparseMatrixRevision(CSR);
+	EXPECT_NE(revision2, revision1);
+
+	//The revision changes when the cache is regenerated.
+	hoppingAmplitudeSet.setUseCompactStorage(true);
+	hoppingAmplitudeSet.getSparseMatrix(CSR);
+	EXPECT_NE(hoppingAmplitudeSet.getSparseMatrixRevision(CSR), revision2);
+}
+
+TEST(HoppingAmplitudeSet, getSparseMatrixConcurrently){
+	ScaledCompactStorageCallback callback;
+	HoppingAmplitudeSet hoppingAmplitudeSet
+		= createCompactStorageTestSet(callback);
+	hoppingAmplitudeSet.construct();
+
+	const SparseMatrix<std::complex<double>> &reference
+		= hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<std::complex<double>>::StorageFormat::CSR
+		);
+	std::vector<std::complex<double>> referenceValues(
+		reference.getCSRValues(),
+		reference.getCSRValues() + reference.getCSRNumMatrixElements()
+	);
+
+	//Every thread receives the same cached matrix and can read it while
+	//other threads call getSparseMatrix(), since the callback dependent
+	//matrix elements are only written to when their values change.
+	const unsigned int NUM_CALLS = 64;
+	std::vector<const SparseMatrix<std::complex<double>>*> sparseMatrices(
+		NUM_CALLS
+	);
+	std::vector<bool> valuesAreUnchanged(NUM_CALLS);
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < NUM_CALLS; n++){
+		sparseMatrices[n] = &hoppingAmplitudeSet.getSparseMatrix(
+			SparseMatrix<std::complex<double>>::StorageFormat::CSR
+		);
+		bool isUnchanged = true;
+		for(unsigned int c = 0; c < referenceValues.size(); c++){
+			if(
+				sparseMatrices[n]->getCSRValues()[c]
+				!= referenceValues[c]
+			){
+				isUnchanged = false;
+			}
+		}
+		valuesAreUnchanged[n] = isUnchanged;
+	}
+	for(unsigned int n = 0; n < NUM_CALLS; n++){
+		EXPECT_EQ(sparseMatrices[n], &reference);
+		EXPECT_TRUE(valuesAreUnchanged[n]);
+	}
+	expectSparseMatrixEquals(
+		hoppingAmplitudeSet,
+		*sparseMatrices[0],
+		SparseMatrix<std::complex<double>>::StorageFormat::CSR
+	);
+}
+
 TEST(HoppingAmplitudeSet, serialize){
 	//Already tested through serializeToJSON
 }
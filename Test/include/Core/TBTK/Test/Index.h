@@ -3,6 +3,8 @@
 #include "gtest/gtest.h"
 
 #include <sstream>
+#include <unordered_set>
+#include <vector>
 
 namespace TBTK{
 
@@ -59,6 +61,49 @@ TEST(Index, CopyConstructor){
 	EXPECT_EQ(indexCopy[2], 3) << "Copy constructor failed.";
 }
 
+TEST(Index, CopyConstructorLarge){
+	Index index({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+	Index indexCopy = index;
+	EXPECT_TRUE(indexCopy.equals({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+	indexCopy[0] = 0;
+	EXPECT_EQ(index[0], 1);
+}
+
+TEST(Index, MoveConstructor){
+	Index index({1, 2, 3});
+	Index indexMoved = std::move(index);
+	EXPECT_TRUE(indexMoved.equals({1, 2, 3}));
+
+	Index largeIndex({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+	Index largeIndexMoved = std::move(largeIndex);
+	EXPECT_TRUE(
+		largeIndexMoved.equals({1, 2, 3, 4, 5, 6, 7, 8, 9, 10})
+	);
+}
+
+TEST(Index, operatorAssignment){
+	Index index({1, 2, 3});
+	Index largeIndex({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+	Index index0({4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+	index0 = index;
+	EXPECT_TRUE(index0.equals({1, 2, 3}));
+
+	Index index1({4, 5});
+	index1 = largeIndex;
+	EXPECT_TRUE(index1.equals({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
+TEST(Index, operatorMoveAssignment){
+	Index index0({4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+	index0 = Index({1, 2, 3});
+	EXPECT_TRUE(index0.equals({1, 2, 3}));
+
+	Index index1({4, 5});
+	index1 = Index({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+	EXPECT_TRUE(index1.equals({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
 //TBTKFeature Core.Index.Construction.4 2019-09-19
 TEST(Index, ConstructorConcatenationInitializerList){
 	std::string errorMessage = "Index concatenation filed.";
@@ -275,6 +320,15 @@ TEST(Index, pushBack){
 	EXPECT_TRUE(index.equals({1, 2, 3})) << "push_back failed.";
 }
 
+TEST(Index, pushBackBeyondInlineCapacity){
+	Index index;
+	for(int n = 0; n < 20; n++)
+		index.pushBack(n);
+	ASSERT_EQ(index.getSize(), 20);
+	for(int n = 0; n < 20; n++)
+		EXPECT_EQ(index[n], n);
+}
+
 //TBTKFeature Core.Index.popFront.1 2019-09-19
 TEST(Index, popFront){
 	std::string errorMessage = "popFront() failed.";
@@ -298,6 +352,10 @@ TEST(Index, insert){
 	Index index({1, 3});
 	index.insert(1, 2);
 	EXPECT_TRUE(index.equals({1, 2, 3}));
+
+	Index largeIndex({1, 2, 3, 4, 5, 6, 7, 9});
+	largeIndex.insert(7, 8);
+	EXPECT_TRUE(largeIndex.equals({1, 2, 3, 4, 5, 6, 7, 8, 9}));
 }
 
 //TBTKFeatre Core.Index.erase.1 2019-10-28
@@ -329,6 +387,32 @@ TEST(Index, split){
 	ASSERT_TRUE(indices[2].equals({6, 7, 8}));
 }
 
+TEST(Index, getNumComponents){
+	EXPECT_EQ(Index().getNumComponents(), 1);
+	EXPECT_EQ(Index({1, 2, 3}).getNumComponents(), 1);
+	EXPECT_EQ(
+		Index({{1, 2, 3}, {4, 5}, {6, 7, 8}}).getNumComponents(),
+		3
+	);
+}
+
+TEST(Index, getComponent){
+	Index index({{1, 2, 3}, {4, 5}, {6, 7, 8}});
+	EXPECT_TRUE(index.getComponent(0).equals({1, 2, 3}));
+	EXPECT_TRUE(index.getComponent(1).equals({4, 5}));
+	EXPECT_TRUE(index.getComponent(2).equals({6, 7, 8}));
+	EXPECT_TRUE(Index({1, 2}).getComponent(0).equals({1, 2}));
+
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			index.getComponent(3);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 TEST(Index, isPatternIndex){
 	std::string errorMessage = "isPatternIndex() failed.";
 
@@ -428,8 +512,51 @@ TEST(Index, operatorGreaterThan){
 	);
 }
 
+TEST(Index, operatorEqualAndNotEqual){
+	EXPECT_TRUE(Index({1, 2, 3}) == Index({1, 2, 3}));
+	EXPECT_FALSE(Index({1, 2, 3}) == Index({1, 2}));
+	EXPECT_FALSE(Index({1, 2, 3}) != Index({1, 2, 3}));
+	EXPECT_TRUE(Index({1, 2, 3}) != Index({1, 2, 4}));
+}
+
+TEST(Index, getHash){
+	EXPECT_EQ(Index({1, 2, 3}).getHash(), Index({1, 2, 3}).getHash());
+	EXPECT_NE(Index({1, 2, 3}).getHash(), Index({1, 2, 4}).getHash());
+	EXPECT_NE(Index({1, 2, 3}).getHash(), Index({3, 2, 1}).getHash());
+	EXPECT_NE(Index({1, 2}).getHash(), Index({1, 2, 0}).getHash());
+
+	std::unordered_set<Index> indices;
+	indices.insert({1, 2, 3});
+	indices.insert({1, 2, 3});
+	indices.insert({1, 2, 3, 4, 5, 6, 7, 8, 9});
+	EXPECT_EQ(indices.size(), 2);
+	EXPECT_EQ(indices.count({1, 2, 3}), 1);
+	EXPECT_EQ(indices.count({1, 2, 4}), 0);
+}
+
+TEST(Index, hashSubindices){
+	std::vector<int> subindices = {7, 1, 2, 3, 7};
+	EXPECT_EQ(
+		Index::hashSubindices(subindices, 1, 3),
+		Index({1, 2, 3}).getHash()
+	);
+	EXPECT_EQ(Index::hashSubindices(subindices, 0, 0), Index().getHash());
+
+	//Subindices that only differ in the high bits are spread over the low
+	//bits of the hash.
+	std::unordered_set<std::size_t> lowBits;
+	for(int n = 0; n < 256; n++)
+		lowBits.insert(Index({0, 256*n}).getHash()&0xFF);
+	EXPECT_GT(lowBits.size(), 128);
+}
+
 TEST(Index, getSizeInBytes){
 	EXPECT_TRUE(Index().getSizeInBytes() > 0) << "getSizeInBytes() failed.";
+	EXPECT_EQ(Index().getSizeInBytes(), Index({1, 2, 3}).getSizeInBytes());
+	EXPECT_TRUE(
+		Index({1, 2, 3, 4, 5, 6, 7, 8, 9}).getSizeInBytes()
+		> Index().getSizeInBytes()
+	);
 }
 
 };
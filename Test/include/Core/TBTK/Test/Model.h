@@ -214,6 +214,41 @@ TEST(Model, operatorMoveAssignment){
 TEST(Model, add){
 }
 
+TEST(Model, addConcurrently){
+	const int SIZE = 20;
+	Model model;
+	model.setVerbose(false);
+	#pragma omp parallel for
+	for(int x = 0; x < SIZE; x++){
+		model.addConcurrently(HoppingAmplitude(x, {x}, {x}));
+		if(x+1 < SIZE)
+			model.addConcurrently(HoppingAmplitude(-1, {x+1}, {x}) + HC);
+	}
+	model.construct();
+
+	EXPECT_EQ(model.getBasisSize(), SIZE);
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= model.getHoppingAmplitudeSet();
+	for(int x = 0; x < SIZE; x++){
+		EXPECT_EQ(model.getBasisIndex({x}), x);
+		const std::vector<HoppingAmplitude> &hoppingAmplitudes
+			= hoppingAmplitudeSet.getHoppingAmplitudes({x});
+		unsigned int expectedSize = 3;
+		if(x == 0 || x == SIZE-1)
+			expectedSize = 2;
+		EXPECT_EQ(hoppingAmplitudes.size(), expectedSize);
+
+		//The HoppingAmplitudes in each leaf node are ordered with
+		//respect to the to-Indices.
+		for(unsigned int n = 1; n < hoppingAmplitudes.size(); n++){
+			EXPECT_LT(
+				hoppingAmplitudes[n-1].getToIndex()[0],
+				hoppingAmplitudes[n].getToIndex()[0]
+			);
+		}
+	}
+}
+
 TEST(Model, addModel){
 	Model model0;
 	model0 << HoppingAmplitude(0, {0}, {0});
@@ -301,6 +336,14 @@ TEST(Model, destructCOO){
 TEST(Model, reconstructCOO){
 }
 
+TEST(Model, setUseCompactStorage){
+	Model model;
+	model.setUseCompactStorage(true);
+	EXPECT_TRUE(model.getHoppingAmplitudeSet().getUseCompactStorage());
+	model.setUseCompactStorage(false);
+	EXPECT_FALSE(model.getHoppingAmplitudeSet().getUseCompactStorage());
+}
+
 TEST(Model, setTemperature){
 	Model model;
 	model.setTemperature(100);
@@ -4,6 +4,10 @@
 #include "TBTK/UnitHandler.h"
 #include <cmath>
 
+#ifdef TBTK_USE_MPI
+#	include <mpi.h>
+#endif
+
 #include "gtest/gtest.h"
 
 namespace TBTK{
@@ -55,6 +59,189 @@ const double CHEMICAL_POTENTIAL = 1;
 TEST(BlockDiagonalizer, Constructor0){
 }
 
+//Helper function that creates a Model with spinful blocks of different
+//sizes. Used to test distributed execution.
+Model createDistributedModel(){
+	Model model;
+	model.setVerbose(false);
+	for(int k = 0; k < 7; k++){
+		for(int x = 0; x < k + 2; x++){
+			for(int s = 0; s < 2; s++){
+				model << HoppingAmplitude(
+					0.1*x + 0.3*k + 0.5*s - 1,
+					{k, x, s},
+					{k, x, s}
+				);
+				if(x + 1 < k + 2){
+					model << HoppingAmplitude(
+						-1,
+						{k, x + 1, s},
+						{k, x, s}
+					) + HC;
+				}
+			}
+			model << HoppingAmplitude(
+				std::complex<double>(0.2, 0.1),
+				{k, x, 1},
+				{k, x, 0}
+			) + HC;
+		}
+	}
+	model.construct();
+	model.setChemicalPotential(0.5);
+
+	return model;
+}
+
+TEST(BlockDiagonalizer, setDistributedReduction){
+#ifdef TBTK_USE_MPI
+	Model model = createDistributedModel();
+
+	Solver::BlockDiagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	Solver::BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setDistributedExecution(true);
+	solver.run();
+
+	BlockDiagonalizer referencePropertyExtractor;
+	referencePropertyExtractor.setSolver(referenceSolver);
+	referencePropertyExtractor.setEnergyWindow(-5, 5, 100);
+	BlockDiagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(-5, 5, 100);
+
+	//Every process receives the full Properties.
+	propertyExtractor.setDistributedReduction(
+		BlockDiagonalizer::DistributedReduction::All
+	);
+	std::vector<double> eigenValues
+		= propertyExtractor.getEigenValues().getData();
+	std::vector<double> referenceEigenValues
+		= referencePropertyExtractor.getEigenValues().getData();
+	for(unsigned int n = 0; n < eigenValues.size(); n++)
+		EXPECT_NEAR(eigenValues[n], referenceEigenValues[n], EPSILON_100);
+
+	std::vector<double> dos = propertyExtractor.calculateDOS().getData();
+	std::vector<double> referenceDOS
+		= referencePropertyExtractor.calculateDOS().getData();
+	for(unsigned int n = 0; n < dos.size(); n++)
+		EXPECT_NEAR(dos[n], referenceDOS[n], EPSILON_100);
+
+	std::vector<double> density = propertyExtractor.calculateDensity(
+		{{IDX_ALL, IDX_ALL, IDX_ALL}}
+	).getData();
+	std::vector<double> referenceDensity
+		= referencePropertyExtractor.calculateDensity(
+			{{IDX_ALL, IDX_ALL, IDX_ALL}}
+		).getData();
+	ASSERT_EQ(density.size(), referenceDensity.size());
+	for(unsigned int n = 0; n < density.size(); n++)
+		EXPECT_NEAR(density[n], referenceDensity[n], EPSILON_10000);
+
+	std::vector<SpinMatrix> magnetization
+		= propertyExtractor.calculateMagnetization(
+			{{IDX_ALL, IDX_ALL, IDX_SPIN}}
+		).getData();
+	std::vector<SpinMatrix> referenceMagnetization
+		= referencePropertyExtractor.calculateMagnetization(
+			{{IDX_ALL, IDX_ALL, IDX_SPIN}}
+		).getData();
+	ASSERT_EQ(magnetization.size(), referenceMagnetization.size());
+	for(unsigned int n = 0; n < magnetization.size(); n++){
+		for(unsigned int row = 0; row < 2; row++){
+			for(unsigned int col = 0; col < 2; col++){
+				EXPECT_NEAR(
+					std::abs(
+						magnetization[n].at(row, col)
+						- referenceMagnetization[n].at(
+							row,
+							col
+						)
+					),
+					0,
+					EPSILON_10000
+				);
+			}
+		}
+	}
+
+	std::vector<double> ldos = propertyExtractor.calculateLDOS(
+		{{IDX_ALL, IDX_ALL, IDX_ALL}}
+	).getData();
+	std::vector<double> referenceLDOS
+		= referencePropertyExtractor.calculateLDOS(
+			{{IDX_ALL, IDX_ALL, IDX_ALL}}
+		).getData();
+	ASSERT_EQ(ldos.size(), referenceLDOS.size());
+	for(unsigned int n = 0; n < ldos.size(); n++)
+		EXPECT_NEAR(ldos[n], referenceLDOS[n], EPSILON_10000);
+
+	EXPECT_NEAR(
+		std::abs(
+			propertyExtractor.calculateExpectationValue(
+				{6, 1, 1},
+				{6, 1, 0}
+			) - referencePropertyExtractor.calculateExpectationValue(
+				{6, 1, 1},
+				{6, 1, 0}
+			)
+		),
+		0,
+		EPSILON_10000
+	);
+
+	//Only the root process receives the full Property. The other
+	//processes keep their own contribution.
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	propertyExtractor.setDistributedReduction(
+		BlockDiagonalizer::DistributedReduction::Root
+	);
+	dos = propertyExtractor.calculateDOS().getData();
+	if(rank == 0){
+		for(unsigned int n = 0; n < dos.size(); n++)
+			EXPECT_NEAR(dos[n], referenceDOS[n], EPSILON_100);
+	}
+
+	//Every process keeps its own contribution, which sum up to the full
+	//Property.
+	propertyExtractor.setDistributedReduction(
+		BlockDiagonalizer::DistributedReduction::None
+	);
+	dos = propertyExtractor.calculateDOS().getData();
+	MPI_Allreduce(
+		MPI_IN_PLACE,
+		dos.data(),
+		dos.size(),
+		MPI_DOUBLE,
+		MPI_SUM,
+		MPI_COMM_WORLD
+	);
+	for(unsigned int n = 0; n < dos.size(); n++)
+		EXPECT_NEAR(dos[n], referenceDOS[n], EPSILON_100);
+#endif
+}
+
+TEST(BlockDiagonalizer, getDistributedReduction){
+	BlockDiagonalizer propertyExtractor;
+	EXPECT_EQ(
+		propertyExtractor.getDistributedReduction(),
+		BlockDiagonalizer::DistributedReduction::All
+	);
+	propertyExtractor.setDistributedReduction(
+		BlockDiagonalizer::DistributedReduction::Root
+	);
+	EXPECT_EQ(
+		propertyExtractor.getDistributedReduction(),
+		BlockDiagonalizer::DistributedReduction::Root
+	);
+}
+
 TEST(BlockDiagonalizer, setEnergyWindowReal){
 	//Not testable on its own.
 }
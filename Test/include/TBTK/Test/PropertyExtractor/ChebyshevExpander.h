@@ -16,6 +16,34 @@ const double CHEMICAL_POTENTIAL = 1;
 //TODO
 //Add tests for most functions.
 
+TEST(ChebyshevExpander, calculateDOS){
+	const unsigned int SIZE = 10;
+	Model model;
+	for(unsigned int n = 0; n < SIZE; n++)
+		model << HoppingAmplitude(-1, {n}, {(n+1)%SIZE}) + HC;
+	model.construct();
+
+	Solver::ChebyshevExpander solver;
+	solver.setModel(model);
+	const double SCALE_FACTOR = 10;
+	solver.setScaleFactor(SCALE_FACTOR);
+
+	ChebyshevExpander propertyExtractor(solver);
+	const double LOWER_BOUND = -SCALE_FACTOR*0.9;
+	const double UPPER_BOUND = SCALE_FACTOR*0.9;
+	const unsigned int RESOLUTION = 1000;
+	propertyExtractor.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, RESOLUTION);
+
+	//The random phase vectors have unit length elements, which means that
+	//the DOS integrates to the number of states.
+	Property::DOS dos = propertyExtractor.calculateDOS();
+	double dE = dos.getDeltaE();
+	double integratedDOS = 0;
+	for(unsigned int n = 0; n < dos.getResolution(); n++)
+		integratedDOS += dos(n)*dE;
+	EXPECT_NEAR(integratedDOS, SIZE, 0.01);
+}
+
 TEST(ChebyshevExpander, calculateLDOS0){
 	const unsigned int SIZE = 10;
 	Model model;
@@ -487,6 +487,51 @@ TEST(Diagonalizer, calculateDensity){
 		EXPECT_NEAR(density1(n), densityBenchmark, EPSILON_100);
 }
 
+TEST(Diagonalizer, calculateDensityEigenVectorsMissing){
+	SETUP_MODEL();
+	Solver::Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setEigenVectorWindow(-1, 1);
+	solver.run();
+
+	Diagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+
+	//Fail since the density requires all eigenvectors.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			propertyExtractor.calculateDensity({{IDX_ALL}});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, calculateDensityEigenValueWindow){
+	SETUP_MODEL();
+	Solver::Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Solver::Diagonalizer::Algorithm::MRRR);
+	solver.setEigenValueWindow(-1, 1);
+	solver.run();
+
+	Diagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+
+	//Fail since the density requires the full spectrum.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			propertyExtractor.calculateDensity({{IDX_ALL}});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 //TODO
 //...
 TEST(Diagonalizer, calculateMagnetization){
@@ -534,6 +579,65 @@ TEST(Diagonalizer, calculateLDOS){
 
 //TODO
 //...
+TEST(Diagonalizer, calculateLDOSEigenVectorWindow){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+	const double LOWER_BOUND = -1;
+	const double UPPER_BOUND = 1;
+	const int RESOLUTION = 100;
+
+	Diagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+	Property::LDOS ldos0 = propertyExtractor.calculateLDOS({{IDX_ALL}});
+
+	//Check that the LDOS is the same when only the eigenvectors in the
+	//energy window are calculated.
+	Solver::Diagonalizer windowedSolver;
+	windowedSolver.setVerbose(false);
+	windowedSolver.setModel(model);
+	windowedSolver.setEigenVectorWindow(LOWER_BOUND, UPPER_BOUND);
+	windowedSolver.run();
+
+	Diagonalizer windowedPropertyExtractor;
+	windowedPropertyExtractor.setSolver(windowedSolver);
+	windowedPropertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+	Property::LDOS ldos1
+		= windowedPropertyExtractor.calculateLDOS({{IDX_ALL}});
+	for(unsigned int n = 0; n < RESOLUTION; n++){
+		for(int x = 0; x < SIZE; x++){
+			EXPECT_NEAR(
+				ldos1({x}, n),
+				ldos0({x}, n),
+				EPSILON_10000
+			);
+		}
+	}
+
+	//Fail if the energy window is larger than the eigenvector window.
+	windowedPropertyExtractor.setEnergyWindow(
+		2*LOWER_BOUND,
+		2*UPPER_BOUND,
+		RESOLUTION
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			windowedPropertyExtractor.calculateLDOS({{IDX_ALL}});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 TEST(Diagonalizer, calculateSpinPolarizedLDOS){
 }
 
@@ -8,6 +8,7 @@
 #include "gtest/gtest.h"
 
 #include <complex>
+#include <typeinfo>
 
 namespace TBTK{
 namespace PropertyExtractor{
@@ -18,6 +19,8 @@ const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
 //Helper class that exposes the PropertyExtractors protected functions.
 class PublicPropertyExtractor : public PropertyExtractor{
 public:
+	typedef Information BaseInformation;
+
 	class PublicInformation : public Information{
 	public:
 		void setSpinIndex(int spinIndex){
@@ -27,6 +30,14 @@ public:
 		int getSpinIndex() const{
 			return Information::getSpinIndex();
 		}
+
+		virtual PublicInformation* clone() const{
+			return new PublicInformation(*this);
+		}
+	};
+
+	//Information that does not override Information::clone().
+	class UnclonableInformation : public Information{
 	};
 
 	const Range& getEnergyWindow() const{
@@ -63,7 +74,8 @@ public:
 		const Index &ranges,
 		int currentOffset,
 		int offsetMultiplier,
-		Information &information
+		Information &information,
+		bool callbackIsThreadSafe = false
 	){
 		PropertyExtractor::calculate(
 			callback,
@@ -72,7 +84,8 @@ public:
 			ranges,
 			currentOffset,
 			offsetMultiplier,
-			information
+			information,
+			callbackIsThreadSafe
 		);
 	}
 
@@ -88,14 +101,16 @@ public:
 		const IndexTree &allIndices,
 		const IndexTree &memoryLayout,
 		Property::AbstractProperty<DataType> &abstractProperty,
-		Information &information
+		Information &information,
+		bool callbackIsThreadSafe = false
 	){
 		PropertyExtractor::calculate(
 			callback,
 			allIndices,
 			memoryLayout,
 			abstractProperty,
-			information
+			information,
+			callbackIsThreadSafe
 		);
 	}
 
@@ -817,6 +832,113 @@ TEST(PropertyExtractor, calculateCustom){
 	}
 }
 
+TEST(PropertyExtractor, calculateRangesThreadSafeCallback){
+	PublicPropertyExtractor propertyExtractor;
+
+	//Check that the result is the same as for the serial calculation when
+	//the callback is called in parallel.
+	Property::LDOS ldos({2, 1, 3}, Range(-1, 1, 10));
+	for(unsigned int n = 0; n < ldos.getSize(); n++)
+		ldos.getDataRW()[n] = 0;
+	PublicPropertyExtractor::PublicInformation information;
+	propertyExtractor.calculate(
+		PublicPropertyExtractor::callbackRanges,
+		ldos,
+		{IDX_SUM_ALL, 2, IDX_X},
+		{2, 1, 3},
+		0,
+		10,
+		information,
+		true
+	);
+	for(unsigned int n = 0; n < 3*10; n++)
+		EXPECT_NEAR(ldos.getData()[n], n + (30 + n), EPSILON_100);
+}
+
+TEST(PropertyExtractor, calculateThreadSafeCallbackUnclonableInformation){
+	PublicPropertyExtractor propertyExtractor;
+
+	//Fail if the Information would be sliced when copied to the threads.
+	Property::LDOS ldos({2, 1, 3}, Range(-1, 1, 10));
+	PublicPropertyExtractor::UnclonableInformation information;
+	::testing::FLAGS_gtest_death_test_style = "threadsafe";
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			propertyExtractor.calculate(
+				PublicPropertyExtractor::callbackRanges,
+				ldos,
+				{IDX_SUM_ALL, 2, IDX_X},
+				{2, 1, 3},
+				0,
+				10,
+				information,
+				true
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	::testing::FLAGS_gtest_death_test_style = "fast";
+}
+
+TEST(PropertyExtractor, calculateCustomThreadSafeCallback){
+	PublicPropertyExtractor propertyExtractor;
+
+	//Setup the Indices for which to call the callback with.
+	IndexTree allIndices;
+	allIndices.add({1, 0, IDX_SPIN});
+	allIndices.add({1, 2, IDX_SPIN});
+	allIndices.add({2, IDX_SPIN});
+	allIndices.add({3, 1, IDX_SPIN});
+	allIndices.add({3, 2, IDX_SPIN});
+	allIndices.generateLinearMap();
+
+	//Setup the momory layout for the property.
+	IndexTree memoryLayout;
+	memoryLayout.add({1, 0, IDX_SPIN});
+	memoryLayout.add({1, 2, IDX_SPIN});
+	memoryLayout.add({2, IDX_SPIN});
+	memoryLayout.add({3, IDX_SUM_ALL, IDX_SPIN});
+	memoryLayout.generateLinearMap();
+
+	//Run the calculation both serially and in parallel. The spin index is
+	//checked by the callback.
+	Property::SpinPolarizedLDOS serial(memoryLayout, Range(-10, 10, 100));
+	Property::SpinPolarizedLDOS parallel(
+		memoryLayout,
+		Range(-10, 10, 100)
+	);
+	PublicPropertyExtractor::PublicInformation information;
+	propertyExtractor.calculate(
+		PublicPropertyExtractor::callbackCustom,
+		allIndices,
+		memoryLayout,
+		serial,
+		information
+	);
+	propertyExtractor.calculate(
+		PublicPropertyExtractor::callbackCustom,
+		allIndices,
+		memoryLayout,
+		parallel,
+		information,
+		true
+	);
+
+	//Check the results.
+	for(unsigned int n = 0; n < 400; n++){
+		for(unsigned int r = 0; r < 2; r++){
+			for(unsigned int c = 0; c < 2; c++){
+				EXPECT_EQ(
+					parallel(n).at(r, c),
+					serial(n).at(r, c)
+				);
+			}
+		}
+	}
+}
+
 TEST(PropertyExtractor, enureCompliantRanges){
 	PublicPropertyExtractor propertyExtractor;
 
@@ -1120,6 +1242,28 @@ TEST(PropertyExtractor, Information){
 	//Nothing to test.
 }
 
+TEST(PropertyExtractorInformation, clone){
+	PublicPropertyExtractor::PublicInformation information;
+	information.setSpinIndex(3);
+
+	//Check that the clone is a copy of the original.
+	PublicPropertyExtractor::PublicInformation *clone
+		= information.clone();
+	EXPECT_EQ(clone->getSpinIndex(), 3);
+	delete clone;
+
+	//Check that the clone has the dynamic type of the original when
+	//cloned through a reference to the base class.
+	const PublicPropertyExtractor::BaseInformation &base = information;
+	PublicPropertyExtractor::BaseInformation *baseClone = base.clone();
+	EXPECT_TRUE(
+		typeid(*baseClone)
+		== typeid(PublicPropertyExtractor::PublicInformation)
+	);
+	EXPECT_EQ(baseClone->getSpinIndex(), 3);
+	delete baseClone;
+}
+
 TEST(PropertyExtractorInformation, setSpinIndex){
 	//Tested through PropertyExtractorInformation::getSpinIndex.
 }
@@ -2,6 +2,13 @@
 
 #include "gtest/gtest.h"
 
+#include <fstream>
+#include <type_traits>
+
+#ifdef TBTK_USE_MPI
+#	include <mpi.h>
+#endif
+
 namespace TBTK{
 namespace Solver{
 
@@ -77,6 +84,298 @@ TEST(BlockDiagonalizer, run){
 	//Diagonalizer::getAmplitude
 }
 
+//Helper function that creates a Model with two blocks, each consisting of a
+//chain with complex hoppings and an on-site potential.
+Model createBlockModel(unsigned int size){
+	Model model;
+	model.setVerbose(false);
+	for(unsigned int k = 0; k < 2; k++){
+		for(unsigned int x = 0; x < size; x++){
+			model << HoppingAmplitude(0.1*x + k, {k, x}, {k, x});
+			if(x+1 < size){
+				model << HoppingAmplitude(
+					std::complex<double>(-1, 0.2),
+					{k, x+1},
+					{k, x}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+	return model;
+}
+
+TEST(BlockDiagonalizer, setEigenVectorMode){
+	Model model = createBlockModel(10);
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(unsigned int n = 0; n < 2; n++){
+		BlockDiagonalizer solver;
+		solver.setParallelExecution(n == 1);
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setEigenVectorMode(
+			BlockDiagonalizer::EigenVectorMode::None
+		);
+		solver.run();
+
+		//Check that the eigenvalues are calculated, but not the
+		//eigenvectors.
+		for(unsigned int state = 0; state < 20; state++){
+			EXPECT_NEAR(
+				solver.getEigenValue(state),
+				reference.getEigenValue(state),
+				1e-12
+			);
+			EXPECT_FALSE(solver.hasEigenVector(state));
+		}
+	}
+
+	//Fail for EigenVectorMode::Window.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			BlockDiagonalizer solver;
+			solver.setEigenVectorMode(
+				BlockDiagonalizer::EigenVectorMode::Window
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(BlockDiagonalizer, getEigenVectorMode){
+	BlockDiagonalizer solver;
+	EXPECT_TRUE(
+		solver.getEigenVectorMode()
+			== BlockDiagonalizer::EigenVectorMode::All
+	);
+	solver.setEigenVectorMode(BlockDiagonalizer::EigenVectorMode::None);
+	EXPECT_TRUE(
+		solver.getEigenVectorMode()
+			== BlockDiagonalizer::EigenVectorMode::None
+	);
+	solver.setEigenVectorWindow(-1, 1);
+	EXPECT_TRUE(
+		solver.getEigenVectorMode()
+			== BlockDiagonalizer::EigenVectorMode::Window
+	);
+}
+
+TEST(BlockDiagonalizer, setEigenVectorWindow){
+	Model model = createBlockModel(10);
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(unsigned int n = 0; n < 2; n++){
+		BlockDiagonalizer solver;
+		solver.setParallelExecution(n == 1);
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setEigenVectorWindow(-0.5, 1.5);
+		solver.run();
+
+		//Check that all eigenvalues are calculated, but only the
+		//eigenvectors inside the window.
+		unsigned int numEigenVectors = 0;
+		for(unsigned int state = 0; state < 20; state++){
+			EXPECT_NEAR(
+				solver.getEigenValue(state),
+				reference.getEigenValue(state),
+				1e-12
+			);
+
+			double eigenValue = reference.getEigenValue(state);
+			if(eigenValue <= -0.5 || eigenValue > 1.5){
+				EXPECT_FALSE(solver.hasEigenVector(state));
+				continue;
+			}
+			EXPECT_TRUE(solver.hasEigenVector(state));
+			numEigenVectors++;
+
+			std::complex<double> overlap = 0;
+			for(unsigned int k = 0; k < 2; k++){
+				for(unsigned int x = 0; x < 10; x++){
+					overlap += conj(
+						reference.getAmplitude(
+							state,
+							{k, x}
+						)
+					)*solver.getAmplitude(state, {k, x});
+				}
+			}
+			EXPECT_NEAR(abs(overlap), 1, 1e-12);
+		}
+		EXPECT_TRUE(numEigenVectors > 0);
+		EXPECT_TRUE(numEigenVectors < 20);
+	}
+}
+
+TEST(BlockDiagonalizer, setEigenVectorScratchFile){
+	const std::string FILENAME = "TBTKTestBlockDiagonalizer.bin";
+	Model model = createBlockModel(10);
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(unsigned int n = 0; n < 2; n++){
+		{
+			BlockDiagonalizer solver;
+			solver.setVerbose(false);
+			solver.setParallelExecution(n == 1);
+			solver.setModel(model);
+			solver.setEigenVectorScratchFile(FILENAME);
+			if(n == 1)
+				solver.setEigenVectorWindow(-0.5, 1.5);
+			solver.run();
+
+			//The eigenvectors are stored in the scratch file.
+			EXPECT_TRUE(std::ifstream(FILENAME).good());
+
+			for(unsigned int state = 0; state < 20; state++){
+				EXPECT_NEAR(
+					solver.getEigenValue(state),
+					reference.getEigenValue(state),
+					1e-12
+				);
+				if(!solver.hasEigenVector(state))
+					continue;
+
+				for(unsigned int x = 0; x < 10; x++){
+					Index index({(int)state/10, (int)x});
+					EXPECT_NEAR(
+						std::abs(
+							solver.getAmplitude(
+								state,
+								index
+							)
+						),
+						std::abs(
+							reference.getAmplitude(
+								state,
+								index
+							)
+						),
+						1e-10
+					);
+				}
+			}
+		}
+
+		//The scratch file is removed together with the solver.
+		EXPECT_FALSE(std::ifstream(FILENAME).good());
+	}
+}
+
+//Helper function for TEST(BlockDiagonalizer, MoveConstructor) and
+//TEST(BlockDiagonalizer, operatorMoveAssignment).
+void expectSameEigenStates(
+	const BlockDiagonalizer &solver,
+	const BlockDiagonalizer &reference
+){
+	for(unsigned int state = 0; state < 20; state++){
+		EXPECT_NEAR(
+			solver.getEigenValue(state),
+			reference.getEigenValue(state),
+			1e-12
+		);
+		for(unsigned int x = 0; x < 10; x++){
+			Index index({(int)state/10, (int)x});
+			EXPECT_NEAR(
+				std::abs(solver.getAmplitude(state, index)),
+				std::abs(reference.getAmplitude(state, index)),
+				1e-10
+			);
+		}
+	}
+}
+
+TEST(BlockDiagonalizer, MoveConstructor){
+	EXPECT_FALSE(std::is_copy_constructible<BlockDiagonalizer>::value);
+
+	const std::string FILENAME = "TBTKTestBlockDiagonalizer.bin";
+	Model model = createBlockModel(10);
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	//The eigenvectors are available after the move, both when they are
+	//stored in RAM and in a scratch file.
+	for(unsigned int n = 0; n < 2; n++){
+		{
+			BlockDiagonalizer solver;
+			solver.setVerbose(false);
+			solver.setModel(model);
+			if(n == 1)
+				solver.setEigenVectorScratchFile(FILENAME);
+			solver.run();
+
+			BlockDiagonalizer movedSolver(std::move(solver));
+			expectSameEigenStates(movedSolver, reference);
+		}
+
+		//The scratch file is removed exactly once.
+		EXPECT_FALSE(std::ifstream(FILENAME).good());
+	}
+}
+
+TEST(BlockDiagonalizer, operatorMoveAssignment){
+	EXPECT_FALSE(std::is_copy_assignable<BlockDiagonalizer>::value);
+
+	const std::string FILENAME = "TBTKTestBlockDiagonalizer.bin";
+	Model model = createBlockModel(10);
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(unsigned int n = 0; n < 2; n++){
+		{
+			BlockDiagonalizer solver;
+			solver.setVerbose(false);
+			solver.setModel(model);
+			if(n == 1)
+				solver.setEigenVectorScratchFile(FILENAME);
+			solver.run();
+
+			BlockDiagonalizer movedSolver;
+			movedSolver = std::move(solver);
+			expectSameEigenStates(movedSolver, reference);
+		}
+
+		EXPECT_FALSE(std::ifstream(FILENAME).good());
+	}
+}
+
+TEST(BlockDiagonalizer, getEigenVectorScratchFile){
+	BlockDiagonalizer solver;
+	EXPECT_EQ(solver.getEigenVectorScratchFile(), "");
+	solver.setEigenVectorScratchFile("Eigenvectors.bin");
+	EXPECT_EQ(solver.getEigenVectorScratchFile(), "Eigenvectors.bin");
+	solver.setEigenVectorScratchFile("");
+	EXPECT_EQ(solver.getEigenVectorScratchFile(), "");
+}
+
+TEST(BlockDiagonalizer, hasEigenVector){
+	//Tested through
+	//BlockDiagonalizer::setEigenVectorMode
+	//BlockDiagonalizer::setEigenVectorWindow
+}
+
 TEST(BlockDiagonalizer, getEigenValue){
 	Model model;
 	model.setVerbose(false);
@@ -292,5 +591,376 @@ TEST(BlockDiagonalizer, setParallelExecution){
 	//Tested through all other implemented tests.
 }
 
+TEST(BlockDiagonalizer, setDistributedExecution){
+	//Create a Model with blocks of different sizes.
+	Model model;
+	model.setVerbose(false);
+	for(unsigned int k = 0; k < 9; k++){
+		for(unsigned int x = 0; x < k + 1; x++){
+			model << HoppingAmplitude(0.1*x + 0.01*k, {k, x}, {k, x});
+			if(x+1 < k + 1){
+				model << HoppingAmplitude(
+					std::complex<double>(-1, 0.2),
+					{k, x+1},
+					{k, x}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+#ifdef TBTK_USE_MPI
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(unsigned int n = 0; n < 2; n++){
+		BlockDiagonalizer solver;
+		solver.setVerbose(false);
+		solver.setParallelExecution(n == 1);
+		solver.setDistributedExecution(true);
+		solver.setModel(model);
+		solver.run();
+
+		//Each block is solved by exactly one process and the local
+		//states are identical to the serial result.
+		int numLocalStates = 0;
+		for(int state = 0; state < model.getBasisSize(); state++){
+			EXPECT_EQ(
+				solver.isLocalState(state),
+				solver.hasEigenVector(state)
+			);
+			if(!solver.isLocalState(state))
+				continue;
+
+			numLocalStates++;
+			EXPECT_NEAR(
+				solver.getEigenValue(state),
+				reference.getEigenValue(state),
+				1e-12
+			);
+		}
+		int numStates;
+		MPI_Allreduce(
+			&numLocalStates,
+			&numStates,
+			1,
+			MPI_INT,
+			MPI_SUM,
+			MPI_COMM_WORLD
+		);
+		EXPECT_EQ(numStates, model.getBasisSize());
+	}
+#else
+	//Fail without MPI.
+	BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setDistributedExecution(true);
+	solver.setModel(model);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+#endif
+}
+
+TEST(BlockDiagonalizer, getDistributedExecution){
+	BlockDiagonalizer solver;
+	EXPECT_FALSE(solver.getDistributedExecution());
+	solver.setDistributedExecution(true);
+	EXPECT_TRUE(solver.getDistributedExecution());
+	solver.setDistributedExecution(false);
+	EXPECT_FALSE(solver.getDistributedExecution());
+}
+
+TEST(BlockDiagonalizer, isLocalState){
+	//All states are local without distributed execution. Tested with
+	//distributed execution through
+	//BlockDiagonalizer::setDistributedExecution.
+	Model model = createBlockModel(10);
+	BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.run();
+	for(int state = 0; state < model.getBasisSize(); state++)
+		EXPECT_TRUE(solver.isLocalState(state));
+}
+
+TEST(BlockDiagonalizer, getBlockTimings){
+	//Create a Model with one large block and many small blocks.
+	Model model;
+	model.setVerbose(false);
+	for(unsigned int k = 0; k < 21; k++){
+		unsigned int size = (k == 0 ? 60 : 3);
+		for(unsigned int x = 0; x < size; x++){
+			model << HoppingAmplitude(0.1*x + 0.01*k, {k, x}, {k, x});
+			if(x+1 < size){
+				model << HoppingAmplitude(
+					std::complex<double>(-1, 0.2),
+					{k, x+1},
+					{k, x}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+	BlockDiagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	//Timings are available for each block.
+	const std::vector<double> &referenceTimings
+		= reference.getBlockTimings();
+	ASSERT_EQ(referenceTimings.size(), 21);
+	for(unsigned int n = 0; n < referenceTimings.size(); n++)
+		EXPECT_TRUE(referenceTimings[n] >= 0);
+
+	//The size aware scheduling gives the same result as serial execution.
+	for(unsigned int n = 0; n < 3; n++){
+		BlockDiagonalizer solver;
+		solver.setVerbose(false);
+		solver.setParallelExecution(true);
+		solver.setModel(model);
+		if(n == 1)
+			solver.setEigenVectorWindow(0.5, 2.5);
+		if(n == 2){
+			solver.setEigenVectorMode(
+				BlockDiagonalizer::EigenVectorMode::None
+			);
+		}
+		solver.run();
+
+		EXPECT_EQ(solver.getBlockTimings().size(), 21);
+		for(unsigned int state = 0; state < 120; state++){
+			EXPECT_NEAR(
+				solver.getEigenValue(state),
+				reference.getEigenValue(state),
+				1e-12
+			);
+			if(!solver.hasEigenVector(state))
+				continue;
+
+			Index index = (
+				state < 60
+				? Index({0, 0})
+				: Index({(int)(1 + (state - 60)/3), 0})
+			);
+			EXPECT_NEAR(
+				std::abs(solver.getAmplitude(state, index)),
+				std::abs(reference.getAmplitude(state, index)),
+				1e-10
+			);
+		}
+	}
+}
+
+//Create a Model for a px and a py orbital on a square lattice in momentum
+//space. If timeReversalOnly is true, an imaginary term that breaks the
+//four-fold rotation symmetry but preserves time reversal symmetry is added.
+Model createSquareLatticeModel(
+	const BrillouinZone &brillouinZone,
+	unsigned int sizeK,
+	bool timeReversalOnly
+){
+	Model model;
+	model.setVerbose(false);
+	for(unsigned int kx = 0; kx < sizeK; kx++){
+		for(unsigned int ky = 0; ky < sizeK; ky++){
+			std::vector<double> k = brillouinZone.getMinorMeshPoint(
+				{kx, ky},
+				{sizeK, sizeK}
+			);
+			int x = kx;
+			int y = ky;
+			if(timeReversalOnly){
+				model << HoppingAmplitude(
+					-2*cos(k[0]) - cos(k[1]),
+					{x, y, 0},
+					{x, y, 0}
+				);
+				model << HoppingAmplitude(
+					1 - cos(k[0]) - 2*cos(k[1]),
+					{x, y, 1},
+					{x, y, 1}
+				);
+				model << HoppingAmplitude(
+					std::complex<double>(0.5, 0.4*sin(k[0])),
+					{x, y, 0},
+					{x, y, 1}
+				) + HC;
+			}
+			else{
+				model << HoppingAmplitude(
+					-2*cos(k[0]) - cos(k[1]),
+					{x, y, 0},
+					{x, y, 0}
+				);
+				model << HoppingAmplitude(
+					-2*cos(k[1]) - cos(k[0]),
+					{x, y, 1},
+					{x, y, 1}
+				);
+				model << HoppingAmplitude(
+					0.5*sin(k[0])*sin(k[1]),
+					{x, y, 0},
+					{x, y, 1}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+	return model;
+}
+
+TEST(BlockDiagonalizer, setIrreducibleBrillouinZone){
+	const unsigned int SIZE_K = 6;
+	const double FERMI_LEVEL = 0.123;
+	BrillouinZone brillouinZone(
+		{{2*M_PI, 0}, {0, 2*M_PI}},
+		SpacePartition::MeshType::Nodal
+	);
+
+	//Four-fold rotation and mirror symmetry for the px and py orbitals.
+	Matrix<std::complex<double>> U(2, 2);
+	U.at(0, 0) = 0;
+	U.at(0, 1) = -1;
+	U.at(1, 0) = 1;
+	U.at(1, 1) = 0;
+	SymmetryOperation c4({{0, -1}, {1, 0}}, U);
+	U.at(0, 0) = -1;
+	U.at(0, 1) = 0;
+	U.at(1, 0) = 0;
+	U.at(1, 1) = 1;
+	SymmetryOperation mirror({{-1, 0}, {0, 1}}, U);
+
+	//Time reversal symmetry.
+	U.at(0, 0) = 1;
+	SymmetryOperation timeReversal({{-1, 0}, {0, -1}}, U, true);
+
+	for(unsigned int n = 0; n < 2; n++){
+		Model model = createSquareLatticeModel(
+			brillouinZone,
+			SIZE_K,
+			n == 1
+		);
+		IrreducibleBrillouinZone irreducibleBrillouinZone(
+			brillouinZone,
+			{SIZE_K, SIZE_K},
+			(
+				n == 0
+				? std::vector<SymmetryOperation>({c4, mirror})
+				: std::vector<SymmetryOperation>({timeReversal})
+			)
+		);
+
+		BlockDiagonalizer reference;
+		reference.setVerbose(false);
+		reference.setModel(model);
+		reference.run();
+
+		for(unsigned int c = 0; c < 3; c++){
+			BlockDiagonalizer solver;
+			solver.setVerbose(false);
+			solver.setParallelExecution(c == 1);
+			solver.setModel(model);
+			solver.setIrreducibleBrillouinZone(
+				irreducibleBrillouinZone
+			);
+			if(c == 2)
+				solver.setEigenVectorWindow(-1, 1);
+			solver.run();
+
+			//Only the irreducible blocks are diagonalized.
+			const std::vector<double> &blockTimings
+				= solver.getBlockTimings();
+			ASSERT_EQ(blockTimings.size(), SIZE_K*SIZE_K);
+			for(unsigned int kx = 0; kx < SIZE_K; kx++){
+				for(unsigned int ky = 0; ky < SIZE_K; ky++){
+					if(
+						!irreducibleBrillouinZone.isIrreducible(
+							{(int)kx, (int)ky}
+						)
+					){
+						EXPECT_EQ(
+							blockTimings[SIZE_K*kx + ky],
+							0
+						);
+					}
+				}
+			}
+
+			//The eigenvalues and the density agree with the
+			//unreduced calculation. Individual eigenvectors are only
+			//determined up to a phase.
+			for(unsigned int kx = 0; kx < SIZE_K; kx++){
+				for(unsigned int ky = 0; ky < SIZE_K; ky++){
+					for(unsigned int orbital = 0; orbital < 2; orbital++){
+						Index index({(int)kx, (int)ky, (int)orbital});
+						double density = 0;
+						double referenceDensity = 0;
+						for(
+							int state = solver.getFirstStateInBlock(
+								index
+							);
+							state <= solver.getLastStateInBlock(
+								index
+							);
+							state++
+						){
+							EXPECT_NEAR(
+								solver.getEigenValue(state),
+								reference.getEigenValue(
+									state
+								),
+								1e-12
+							);
+							if(
+								solver.getEigenValue(state)
+								> FERMI_LEVEL
+							){
+								continue;
+							}
+							if(!solver.hasEigenVector(state))
+								continue;
+
+							density += pow(
+								std::abs(
+									solver.getAmplitude(
+										state,
+										index
+									)
+								),
+								2
+							);
+							referenceDensity += pow(
+								std::abs(
+									reference.getAmplitude(
+										state,
+										index
+									)
+								),
+								2
+							);
+						}
+						EXPECT_NEAR(
+							density,
+							referenceDensity,
+							1e-10
+						);
+					}
+				}
+			}
+		}
+	}
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
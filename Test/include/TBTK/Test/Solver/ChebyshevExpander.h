@@ -1,5 +1,8 @@
+#include "TBTK/Functions.h"
 #include "TBTK/Range.h"
 #include "TBTK/Solver/ChebyshevExpander.h"
+#include "TBTK/Solver/Diagonalizer.h"
+#include "TBTK/UnitHandler.h"
 
 #include "gtest/gtest.h"
 
@@ -63,6 +66,203 @@ TEST(ChebyshevExpander, getScaleFactor){
 	EXPECT_DOUBLE_EQ(solver.getScaleFactor(), 10);
 }
 
+TEST(ChebyshevExpander, setAutomaticScaleFactor){
+	//Tested through ChebyshevExpander::getAutomaticScaleFactor().
+}
+
+TEST(ChebyshevExpander, getAutomaticScaleFactor){
+	ChebyshevExpander solver;
+
+	//Default value is false.
+	EXPECT_FALSE(solver.getAutomaticScaleFactor());
+
+	//Test setting and getting.
+	solver.setAutomaticScaleFactor(true);
+	EXPECT_TRUE(solver.getAutomaticScaleFactor());
+
+	//Setting the scale factor disables the automatic scale factor.
+	solver.setScaleFactor(10);
+	EXPECT_FALSE(solver.getAutomaticScaleFactor());
+}
+
+TEST(ChebyshevExpander, setSpectralBoundsMethod){
+	//Tested through ChebyshevExpander::getSpectralBoundsMethod().
+}
+
+TEST(ChebyshevExpander, getSpectralBoundsMethod){
+	ChebyshevExpander solver;
+
+	//Default value is Gershgorin.
+	EXPECT_TRUE(
+		solver.getSpectralBoundsMethod()
+		== ChebyshevExpander::SpectralBoundsMethod::Gershgorin
+	);
+
+	//Test setting and getting.
+	solver.setSpectralBoundsMethod(
+		ChebyshevExpander::SpectralBoundsMethod::Lanczos
+	);
+	EXPECT_TRUE(
+		solver.getSpectralBoundsMethod()
+		== ChebyshevExpander::SpectralBoundsMethod::Lanczos
+	);
+}
+
+TEST(ChebyshevExpander, setScaleFactorSafetyMargin){
+	ChebyshevExpander solver;
+
+	//Fail for negative safety margin.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setScaleFactorSafetyMargin(-0.1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getScaleFactorSafetyMargin){
+	ChebyshevExpander solver;
+
+	//Default value is 0.01.
+	EXPECT_DOUBLE_EQ(solver.getScaleFactorSafetyMargin(), 0.01);
+
+	//Test setting and getting.
+	solver.setScaleFactorSafetyMargin(0.1);
+	EXPECT_DOUBLE_EQ(solver.getScaleFactorSafetyMargin(), 0.1);
+}
+
+TEST(ChebyshevExpander, automaticScaleFactor){
+	//Chain with alternating on-site energies, which has the spectrum
+	//+-sqrt(1 + 4cos^2(k)) for k in the Brillouin zone. The largest
+	//absolute eigenvalue is sqrt(5), while the Gershgorin bound is 3.
+	const int SIZE = 20;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(x%2 == 0 ? 1 : -1, {x}, {x});
+		model << HoppingAmplitude(-1, {(x+1)%SIZE}, {x}) + HC;
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAutomaticScaleFactor(true);
+	solver.setScaleFactorSafetyMargin(0.1);
+
+	//Gershgorin.
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*3, 1e-10);
+
+	//Lanczos.
+	solver.setSpectralBoundsMethod(
+		ChebyshevExpander::SpectralBoundsMethod::Lanczos
+	);
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*sqrt(5.), 1e-6);
+
+	//Gershgorin.
+	solver.setSpectralBoundsMethod(
+		ChebyshevExpander::SpectralBoundsMethod::Gershgorin
+	);
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*3, 1e-10);
+
+	//The coefficients are the same as for a manually set scale factor.
+	solver.setNumCoefficients(20);
+	std::vector<std::complex<double>> coefficients0
+		= solver.calculateCoefficients({0}, {0});
+	solver.setScaleFactor(3.3);
+	std::vector<std::complex<double>> coefficients1
+		= solver.calculateCoefficients({0}, {0});
+	for(unsigned int n = 0; n < 20; n++){
+		EXPECT_NEAR(real(coefficients0[n]), real(coefficients1[n]), 1e-10);
+		EXPECT_NEAR(imag(coefficients0[n]), imag(coefficients1[n]), 1e-10);
+	}
+}
+
+TEST(ChebyshevExpander, automaticScaleFactorUnconvergedLanczos){
+	//Same chain as above, but too long for the extremal Ritz values to
+	//converge in the fixed number of Lanczos iterations. The Gershgorin
+	//bound is used in this case.
+	const int SIZE = 2000;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(x%2 == 0 ? 1 : -1, {x}, {x});
+		model << HoppingAmplitude(-1, {(x+1)%SIZE}, {x}) + HC;
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAutomaticScaleFactor(true);
+	solver.setSpectralBoundsMethod(
+		ChebyshevExpander::SpectralBoundsMethod::Lanczos
+	);
+	solver.setScaleFactorSafetyMargin(0.1);
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*3, 1e-10);
+}
+
+//On-site energy with an adjustable strength.
+class AdjustableOnSiteEnergy : public HoppingAmplitude::AmplitudeCallback{
+public:
+	double strength = 0;
+
+	virtual std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		return strength;
+	}
+};
+
+TEST(ChebyshevExpander, automaticScaleFactorDeferredEstimate){
+	AdjustableOnSiteEnergy onSiteEnergy;
+	const int SIZE = 10;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(onSiteEnergy, {x}, {x});
+		if(x + 1 < SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	//The solver can be configured before the Model is set.
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setAutomaticScaleFactor(true);
+	solver.setScaleFactorSafetyMargin(0.1);
+	solver.setEnergyWindow(Range(-2, 2, 10));
+	solver.setNumCoefficients(20);
+	solver.setModel(model);
+	solver.calculateCoefficients({0}, {0});
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*2, 1e-10);
+
+	//The scale factor is estimated again when the Hamiltonian changes.
+	onSiteEnergy.strength = 1;
+	solver.calculateCoefficients({0}, {0});
+	EXPECT_NEAR(solver.getScaleFactor(), 1.1*3, 1e-10);
+
+	//The energy window is checked when the scale factor is estimated.
+	onSiteEnergy.strength = -0.5;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			ChebyshevExpander solver;
+			solver.setVerbose(false);
+			solver.setAutomaticScaleFactor(true);
+			solver.setScaleFactorSafetyMargin(0);
+			solver.setEnergyWindow(Range(-2.6, 2.6, 10));
+			solver.setModel(model);
+			solver.calculateCoefficients({0}, {0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 TEST(ChebyshevExpander, setNumCoefficients){
 	//Tested through ChebyshevExpander::getNumCoefficients().
 }
@@ -181,6 +381,164 @@ TEST(ChebyshevExpander, getUseLookupTable){
 	EXPECT_TRUE(solver.getUseLookupTable());
 }
 
+TEST(ChebyshevExpander, setUseFastTransform){
+	//Tested through ChebyshevExpander::getUseFastTransform().
+}
+
+TEST(ChebyshevExpander, getUseFastTransform){
+	ChebyshevExpander solver;
+
+	//Default value is false.
+	EXPECT_FALSE(solver.getUseFastTransform());
+
+	//Test setting and getting.
+	solver.setUseFastTransform(true);
+	EXPECT_TRUE(solver.getUseFastTransform());
+}
+
+TEST(ChebyshevExpander, setAdaptiveTruncationTolerance){
+	ChebyshevExpander solver;
+
+	//Fail for negative tolerance.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setAdaptiveTruncationTolerance(-1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getAdaptiveTruncationTolerance){
+	ChebyshevExpander solver;
+
+	//Default value is 0.
+	EXPECT_EQ(solver.getAdaptiveTruncationTolerance(), 0);
+
+	//Test setting and getting.
+	solver.setAdaptiveTruncationTolerance(1e-6);
+	EXPECT_EQ(solver.getAdaptiveTruncationTolerance(), 1e-6);
+}
+
+TEST(ChebyshevExpander, setUseLocalEnvironment){
+	//Tested through ChebyshevExpander::getUseLocalEnvironment().
+}
+
+TEST(ChebyshevExpander, getUseLocalEnvironment){
+	ChebyshevExpander solver;
+
+	//Default value is false.
+	EXPECT_FALSE(solver.getUseLocalEnvironment());
+
+	//Test setting and getting.
+	solver.setUseLocalEnvironment(true);
+	EXPECT_TRUE(solver.getUseLocalEnvironment());
+}
+
+TEST(ChebyshevExpander, setDensityMatrixTruncationRadius){
+	//Tested through ChebyshevExpander::getDensityMatrixTruncationRadius().
+}
+
+TEST(ChebyshevExpander, getDensityMatrixTruncationRadius){
+	ChebyshevExpander solver;
+
+	//Default value is -1.
+	EXPECT_EQ(solver.getDensityMatrixTruncationRadius(), -1);
+
+	//Test setting and getting.
+	solver.setDensityMatrixTruncationRadius(5);
+	EXPECT_EQ(solver.getDensityMatrixTruncationRadius(), 5);
+}
+
+TEST(ChebyshevExpander, setBlockSize){
+	ChebyshevExpander solver;
+
+	//Fail for zero block size.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setBlockSize(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getBlockSize){
+	ChebyshevExpander solver;
+
+	//Default value is 8.
+	EXPECT_EQ(solver.getBlockSize(), 8);
+
+	//Test setting and getting.
+	solver.setBlockSize(3);
+	EXPECT_EQ(solver.getBlockSize(), 3);
+}
+
+TEST(ChebyshevExpander, setNumRandomVectors){
+	ChebyshevExpander solver;
+
+	//Fail for zero random vectors.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setNumRandomVectors(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getNumRandomVectors){
+	ChebyshevExpander solver;
+
+	//Default value is 10.
+	EXPECT_EQ(solver.getNumRandomVectors(), 10);
+
+	//Test setting and getting.
+	solver.setNumRandomVectors(3);
+	EXPECT_EQ(solver.getNumRandomVectors(), 3);
+}
+
+TEST(ChebyshevExpander, setRandomVectorType){
+	//Tested through ChebyshevExpander::getRandomVectorType().
+}
+
+TEST(ChebyshevExpander, getRandomVectorType){
+	ChebyshevExpander solver;
+
+	//Default value is RandomPhase.
+	EXPECT_TRUE(
+		solver.getRandomVectorType()
+		== ChebyshevExpander::RandomVectorType::RandomPhase
+	);
+
+	//Test setting and getting.
+	solver.setRandomVectorType(
+		ChebyshevExpander::RandomVectorType::Rademacher
+	);
+	EXPECT_TRUE(
+		solver.getRandomVectorType()
+		== ChebyshevExpander::RandomVectorType::Rademacher
+	);
+}
+
+TEST(ChebyshevExpander, setRandomSeed){
+	//Tested through ChebyshevExpander::getRandomSeed().
+}
+
+TEST(ChebyshevExpander, getRandomSeed){
+	ChebyshevExpander solver;
+
+	//Default value is 0.
+	EXPECT_EQ(solver.getRandomSeed(), 0);
+
+	//Test setting and getting.
+	solver.setRandomSeed(123);
+	EXPECT_EQ(solver.getRandomSeed(), 123);
+}
+
 TEST(ChebyshevExpander, calculateCoefficients){
 	const int SIZE = 5;
 	const double mu = -2;
@@ -368,6 +726,521 @@ TEST(ChebyshevExpander, calculateCoefficients){
 	#endif
 }
 
+TEST(ChebyshevExpander, calculateBlockCoefficients){
+	const int SIZE = 5;
+	const double mu = -2;
+	const double t = 1;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(-mu, {x,		y},		{x, y});
+			model << HoppingAmplitude(-t, {(x+1)%SIZE,	y},		{x, y}) + HC;
+			model << HoppingAmplitude(
+				std::complex<double>(0, t/2),
+				{x,		(y+1)%SIZE},
+				{x, y}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(100);
+	solver.setBroadening(1e-3);
+	solver.setBlockSize(3);
+
+	const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+	//Seven 'from'-Indices, which gives two full blocks and one partial
+	//block.
+	std::vector<Index> from;
+	std::vector<std::vector<Index>> to;
+	for(int n = 0; n < 7; n++){
+		from.push_back({n%SIZE, n/SIZE});
+		to.push_back({{n%SIZE, n/SIZE}, {0, 0}, {(n+1)%SIZE, 1}});
+	}
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> coefficients = solver.calculateBlockCoefficients(to, from);
+	ASSERT_EQ(coefficients.size(), 7);
+	for(unsigned int f = 0; f < from.size(); f++){
+		ASSERT_EQ(coefficients[f].size(), 3);
+		std::vector<std::vector<std::complex<double>>> reference
+			= solver.calculateCoefficients(to[f], from[f]);
+		for(unsigned int c = 0; c < to[f].size(); c++){
+			ASSERT_EQ(coefficients[f][c].size(), 100);
+			for(unsigned int n = 0; n < 100; n++){
+				EXPECT_NEAR(
+					real(coefficients[f][c][n]),
+					real(reference[c][n]),
+					EPSILON_100
+				);
+				EXPECT_NEAR(
+					imag(coefficients[f][c][n]),
+					imag(reference[c][n]),
+					EPSILON_100
+				);
+			}
+		}
+	}
+
+	//Fail for incompatible sizes.
+	to.pop_back();
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.calculateBlockCoefficients(to, from);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, calculateCoefficientsAdaptiveTruncation){
+	const int SIZE = 200;
+	const double t = 1;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++)
+		model << HoppingAmplitude(-t, {(x+1)%SIZE}, {x}) + HC;
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(2.5);
+	solver.setNumCoefficients(1000);
+	solver.setBroadening(0.05);
+
+	std::vector<Index> to = {{0}, {1}, {5}};
+	std::vector<std::vector<std::complex<double>>> reference
+		= solver.calculateCoefficients(to, {0});
+
+	//The broadening damps the coefficients as exp(-0.05n), which gives
+	//a truncation at around 280 coefficients for a tolerance of 1e-6.
+	const double TOLERANCE = 1e-6;
+	solver.setAdaptiveTruncationTolerance(TOLERANCE);
+	std::vector<std::vector<std::complex<double>>> coefficients
+		= solver.calculateCoefficients(to, {0});
+	ASSERT_EQ(coefficients.size(), 3);
+	for(unsigned int c = 0; c < coefficients.size(); c++){
+		EXPECT_LT(coefficients[c].size(), 400);
+		EXPECT_GT(coefficients[c].size(), 200);
+		EXPECT_EQ(coefficients[c].size(), coefficients[0].size());
+
+		//The truncated expansion agrees with the full expansion on
+		//the common coefficients and the remaining coefficients are
+		//of the order of the tolerance.
+		for(unsigned int n = 0; n < coefficients[c].size(); n++)
+			EXPECT_EQ(coefficients[c][n], reference[c][n]);
+		for(unsigned int n = coefficients[c].size(); n < 1000; n++)
+			EXPECT_LT(abs(reference[c][n]), 2*TOLERANCE);
+	}
+
+	//Sources that are truncated at different moments give the same
+	//result in a block calculation as in separate calculations. The
+	//moments between sites at distance 98 vanish for n < 98 and are
+	//therefore truncated later than the diagonal moments.
+	std::vector<Index> from = {{0}, {1}, {2}};
+	std::vector<std::vector<Index>> blockTo = {{{0}}, {{1}}, {{100}}};
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> blockCoefficients = solver.calculateBlockCoefficients(
+		blockTo,
+		from
+	);
+	ASSERT_EQ(blockCoefficients.size(), 3);
+	for(unsigned int f = 0; f < from.size(); f++){
+		std::vector<std::vector<std::complex<double>>> single
+			= solver.calculateCoefficients(blockTo[f], from[f]);
+		ASSERT_EQ(blockCoefficients[f].size(), 1);
+		ASSERT_EQ(blockCoefficients[f][0].size(), single[0].size());
+		for(unsigned int n = 0; n < single[0].size(); n++){
+			EXPECT_NEAR(
+				real(blockCoefficients[f][0][n]),
+				real(single[0][n]),
+				1e-12
+			);
+			EXPECT_NEAR(
+				imag(blockCoefficients[f][0][n]),
+				imag(single[0][n]),
+				1e-12
+			);
+		}
+	}
+	EXPECT_GT(
+		blockCoefficients[2][0].size(),
+		blockCoefficients[0][0].size()
+	);
+
+	//Sources that are truncated at different moments while other
+	//sources in the block are still being expanded. The distances
+	//between the 'from'- and 'to'-indices are 0, 40, and 80, which gives
+	//three different truncation points.
+	from = {{0}, {1}, {2}, {3}};
+	blockTo = {{{0}}, {{41}}, {{82}}, {{3}, {43}}};
+	solver.setBlockSize(4);
+	blockCoefficients = solver.calculateBlockCoefficients(blockTo, from);
+	ASSERT_EQ(blockCoefficients.size(), 4);
+	for(unsigned int f = 0; f < from.size(); f++){
+		std::vector<std::vector<std::complex<double>>> single
+			= solver.calculateCoefficients(blockTo[f], from[f]);
+		ASSERT_EQ(blockCoefficients[f].size(), blockTo[f].size());
+		for(unsigned int c = 0; c < blockTo[f].size(); c++){
+			ASSERT_EQ(
+				blockCoefficients[f][c].size(),
+				single[c].size()
+			);
+			for(unsigned int n = 0; n < single[c].size(); n++){
+				EXPECT_NEAR(
+					real(blockCoefficients[f][c][n]),
+					real(single[c][n]),
+					1e-12
+				);
+				EXPECT_NEAR(
+					imag(blockCoefficients[f][c][n]),
+					imag(single[c][n]),
+					1e-12
+				);
+			}
+		}
+	}
+	EXPECT_NE(
+		blockCoefficients[0][0].size(),
+		blockCoefficients[1][0].size()
+	);
+	EXPECT_NE(
+		blockCoefficients[0][0].size(),
+		blockCoefficients[2][0].size()
+	);
+	EXPECT_NE(
+		blockCoefficients[1][0].size(),
+		blockCoefficients[2][0].size()
+	);
+}
+
+TEST(ChebyshevExpander, calculateCoefficientsLocalEnvironment){
+	const int SIZE = 30;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(
+				0.1*((7*x + 3*y)%5),
+				{x, y},
+				{x, y}
+			);
+			model << HoppingAmplitude(
+				-1,
+				{(x+1)%SIZE, y},
+				{x, y}
+			) + HC;
+			model << HoppingAmplitude(
+				std::complex<double>(0, 0.5),
+				{x, (y+1)%SIZE},
+				{x, y}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(5);
+	solver.setNumCoefficients(20);
+	solver.setBroadening(1e-3);
+
+	//The last 'to'-index is further away than the number of
+	//coefficients, which gives vanishing coefficients.
+	std::vector<Index> from = {{0, 0}, {5, 7}, {29, 29}};
+	std::vector<std::vector<Index>> to = {
+		{{0, 0}, {1, 0}, {3, 29}},
+		{{5, 7}, {10, 12}, {20, 20}},
+		{{29, 29}, {0, 0}, {14, 29}}
+	};
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> reference = solver.calculateBlockCoefficients(to, from);
+
+	solver.setUseLocalEnvironment(true);
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> coefficients = solver.calculateBlockCoefficients(to, from);
+	ASSERT_EQ(coefficients.size(), from.size());
+	for(unsigned int f = 0; f < from.size(); f++){
+		ASSERT_EQ(coefficients[f].size(), to[f].size());
+		for(unsigned int t = 0; t < to[f].size(); t++){
+			ASSERT_EQ(coefficients[f][t].size(), 20);
+			for(unsigned int n = 0; n < 20; n++){
+				EXPECT_NEAR(
+					real(coefficients[f][t][n]),
+					real(reference[f][t][n]),
+					EPSILON_100
+				);
+				EXPECT_NEAR(
+					imag(coefficients[f][t][n]),
+					imag(reference[f][t][n]),
+					EPSILON_100
+				);
+			}
+		}
+	}
+	for(unsigned int n = 0; n < 20; n++)
+		EXPECT_EQ(coefficients[1][2][n], std::complex<double>(0));
+
+	//Also applies to ChebyshevExpander::calculateCoefficients().
+	std::vector<std::vector<std::complex<double>>> singleCoefficients
+		= solver.calculateCoefficients(to[1], from[1]);
+	for(unsigned int t = 0; t < to[1].size(); t++)
+		for(unsigned int n = 0; n < 20; n++)
+			EXPECT_EQ(singleCoefficients[t][n], coefficients[1][t][n]);
+}
+
+TEST(ChebyshevExpander, calculateDensityMatrix){
+	const int SIZE = 8;
+	const double mu = 0.3;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(
+				0.1*((7*x + 3*y)%5),
+				{x, y},
+				{x, y}
+			);
+			if(x + 1 < SIZE)
+				model << HoppingAmplitude(-1, {x+1, y}, {x, y}) + HC;
+			if(y + 1 < SIZE)
+				model << HoppingAmplitude(-1, {x, y+1}, {x, y}) + HC;
+		}
+	}
+	model.construct();
+	model.setChemicalPotential(mu);
+
+	std::vector<Index> from = {{0, 0}, {3, 4}};
+	std::vector<std::vector<Index>> to = {
+		{{0, 0}, {1, 0}, {2, 2}},
+		{{3, 4}, {3, 5}, {7, 7}}
+	};
+
+	//Calculates the density matrix using diagonalization.
+	auto calculateReference = [&](){
+		Diagonalizer diagonalizer;
+		diagonalizer.setVerbose(false);
+		diagonalizer.setModel(model);
+		diagonalizer.run();
+
+		std::vector<std::vector<std::complex<double>>> reference;
+		for(unsigned int f = 0; f < from.size(); f++){
+			reference.push_back(std::vector<std::complex<double>>());
+			for(unsigned int t = 0; t < to[f].size(); t++){
+				std::complex<double> element = 0;
+				for(int n = 0; n < SIZE*SIZE; n++){
+					element += Functions::fermiDiracDistribution(
+						diagonalizer.getEigenValue(n),
+						mu,
+						model.getTemperature()
+					)*diagonalizer.getAmplitude(n, to[f][t])
+					*conj(diagonalizer.getAmplitude(
+						n,
+						from[f]
+					));
+				}
+				reference[f].push_back(element);
+			}
+		}
+
+		return reference;
+	};
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(5);
+	solver.setNumCoefficients(400);
+	solver.setBroadening(0);
+
+	//At finite temperature the expansion converges exponentially. A
+	//truncation radius of numCoefficients - 1 is exact.
+	model.setTemperature(0.2/UnitHandler::getConstantInBaseUnits("k_B"));
+	std::vector<std::vector<std::complex<double>>> reference
+		= calculateReference();
+	for(int radius : {-1, 399}){
+		solver.setDensityMatrixTruncationRadius(radius);
+		std::vector<std::vector<std::complex<double>>> densityMatrix
+			= solver.calculateDensityMatrix(to, from);
+		ASSERT_EQ(densityMatrix.size(), from.size());
+		for(unsigned int f = 0; f < from.size(); f++){
+			ASSERT_EQ(densityMatrix[f].size(), to[f].size());
+			for(unsigned int t = 0; t < to[f].size(); t++){
+				EXPECT_NEAR(
+					real(densityMatrix[f][t]),
+					real(reference[f][t]),
+					1e-12
+				);
+				EXPECT_NEAR(
+					imag(densityMatrix[f][t]),
+					imag(reference[f][t]),
+					1e-12
+				);
+			}
+		}
+	}
+
+	//A smaller truncation radius gives an approximation that improves
+	//with the radius. Elements outside the radius are zero.
+	double previousError = 1;
+	for(int radius : {2, 5, 8, 12}){
+		solver.setDensityMatrixTruncationRadius(radius);
+		std::vector<std::vector<std::complex<double>>> densityMatrix
+			= solver.calculateDensityMatrix(to, from);
+		double error = 0;
+		for(unsigned int f = 0; f < from.size(); f++){
+			for(unsigned int t = 0; t < to[f].size(); t++){
+				error = std::max(
+					error,
+					abs(densityMatrix[f][t] - reference[f][t])
+				);
+			}
+		}
+		EXPECT_LT(error, previousError);
+		previousError = error;
+
+		if(radius < 7)
+			EXPECT_EQ(densityMatrix[1][2], std::complex<double>(0));
+	}
+	EXPECT_LT(previousError, 1e-2);
+
+	//At zero temperature the expansion converges slowly due to the
+	//discontinuity at the chemical potential.
+	model.setTemperature(0);
+	reference = calculateReference();
+	solver.setDensityMatrixTruncationRadius(-1);
+	std::vector<std::vector<std::complex<double>>> densityMatrix
+		= solver.calculateDensityMatrix(to, from);
+	for(unsigned int f = 0; f < from.size(); f++){
+		for(unsigned int t = 0; t < to[f].size(); t++){
+			EXPECT_NEAR(
+				abs(densityMatrix[f][t] - reference[f][t]),
+				0,
+				1e-2
+			);
+		}
+	}
+
+	//Fail for incompatible sizes.
+	to.pop_back();
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.calculateDensityMatrix(to, from);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, calculateTraceCoefficients0){
+	//For a diagonal Hamiltonian, random phase vectors give the exact
+	//trace since |r_i|^2 = 1.
+	const int SIZE = 10;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++)
+		model << HoppingAmplitude(x - 4.5, {x}, {x});
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(51);
+	solver.setBroadening(0);
+	solver.setNumRandomVectors(3);
+
+	const double EPSILON_10000
+		= 10000*std::numeric_limits<double>::epsilon();
+
+	std::vector<double> standardErrors;
+	std::vector<std::complex<double>> coefficients
+		= solver.calculateTraceCoefficients(standardErrors);
+	ASSERT_EQ(coefficients.size(), 51);
+	ASSERT_EQ(standardErrors.size(), 51);
+	for(int n = 0; n < 51; n++){
+		double reference = 0;
+		for(int x = 0; x < SIZE; x++)
+			reference += cos(n*acos((x - 4.5)/10.));
+		EXPECT_NEAR(real(coefficients[n]), reference, EPSILON_10000);
+		EXPECT_NEAR(imag(coefficients[n]), 0, EPSILON_10000);
+		EXPECT_NEAR(standardErrors[n], 0, EPSILON_10000);
+	}
+
+	//The errors are infinite for a single random vector.
+	solver.setNumRandomVectors(1);
+	solver.calculateTraceCoefficients(standardErrors);
+	EXPECT_TRUE(std::isinf(standardErrors[0]));
+}
+
+TEST(ChebyshevExpander, calculateTraceCoefficients1){
+	const int SIZE = 20;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(0.1*x, {x}, {x});
+		model << HoppingAmplitude(-1, {(x+1)%SIZE}, {x}) + HC;
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(5);
+	solver.setNumCoefficients(40);
+	solver.setRandomVectorType(
+		ChebyshevExpander::RandomVectorType::Rademacher
+	);
+	solver.setNumRandomVectors(200);
+
+	//Exact trace.
+	std::vector<std::complex<double>> reference(40, 0);
+	for(int x = 0; x < SIZE; x++){
+		std::vector<std::complex<double>> coefficients
+			= solver.calculateCoefficients({x}, {x});
+		for(unsigned int n = 0; n < 40; n++)
+			reference[n] += coefficients[n];
+	}
+
+	//The result agrees with the exact trace within a few standard
+	//errors.
+	std::vector<double> standardErrors;
+	std::vector<std::complex<double>> coefficients0
+		= solver.calculateTraceCoefficients(standardErrors);
+	for(unsigned int n = 0; n < 40; n++){
+		EXPECT_LT(
+			abs(coefficients0[n] - reference[n]),
+			5*standardErrors[n] + 1e-10
+		);
+	}
+
+	//The result is independent of the block size.
+	solver.setBlockSize(3);
+	std::vector<std::complex<double>> coefficients1
+		= solver.calculateTraceCoefficients();
+	for(unsigned int n = 0; n < 40; n++)
+		EXPECT_NEAR(abs(coefficients1[n] - coefficients0[n]), 0, 1e-10);
+
+	//The result depends on the seed.
+	solver.setRandomSeed(1);
+	std::vector<std::complex<double>> coefficients2
+		= solver.calculateTraceCoefficients();
+	EXPECT_GT(abs(coefficients2[2] - coefficients0[2]), 1e-10);
+}
+
 TEST(ChebyshevExpander, generateGreensFunction0){
 	const double SCALE_FACTOR = 10;
 	Range energyWindow(-5, 5, 10);
@@ -563,5 +1436,205 @@ TEST(ChebyshevExpander, generateGreensFunction4){
 	}
 }
 
+TEST(ChebyshevExpander, generateGreensFunction5){
+	//Compare the fast transform to the direct summation.
+	const double SCALE_FACTOR = 10;
+	Range energyWindow(-9, 9, 101);
+
+	ChebyshevExpander solver;
+	solver.setScaleFactor(SCALE_FACTOR);
+	solver.setGenerateGreensFunctionsOnGPU(false);
+	solver.setUseLookupTable(false);
+	solver.setNumCoefficients(50);
+	solver.setEnergyWindow(energyWindow);
+
+	std::vector<std::complex<double>> coefficients;
+	for(unsigned int n = 0; n < 50; n++){
+		coefficients.push_back(
+			std::complex<double>(cos(0.3*n), sin(0.7*n))/(1. + n)
+		);
+	}
+
+	ChebyshevExpander::Type types[4] = {
+		ChebyshevExpander::Type::Retarded,
+		ChebyshevExpander::Type::Advanced,
+		ChebyshevExpander::Type::Principal,
+		ChebyshevExpander::Type::NonPrincipal
+	};
+	for(unsigned int t = 0; t < 4; t++){
+		solver.setUseFastTransform(false);
+		std::vector<std::complex<double>> reference
+			= solver.generateGreensFunction(coefficients, types[t]);
+		solver.setUseFastTransform(true);
+		std::vector<std::complex<double>> greensFunction
+			= solver.generateGreensFunction(coefficients, types[t]);
+
+		ASSERT_EQ(greensFunction.size(), reference.size());
+		for(unsigned int n = 0; n < reference.size(); n++){
+			EXPECT_NEAR(
+				real(greensFunction[n]),
+				real(reference[n]),
+				1e-4
+			);
+			EXPECT_NEAR(
+				imag(greensFunction[n]),
+				imag(reference[n]),
+				1e-4
+			);
+		}
+	}
+}
+
+TEST(ChebyshevExpander, generateGreensFunction6){
+	//The advanced Green's function is the same for the direct summation,
+	//the lookup table, and the fast transform when the coefficients,
+	//including the zeroth coefficient, are complex. It is also related to
+	//the retarded Green's function through
+	//G^A[c](E) = conj(G^R[conj(c)](E)).
+	const double SCALE_FACTOR = 10;
+	Range energyWindow(-9, 9, 101);
+
+	std::vector<std::complex<double>> coefficients;
+	std::vector<std::complex<double>> conjugatedCoefficients;
+	for(unsigned int n = 0; n < 50; n++){
+		coefficients.push_back(
+			std::complex<double>(cos(0.3*n + 1), sin(0.7*n + 1))
+			/(1. + n)
+		);
+		conjugatedCoefficients.push_back(conj(coefficients.back()));
+	}
+
+	ChebyshevExpander solver;
+	solver.setScaleFactor(SCALE_FACTOR);
+	solver.setGenerateGreensFunctionsOnGPU(false);
+	solver.setNumCoefficients(50);
+	solver.setEnergyWindow(energyWindow);
+
+	solver.setUseLookupTable(false);
+	solver.setUseFastTransform(false);
+	std::vector<std::complex<double>> direct
+		= solver.generateGreensFunction(
+			coefficients,
+			ChebyshevExpander::Type::Advanced
+		);
+	std::vector<std::complex<double>> retarded
+		= solver.generateGreensFunction(
+			conjugatedCoefficients,
+			ChebyshevExpander::Type::Retarded
+		);
+	solver.setUseFastTransform(true);
+	std::vector<std::complex<double>> fastTransform
+		= solver.generateGreensFunction(
+			coefficients,
+			ChebyshevExpander::Type::Advanced
+		);
+	solver.setUseFastTransform(false);
+	solver.setUseLookupTable(true);
+	std::vector<std::complex<double>> lookupTable
+		= solver.generateGreensFunction(
+			coefficients,
+			ChebyshevExpander::Type::Advanced
+		);
+
+	for(unsigned int n = 0; n < energyWindow.getResolution(); n++){
+		EXPECT_NEAR(real(direct[n]), real(retarded[n]), EPSILON_100);
+		EXPECT_NEAR(imag(direct[n]), -imag(retarded[n]), EPSILON_100);
+		EXPECT_NEAR(real(direct[n]), real(lookupTable[n]), EPSILON_100);
+		EXPECT_NEAR(imag(direct[n]), imag(lookupTable[n]), EPSILON_100);
+		EXPECT_NEAR(real(direct[n]), real(fastTransform[n]), 1e-4);
+		EXPECT_NEAR(imag(direct[n]), imag(fastTransform[n]), 1e-4);
+	}
+}
+
+TEST(ChebyshevExpander, getChebyshevNodes){
+	ChebyshevExpander solver;
+	solver.setScaleFactor(10);
+	std::vector<double> nodes = solver.getChebyshevNodes(8);
+	ASSERT_EQ(nodes.size(), 8);
+	for(unsigned int k = 0; k < 8; k++)
+		EXPECT_NEAR(nodes[k], 10*cos(M_PI*(k + 0.5)/8), EPSILON_100);
+}
+
+TEST(ChebyshevExpander, generateGreensFunctionOnChebyshevNodes){
+	const double SCALE_FACTOR = 10;
+	std::complex<double> i(0, 1);
+
+	ChebyshevExpander solver;
+	solver.setScaleFactor(SCALE_FACTOR);
+
+	std::vector<std::complex<double>> coefficients
+		= {1, std::complex<double>(2, 1), 3, -1};
+	std::vector<double> nodes = solver.getChebyshevNodes(8);
+
+	//Retarded.
+	std::vector<std::complex<double>> greensFunction
+		= solver.generateGreensFunctionOnChebyshevNodes(
+			coefficients,
+			8,
+			ChebyshevExpander::Type::Retarded
+		);
+	ASSERT_EQ(greensFunction.size(), 8);
+	for(unsigned int k = 0; k < 8; k++){
+		std::complex<double> reference = -coefficients[0]/2.;
+		for(unsigned int c = 1; c < coefficients.size(); c++){
+			reference -= coefficients[c]*exp(
+				-i*((double)c)*acos(nodes[k]/SCALE_FACTOR)
+			);
+		}
+		reference *= 2.*i/sqrt(
+			pow(SCALE_FACTOR, 2) - pow(nodes[k], 2)
+		);
+		EXPECT_NEAR(real(greensFunction[k]), real(reference), 1e-12);
+		EXPECT_NEAR(imag(greensFunction[k]), imag(reference), 1e-12);
+	}
+
+	//NonPrincipal.
+	greensFunction = solver.generateGreensFunctionOnChebyshevNodes(
+		coefficients,
+		8,
+		ChebyshevExpander::Type::NonPrincipal
+	);
+	for(unsigned int k = 0; k < 8; k++){
+		std::complex<double> reference = coefficients[0]/2.;
+		for(unsigned int c = 1; c < coefficients.size(); c++){
+			reference += coefficients[c]*cos(
+				((double)c)*acos(nodes[k]/SCALE_FACTOR)
+			);
+		}
+		reference *= 2.*i/sqrt(
+			pow(SCALE_FACTOR, 2) - pow(nodes[k], 2)
+		);
+		EXPECT_NEAR(real(greensFunction[k]), real(reference), 1e-12);
+		EXPECT_NEAR(imag(greensFunction[k]), imag(reference), 1e-12);
+	}
+
+	//Fail if the number of nodes is not a power of two.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.generateGreensFunctionOnChebyshevNodes(
+				coefficients,
+				6
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the number of nodes is smaller than the number of
+	//coefficients.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.generateGreensFunctionOnChebyshevNodes(
+				coefficients,
+				2
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
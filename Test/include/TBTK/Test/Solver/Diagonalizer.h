@@ -6,6 +6,7 @@ namespace TBTK{
 namespace Solver{
 
 const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
 
 TEST(Diagonalizer, DynamicTypeInformation){
 	Diagonalizer solver;
@@ -24,6 +25,675 @@ TEST(Diagonalizer, Destructor){
 	//Not testable on its own.
 }
 
+//Helper function that creates a chain with complex hoppings and an on-site
+//potential, to get a non-degenerate spectrum.
+Model createChainModel(unsigned int size){
+	Model model;
+	model.setVerbose(false);
+	for(unsigned int x = 0; x < size; x++){
+		model << HoppingAmplitude(0.1*x, {x}, {x});
+		if(x+1 < size){
+			model << HoppingAmplitude(
+				std::complex<double>(-1, 0.2),
+				{x+1},
+				{x}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	return model;
+}
+
+TEST(Diagonalizer, setAlgorithm){
+	Model model = createChainModel(20);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	//Check that all algorithms give the same eigenvalues and the same
+	//eigenvectors up to a phase.
+	for(
+		Diagonalizer::Algorithm algorithm : {
+			Diagonalizer::Algorithm::Packed,
+			Diagonalizer::Algorithm::DivideAndConquer,
+			Diagonalizer::Algorithm::MRRR
+		}
+	){
+		Diagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setAlgorithm(algorithm);
+		solver.run();
+
+		ASSERT_EQ(solver.getEigenValues().getSize(), 20);
+		for(unsigned int n = 0; n < 20; n++){
+			EXPECT_NEAR(
+				solver.getEigenValue(n),
+				reference.getEigenValue(n),
+				EPSILON_10000
+			);
+
+			std::complex<double> overlap = 0;
+			for(unsigned int x = 0; x < 20; x++){
+				overlap += conj(reference.getAmplitude(n, {x}))
+					*solver.getAmplitude(n, {x});
+			}
+			EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+		}
+	}
+}
+
+TEST(Diagonalizer, getAlgorithm){
+	Diagonalizer solver;
+	EXPECT_TRUE(solver.getAlgorithm() == Diagonalizer::Algorithm::Packed);
+	solver.setAlgorithm(Diagonalizer::Algorithm::DivideAndConquer);
+	EXPECT_TRUE(
+		solver.getAlgorithm()
+			== Diagonalizer::Algorithm::DivideAndConquer
+	);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	EXPECT_TRUE(solver.getAlgorithm() == Diagonalizer::Algorithm::MRRR);
+	solver.setAlgorithm(Diagonalizer::Algorithm::LOBPCG);
+	EXPECT_TRUE(
+		solver.getAlgorithm() == Diagonalizer::Algorithm::LOBPCG
+	);
+}
+
+TEST(Diagonalizer, setEigenValueWindow){
+	Model model = createChainModel(20);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setEigenValueWindow(-1, 1);
+	solver.run();
+
+	//Check that exactly the eigenvalues inside the window are
+	//calculated.
+	unsigned int first = 0;
+	while(reference.getEigenValue(first) <= -1)
+		first++;
+	unsigned int last = first;
+	while(last < 20 && reference.getEigenValue(last) <= 1)
+		last++;
+	ASSERT_EQ(solver.getEigenValues().getSize(), last - first);
+	for(unsigned int n = 0; n < last - first; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			reference.getEigenValue(first + n),
+			EPSILON_10000
+		);
+	}
+
+	//Fail for invalid windows.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setEigenValueWindow(1, -1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for algorithms other than MRRR.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setAlgorithm(Diagonalizer::Algorithm::Packed);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, setEigenStateIndexRange){
+	Model model = createChainModel(20);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setEigenStateIndexRange(3, 7);
+	solver.run();
+
+	//Check the eigenvalues and eigenvectors.
+	ASSERT_EQ(solver.getEigenValues().getSize(), 5);
+	ASSERT_EQ(solver.getEigenVectors().getSize(), 5*20);
+	for(unsigned int n = 0; n < 5; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			reference.getEigenValue(3 + n),
+			EPSILON_10000
+		);
+
+		std::complex<double> overlap = 0;
+		for(unsigned int x = 0; x < 20; x++){
+			overlap += conj(reference.getAmplitude(3 + n, {x}))
+				*solver.getAmplitude(n, {x});
+		}
+		EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+	}
+
+	//Fail for invalid ranges.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setEigenStateIndexRange(3, 2);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setEigenStateIndexRange(3, 20);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, setFullSpectrum){
+	Model model = createChainModel(20);
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setEigenStateIndexRange(3, 7);
+	solver.run();
+	EXPECT_EQ(solver.getEigenValues().getSize(), 5);
+
+	solver.setFullSpectrum();
+	solver.run();
+	EXPECT_EQ(solver.getEigenValues().getSize(), 20);
+}
+
+TEST(Diagonalizer, setEigenVectorMode){
+	Model model = createChainModel(20);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	//Check that only the eigenvalues are calculated for all algorithms.
+	for(
+		Diagonalizer::Algorithm algorithm : {
+			Diagonalizer::Algorithm::Packed,
+			Diagonalizer::Algorithm::DivideAndConquer,
+			Diagonalizer::Algorithm::MRRR
+		}
+	){
+		Diagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setAlgorithm(algorithm);
+		solver.setEigenVectorMode(Diagonalizer::EigenVectorMode::None);
+		solver.run();
+
+		ASSERT_EQ(solver.getEigenValues().getSize(), 20);
+		EXPECT_EQ(solver.getEigenVectors().getSize(), 0);
+		for(unsigned int n = 0; n < 20; n++){
+			EXPECT_NEAR(
+				solver.getEigenValue(n),
+				reference.getEigenValue(n),
+				EPSILON_10000
+			);
+			EXPECT_FALSE(solver.hasEigenVector(n));
+		}
+	}
+
+	//Fail for EigenVectorMode::Window.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Diagonalizer solver;
+			solver.setEigenVectorMode(
+				Diagonalizer::EigenVectorMode::Window
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, getEigenVectorMode){
+	Diagonalizer solver;
+	EXPECT_TRUE(
+		solver.getEigenVectorMode() == Diagonalizer::EigenVectorMode::All
+	);
+	solver.setEigenVectorMode(Diagonalizer::EigenVectorMode::None);
+	EXPECT_TRUE(
+		solver.getEigenVectorMode()
+			== Diagonalizer::EigenVectorMode::None
+	);
+	solver.setEigenVectorWindow(-1, 1);
+	EXPECT_TRUE(
+		solver.getEigenVectorMode()
+			== Diagonalizer::EigenVectorMode::Window
+	);
+}
+
+TEST(Diagonalizer, setEigenVectorWindow){
+	Model model = createChainModel(20);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	for(
+		Diagonalizer::Algorithm algorithm : {
+			Diagonalizer::Algorithm::Packed,
+			Diagonalizer::Algorithm::DivideAndConquer,
+			Diagonalizer::Algorithm::MRRR
+		}
+	){
+		Diagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setAlgorithm(algorithm);
+		solver.setEigenVectorWindow(-1, 1);
+		solver.run();
+
+		//Check that all eigenvalues are calculated, but only the
+		//eigenvectors inside the window.
+		ASSERT_EQ(solver.getEigenValues().getSize(), 20);
+		unsigned int numEigenVectors = 0;
+		for(unsigned int n = 0; n < 20; n++){
+			EXPECT_NEAR(
+				solver.getEigenValue(n),
+				reference.getEigenValue(n),
+				EPSILON_10000
+			);
+
+			double eigenValue = reference.getEigenValue(n);
+			if(eigenValue <= -1 || eigenValue > 1){
+				EXPECT_FALSE(solver.hasEigenVector(n));
+				continue;
+			}
+			EXPECT_TRUE(solver.hasEigenVector(n));
+			numEigenVectors++;
+
+			std::complex<double> overlap = 0;
+			for(unsigned int x = 0; x < 20; x++){
+				overlap += conj(reference.getAmplitude(n, {x}))
+					*solver.getAmplitude(n, {x});
+			}
+			EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+		}
+		EXPECT_TRUE(numEigenVectors > 0);
+		EXPECT_EQ(solver.getEigenVectors().getSize(), 20*numEigenVectors);
+	}
+
+	//Fail for invalid windows.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Diagonalizer solver;
+			solver.setEigenVectorWindow(1, -1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if combined with a partial spectrum.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Diagonalizer solver;
+			solver.setVerbose(false);
+			solver.setModel(model);
+			solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+			solver.setEigenStateIndexRange(3, 7);
+			solver.setEigenVectorWindow(-1, 1);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Two decoupled chains, for which the tridiagonal matrix splits into
+	//blocks.
+	Model decoupledModel;
+	decoupledModel.setVerbose(false);
+	for(unsigned int chain = 0; chain < 2; chain++){
+		for(unsigned int x = 0; x < 10; x++){
+			decoupledModel << HoppingAmplitude(
+				0.1*x + 0.03*chain,
+				{chain, x},
+				{chain, x}
+			);
+			if(x+1 < 10){
+				decoupledModel << HoppingAmplitude(
+					std::complex<double>(-1, 0.2),
+					{chain, x+1},
+					{chain, x}
+				) + HC;
+			}
+		}
+	}
+	decoupledModel.construct();
+
+	Diagonalizer decoupledReference;
+	decoupledReference.setVerbose(false);
+	decoupledReference.setModel(decoupledModel);
+	decoupledReference.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(decoupledModel);
+	solver.setEigenVectorWindow(-1, 1);
+	solver.run();
+	unsigned int numEigenVectors = 0;
+	for(unsigned int n = 0; n < 20; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			decoupledReference.getEigenValue(n),
+			EPSILON_10000
+		);
+		if(!solver.hasEigenVector(n))
+			continue;
+		numEigenVectors++;
+
+		std::complex<double> overlap = 0;
+		for(unsigned int chain = 0; chain < 2; chain++){
+			for(unsigned int x = 0; x < 10; x++){
+				overlap += conj(
+					decoupledReference.getAmplitude(
+						n,
+						{chain, x}
+					)
+				)*solver.getAmplitude(n, {chain, x});
+			}
+		}
+		EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+	}
+	EXPECT_TRUE(numEigenVectors > 0);
+}
+
+TEST(Diagonalizer, hasEigenVector){
+	//Tested through
+	//Diagonalizer::setEigenVectorMode
+	//Diagonalizer::setEigenVectorWindow
+}
+
+//Self-consistency callback that limits the number of LOBPCG iterations
+//after the first step. The following steps therefore only succeed if they
+//start from the eigenvectors of the previous step.
+class LOBPCGSelfConsistencyCallback :
+	public Diagonalizer::SelfConsistencyCallback
+{
+public:
+	int counter;
+	bool selfConsistencyCallback(Diagonalizer &diagonalizer){
+		diagonalizer.setLOBPCGMaxIterations(1);
+		counter++;
+
+		return counter == 3;
+	}
+};
+
+TEST(Diagonalizer, setLOBPCGTolerance){
+	Model model = createChainModel(40);
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.run();
+
+	//Lowest states in an index range.
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::LOBPCG);
+	solver.setLOBPCGTolerance(1e-10);
+	solver.setEigenStateIndexRange(2, 5);
+	solver.run();
+
+	ASSERT_EQ(solver.getEigenValues().getSize(), 4);
+	ASSERT_EQ(solver.getEigenVectors().getSize(), 4*40);
+	for(unsigned int n = 0; n < 4; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			reference.getEigenValue(2 + n),
+			1e-10
+		);
+
+		std::complex<double> overlap = 0;
+		for(unsigned int x = 0; x < 40; x++){
+			overlap += conj(reference.getAmplitude(2 + n, {x}))
+				*solver.getAmplitude(n, {x});
+		}
+		EXPECT_NEAR(abs(overlap), 1, 1e-8);
+	}
+
+	//States in an energy window. The window contains more states than
+	//are iterated initially.
+	solver.setEigenValueWindow(-1.5, 2.5);
+	solver.run();
+
+	unsigned int first = 0;
+	while(reference.getEigenValue(first) <= -1.5)
+		first++;
+	unsigned int last = first;
+	while(last < 40 && reference.getEigenValue(last) <= 2.5)
+		last++;
+	ASSERT_GT(last - first, 16);
+	ASSERT_EQ(solver.getEigenValues().getSize(), last - first);
+	for(unsigned int n = 0; n < last - first; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			reference.getEigenValue(first + n),
+			1e-8
+		);
+
+		std::complex<double> overlap = 0;
+		for(unsigned int x = 0; x < 40; x++){
+			overlap += conj(reference.getAmplitude(first + n, {x}))
+				*solver.getAmplitude(n, {x});
+		}
+		EXPECT_NEAR(abs(overlap), 1, 1e-6);
+	}
+
+	//Self-consistent calculation where each step starts from the
+	//previous eigenvectors.
+	Diagonalizer selfConsistentSolver;
+	selfConsistentSolver.setVerbose(false);
+	selfConsistentSolver.setModel(model);
+	selfConsistentSolver.setAlgorithm(Diagonalizer::Algorithm::LOBPCG);
+	selfConsistentSolver.setLOBPCGTolerance(1e-10);
+	selfConsistentSolver.setEigenStateIndexRange(0, 3);
+	LOBPCGSelfConsistencyCallback lobpcgSelfConsistencyCallback;
+	lobpcgSelfConsistencyCallback.counter = 0;
+	selfConsistentSolver.setSelfConsistencyCallback(
+		lobpcgSelfConsistencyCallback
+	);
+	selfConsistentSolver.run();
+	EXPECT_EQ(lobpcgSelfConsistencyCallback.counter, 3);
+	for(unsigned int n = 0; n < 4; n++){
+		EXPECT_NEAR(
+			selfConsistentSolver.getEigenValue(n),
+			reference.getEigenValue(n),
+			1e-10
+		);
+	}
+
+	//Fail for non-positive tolerances.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setLOBPCGTolerance(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the full spectrum is requested.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setFullSpectrum();
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, getLOBPCGTolerance){
+	Diagonalizer solver;
+	EXPECT_DOUBLE_EQ(solver.getLOBPCGTolerance(), 1e-8);
+	solver.setLOBPCGTolerance(1e-6);
+	EXPECT_DOUBLE_EQ(solver.getLOBPCGTolerance(), 1e-6);
+}
+
+TEST(Diagonalizer, setLOBPCGMaxIterations){
+	Diagonalizer solver;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setLOBPCGMaxIterations(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, getLOBPCGMaxIterations){
+	Diagonalizer solver;
+	EXPECT_EQ(solver.getLOBPCGMaxIterations(), 1000);
+	solver.setLOBPCGMaxIterations(10);
+	EXPECT_EQ(solver.getLOBPCGMaxIterations(), 10);
+}
+
+TEST(Diagonalizer, setNonOrthonormalBasisMethod){
+	//Chain with overlap between nearest neighbors.
+	const unsigned int SIZE = 20;
+	Model model = createChainModel(SIZE);
+	for(unsigned int x = 0; x < SIZE; x++){
+		model << OverlapAmplitude(1, {x}, {x});
+		if(x+1 < SIZE){
+			model << OverlapAmplitude(
+				std::complex<double>(0.2, 0.1),
+				{x+1},
+				{x}
+			);
+			model << OverlapAmplitude(
+				std::complex<double>(0.2, -0.1),
+				{x},
+				{x+1}
+			);
+		}
+	}
+
+	Diagonalizer reference;
+	reference.setVerbose(false);
+	reference.setModel(model);
+	reference.setNonOrthonormalBasisMethod(
+		Diagonalizer::NonOrthonormalBasisMethod::CanonicalOrthogonalization
+	);
+	reference.run();
+
+	for(
+		Diagonalizer::Algorithm algorithm : {
+			Diagonalizer::Algorithm::Packed,
+			Diagonalizer::Algorithm::DivideAndConquer,
+			Diagonalizer::Algorithm::MRRR
+		}
+	){
+		Diagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setAlgorithm(algorithm);
+		solver.setNonOrthonormalBasisMethod(
+			Diagonalizer::NonOrthonormalBasisMethod::Cholesky
+		);
+		solver.run();
+
+		//Check that the eigenvalues agree and that the eigenvectors
+		//are the same up to a phase. Both methods normalize the
+		//eigenvectors such that v^{\dagger}Sv = 1, and the overlap
+		//v_{ref}^{\dagger}Sv therefore has unit magnitude.
+		for(unsigned int n = 0; n < SIZE; n++){
+			EXPECT_NEAR(
+				solver.getEigenValue(n),
+				reference.getEigenValue(n),
+				EPSILON_10000
+			);
+
+			std::complex<double> overlap = 0;
+			for(unsigned int x = 0; x < SIZE; x++){
+				std::complex<double> sv = solver.getAmplitude(n, {x});
+				if(x > 0){
+					sv += std::complex<double>(0.2, 0.1)
+						*solver.getAmplitude(n, {x-1});
+				}
+				if(x+1 < SIZE){
+					sv += std::complex<double>(0.2, -0.1)
+						*solver.getAmplitude(n, {x+1});
+				}
+				overlap += conj(reference.getAmplitude(n, {x}))*sv;
+			}
+			EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+		}
+	}
+
+	//Fail for an overlap matrix that is not positive definite.
+	Model model1;
+	model1.setVerbose(false);
+	model1 << HoppingAmplitude(1, {0}, {0});
+	model1 << HoppingAmplitude(1, {1}, {1});
+	model1.construct();
+	model1 << OverlapAmplitude(1, {0}, {0});
+	model1 << OverlapAmplitude(2, {0}, {1});
+	model1 << OverlapAmplitude(2, {1}, {0});
+	model1 << OverlapAmplitude(1, {1}, {1});
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Diagonalizer solver;
+			solver.setVerbose(false);
+			solver.setModel(model1);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, getNonOrthonormalBasisMethod){
+	Diagonalizer solver;
+	EXPECT_TRUE(
+		solver.getNonOrthonormalBasisMethod()
+			== Diagonalizer::NonOrthonormalBasisMethod::Cholesky
+	);
+	solver.setNonOrthonormalBasisMethod(
+		Diagonalizer::NonOrthonormalBasisMethod::CanonicalOrthogonalization
+	);
+	EXPECT_TRUE(
+		solver.getNonOrthonormalBasisMethod()
+			== Diagonalizer::NonOrthonormalBasisMethod::CanonicalOrthogonalization
+	);
+}
+
 class SelfConsistencyCallback : public Diagonalizer::SelfConsistencyCallback{
 public:
 	int counter;
@@ -183,6 +853,9 @@ TEST(Diagonalizer, getEigenVectors){
 	Diagonalizer solver1;
 	solver1.setVerbose(false);
 	solver1.setModel(model1);
+	solver1.setNonOrthonormalBasisMethod(
+		Diagonalizer::NonOrthonormalBasisMethod::CanonicalOrthogonalization
+	);
 	solver1.run();
 
 	const CArray<std::complex<double>> &eigenVectors2
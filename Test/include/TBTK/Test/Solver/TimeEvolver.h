@@ -0,0 +1,256 @@
+#include "TBTK/Solver/Diagonalizer.h"
+#include "TBTK/Solver/TimeEvolver.h"
+#include "TBTK/UnitHandler.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+
+namespace TBTK{
+namespace Solver{
+
+//Potential that is switched on when the time evolution starts.
+bool timeEvolverIsQuenched = false;
+
+class QuenchedPotential : public HoppingAmplitude::AmplitudeCallback{
+public:
+	virtual std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		if(timeEvolverIsQuenched)
+			return 0.3*to[0];
+		else
+			return 0;
+	}
+};
+
+bool timeEvolverCallback(TimeEvolver *timeEvolver){
+	timeEvolverIsQuenched = (timeEvolver->getCurrentTimeStep() >= 0);
+
+	return true;
+}
+
+//Returns the time step for which H*dt/hbar is equal to the given value for H
+//measured in the base energy unit.
+double getTimeStep(double timeStepOverHbar){
+	return timeStepOverHbar*UnitHandler::getConstantInBaseUnits("hbar")
+		/UnitHandler::convertNaturalToBase<Quantity::Time>(1);
+}
+
+TEST(TimeEvolver, Constructor){
+	//Not testable on its own.
+}
+
+TEST(TimeEvolver, Destructor){
+	//Not testable on its own.
+}
+
+TEST(TimeEvolver, setPropagationMethod){
+	//Tested through TimeEvolver::getPropagationMethod().
+}
+
+TEST(TimeEvolver, getPropagationMethod){
+	TimeEvolver timeEvolver;
+
+	//Default value is Euler.
+	EXPECT_TRUE(
+		timeEvolver.getPropagationMethod()
+		== TimeEvolver::PropagationMethod::Euler
+	);
+
+	//Test setting and getting.
+	timeEvolver.setPropagationMethod(
+		TimeEvolver::PropagationMethod::Chebyshev
+	);
+	EXPECT_TRUE(
+		timeEvolver.getPropagationMethod()
+		== TimeEvolver::PropagationMethod::Chebyshev
+	);
+}
+
+TEST(TimeEvolver, runChebyshev0){
+	//A static Hamiltonian only changes the phase of the eigenstates.
+	const int SIZE = 12;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(0.1*x, {x}, {x});
+		if(x + 1 < SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+	model.setChemicalPotential(0.2);
+
+	Diagonalizer diagonalizer;
+	diagonalizer.setVerbose(false);
+	diagonalizer.setModel(model);
+	diagonalizer.run();
+
+	const int NUM_TIME_STEPS = 5;
+	const double TIME_STEP_OVER_HBAR = 3;
+	timeEvolverIsQuenched = false;
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(timeEvolverCallback);
+	timeEvolver.setPropagationMethod(
+		TimeEvolver::PropagationMethod::Chebyshev
+	);
+	timeEvolver.setNumTimeSteps(NUM_TIME_STEPS);
+	timeEvolver.setTimeStep(getTimeStep(TIME_STEP_OVER_HBAR));
+	timeEvolver.run();
+
+	for(int n = 0; n < SIZE; n++){
+		//The energies of both the propagated and unpropagated states
+		//are the expectation values of the Hamiltonian.
+		double energy = diagonalizer.getEigenValue(n);
+		EXPECT_NEAR(timeEvolver.getEigenValue(n), energy, 1e-12);
+
+		//Only the occupied states are propagated.
+		std::complex<double> phase = 1;
+		if(timeEvolver.getOccupancy(n) != 0){
+			phase = exp(
+				-std::complex<double>(0, 1)*energy
+				*TIME_STEP_OVER_HBAR*(double)NUM_TIME_STEPS
+			);
+		}
+		for(int x = 0; x < SIZE; x++){
+			std::complex<double> expected
+				= phase*diagonalizer.getAmplitude(n, {x});
+			std::complex<double> amplitude
+				= timeEvolver.getAmplitude(n, {x});
+			EXPECT_NEAR(real(amplitude), real(expected), 1e-12);
+			EXPECT_NEAR(imag(amplitude), imag(expected), 1e-12);
+		}
+	}
+}
+
+TEST(TimeEvolver, runChebyshev1){
+	//A quenched Hamiltonian evolved with one large time step gives the
+	//same result as when evolved with many small time steps, and the
+	//evolution is unitary. The Euler method agrees for sufficiently small
+	//time steps.
+	const int SIZE = 12;
+	QuenchedPotential quenchedPotential;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(quenchedPotential, {x}, {x});
+		if(x + 1 < SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+	model.setChemicalPotential(0);
+
+	const double TOTAL_TIME_OVER_HBAR = 4;
+	const int NUM_RUNS = 3;
+	const int NUM_TIME_STEPS[NUM_RUNS] = {1, 20, 20000};
+	const TimeEvolver::PropagationMethod PROPAGATION_METHODS[NUM_RUNS] = {
+		TimeEvolver::PropagationMethod::Chebyshev,
+		TimeEvolver::PropagationMethod::Chebyshev,
+		TimeEvolver::PropagationMethod::Euler
+	};
+	std::vector<std::vector<std::complex<double>>> states[NUM_RUNS];
+	for(int run = 0; run < NUM_RUNS; run++){
+		timeEvolverIsQuenched = false;
+		TimeEvolver timeEvolver;
+		timeEvolver.getDiagonalizer()->setVerbose(false);
+		timeEvolver.setModel(model);
+		timeEvolver.setCallback(timeEvolverCallback);
+		timeEvolver.setPropagationMethod(PROPAGATION_METHODS[run]);
+		timeEvolver.setNumTimeSteps(NUM_TIME_STEPS[run]);
+		timeEvolver.setTimeStep(
+			getTimeStep(TOTAL_TIME_OVER_HBAR/NUM_TIME_STEPS[run])
+		);
+		timeEvolver.run();
+
+		//The states are sorted by their energies, including the states
+		//that are not propagated.
+		double previousEnergy = -std::numeric_limits<double>::max();
+		for(int n = 0; n < SIZE; n++){
+			EXPECT_FALSE(std::isnan(timeEvolver.getEigenValue(n)));
+			EXPECT_GE(timeEvolver.getEigenValue(n), previousEnergy);
+			previousEnergy = timeEvolver.getEigenValue(n);
+		}
+
+		//The energies of the unoccupied states that are not propagated
+		//by the Chebyshev method are the expectation values of the
+		//quenched Hamiltonian.
+		for(int n = 0; n < SIZE; n++){
+			if(
+				PROPAGATION_METHODS[run]
+					!= TimeEvolver::PropagationMethod::Chebyshev
+				|| timeEvolver.getOccupancy(n) != 0
+			){
+				continue;
+			}
+
+			std::complex<double> expectationValue = 0;
+			for(
+				HoppingAmplitudeSet::ConstIterator iterator
+					= model.getHoppingAmplitudeSet().cbegin();
+				iterator != model.getHoppingAmplitudeSet().cend();
+				++iterator
+			){
+				expectationValue += conj(
+					timeEvolver.getAmplitude(
+						n,
+						(*iterator).getToIndex()
+					)
+				)*(*iterator).getAmplitude()
+				*timeEvolver.getAmplitude(
+					n,
+					(*iterator).getFromIndex()
+				);
+			}
+			EXPECT_NEAR(
+				timeEvolver.getEigenValue(n),
+				real(expectationValue),
+				1e-10
+			);
+		}
+
+		for(int n = 0; n < SIZE; n++){
+			if(timeEvolver.getOccupancy(n) == 0)
+				continue;
+
+			states[run].push_back(std::vector<std::complex<double>>());
+			for(int x = 0; x < SIZE; x++){
+				states[run].back().push_back(
+					timeEvolver.getAmplitude(n, {x})
+				);
+			}
+		}
+	}
+
+	ASSERT_EQ(states[0].size(), SIZE/2);
+	for(int run = 1; run < NUM_RUNS; run++)
+		ASSERT_EQ(states[run].size(), states[0].size());
+
+	for(unsigned int m = 0; m < states[0].size(); m++){
+		for(unsigned int n = 0; n < states[0].size(); n++){
+			std::complex<double> overlap = 0;
+			for(int x = 0; x < SIZE; x++)
+				overlap += conj(states[0][m][x])*states[0][n][x];
+			EXPECT_NEAR(abs(overlap), (m == n ? 1 : 0), 1e-13);
+		}
+
+		for(int x = 0; x < SIZE; x++){
+			EXPECT_NEAR(
+				abs(states[1][m][x] - states[0][m][x]),
+				0,
+				1e-12
+			);
+			EXPECT_NEAR(
+				abs(states[2][m][x] - states[0][m][x]),
+				0,
+				5e-3
+			);
+		}
+	}
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
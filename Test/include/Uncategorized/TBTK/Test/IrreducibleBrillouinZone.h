@@ -0,0 +1,371 @@
+#include "TBTK/IrreducibleBrillouinZone.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+namespace TBTK{
+
+class IrreducibleBrillouinZoneTest : public ::testing::Test{
+protected:
+	//Brillouin zone of a square lattice.
+	BrillouinZone brillouinZone = BrillouinZone(
+		{{2*M_PI, 0}, {0, 2*M_PI}},
+		SpacePartition::MeshType::Nodal
+	);
+
+	//Four-fold rotation and mirror symmetry for a single orbital.
+	std::vector<SymmetryOperation> symmetryOperations;
+
+	void SetUp() override{
+		Matrix<std::complex<double>> U(1, 1);
+		U.at(0, 0) = 1;
+		symmetryOperations.push_back(
+			SymmetryOperation({{0, -1}, {1, 0}}, U)
+		);
+		symmetryOperations.push_back(
+			SymmetryOperation({{-1, 0}, {0, 1}}, U)
+		);
+	}
+};
+
+TEST_F(IrreducibleBrillouinZoneTest, Constructor){
+	//Fail for incompatible number of mesh points.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IrreducibleBrillouinZone(
+				brillouinZone,
+				{4},
+				symmetryOperations
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for SymmetryOperations with incompatible dimension.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IrreducibleBrillouinZone(
+				brillouinZone,
+				{4, 4},
+				{SymmetryOperation::createIdentity(3, 1)}
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for SymmetryOperations that do not map the mesh onto itself.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IrreducibleBrillouinZone(
+				brillouinZone,
+				{4, 3},
+				symmetryOperations
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for SymmetryOperations that do not generate a finite group.
+	Matrix<std::complex<double>> U(1, 1);
+	U.at(0, 0) = 1;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IrreducibleBrillouinZone(
+				brillouinZone,
+				{4, 4},
+				{SymmetryOperation({{1, 1}, {0, 1}}, U)}
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getNumDimensions){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	EXPECT_EQ(irreducibleBrillouinZone.getNumDimensions(), 2);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getNumMeshPoints){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	const std::vector<unsigned int> &numMeshPoints
+		= irreducibleBrillouinZone.getNumMeshPoints();
+	ASSERT_EQ(numMeshPoints.size(), 2);
+	EXPECT_EQ(numMeshPoints[0], 4);
+	EXPECT_EQ(numMeshPoints[1], 4);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getSymmetryGroup){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	const std::vector<SymmetryOperation> &symmetryGroup
+		= irreducibleBrillouinZone.getSymmetryGroup();
+
+	//The four-fold rotation and the mirror generate the eight operations
+	//of C4v, with the identity first.
+	ASSERT_EQ(symmetryGroup.size(), 8);
+	EXPECT_TRUE(
+		symmetryGroup[0].hasSameAction(
+			SymmetryOperation::createIdentity(2, 1)
+		)
+	);
+	for(unsigned int n = 0; n < symmetryGroup.size(); n++)
+		for(unsigned int c = n+1; c < symmetryGroup.size(); c++)
+			EXPECT_FALSE(symmetryGroup[n].hasSameAction(symmetryGroup[c]));
+
+	//Time reversal doubles the group since anti-unitary operations are
+	//distinct from the unitary operations with the same rotation.
+	Matrix<std::complex<double>> U(1, 1);
+	U.at(0, 0) = 1;
+	symmetryOperations.push_back(
+		SymmetryOperation({{-1, 0}, {0, -1}}, U, true)
+	);
+	IrreducibleBrillouinZone timeReversalSymmetric(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	EXPECT_EQ(timeReversalSymmetric.getSymmetryGroup().size(), 16);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getIrreducibleMeshPoints){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+
+	//The stars are {(0, 0)}, {(0, 1), ...}, {(0, 2), (2, 0)},
+	//{(1, 1), ...}, {(1, 2), ...}, and {(2, 2)}.
+	const std::vector<Index> &irreducibleMeshPoints
+		= irreducibleBrillouinZone.getIrreducibleMeshPoints();
+	ASSERT_EQ(irreducibleMeshPoints.size(), 6);
+	EXPECT_TRUE(irreducibleMeshPoints[0].equals({0, 0}));
+	EXPECT_TRUE(irreducibleMeshPoints[1].equals({0, 1}));
+	EXPECT_TRUE(irreducibleMeshPoints[2].equals({0, 2}));
+	EXPECT_TRUE(irreducibleMeshPoints[3].equals({1, 1}));
+	EXPECT_TRUE(irreducibleMeshPoints[4].equals({1, 2}));
+	EXPECT_TRUE(irreducibleMeshPoints[5].equals({2, 2}));
+
+	//Without SymmetryOperations, every mesh point is irreducible.
+	IrreducibleBrillouinZone trivial(brillouinZone, {4, 4}, {});
+	EXPECT_EQ(trivial.getIrreducibleMeshPoints().size(), 16);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getIrreducibleMeshPointsInterior){
+	BrillouinZone interiorBrillouinZone(
+		{{2*M_PI, 0}, {0, 2*M_PI}},
+		SpacePartition::MeshType::Interior
+	);
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		interiorBrillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+
+	//The mesh points are at the centers of the mesh cells, which gives
+	//the stars {(0, 0), (0, 3), (3, 0), (3, 3)}, {(0, 1), ...}, and
+	//{(1, 1), (1, 2), (2, 1), (2, 2)}.
+	const std::vector<Index> &irreducibleMeshPoints
+		= irreducibleBrillouinZone.getIrreducibleMeshPoints();
+	ASSERT_EQ(irreducibleMeshPoints.size(), 3);
+	EXPECT_TRUE(irreducibleMeshPoints[0].equals({0, 0}));
+	EXPECT_TRUE(irreducibleMeshPoints[1].equals({0, 1}));
+	EXPECT_TRUE(irreducibleMeshPoints[2].equals({1, 1}));
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({3, 3}).equals(
+			{0, 0}
+		)
+	);
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({3, 2}).equals(
+			{0, 1}
+		)
+	);
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({2, 2}).equals(
+			{1, 1}
+		)
+	);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({0, 0}), 4/16.);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({2, 0}), 8/16.);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({1, 2}), 4/16.);
+
+	//The SymmetryOperation maps the k-vector of the irreducible mesh
+	//point to a k-vector in the mesh cell of the mesh point.
+	for(int x = 0; x < 4; x++){
+		for(int y = 0; y < 4; y++){
+			const Index &irreducibleMeshPoint
+				= irreducibleBrillouinZone.getIrreducibleMeshPoint(
+					{x, y}
+				);
+			std::vector<double> k = {
+				2*M_PI*(irreducibleMeshPoint[0] + 1/2.)/4,
+				2*M_PI*(irreducibleMeshPoint[1] + 1/2.)/4
+			};
+			std::vector<double> image
+				= irreducibleBrillouinZone.getSymmetryOperation(
+					{x, y}
+				).apply(k);
+			for(unsigned int n = 0; n < 2; n++)
+				if(image[n] < 0)
+					image[n] += 2*M_PI;
+			EXPECT_TRUE(
+				interiorBrillouinZone.getMinorCellIndex(
+					image,
+					{4, 4}
+				).equals({x, y})
+			);
+		}
+	}
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getIrreducibleMeshPoint){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({3, 0}).equals(
+			{0, 1}
+		)
+	);
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({2, 0}).equals(
+			{0, 2}
+		)
+	);
+	EXPECT_TRUE(
+		irreducibleBrillouinZone.getIrreducibleMeshPoint({3, 2}).equals(
+			{1, 2}
+		)
+	);
+
+	//Fail for mesh points out of range.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			irreducibleBrillouinZone.getIrreducibleMeshPoint({4, 0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			irreducibleBrillouinZone.getIrreducibleMeshPoint({0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, isIrreducible){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	unsigned int counter = 0;
+	for(int x = 0; x < 4; x++){
+		for(int y = 0; y < 4; y++){
+			Index meshPoint({x, y});
+			if(irreducibleBrillouinZone.isIrreducible(meshPoint)){
+				EXPECT_TRUE(
+					irreducibleBrillouinZone.getIrreducibleMeshPoint(
+						meshPoint
+					).equals(meshPoint)
+				);
+				counter++;
+			}
+		}
+	}
+	EXPECT_EQ(counter, 6);
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getSymmetryOperation){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+
+	//The SymmetryOperation maps the k-vector of the irreducible mesh
+	//point to the k-vector of the mesh point, up to a reciprocal lattice
+	//vector.
+	for(unsigned int x = 0; x < 4; x++){
+		for(unsigned int y = 0; y < 4; y++){
+			Index meshPoint({(int)x, (int)y});
+			const Index &irreducibleMeshPoint
+				= irreducibleBrillouinZone.getIrreducibleMeshPoint(
+					meshPoint
+				);
+			std::vector<double> k = brillouinZone.getMinorMeshPoint(
+				{
+					(unsigned int)irreducibleMeshPoint[0],
+					(unsigned int)irreducibleMeshPoint[1]
+				},
+				{4, 4}
+			);
+			std::vector<double> image
+				= irreducibleBrillouinZone.getSymmetryOperation(
+					meshPoint
+				).apply(k);
+			std::vector<double> expected
+				= brillouinZone.getMinorMeshPoint({x, y}, {4, 4});
+			for(unsigned int n = 0; n < 2; n++){
+				double difference
+					= (image[n] - expected[n])/(2*M_PI);
+				EXPECT_NEAR(
+					difference,
+					std::round(difference),
+					1e-10
+				);
+			}
+		}
+	}
+}
+
+TEST_F(IrreducibleBrillouinZoneTest, getWeight){
+	IrreducibleBrillouinZone irreducibleBrillouinZone(
+		brillouinZone,
+		{4, 4},
+		symmetryOperations
+	);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({0, 0}), 1/16.);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({0, 2}), 2/16.);
+	EXPECT_DOUBLE_EQ(irreducibleBrillouinZone.getWeight({3, 1}), 4/16.);
+
+	//The weights of the irreducible mesh points sum up to one.
+	double totalWeight = 0;
+	const std::vector<Index> &irreducibleMeshPoints
+		= irreducibleBrillouinZone.getIrreducibleMeshPoints();
+	for(unsigned int n = 0; n < irreducibleMeshPoints.size(); n++){
+		totalWeight += irreducibleBrillouinZone.getWeight(
+			irreducibleMeshPoints[n]
+		);
+	}
+	EXPECT_DOUBLE_EQ(totalWeight, 1);
+}
+
+};
@@ -0,0 +1,195 @@
+#include "TBTK/SymmetryOperation.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+
+//Four-fold rotation acting on a px and py orbital.
+SymmetryOperation createC4(){
+	Matrix<std::complex<double>> U(2, 2);
+	U.at(0, 0) = 0;
+	U.at(0, 1) = -1;
+	U.at(1, 0) = 1;
+	U.at(1, 1) = 0;
+
+	return SymmetryOperation({{0, -1}, {1, 0}}, U);
+}
+
+TEST(SymmetryOperation, Constructor){
+	SymmetryOperation c4 = createC4();
+	EXPECT_EQ(c4.getNumDimensions(), 2);
+	EXPECT_EQ(c4.getNumOrbitals(), 2);
+	EXPECT_FALSE(c4.isAntiUnitary());
+
+	//Fail for unsupported dimensions.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SymmetryOperation(
+				{},
+				Matrix<std::complex<double>>(1, 1)
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for non-square rotation.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SymmetryOperation(
+				{{1, 0}, {0}},
+				Matrix<std::complex<double>>(1, 1)
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for non-square orbital representation.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SymmetryOperation(
+				{{1}},
+				Matrix<std::complex<double>>(1, 2)
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(SymmetryOperation, createIdentity){
+	SymmetryOperation identity = SymmetryOperation::createIdentity(3, 2);
+	EXPECT_EQ(identity.getNumDimensions(), 3);
+	EXPECT_EQ(identity.getNumOrbitals(), 2);
+	EXPECT_FALSE(identity.isAntiUnitary());
+	for(unsigned int row = 0; row < 3; row++)
+		for(unsigned int col = 0; col < 3; col++)
+			EXPECT_EQ(identity.getRotation()[row][col], row == col);
+	for(unsigned int row = 0; row < 2; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			EXPECT_EQ(
+				identity.getOrbitalRepresentation().at(row, col),
+				std::complex<double>(row == col)
+			);
+		}
+	}
+}
+
+TEST(SymmetryOperation, getNumDimensions){
+	//Tested through SymmetryOperation::Constructor.
+}
+
+TEST(SymmetryOperation, getNumOrbitals){
+	//Tested through SymmetryOperation::Constructor.
+}
+
+TEST(SymmetryOperation, getRotation){
+	//Tested through SymmetryOperation::createIdentity.
+}
+
+TEST(SymmetryOperation, getOrbitalRepresentation){
+	//Tested through SymmetryOperation::createIdentity.
+}
+
+TEST(SymmetryOperation, isAntiUnitary){
+	Matrix<std::complex<double>> U(1, 1);
+	U.at(0, 0) = 1;
+	EXPECT_FALSE(SymmetryOperation({{-1}}, U).isAntiUnitary());
+	EXPECT_TRUE(SymmetryOperation({{-1}}, U, true).isAntiUnitary());
+}
+
+TEST(SymmetryOperation, apply){
+	SymmetryOperation c4 = createC4();
+	std::vector<double> k = c4.apply({1, 2});
+	ASSERT_EQ(k.size(), 2);
+	EXPECT_DOUBLE_EQ(k[0], -2);
+	EXPECT_DOUBLE_EQ(k[1], 1);
+
+	//Fail for incompatible dimensions.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			c4.apply({1, 2, 3});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(SymmetryOperation, operatorMultiplication){
+	SymmetryOperation c4 = createC4();
+
+	//Four rotations give the identity.
+	SymmetryOperation c4Squared = c4*c4;
+	SymmetryOperation c4Fourth = c4Squared*c4Squared;
+	EXPECT_TRUE(
+		c4Fourth.hasSameAction(SymmetryOperation::createIdentity(2, 2))
+	);
+	EXPECT_FALSE(
+		c4Squared.hasSameAction(
+			SymmetryOperation::createIdentity(2, 2)
+		)
+	);
+	for(unsigned int row = 0; row < 2; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			EXPECT_EQ(
+				c4Squared.getOrbitalRepresentation().at(
+					row,
+					col
+				),
+				-std::complex<double>(row == col)
+			);
+			EXPECT_EQ(
+				c4Fourth.getOrbitalRepresentation().at(row, col),
+				std::complex<double>(row == col)
+			);
+		}
+	}
+
+	//An anti-unitary left hand side conjugates the representation of the
+	//right hand side.
+	Matrix<std::complex<double>> U(1, 1);
+	U.at(0, 0) = std::complex<double>(0, 1);
+	SymmetryOperation unitary({{-1}}, U);
+	U.at(0, 0) = 1;
+	SymmetryOperation antiUnitary({{-1}}, U, true);
+	SymmetryOperation product = antiUnitary*unitary;
+	EXPECT_TRUE(product.isAntiUnitary());
+	EXPECT_DOUBLE_EQ(product.getRotation()[0][0], 1);
+	EXPECT_EQ(
+		product.getOrbitalRepresentation().at(0, 0),
+		std::complex<double>(0, -1)
+	);
+	product = unitary*antiUnitary;
+	EXPECT_TRUE(product.isAntiUnitary());
+	EXPECT_EQ(
+		product.getOrbitalRepresentation().at(0, 0),
+		std::complex<double>(0, 1)
+	);
+	EXPECT_FALSE((antiUnitary*antiUnitary).isAntiUnitary());
+}
+
+TEST(SymmetryOperation, hasSameAction){
+	SymmetryOperation c4 = createC4();
+	Matrix<std::complex<double>> U(2, 2);
+	U.at(0, 0) = 1;
+	U.at(0, 1) = 0;
+	U.at(1, 0) = 0;
+	U.at(1, 1) = 1;
+
+	//The orbital representation is not compared.
+	EXPECT_TRUE(c4.hasSameAction(SymmetryOperation({{0, -1}, {1, 0}}, U)));
+	EXPECT_FALSE(
+		c4.hasSameAction(SymmetryOperation({{0, -1}, {1, 0}}, U, true))
+	);
+	EXPECT_FALSE(c4.hasSameAction(SymmetryOperation({{0, 1}, {-1, 0}}, U)));
+	EXPECT_FALSE(
+		c4.hasSameAction(SymmetryOperation::createIdentity(3, 2))
+	);
+}
+
+};
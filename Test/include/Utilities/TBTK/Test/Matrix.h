@@ -0,0 +1,326 @@
+#include "TBTK/Matrix.h"
+
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <vector>
+
+namespace TBTK{
+
+const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+Matrix<double> createDoubleMatrix(unsigned int rows, unsigned int cols){
+	Matrix<double> matrix(rows, cols);
+	for(unsigned int row = 0; row < rows; row++)
+		for(unsigned int col = 0; col < cols; col++)
+			matrix.at(row, col) = row + 2.*col + 1;
+
+	return matrix;
+}
+
+Matrix<std::complex<double>> createComplexMatrix(
+	unsigned int rows,
+	unsigned int cols
+){
+	Matrix<std::complex<double>> matrix(rows, cols);
+	for(unsigned int row = 0; row < rows; row++){
+		for(unsigned int col = 0; col < cols; col++){
+			matrix.at(row, col)
+				= std::complex<double>(row + 1., col - 2.*row);
+		}
+	}
+
+	return matrix;
+}
+
+//TBTKFeature Utilities.Matrix.operatorMultiplication.1 2026-10-16
+TEST(Matrix, operatorMultiplication0){
+	Matrix<int> lhs(2, 3);
+	Matrix<int> rhs(3, 2);
+	for(unsigned int row = 0; row < 2; row++){
+		for(unsigned int col = 0; col < 3; col++){
+			lhs.at(row, col) = row + col;
+			rhs.at(col, row) = row*col + 1;
+		}
+	}
+
+	Matrix<int> result = lhs*rhs;
+	EXPECT_EQ(result.getNumRows(), 2);
+	EXPECT_EQ(result.getNumCols(), 2);
+	for(unsigned int row = 0; row < 2; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			int reference = 0;
+			for(unsigned int n = 0; n < 3; n++)
+				reference += (row + n)*(n*col + 1);
+			EXPECT_EQ(result.at(row, col), reference);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.operatorMultiplication.2 2026-10-16
+TEST(Matrix, operatorMultiplication1){
+	Matrix<double> lhs = createDoubleMatrix(3, 4);
+	Matrix<double> rhs = createDoubleMatrix(4, 2);
+
+	Matrix<double> result = lhs*rhs;
+	EXPECT_EQ(result.getNumRows(), 3);
+	EXPECT_EQ(result.getNumCols(), 2);
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			double reference = 0;
+			for(unsigned int n = 0; n < 4; n++)
+				reference += lhs.at(row, n)*rhs.at(n, col);
+			EXPECT_NEAR(result.at(row, col), reference, EPSILON_100);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.operatorMultiplication.3 2026-10-16
+TEST(Matrix, operatorMultiplication2){
+	Matrix<std::complex<double>> lhs = createComplexMatrix(3, 4);
+	Matrix<std::complex<double>> rhs = createComplexMatrix(4, 2);
+
+	Matrix<std::complex<double>> result = lhs*rhs;
+	EXPECT_EQ(result.getNumRows(), 3);
+	EXPECT_EQ(result.getNumCols(), 2);
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			std::complex<double> reference = 0;
+			for(unsigned int n = 0; n < 4; n++)
+				reference += lhs.at(row, n)*rhs.at(n, col);
+			EXPECT_NEAR(
+				real(result.at(row, col)),
+				real(reference),
+				EPSILON_100
+			);
+			EXPECT_NEAR(
+				imag(result.at(row, col)),
+				imag(reference),
+				EPSILON_100
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.operatorMultiplication.4 2026-10-16
+TEST(Matrix, operatorMultiplication3){
+	Matrix<std::complex<double>> lhs = createComplexMatrix(3, 4);
+	Matrix<std::complex<double>> rhs = createComplexMatrix(3, 2);
+
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			lhs*rhs;
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.Matrix.multiply.1 2026-10-16
+TEST(Matrix, multiply0){
+	Matrix<double> lhs = createDoubleMatrix(3, 4);
+	Matrix<double> rhs = createDoubleMatrix(4, 2);
+	Matrix<double> result = createDoubleMatrix(3, 2);
+	Matrix<double> original = result;
+
+	result.multiply(lhs, rhs, 2, 3);
+	Matrix<double> product = lhs*rhs;
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			EXPECT_NEAR(
+				result.at(row, col),
+				2*product.at(row, col) + 3*original.at(row, col),
+				EPSILON_100
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.multiply.2 2026-10-16
+TEST(Matrix, multiply1){
+	Matrix<std::complex<double>> lhs = createComplexMatrix(3, 4);
+	Matrix<std::complex<double>> rhs = createComplexMatrix(4, 2);
+	Matrix<std::complex<double>> result = createComplexMatrix(3, 2);
+	Matrix<std::complex<double>> original = result;
+
+	std::complex<double> alpha(1, 2);
+	std::complex<double> beta(-1, 0.5);
+	result.multiply(lhs, rhs, alpha, beta);
+	Matrix<std::complex<double>> product = lhs*rhs;
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			std::complex<double> reference
+				= alpha*product.at(row, col)
+					+ beta*original.at(row, col);
+			EXPECT_NEAR(
+				abs(result.at(row, col) - reference),
+				0,
+				EPSILON_100
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.multiply.3 2026-10-16
+TEST(Matrix, multiply2){
+	//Resize the matrix when beta is zero.
+	Matrix<std::complex<double>> lhs = createComplexMatrix(3, 4);
+	Matrix<std::complex<double>> rhs = createComplexMatrix(4, 2);
+	Matrix<std::complex<double>> result(5, 5);
+	result.multiply(lhs, rhs);
+	EXPECT_EQ(result.getNumRows(), 3);
+	EXPECT_EQ(result.getNumCols(), 2);
+
+	//Fail for incompatible dimensions when beta is non-zero.
+	Matrix<std::complex<double>> wrongSize(5, 5);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			wrongSize.multiply(lhs, rhs, 1, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the result is stored in one of the factors.
+	Matrix<std::complex<double>> square = createComplexMatrix(3, 3);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			square.multiply(square, square);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.Matrix.adjointMultiply.1 2026-10-16
+TEST(Matrix, adjointMultiply0){
+	Matrix<double> lhs = createDoubleMatrix(4, 3);
+	Matrix<double> rhs = createDoubleMatrix(4, 2);
+	Matrix<double> result;
+	result.adjointMultiply(lhs, rhs);
+	EXPECT_EQ(result.getNumRows(), 3);
+	EXPECT_EQ(result.getNumCols(), 2);
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			double reference = 0;
+			for(unsigned int n = 0; n < 4; n++)
+				reference += lhs.at(n, row)*rhs.at(n, col);
+			EXPECT_NEAR(result.at(row, col), reference, EPSILON_100);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.adjointMultiply.2 2026-10-16
+TEST(Matrix, adjointMultiply1){
+	Matrix<std::complex<double>> lhs = createComplexMatrix(4, 3);
+	Matrix<std::complex<double>> rhs = createComplexMatrix(4, 2);
+	Matrix<std::complex<double>> result = createComplexMatrix(3, 2);
+	Matrix<std::complex<double>> original = result;
+	result.adjointMultiply(lhs, rhs, 2, 1);
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			std::complex<double> reference = original.at(row, col);
+			for(unsigned int n = 0; n < 4; n++){
+				reference += 2.*conj(lhs.at(n, row))
+					*rhs.at(n, col);
+			}
+			EXPECT_NEAR(
+				abs(result.at(row, col) - reference),
+				0,
+				EPSILON_100
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.adjointMultiply.3 2026-10-16
+TEST(Matrix, adjointMultiply2){
+	Matrix<std::complex<float>> lhs(4, 3);
+	Matrix<std::complex<float>> rhs(4, 2);
+	for(unsigned int row = 0; row < 4; row++){
+		for(unsigned int col = 0; col < 3; col++)
+			lhs.at(row, col) = std::complex<float>(row, col + 1);
+		for(unsigned int col = 0; col < 2; col++)
+			rhs.at(row, col) = std::complex<float>(col, row + 1);
+	}
+	Matrix<std::complex<float>> result;
+	result.adjointMultiply(lhs, rhs);
+	EXPECT_EQ(result.getNumRows(), 3);
+	EXPECT_EQ(result.getNumCols(), 2);
+	for(unsigned int row = 0; row < 3; row++){
+		for(unsigned int col = 0; col < 2; col++){
+			std::complex<float> reference = 0;
+			for(unsigned int n = 0; n < 4; n++){
+				reference += conj(lhs.at(n, row))
+					*rhs.at(n, col);
+			}
+			EXPECT_FLOAT_EQ(
+				real(result.at(row, col)),
+				real(reference)
+			);
+			EXPECT_FLOAT_EQ(
+				imag(result.at(row, col)),
+				imag(reference)
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.Matrix.diagonalizeHermitian.1 2026-10-16
+TEST(Matrix, diagonalizeHermitian0){
+	const unsigned int SIZE = 5;
+	Matrix<std::complex<double>> matrix(SIZE, SIZE);
+	for(unsigned int row = 0; row < SIZE; row++){
+		for(unsigned int col = 0; col < SIZE; col++){
+			if(row == col)
+				matrix.at(row, col) = row;
+			else if(row < col)
+				matrix.at(row, col) = std::complex<double>(1, 0.5);
+			else
+				matrix.at(row, col) = std::complex<double>(1, -0.5);
+		}
+	}
+
+	std::vector<double> eigenValues;
+	Matrix<std::complex<double>> eigenVectors;
+	matrix.diagonalizeHermitian(eigenValues, eigenVectors);
+	ASSERT_EQ(eigenValues.size(), SIZE);
+	EXPECT_EQ(eigenVectors.getNumRows(), SIZE);
+	EXPECT_EQ(eigenVectors.getNumCols(), SIZE);
+
+	//Check that the eigenvalues are sorted and that Hv = Ev.
+	Matrix<std::complex<double>> product = matrix*eigenVectors;
+	for(unsigned int n = 0; n < SIZE; n++){
+		if(n > 0)
+			EXPECT_LE(eigenValues[n-1], eigenValues[n]);
+
+		for(unsigned int row = 0; row < SIZE; row++){
+			EXPECT_NEAR(
+				abs(
+					product.at(row, n)
+					- eigenValues[n]*eigenVectors.at(row, n)
+				),
+				0,
+				EPSILON_100
+			);
+		}
+	}
+
+	//Check that the eigenvectors are orthonormal.
+	Matrix<std::complex<double>> overlap;
+	overlap.adjointMultiply(eigenVectors, eigenVectors);
+	for(unsigned int row = 0; row < SIZE; row++){
+		for(unsigned int col = 0; col < SIZE; col++){
+			EXPECT_NEAR(
+				abs(overlap.at(row, col) - (row == col ? 1. : 0.)),
+				0,
+				EPSILON_100
+			);
+		}
+	}
+}
+
+};
@@ -0,0 +1,95 @@
+#include "TBTK/MemoryMappedFile.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+namespace TBTK{
+
+//Helper function that checks whether a file exists.
+bool memoryMappedFileExists(const std::string &filename){
+	std::ifstream fin(filename);
+
+	return fin.good();
+}
+
+//TBTKFeature Utilities.MemoryMappedFile.construction.1 2026-10-16
+TEST(MemoryMappedFile, Constructor0){
+	MemoryMappedFile memoryMappedFile;
+	EXPECT_EQ(memoryMappedFile.getData(), nullptr);
+	EXPECT_EQ(memoryMappedFile.getSize(), 0);
+	EXPECT_EQ(memoryMappedFile.getFilename(), "");
+}
+
+//TBTKFeature Utilities.MemoryMappedFile.construction.2 2026-10-16
+TEST(MemoryMappedFile, Constructor1){
+	const std::string FILENAME = "TBTKTestMemoryMappedFile.bin";
+	{
+		MemoryMappedFile memoryMappedFile(FILENAME, 1000*sizeof(double));
+		EXPECT_NE(memoryMappedFile.getData(), nullptr);
+		EXPECT_EQ(memoryMappedFile.getSize(), 1000*sizeof(double));
+		EXPECT_EQ(memoryMappedFile.getFilename(), FILENAME);
+		EXPECT_TRUE(memoryMappedFileExists(FILENAME));
+
+		//The memory can be written to and read from.
+		double *data = static_cast<double*>(memoryMappedFile.getData());
+		for(unsigned int n = 0; n < 1000; n++)
+			data[n] = n;
+		for(unsigned int n = 0; n < 1000; n++)
+			EXPECT_EQ(data[n], n);
+	}
+
+	//The file is removed when the MemoryMappedFile is destroyed.
+	EXPECT_FALSE(memoryMappedFileExists(FILENAME));
+}
+
+//TBTKFeature Utilities.MemoryMappedFile.construction.3 2026-10-16
+TEST(MemoryMappedFile, Constructor2){
+	//Fail to create a file in a directory that does not exist.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			MemoryMappedFile memoryMappedFile(
+				"TBTKNonExistingDirectory/File.bin",
+				100
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.MemoryMappedFile.moveConstruction.1 2026-10-16
+TEST(MemoryMappedFile, MoveConstructor){
+	const std::string FILENAME = "TBTKTestMemoryMappedFile.bin";
+	MemoryMappedFile memoryMappedFile0(FILENAME, 100);
+	void *data = memoryMappedFile0.getData();
+	MemoryMappedFile memoryMappedFile1 = std::move(memoryMappedFile0);
+	EXPECT_EQ(memoryMappedFile0.getData(), nullptr);
+	EXPECT_EQ(memoryMappedFile0.getSize(), 0);
+	EXPECT_EQ(memoryMappedFile1.getData(), data);
+	EXPECT_EQ(memoryMappedFile1.getSize(), 100);
+	EXPECT_EQ(memoryMappedFile1.getFilename(), FILENAME);
+	EXPECT_TRUE(memoryMappedFileExists(FILENAME));
+}
+
+//TBTKFeature Utilities.MemoryMappedFile.moveAssignment.1 2026-10-16
+TEST(MemoryMappedFile, operatorMoveAssignment){
+	const std::string FILENAME0 = "TBTKTestMemoryMappedFile0.bin";
+	const std::string FILENAME1 = "TBTKTestMemoryMappedFile1.bin";
+	MemoryMappedFile memoryMappedFile0(FILENAME0, 100);
+	MemoryMappedFile memoryMappedFile1(FILENAME1, 200);
+	void *data = memoryMappedFile0.getData();
+	memoryMappedFile1 = std::move(memoryMappedFile0);
+	EXPECT_EQ(memoryMappedFile0.getData(), nullptr);
+	EXPECT_EQ(memoryMappedFile1.getData(), data);
+	EXPECT_EQ(memoryMappedFile1.getSize(), 100);
+	EXPECT_EQ(memoryMappedFile1.getFilename(), FILENAME0);
+
+	//The file that was overwritten is removed.
+	EXPECT_TRUE(memoryMappedFileExists(FILENAME0));
+	EXPECT_FALSE(memoryMappedFileExists(FILENAME1));
+}
+
+};
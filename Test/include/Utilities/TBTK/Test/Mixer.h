@@ -0,0 +1,249 @@
+#include "TBTK/Mixer.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+namespace TBTK{
+
+//Fixed point iteration x -> Mx + b, with M having eigenvalues close to one
+//to make linear mixing converge slowly.
+std::vector<std::complex<double>> iterateLinearProblem(
+	const std::vector<std::complex<double>> &x
+){
+	const unsigned int SIZE = x.size();
+	std::vector<std::complex<double>> result(SIZE);
+	for(unsigned int n = 0; n < SIZE; n++){
+		result[n] = 0.9*x[n] + std::complex<double>(1, n);
+		if(n > 0)
+			result[n] += 0.04*x[n-1];
+		if(n + 1 < SIZE)
+			result[n] += 0.04*x[n+1];
+	}
+
+	return result;
+}
+
+//Fixed point iteration x -> 2 + tanh(x) - 0.5*x. Mildly nonlinear.
+std::vector<std::complex<double>> iterateNonlinearProblem(
+	const std::vector<std::complex<double>> &x
+){
+	std::vector<std::complex<double>> result(x.size());
+	for(unsigned int n = 0; n < x.size(); n++)
+		result[n] = 2. + tanh(x[n]) - 0.5*x[n];
+
+	return result;
+}
+
+unsigned int solve(
+	Mixer &mixer,
+	std::vector<std::complex<double>> &x,
+	std::vector<std::complex<double>> (*iterate)(
+		const std::vector<std::complex<double>> &x
+	),
+	unsigned int maxIterations
+){
+	for(unsigned int n = 0; n < maxIterations; n++)
+		if(mixer.update(x, iterate(x)))
+			return n + 1;
+
+	return maxIterations;
+}
+
+//TBTKFeature Utilities.Mixer.construction.1 2026-10-16
+TEST(Mixer, constructor0){
+	Mixer mixer;
+	EXPECT_TRUE(mixer.getMethod() == Mixer::Method::Pulay);
+	EXPECT_DOUBLE_EQ(mixer.getMixingParameter(), 0.5);
+	EXPECT_EQ(mixer.getHistorySize(), 8);
+	EXPECT_EQ(mixer.getNumIterations(), 0);
+	EXPECT_FALSE(mixer.isConverged());
+}
+
+//TBTKFeature Utilities.Mixer.construction.2 2026-10-16
+TEST(Mixer, constructor1){
+	Mixer mixer(Mixer::Method::Broyden, 0.2, 4);
+	EXPECT_TRUE(mixer.getMethod() == Mixer::Method::Broyden);
+	EXPECT_DOUBLE_EQ(mixer.getMixingParameter(), 0.2);
+	EXPECT_EQ(mixer.getHistorySize(), 4);
+}
+
+//TBTKFeature Utilities.Mixer.setMixingParameter.1 2026-10-16
+TEST(Mixer, setMixingParameter0){
+	Mixer mixer;
+	mixer.setMixingParameter(0.1);
+	EXPECT_DOUBLE_EQ(mixer.getMixingParameter(), 0.1);
+
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			mixer.setMixingParameter(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.Mixer.setHistorySize.1 2026-10-16
+TEST(Mixer, setHistorySize0){
+	Mixer mixer;
+	mixer.setHistorySize(3);
+	EXPECT_EQ(mixer.getHistorySize(), 3);
+
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			mixer.setHistorySize(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.Mixer.setTolerance.1 2026-10-16
+TEST(Mixer, setTolerance0){
+	Mixer mixer;
+	mixer.setTolerance(1e-3);
+	EXPECT_DOUBLE_EQ(mixer.getTolerance(), 1e-3);
+}
+
+//TBTKFeature Utilities.Mixer.mix.1 2026-10-16
+TEST(Mixer, mix0){
+	//Linear mixing.
+	Mixer mixer(Mixer::Method::Linear, 0.25);
+	std::vector<std::complex<double>> input = {1, std::complex<double>(0, 2)};
+	std::vector<std::complex<double>> output = {3, std::complex<double>(4, 2)};
+	std::vector<std::complex<double>> result = mixer.mix(input, output);
+	EXPECT_DOUBLE_EQ(real(result[0]), 1.5);
+	EXPECT_DOUBLE_EQ(imag(result[0]), 0);
+	EXPECT_DOUBLE_EQ(real(result[1]), 1);
+	EXPECT_DOUBLE_EQ(imag(result[1]), 2);
+	EXPECT_EQ(mixer.getNumIterations(), 1);
+	EXPECT_DOUBLE_EQ(mixer.getResidual(), sqrt(20.));
+}
+
+//TBTKFeature Utilities.Mixer.mix.2 2026-10-16
+TEST(Mixer, mix1){
+	//Fail for incompatible sizes.
+	Mixer mixer;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			mixer.mix({1, 2}, {1, 2, 3});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	mixer.mix({1, 2}, {2, 3});
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			mixer.mix({1, 2, 3}, {1, 2, 3});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.Mixer.update.1 2026-10-16
+TEST(Mixer, update0){
+	//The accelerated methods should converge to the same fixed point as
+	//linear mixing, but in considerably fewer iterations.
+	const unsigned int SIZE = 10;
+	const unsigned int MAX_ITERATIONS = 10000;
+
+	Mixer linearMixer(Mixer::Method::Linear, 0.5);
+	linearMixer.setTolerance(1e-10);
+	std::vector<std::complex<double>> reference(SIZE, 0.);
+	unsigned int linearIterations = solve(
+		linearMixer,
+		reference,
+		iterateLinearProblem,
+		MAX_ITERATIONS
+	);
+	ASSERT_TRUE(linearMixer.isConverged());
+
+	Mixer::Method methods[3] = {
+		Mixer::Method::Anderson,
+		Mixer::Method::Pulay,
+		Mixer::Method::Broyden
+	};
+	for(unsigned int n = 0; n < 3; n++){
+		Mixer mixer(methods[n], 0.5);
+		mixer.setTolerance(1e-10);
+		std::vector<std::complex<double>> x(SIZE, 0.);
+		unsigned int iterations = solve(
+			mixer,
+			x,
+			iterateLinearProblem,
+			MAX_ITERATIONS
+		);
+		EXPECT_TRUE(mixer.isConverged());
+		EXPECT_LT(5*iterations, linearIterations);
+		for(unsigned int c = 0; c < SIZE; c++)
+			EXPECT_NEAR(abs(x[c] - reference[c]), 0, 1e-8);
+	}
+}
+
+//TBTKFeature Utilities.Mixer.update.2 2026-10-16
+TEST(Mixer, update1){
+	const unsigned int SIZE = 5;
+	const unsigned int MAX_ITERATIONS = 200;
+
+	Mixer::Method methods[4] = {
+		Mixer::Method::Linear,
+		Mixer::Method::Anderson,
+		Mixer::Method::Pulay,
+		Mixer::Method::Broyden
+	};
+	for(unsigned int n = 0; n < 4; n++){
+		Mixer mixer(methods[n], 0.5, 4);
+		mixer.setTolerance(1e-10);
+		std::vector<std::complex<double>> x(SIZE, 0.);
+		solve(mixer, x, iterateNonlinearProblem, MAX_ITERATIONS);
+		EXPECT_TRUE(mixer.isConverged());
+
+		std::vector<std::complex<double>> y
+			= iterateNonlinearProblem(x);
+		for(unsigned int c = 0; c < SIZE; c++)
+			EXPECT_NEAR(abs(x[c] - y[c]), 0, 1e-9);
+	}
+}
+
+//TBTKFeature Utilities.Mixer.getResidualHistory.1 2026-10-16
+TEST(Mixer, getResidualHistory0){
+	Mixer mixer(Mixer::Method::Pulay, 0.5);
+	std::vector<std::complex<double>> x(4, 0.);
+	for(unsigned int n = 0; n < 3; n++)
+		mixer.update(x, iterateLinearProblem(x));
+
+	const std::vector<double> &residualHistory
+		= mixer.getResidualHistory();
+	EXPECT_EQ(residualHistory.size(), 3);
+	EXPECT_DOUBLE_EQ(residualHistory.back(), mixer.getResidual());
+}
+
+//TBTKFeature Utilities.Mixer.reset.1 2026-10-16
+TEST(Mixer, reset0){
+	Mixer mixer;
+	mixer.mix({1, 2}, {2, 3});
+	mixer.reset();
+	EXPECT_EQ(mixer.getNumIterations(), 0);
+	EXPECT_EQ(mixer.getResidualHistory().size(), 0);
+
+	//A new calculation with another size is possible after reset.
+	mixer.mix({1, 2, 3}, {1, 2, 3});
+	EXPECT_TRUE(mixer.isConverged());
+}
+
+//TBTKFeature Utilities.Mixer.toString.1 2026-10-16
+TEST(Mixer, toString0){
+	Mixer mixer(Mixer::Method::Anderson);
+	mixer.mix({1, 2}, {1, 2});
+	std::string report = mixer.toString();
+	EXPECT_NE(report.find("Anderson"), std::string::npos);
+	EXPECT_NE(report.find("Converged: Yes"), std::string::npos);
+}
+
+};
@@ -0,0 +1,262 @@
+#include "TBTK/SparseMatrix.h"
+
+#include "gtest/gtest.h"
+
+#include <complex>
+
+namespace TBTK{
+
+const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+class SparseMatrixTest : public ::testing::Test{
+protected:
+	const unsigned int SIZE = 4;
+	SparseMatrix<std::complex<double>> sparseMatrix;
+	std::vector<std::vector<std::complex<double>>> reference;
+	std::vector<std::complex<double>> x;
+	std::vector<std::complex<double>> y;
+
+	void SetUp() override{
+		//Tridiagonal matrix with complex hoppings and an empty last row.
+		sparseMatrix = SparseMatrix<std::complex<double>>(
+			SparseMatrix<std::complex<double>>::StorageFormat::CSR,
+			SIZE,
+			SIZE
+		);
+		reference = std::vector<std::vector<std::complex<double>>>(
+			SIZE,
+			std::vector<std::complex<double>>(SIZE, 0)
+		);
+		for(unsigned int n = 0; n < SIZE-1; n++){
+			std::complex<double> value(n + 1, 2*n - 1);
+			sparseMatrix.add(n, n, value);
+			reference[n][n] += value;
+			if(n + 1 < SIZE-1){
+				sparseMatrix.add(n, n+1, conj(value));
+				reference[n][n+1] += conj(value);
+				sparseMatrix.add(n+1, n, value);
+				reference[n+1][n] += value;
+			}
+		}
+		sparseMatrix.construct();
+
+		for(unsigned int n = 0; n < SIZE; n++){
+			x.push_back(std::complex<double>(n, 1));
+			y.push_back(std::complex<double>(1, -(double)n));
+		}
+	}
+
+	std::complex<double> getReferenceProduct(unsigned int row){
+		std::complex<double> result = 0;
+		for(unsigned int c = 0; c < SIZE; c++)
+			result += reference[row][c]*x[c];
+
+		return result;
+	}
+};
+
+//TBTKFeature Utilities.SparseMatrix.ConstructorCOO.0 2026-10-16
+TEST_F(SparseMatrixTest, ConstructorCOO0){
+	//The matrix elements of the reference matrix in reversed order and
+	//with the diagonal split into two equal contributions.
+	std::vector<unsigned int> rows;
+	std::vector<unsigned int> columns;
+	std::vector<std::complex<double>> values;
+	for(int row = SIZE-1; row >= 0; row--){
+		for(int column = SIZE-1; column >= 0; column--){
+			if(reference[row][column] == 0.)
+				continue;
+
+			unsigned int numContributions = (row == column ? 2 : 1);
+			for(unsigned int n = 0; n < numContributions; n++){
+				rows.push_back(row);
+				columns.push_back(column);
+				values.push_back(
+					reference[row][column]
+					/(double)numContributions
+				);
+			}
+		}
+	}
+
+	for(unsigned int n = 0; n < 2; n++){
+		SparseMatrix<std::complex<double>>::StorageFormat storageFormat
+			= (n == 0)
+			? SparseMatrix<std::complex<double>>::StorageFormat::CSR
+			: SparseMatrix<std::complex<double>>::StorageFormat::CSC;
+		SparseMatrix<std::complex<double>> expected = sparseMatrix;
+		expected.setStorageFormat(storageFormat);
+		SparseMatrix<std::complex<double>> sparseMatrixCOO(
+			storageFormat,
+			SIZE,
+			SIZE,
+			rows,
+			columns,
+			values
+		);
+		EXPECT_EQ(sparseMatrixCOO.getNumRows(), SIZE);
+		EXPECT_EQ(sparseMatrixCOO.getNumColumns(), SIZE);
+
+		unsigned int numMatrixElements;
+		const unsigned int *xPointers;
+		const unsigned int *y;
+		const std::complex<double> *matrixValues;
+		const unsigned int *expectedXPointers;
+		const unsigned int *expectedY;
+		const std::complex<double> *expectedValues;
+		if(n == 0){
+			numMatrixElements
+				= sparseMatrixCOO.getCSRNumMatrixElements();
+			ASSERT_EQ(
+				numMatrixElements,
+				expected.getCSRNumMatrixElements()
+			);
+			xPointers = sparseMatrixCOO.getCSRRowPointers();
+			y = sparseMatrixCOO.getCSRColumns();
+			matrixValues = sparseMatrixCOO.getCSRValues();
+			expectedXPointers = expected.getCSRRowPointers();
+			expectedY = expected.getCSRColumns();
+			expectedValues = expected.getCSRValues();
+		}
+		else{
+			numMatrixElements
+				= sparseMatrixCOO.getCSCNumMatrixElements();
+			ASSERT_EQ(
+				numMatrixElements,
+				expected.getCSCNumMatrixElements()
+			);
+			xPointers = sparseMatrixCOO.getCSCColumnPointers();
+			y = sparseMatrixCOO.getCSCRows();
+			matrixValues = sparseMatrixCOO.getCSCValues();
+			expectedXPointers = expected.getCSCColumnPointers();
+			expectedY = expected.getCSCRows();
+			expectedValues = expected.getCSCValues();
+		}
+
+		for(unsigned int c = 0; c < SIZE+1; c++)
+			EXPECT_EQ(xPointers[c], expectedXPointers[c]);
+		for(unsigned int c = 0; c < numMatrixElements; c++){
+			EXPECT_EQ(y[c], expectedY[c]);
+			EXPECT_NEAR(
+				real(matrixValues[c]),
+				real(expectedValues[c]),
+				EPSILON_100
+			);
+			EXPECT_NEAR(
+				imag(matrixValues[c]),
+				imag(expectedValues[c]),
+				EPSILON_100
+			);
+		}
+	}
+}
+
+//TBTKFeature Utilities.SparseMatrix.ConstructorCOO.1 2026-10-16
+TEST_F(SparseMatrixTest, ConstructorCOO1){
+	//Fail for matrix elements outside of the matrix.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SparseMatrix<std::complex<double>> sparseMatrixCOO(
+				SparseMatrix<
+					std::complex<double>
+				>::StorageFormat::CSR,
+				2,
+				2,
+				{0, 2},
+				{0, 1},
+				{1, 1}
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for incompatible sizes.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SparseMatrix<std::complex<double>> sparseMatrixCOO(
+				SparseMatrix<
+					std::complex<double>
+				>::StorageFormat::CSR,
+				2,
+				2,
+				{0, 1},
+				{0},
+				{1, 1}
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.SparseMatrix.multiply.0 2026-10-16
+TEST_F(SparseMatrixTest, multiply0){
+	std::vector<std::complex<double>> result(SIZE, 7);
+	sparseMatrix.multiply(x.data(), result.data());
+	for(unsigned int n = 0; n < SIZE; n++){
+		std::complex<double> product = getReferenceProduct(n);
+		EXPECT_NEAR(real(result[n]), real(product), EPSILON_100);
+		EXPECT_NEAR(imag(result[n]), imag(product), EPSILON_100);
+	}
+}
+
+//TBTKFeature Utilities.SparseMatrix.multiply.1 2026-10-16
+TEST_F(SparseMatrixTest, multiply1){
+	SparseMatrix<std::complex<double>> sparseMatrixCSC = sparseMatrix;
+	sparseMatrixCSC.setStorageFormat(
+		SparseMatrix<std::complex<double>>::StorageFormat::CSC
+	);
+	std::vector<std::complex<double>> result(SIZE);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			sparseMatrixCSC.multiply(x.data(), result.data());
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Utilities.SparseMatrix.axpby.0 2026-10-16
+TEST_F(SparseMatrixTest, axpby0){
+	std::complex<double> alpha(2, 1);
+	std::complex<double> beta(-1, 0.5);
+	std::vector<std::complex<double>> result(SIZE);
+	sparseMatrix.axpby(alpha, x.data(), beta, y.data(), result.data());
+	for(unsigned int n = 0; n < SIZE; n++){
+		std::complex<double> expected
+			= alpha*getReferenceProduct(n) + beta*y[n];
+		EXPECT_NEAR(real(result[n]), real(expected), EPSILON_100);
+		EXPECT_NEAR(imag(result[n]), imag(expected), EPSILON_100);
+	}
+}
+
+//TBTKFeature Utilities.SparseMatrix.axpby.1 2026-10-16
+TEST_F(SparseMatrixTest, axpby1){
+	//The result is allowed to be written to y.
+	std::vector<std::complex<double>> result = y;
+	sparseMatrix.axpby(2., x.data(), -1., result.data(), result.data());
+	for(unsigned int n = 0; n < SIZE; n++){
+		std::complex<double> expected
+			= 2.*getReferenceProduct(n) - y[n];
+		EXPECT_NEAR(real(result[n]), real(expected), EPSILON_100);
+		EXPECT_NEAR(imag(result[n]), imag(expected), EPSILON_100);
+	}
+}
+
+//TBTKFeature Utilities.SparseMatrix.axpby.2 2026-10-16
+TEST_F(SparseMatrixTest, axpby2){
+	//y is not accessed when beta is zero.
+	std::vector<std::complex<double>> result(SIZE);
+	sparseMatrix.axpby(3., x.data(), 0., nullptr, result.data());
+	for(unsigned int n = 0; n < SIZE; n++){
+		std::complex<double> expected = 3.*getReferenceProduct(n);
+		EXPECT_NEAR(real(result[n]), real(expected), EPSILON_100);
+		EXPECT_NEAR(imag(result[n]), imag(expected), EPSILON_100);
+	}
+}
+
+};
@@ -3,9 +3,21 @@
 #include "TBTK/TBTK.h"
 #include "TBTK/Test/PropertyExtractor/BlockDiagonalizer.h"
 
+#ifdef TBTK_USE_MPI
+#	include <mpi.h>
+#endif
+
 int main(int argc, char **argv){
+#ifdef TBTK_USE_MPI
+	MPI_Init(&argc, &argv);
+#endif
 	TBTK::Initialize();
 	::testing::InitGoogleTest(&argc, argv);
 
-	return RUN_ALL_TESTS();
+	int result = RUN_ALL_TESTS();
+#ifdef TBTK_USE_MPI
+	MPI_Finalize();
+#endif
+
+	return result;
 }
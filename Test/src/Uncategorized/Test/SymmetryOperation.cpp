@@ -0,0 +1,11 @@
+#include "gtest/gtest.h"
+
+#include "TBTK/TBTK.h"
+#include "TBTK/Test/SymmetryOperation.h"
+
+int main(int argc, char **argv){
+	TBTK::Initialize();
+	::testing::InitGoogleTest(&argc, argv);
+
+	return RUN_ALL_TESTS();
+}